@@ -48,6 +48,7 @@
 #include "progress_display.hpp"
 #include "reportingUtils.hpp"
 #include "sumAccumulators.hpp"
+#include "threadUtils.hpp"
 
 
 using namespace std;
@@ -251,6 +252,47 @@ ampIntegralMatrix::element(const unsigned int waveIndexI,
 	return _integrals[waveIndexI][waveIndexJ] / ((double)_nmbEvents);
 }
 
+namespace {
+
+	// splits the rows of the upper triangle of a nmbWaves x nmbWaves
+	// matrix into nmbChunks contiguous row ranges with approximately
+	// equal numbers of matrix elements; rows of chunk i are in
+	// [rowBegin[i], rowBegin[i + 1])
+	void
+	triangleRowRanges(const unsigned int    nmbWaves,
+	                  const unsigned int    nmbChunks,
+	                  vector<unsigned int>& rowBegin)
+	{
+		rowBegin.assign(nmbChunks + 1, nmbWaves);
+		rowBegin[0] = 0;
+		const double nmbElements = 0.5 * nmbWaves * (nmbWaves + 1);
+		double       nmbElementsRows = 0;
+		unsigned int iChunk          = 1;
+		for (unsigned int row = 0; (row < nmbWaves) and (iChunk < nmbChunks); ++row) {
+			nmbElementsRows += nmbWaves - row;
+			if (nmbElementsRows >= iChunk * nmbElements / nmbChunks)
+				rowBegin[iChunk++] = row + 1;
+		}
+	}
+
+
+	// adds term to compensated (Kahan) sum
+	inline
+	void
+	kahanAdd(complex<double>&       sum,
+	         complex<double>&       compensation,
+	         const complex<double>& term)
+	{
+		const complex<double> y = term - compensation;
+		const complex<double> t = sum + y;
+		compensation = (t - sum) - y;
+		sum          = t;
+	}
+
+}
+
+
+
 bool
 ampIntegralMatrix::setWaveNames(const vector<string> &waveNames)
 {
@@ -296,12 +338,70 @@ ampIntegralMatrix::addEvent(map<string, complex<double> > &amplitudes)
 	return true;
 }
 
+
+bool
+ampIntegralMatrix::addEvents(const vector<vector<complex<double> > >& amplitudes,
+                             const unsigned int                       nmbThreads)
+{
+	if (amplitudes.size() != _nmbWaves) {
+		printErr << "number of amplitude arrays (" << amplitudes.size() << ") does not match "
+		         << "number of waves (" << _nmbWaves << ")." << endl;
+		return false;
+	}
+	if (_nmbWaves == 0)
+		return true;
+	const unsigned long nmbEvents = amplitudes[0].size();
+	for (size_t iWave = 1; iWave < _nmbWaves; ++iWave)
+		if (amplitudes[iWave].size() != nmbEvents) {
+			printErr << "number of amplitudes for wave '" << _waveNames[iWave] << "' (" << amplitudes[iWave].size() << ") "
+			         << "differs from that of wave '" << _waveNames[0] << "' (" << nmbEvents << ")." << endl;
+			return false;
+		}
+
+	// every thread owns a range of rows of the upper triangle and the
+	// corresponding columns of the lower triangle; each matrix element
+	// is summed up in event order, so that the result is the same as
+	// that of calling addEvent() for every event
+	const unsigned int nmbThreadChunks = nmbChunks(_nmbWaves, nmbThreadsToUse(nmbThreads));
+	vector<unsigned int> chunkRowBegin;
+	triangleRowRanges(_nmbWaves, nmbThreadChunks, chunkRowBegin);
+	const unsigned long nmbEventsTile = 1024;  // number of events per tile; the amplitudes of all waves in a tile should fit into the L2 cache
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbThreadChunks) schedule(static, 1)
+#endif
+	for (unsigned int iChunk = 0; iChunk < nmbThreadChunks; ++iChunk)
+		for (unsigned long tileBegin = 0; tileBegin < nmbEvents; tileBegin += nmbEventsTile) {
+			const unsigned long tileEnd = min(tileBegin + nmbEventsTile, nmbEvents);
+			for (unsigned int iWave = chunkRowBegin[iChunk]; iWave < chunkRowBegin[iChunk + 1]; ++iWave) {
+				const complex<double>* iAmps = &amplitudes[iWave][0];
+				for (unsigned int jWave = iWave; jWave < _nmbWaves; ++jWave) {
+					const complex<double>* jAmps = &amplitudes[jWave][0];
+					complex<double>        upper = _integrals[iWave][jWave];
+					complex<double>        lower = _integrals[jWave][iWave];
+					for (unsigned long iEvent = tileBegin; iEvent < tileEnd; ++iEvent) {
+						const complex<double> val = iAmps[iEvent] * conj(jAmps[iEvent]);
+						upper += val;
+						// conj(val) is bitwise identical to jAmp * conj(iAmp)
+						lower += conj(val);
+					}
+					_integrals[iWave][jWave] = upper;
+					if (jWave != iWave)
+						_integrals[jWave][iWave] = lower;
+				}
+			}
+		}
+	_nmbEvents += nmbEvents;
+	return true;
+}
+
 bool
 ampIntegralMatrix::integrate(const vector<const amplitudeMetadata*>& ampMetadata,
                              const long                              maxNmbEvents,
                              const string&                           weightFileName,
                              const eventMetadata*                    eventMeta,
-                             const multibinBoundariesType&           otfBin)
+                             const multibinBoundariesType&           otfBin,
+                             const unsigned int                      nmbThreads,
+                             const long                              nmbEventsPerBlock)
 {
 	if (ampMetadata.empty()) {
 		printWarn << "did not receive any amplitude trees. cannot calculate integral." << endl;
@@ -400,87 +500,163 @@ ampIntegralMatrix::integrate(const vector<const amplitudeMetadata*>& ampMetadata
 		}
 	}
 
-	// loop over events and calculate integral matrix
+	// the amplitudes are read in blocks of events into a contiguous
+	// nmbWaves x (nmbEvents * nmbSubAmps) matrix and the upper triangle
+	// of the Hermitian product of this matrix with itself is accumulated
+	// in tiles of events; within a tile the products are added up in
+	// plain sums, and the sum of each tile is added to the compensated
+	// sum of the matrix element; the tiles are counted in selected
+	// events independent of the block boundaries, and every thread owns
+	// a range of matrix rows, so that each matrix element is summed up
+	// in event order by a single thread; hence the result is
+	// independent of the number of threads and of the block size
 	accumulator_set<double, stats<tag::sum(compensated)> > weightAcc;
-	typedef accumulator_set<complex<double>, stats<tag::sum(compensated)> > complexAcc;
-	vector<vector<complexAcc> > ampProdAcc(_nmbWaves, vector<complexAcc>(_nmbWaves));
+	// upper triangles of the plain sums of the current tile and of the
+	// compensated sums over the tiles as [wave index I][wave index J]
+	vector<vector<complex<double> > > ampProdTileSums(_nmbWaves, vector<complex<double> >(_nmbWaves, 0));
+	vector<vector<complex<double> > > ampProdSums    (_nmbWaves, vector<complex<double> >(_nmbWaves, 0));
+	vector<vector<complex<double> > > ampProdComps   (_nmbWaves, vector<complex<double> >(_nmbWaves, 0));
+	const unsigned int nmbThreadChunks = nmbChunks(_nmbWaves, nmbThreadsToUse(nmbThreads));
+	vector<unsigned int> chunkRowBegin;
+	triangleRowRanges(_nmbWaves, nmbThreadChunks, chunkRowBegin);
+	const unsigned long nmbEventsBlock = max(nmbEventsPerBlock, 1L);
+	const unsigned long nmbEventsTile  = 256;  // number of events per tile; the amplitudes of all waves in a tile should fit into the L2 cache
 	// process weight file and amplitudes
-	vector<vector<complex<double> > > amps(_nmbWaves);
+	vector<unsigned long>    blockEvents;         // indices of events in block that are within the on-the-fly bin
+	vector<double>           blockWeights;        // importance sampling weights of events in block
+	vector<unsigned int>     blockSubAmpOffsets;  // offsets of the sub-amplitudes of the events in block within an amplitude row
+	vector<complex<double> > blockAmps;           // amplitude matrix [wave index][event in block][sub-amplitude index]
 	progress_display progressIndicator(_nmbEvents, cout, "");
-	bool          success      = true;
-	unsigned long eventCounter = 0;
-	for (unsigned long iEvent = 0; iEvent < _nmbEvents; ++iEvent) {
-		++progressIndicator;
-
-		if(eventTree) {
-			eventTree->GetEntry(iEvent);
-			if (not variables.inBoundaries(otfBin)) {
-				continue;
-			}
-		}
-		++eventCounter;
-
-		// sum up importance sampling weight
-		double w = 1;
-		if (useWeight)
-			if (not(weightFile >> w)) {
-				success = false;
-				printWarn << "error reading weight file. stopping integration "
-				          << "at event " << iEvent << " of total " << _nmbEvents << "." << endl;
-				break;
+	bool          success         = true;
+	unsigned long eventCounter    = 0;
+	unsigned long nmbSummedEvents = 0;  // number of events whose amplitude products have been summed up
+	for (unsigned long blockBegin = 0; (blockBegin < _nmbEvents) and success; blockBegin += nmbEventsBlock) {
+		const unsigned long blockEnd = min(blockBegin + nmbEventsBlock, _nmbEvents);
+
+		// select events and sum up importance sampling weights
+		blockEvents.clear();
+		blockWeights.clear();
+		for (unsigned long iEvent = blockBegin; iEvent < blockEnd; ++iEvent) {
+			++progressIndicator;
+
+			if(eventTree) {
+				eventTree->GetEntry(iEvent);
+				if (not variables.inBoundaries(otfBin)) {
+					continue;
+				}
 			}
-		const double weight = 1 / w; // we have to undo the weighting of the events!
-		weightAcc(weight);
+			++eventCounter;
 
-		// read amplitude values for this event from root trees
-		for (unsigned int waveIndex = 0; waveIndex < _nmbWaves; ++waveIndex) {
-			ampMetadata[waveIndex]->amplitudeTree()->GetEntry(iEvent);
-			const unsigned int nmbSubAmps = ampTreeLeafs[waveIndex]->nmbIncohSubAmps();
-			if (nmbSubAmps < 1) {
-				printErr << "amplitude object for wave '" << _waveNames[waveIndex] << "' "
-				         << "does not contain any amplitude values "
-				         << "at event " << iEvent << " of total " << _nmbEvents << ". Aborting..." << endl;
-				throw;
-			}
-			// get all incoherent subamps
-			amps[waveIndex].resize(nmbSubAmps);
-			for (unsigned int subAmpIndex = 0; subAmpIndex < nmbSubAmps; ++subAmpIndex)
-				amps[waveIndex][subAmpIndex] = ampTreeLeafs[waveIndex]->incohSubAmp(subAmpIndex);
+			double w = 1;
+			if (useWeight)
+				if (not(weightFile >> w)) {
+					success = false;
+					printWarn << "error reading weight file. stopping integration "
+					          << "at event " << iEvent << " of total " << _nmbEvents << "." << endl;
+					break;
+				}
+			const double weight = 1 / w; // we have to undo the weighting of the events!
+			weightAcc(weight);
+			blockEvents.push_back (iEvent);
+			blockWeights.push_back(weight);
 		}
-
-		// sum up integral matrix elements
-		for (unsigned int waveIndexI = 0; waveIndexI < _nmbWaves; ++waveIndexI)
-			for (unsigned int waveIndexJ = 0; waveIndexJ < _nmbWaves; ++waveIndexJ) {
-				// sum over incoherent subamps
-				const unsigned int nmbSubAmps = amps[waveIndexI].size();
-				if (nmbSubAmps != amps[waveIndexJ].size()) {
+		const unsigned long nmbBlockEvents = blockEvents.size();
+		if (nmbBlockEvents == 0)
+			continue;
+
+		// read amplitude values for the events in this block from root
+		// trees; wave by wave, so that each tree is read sequentially
+		blockAmps.clear();
+		blockSubAmpOffsets.assign(nmbBlockEvents + 1, 0);
+		for (unsigned int waveIndex = 0; waveIndex < _nmbWaves; ++waveIndex) {
+			for (unsigned long i = 0; i < nmbBlockEvents; ++i) {
+				ampMetadata[waveIndex]->amplitudeTree()->GetEntry(blockEvents[i]);
+				const unsigned int nmbSubAmps = ampTreeLeafs[waveIndex]->nmbIncohSubAmps();
+				if (nmbSubAmps < 1) {
+					printErr << "amplitude object for wave '" << _waveNames[waveIndex] << "' "
+					         << "does not contain any amplitude values "
+					         << "at event " << blockEvents[i] << " of total " << _nmbEvents << ". Aborting..." << endl;
+					throw;
+				}
+				if (waveIndex == 0) {
+					blockSubAmpOffsets[i + 1] = blockSubAmpOffsets[i] + nmbSubAmps;
+				} else if (nmbSubAmps != blockSubAmpOffsets[i + 1] - blockSubAmpOffsets[i]) {
 					printErr << "number of incoherent sub-amplitudes for wave '"
-					         << _waveNames[waveIndexI] << "' = " << nmbSubAmps
-					         << " differs from that of wave '" << _waveNames[waveIndexJ] << "' = "
-					         << amps[waveIndexJ].size()
-					         << " at event " << iEvent << " of total " << _nmbEvents << ". Aborting... "
+					         << _waveNames[0] << "' = " << blockSubAmpOffsets[i + 1] - blockSubAmpOffsets[i]
+					         << " differs from that of wave '" << _waveNames[waveIndex] << "' = "
+					         << nmbSubAmps
+					         << " at event " << blockEvents[i] << " of total " << _nmbEvents << ". Aborting... "
 					         << "be sure to use only .root amplitude files, "
 					         << "if your channel has sub-amplitudes." << endl;
 					throw;
 				}
-				complex<double> val = 0;
+				// get all incoherent subamps
 				for (unsigned int subAmpIndex = 0; subAmpIndex < nmbSubAmps; ++subAmpIndex)
-					val += amps[waveIndexI][subAmpIndex] * conj(amps[waveIndexJ][subAmpIndex]);
-				if (useWeight)
-					val *= weight;
-				ampProdAcc[waveIndexI][waveIndexJ](val);
+					blockAmps.push_back(ampTreeLeafs[waveIndex]->incohSubAmp(subAmpIndex));
+			}
+		}
+		const size_t rowSize = blockSubAmpOffsets[nmbBlockEvents];
+
+		// sum up upper triangle of integral matrix
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbThreadChunks) schedule(static, 1)
+#endif
+		for (unsigned int iChunk = 0; iChunk < nmbThreadChunks; ++iChunk)
+			for (unsigned long tileBegin = 0; tileBegin < nmbBlockEvents;) {
+				// the first tile of the block might continue the last tile of the previous block
+				const unsigned long tileEnd      = min(tileBegin + nmbEventsTile - (nmbSummedEvents + tileBegin) % nmbEventsTile, nmbBlockEvents);
+				const bool          tileComplete = ((nmbSummedEvents + tileEnd) % nmbEventsTile == 0);
+				for (unsigned int waveIndexI = chunkRowBegin[iChunk]; waveIndexI < chunkRowBegin[iChunk + 1]; ++waveIndexI) {
+					const complex<double>* ampsI = &blockAmps[waveIndexI * rowSize];
+					for (unsigned int waveIndexJ = waveIndexI; waveIndexJ < _nmbWaves; ++waveIndexJ) {
+						const complex<double>* ampsJ = &blockAmps[waveIndexJ * rowSize];
+						double tileSumRe = ampProdTileSums[waveIndexI][waveIndexJ].real();
+						double tileSumIm = ampProdTileSums[waveIndexI][waveIndexJ].imag();
+						for (unsigned long i = tileBegin; i < tileEnd; ++i) {
+							// sum over incoherent subamps of amp_i * conj(amp_j)
+							double valRe = 0;
+							double valIm = 0;
+							for (unsigned int subAmpIndex = blockSubAmpOffsets[i]; subAmpIndex < blockSubAmpOffsets[i + 1]; ++subAmpIndex) {
+								valRe += ampsI[subAmpIndex].real() * ampsJ[subAmpIndex].real() + ampsI[subAmpIndex].imag() * ampsJ[subAmpIndex].imag();
+								valIm += ampsI[subAmpIndex].imag() * ampsJ[subAmpIndex].real() - ampsI[subAmpIndex].real() * ampsJ[subAmpIndex].imag();
+							}
+							if (useWeight) {
+								valRe *= blockWeights[i];
+								valIm *= blockWeights[i];
+							}
+							tileSumRe += valRe;
+							tileSumIm += valIm;
+						}
+						if (tileComplete) {
+							kahanAdd(ampProdSums[waveIndexI][waveIndexJ], ampProdComps[waveIndexI][waveIndexJ],
+							         complex<double>(tileSumRe, tileSumIm));
+							ampProdTileSums[waveIndexI][waveIndexJ] = 0;
+						} else
+							ampProdTileSums[waveIndexI][waveIndexJ] = complex<double>(tileSumRe, tileSumIm);
+					}
+				}
+				tileBegin = tileEnd;
 			}
-	}  // event loop
+		nmbSummedEvents += nmbBlockEvents;
+	}  // block loop
 	_nmbEvents = eventCounter;
 
-	// copy values from accumulators and (if necessary) renormalize to
-	// integral of importance sampling weights
+	// add last incomplete tile, copy values from compensated sums and
+	// (if necessary) renormalize to integral of importance sampling
+	// weights; the lower triangle is the complex conjugate of the upper
+	// one, because amp_j * conj(amp_i) is exactly the complex conjugate
+	// of amp_i * conj(amp_j) in IEEE arithmetic (without fused
+	// multiply-adds) and the compensated sum commutes with conjugation
 	const double weightNorm = sum(weightAcc) / (double)_nmbEvents;
 	for (unsigned int waveIndexI = 0; waveIndexI < _nmbWaves; ++waveIndexI)
-		for (unsigned int waveIndexJ = 0; waveIndexJ < _nmbWaves; ++waveIndexJ) {
-			_integrals[waveIndexI][waveIndexJ] = sum(ampProdAcc[waveIndexI][waveIndexJ]);
+		for (unsigned int waveIndexJ = waveIndexI; waveIndexJ < _nmbWaves; ++waveIndexJ) {
+			kahanAdd(ampProdSums[waveIndexI][waveIndexJ], ampProdComps[waveIndexI][waveIndexJ],
+			         ampProdTileSums[waveIndexI][waveIndexJ]);
+			_integrals[waveIndexI][waveIndexJ] = ampProdSums[waveIndexI][waveIndexJ] - ampProdComps[waveIndexI][waveIndexJ];
 			if (useWeight)
 				_integrals[waveIndexI][waveIndexJ] *= 1 / weightNorm;
+			if (waveIndexJ != waveIndexI)
+				_integrals[waveIndexJ][waveIndexI] = conj(_integrals[waveIndexI][waveIndexJ]);
 		}
 
 	printSucc << "calculated integrals of " << _nmbWaves << " amplitude(s) "
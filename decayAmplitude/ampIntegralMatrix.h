@@ -124,11 +124,15 @@ namespace rpwa {
 
 		bool setWaveNames(const std::vector<std::string> &waveNames);
 		bool addEvent(std::map<std::string, std::complex<double> > &amplitudes);
+		bool addEvents(const std::vector<std::vector<std::complex<double> > >& amplitudes,
+		               const unsigned int                                      nmbThreads = 1);  ///< adds amplitudes [wave index][event index] of several events; equivalent to calling addEvent() for each event
 		bool integrate(const std::vector<const rpwa::amplitudeMetadata*>& ampMetadata,
 		               const long                                         maxNmbEvents       = 0,
 		               const std::string&                                 weightFileName     = "",
 		               const rpwa::eventMetadata*                         eventMeta          = 0,
-		               const rpwa::multibinBoundariesType&                multibinBoundaries = rpwa::multibinBoundariesType());
+		               const rpwa::multibinBoundariesType&                multibinBoundaries = rpwa::multibinBoundariesType(),
+		               const unsigned int                                 nmbThreads         = 1,       // 0 uses all available threads
+		               const long                                         nmbEventsPerBlock  = 10000);  ///< calculates integral matrix from amplitude trees; result does not depend on number of threads or block size
 
 		void renormalize(const unsigned long nmbEventsRenorm);
 
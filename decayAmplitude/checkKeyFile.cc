@@ -51,6 +51,7 @@
 #include "waveDescription.h"
 #include "isobarHelicityAmplitude.h"
 #include "isobarCanonicalAmplitude.h"
+#include "isobarAmplitudeProgram.h"
 
 
 using namespace std;
@@ -71,7 +72,7 @@ usage(const string& progName,
 	     << "        -n #       maximum number of events to read (default: all)" << endl
 	     << "        -p file    path to particle data table file (default: ./particleDataTable.txt)" << endl
 	     << "        -t name    name of tree in ROOT data files (default: rootPwaEvtTree)" << endl
-	     << "        -e #       maximum deviation of amplitude ratios from 1 (default: 1E-6)" << endl
+	     << "        -e #       maximum deviation of amplitude ratios from 1 and maximum relative deviation of compiled amplitude program (default: 1E-6)" << endl
 	     << "        -l names   semicolon separated object/leaf names in input data (default: 'prodKinParticles;prodKinMomenta;decayKinParticles;decayKinMomenta')" << endl
 	     << "        -v         verbose; print debug output (default: false)" << endl
 	     << "        -h         print help" << endl
@@ -80,6 +81,46 @@ usage(const string& progName,
 }
 
 
+// calculates amplitudes with the compiled program; the kinematics data
+// of the decay topology the program was compiled from have to be initialized
+bool
+processTreeWithProgram(TTree&                        tree,
+                       const isobarAmplitudeProgram& program,
+                       vector<complex<double> >&     ampValues,
+                       const long int                maxNmbEvents,
+                       const string&                 prodKinMomentaLeafName,
+                       const string&                 decayKinMomentaLeafName)
+{
+	TBranch*      prodKinMomentaBr  = 0;
+	TBranch*      decayKinMomentaBr = 0;
+	TClonesArray* prodKinMomenta    = 0;
+	TClonesArray* decayKinMomenta   = 0;
+	tree.SetBranchAddress(prodKinMomentaLeafName.c_str(),  &prodKinMomenta,  &prodKinMomentaBr );
+	tree.SetBranchAddress(decayKinMomentaLeafName.c_str(), &decayKinMomenta, &decayKinMomentaBr);
+
+	const long int nmbEventsTree = tree.GetEntries();
+	const long int nmbEvents     = ((maxNmbEvents > 0) ? min(maxNmbEvents, nmbEventsTree)
+	                                                   : nmbEventsTree);
+	bool success = true;
+	for (long int eventIndex = 0; eventIndex < nmbEvents; ++eventIndex) {
+		if (tree.LoadTree(eventIndex) < 0)
+			break;
+		prodKinMomentaBr->GetEntry (eventIndex);
+		decayKinMomentaBr->GetEntry(eventIndex);
+
+		complex<double> amp;
+		if (prodKinMomenta and decayKinMomenta
+		    and program.amplitude(*prodKinMomenta, *decayKinMomenta, amp))
+			ampValues.push_back(amp);
+		else {
+			printWarn << "problems reading event[" << eventIndex << "]" << endl;
+			success = false;
+		}
+	}
+	return success;
+}
+
+
 bool testAmplitude(TTree*              inTree,
                    const string&       keyFileName,
                    vector<string>&     keyFileErrors,
@@ -152,6 +193,31 @@ bool testAmplitude(TTree*              inTree,
 			continue;
 		}
 
+		// calculate amplitudes with the compiled program, if the amplitude
+		// can be compiled
+		isobarAmplitudeProgram   program;
+		vector<complex<double> > ampProgramValues;
+		if (program.compile(*amplitude)) {
+			if (not processTreeWithProgram(*inTree, program, ampProgramValues, maxNmbEvents,
+			                               prodKinMomentaLeafName, decayKinMomentaLeafName)) {
+				printWarn << "problems reading tree" << endl;
+				continue;
+			}
+		} else
+			printInfo << "amplitude cannot be compiled into a program. "
+			          << "skipping comparison with compiled program." << endl;
+
+		// calculate amplitudes with recursive evaluation of the decay
+		vector<complex<double> > ampRecursionValues;
+		amplitude->enableHelicityMemoization(false);
+		if (not processTree(*inTree, *prodKinPartNames, *decayKinPartNames,
+		                    amplitude, ampRecursionValues, maxNmbEvents,
+		                    prodKinMomentaLeafName, decayKinMomentaLeafName, false)) {
+			printWarn << "problems reading tree" << endl;
+			continue;
+		}
+		amplitude->enableHelicityMemoization(true);
+
 		// calculate amplitudes for parity transformed decay daughters
 		vector<complex<double> > ampSpaceInvValues;
 		amplitude->enableSpaceInversion(true);
@@ -173,11 +239,19 @@ bool testAmplitude(TTree*              inTree,
 			continue;
 		}
 
-		if (   (ampValues.size() != ampSpaceInvValues.size())
-		    or (ampValues.size() != ampReflValues.size    ())) {
+		if (   (ampValues.size() != ampSpaceInvValues.size ())
+		    or (ampValues.size() != ampReflValues.size     ())
+		    or (ampValues.size() != ampRecursionValues.size())) {
 			printWarn << "different number of amplitudes for space inverted "
 			          << "(" << ampSpaceInvValues.size() << "), reflected "
-			          << "(" << ampReflValues.size() << "), and unmodified data "
+			          << "(" << ampReflValues.size() << "), recursively evaluated "
+			          << "(" << ampRecursionValues.size() << "), and unmodified data "
+			          << "(" << ampValues.size() << ")." << endl;
+			continue;
+		}
+		if (program.valid() and (ampValues.size() != ampProgramValues.size())) {
+			printWarn << "different number of amplitudes from compiled program "
+			          << "(" << ampProgramValues.size() << ") and unmodified data "
 			          << "(" << ampValues.size() << ")." << endl;
 			continue;
 		}
@@ -187,7 +261,29 @@ bool testAmplitude(TTree*              inTree,
 		unsigned int countAmpRatioNotOk         = 0;
 		unsigned int countSpaceInvEigenValNotOk = 0;
 		unsigned int countReflEigenValNotOk     = 0;
+		unsigned int countRecursionNotOk        = 0;
+		unsigned int countProgramNotOk          = 0;
 		for (unsigned int i = 0; i < ampValues.size(); ++i) {
+			// check that memoized and recursive evaluation give identical results
+			if (ampValues[i] != ampRecursionValues[i]) {
+				if (debug)
+					printDebug << "amplitude [" << i << "]: memoized evaluation "
+					           << maxPrecisionDouble(ampValues[i]) << " differs from recursive evaluation "
+					           << maxPrecisionDouble(ampRecursionValues[i]) << endl;
+				++countRecursionNotOk;
+			}
+
+			// check that compiled program agrees with evaluation of the
+			// decay topology; the order of the floating-point operations
+			// differs, so only agreement within the tolerance is required
+			if (program.valid() and (abs(ampProgramValues[i] - ampValues[i]) > maxDelta * abs(ampValues[i]))) {
+				if (debug)
+					printDebug << "amplitude [" << i << "]: compiled program "
+					           << maxPrecisionDouble(ampProgramValues[i]) << " differs from topology evaluation "
+					           << maxPrecisionDouble(ampValues[i]) << endl;
+				++countProgramNotOk;
+			}
+
 			// check that amplitude is non-zero
 			bool ampZero = false;
 			if (ampValues[i] == complex<double>(0, 0)) {
@@ -294,6 +390,16 @@ bool testAmplitude(TTree*              inTree,
 			keyFileErrors.push_back("wrong eigenvalue for reflection through production plane");
 			success = false;
 		}
+		if (countRecursionNotOk > 0) {
+			keyFileErrors.push_back("memoized and recursive evaluation of amplitude differ");
+			success = false;
+		}
+		if (countProgramNotOk > 0) {
+			stringstream s;
+			s << "compiled program and topology evaluation of amplitude differ by more than " << maxDelta;
+			keyFileErrors.push_back(s.str());
+			success = false;
+		}
 		successAll &= success;
 	}
 	return successAll;
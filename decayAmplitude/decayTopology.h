@@ -135,6 +135,8 @@ namespace rpwa {
 		bool initKinematicsData(const TClonesArray& prodKinParticles,
 		                        const TClonesArray& decayKinParticles);  ///< initializes input data
 
+		const std::map<unsigned int, unsigned int>& fsDataPartIndexMap() const { return _fsDataPartIndexMap; }  ///< returns map of final-state particle indices to indices in input data array; set by initKinematicsData()
+
 		bool readKinematicsData(const std::vector<TVector3>& prodKinMomenta,
 		                        const std::vector<TVector3>& decayKinMomenta);  ///< reads production and decay kinematics data and sets respective 4-momenta
 
@@ -59,6 +59,7 @@ diffractiveDissVertex::diffractiveDissVertex(const particlePtr& beam,
                                              const particlePtr& XParticle,
                                              const particlePtr& recoil)
 	: productionVertex(),
+	  _nmbProdKinPart (0),
 	  _beamMomCache   (),
 	  _recoilMomCache (),
 	  _targetMomCache ()
@@ -105,6 +106,7 @@ diffractiveDissVertex::operator =(const diffractiveDissVertex& vert)
 {
 	if (this != &vert) {
 		interactionVertex::operator =(vert);
+		_nmbProdKinPart = vert._nmbProdKinPart;
 		_beamMomCache   = vert._beamMomCache;
 		_recoilMomCache = vert._recoilMomCache;
 		_targetMomCache = vert._targetMomCache;
@@ -34,12 +34,15 @@
 #include <algorithm>
 #include <cassert>
 
+#include "TClonesArray.h"
 #include "TLorentzRotation.h"
 #include "TMath.h"
 
 #include "conversionUtils.hpp"
 #include "factorial.hpp"
 #include "isobarAmplitude.h"
+#include "physUtils.hpp"
+#include "threadUtils.hpp"
 
 
 using namespace std;
@@ -50,13 +53,54 @@ using namespace rpwa;
 bool isobarAmplitude::_debug = false;
 
 
+namespace {
+
+	bool
+	checkKinematicsData(const vector<const TClonesArray*>& prodKinMomenta,
+	                    const vector<const TClonesArray*>& decayKinMomenta)
+	{
+		if (decayKinMomenta.size() != prodKinMomenta.size()) {
+			printErr << "number of production kinematics entries (" << prodKinMomenta.size() << ") "
+			         << "differs from number of decay kinematics entries (" << decayKinMomenta.size() << "). "
+			         << "cannot calculate amplitudes." << endl;
+			return false;
+		}
+		for (size_t iEvt = 0; iEvt < prodKinMomenta.size(); ++iEvt)
+			if (not prodKinMomenta[iEvt] or not decayKinMomenta[iEvt]) {
+				printErr << "null pointer to kinematics data of event [" << iEvt << "]. "
+				         << "cannot calculate amplitudes." << endl;
+				return false;
+			}
+		return true;
+	}
+
+
+	bool
+	checkChunkSuccess(const vector<char>& chunkSuccess)
+	{
+		for (unsigned int iChunk = 0; iChunk < chunkSuccess.size(); ++iChunk)
+			if (not chunkSuccess[iChunk]) {
+				printWarn << "problems reading kinematics data of at least one event. "
+				          << "amplitudes of these events are set to 0." << endl;
+				return false;
+			}
+		return true;
+	}
+
+}
+
+
 isobarAmplitude::isobarAmplitude()
 	: _decay               (),
 	  _useReflectivityBasis(true),
 	  _boseSymmetrize      (true),
 	  _isospinSymmetrize   (true),
 	  _doSpaceInversion    (false),
-	  _doReflection        (false)
+	  _doReflection        (false),
+	  _memoizeHelicities   (true),
+	  _shareSubsystems     (true),
+	  _memoVertexIndex     (-1),
+	  _subsystemsShared    (false)
 { }
 
 
@@ -65,7 +109,11 @@ isobarAmplitude::isobarAmplitude(const isobarDecayTopologyPtr& decay)
 	  _boseSymmetrize      (true),
 	  _isospinSymmetrize   (true),
 	  _doSpaceInversion    (false),
-	  _doReflection        (false)
+	  _doReflection        (false),
+	  _memoizeHelicities   (true),
+	  _shareSubsystems     (true),
+	  _memoVertexIndex     (-1),
+	  _subsystemsShared    (false)
 {
 	setDecayTopology(decay);
 }
@@ -92,12 +140,18 @@ isobarAmplitude::setDecayTopology(const isobarDecayTopologyPtr& decay)
 	}
 	_decay = decay;
 	_decay->saveDecayToVertices(_decay);
+	_threadAmps.clear();
+	_vertexCaches.clear();
+	_symTermSubsystems.clear();
 }
 
 
 void
 isobarAmplitude::init()
 {
+	_threadAmps.clear();
+	_vertexCaches.clear();
+	_symTermSubsystems.clear();
 	_symTermMaps.clear();
 	// create first symmetrization entry with identity permutation map
 	vector<unsigned int> identityPermMap;
@@ -124,6 +178,13 @@ isobarAmplitude::amplitude() const
 		         << "was called. cannot calculate amplitude. returning 0." << endl;
 		return 0;
 	}
+	if (_memoizeHelicities and _shareSubsystems and not _debug
+	    and not _doSpaceInversion and not _doReflection) {
+		if (_symTermSubsystems.size() != 2 * nmbSymTerms)
+			initSymSubsystems();
+		if (_subsystemsShared)
+			return sharedSubsystemAmplitude();
+	}
 	// loop over all symmetrization terms; assumes that init() was called before
 	complex<double> amp = 0;
 	for (unsigned int i = 0; i < nmbSymTerms; ++i)
@@ -132,6 +193,182 @@ isobarAmplitude::amplitude() const
 }
 
 
+bool
+isobarAmplitude::amplitudes(const vector<const TClonesArray*>& prodKinMomenta,
+                            const vector<const TClonesArray*>& decayKinMomenta,
+                            vector<complex<double> >&          amps,
+                            const unsigned int                 nmbThreads)
+{
+	if (not checkKinematicsData(prodKinMomenta, decayKinMomenta))
+		return false;
+	const size_t nmbEvents = prodKinMomenta.size();
+	amps.resize(nmbEvents);
+	if (nmbEvents == 0)
+		return true;
+
+	// the events are split into contiguous chunks; each chunk is
+	// processed by its own copy of the amplitude, so that no decay
+	// topology is shared between threads; the first chunk uses this
+	// amplitude
+	unsigned int nmbEvtChunks = nmbChunks(nmbEvents, nmbThreadsToUse(nmbThreads));
+	if ((nmbEvtChunks > 1) and not initThreadAmps(nmbEvtChunks - 1, *prodKinMomenta[0], *decayKinMomenta[0]))
+		nmbEvtChunks = 1;
+	vector<char> chunkSuccess(nmbEvtChunks, true);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbEvtChunks) schedule(static, 1)
+#endif
+	for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk) {
+		const isobarAmplitude& amp = (iChunk == 0) ? *this : *_threadAmps[iChunk - 1];
+		size_t evtBegin, evtEnd;
+		chunkRange(nmbEvents, nmbEvtChunks, iChunk, evtBegin, evtEnd);
+		for (size_t iEvt = evtBegin; iEvt < evtEnd; ++iEvt) {
+			if (amp._decay->readKinematicsData(*prodKinMomenta[iEvt], *decayKinMomenta[iEvt]))
+				amps[iEvt] = amp.amplitude();
+			else {
+				amps[iEvt]           = 0;
+				chunkSuccess[iChunk] = false;
+			}
+		}
+	}
+
+	return checkChunkSuccess(chunkSuccess);
+}
+
+
+bool
+isobarAmplitude::amplitudes(const vector<isobarAmplitudePtr>&  amplitudes,
+                            const vector<const TClonesArray*>& prodKinMomenta,
+                            const vector<const TClonesArray*>& decayKinMomenta,
+                            vector<vector<complex<double> > >& amps,
+                            const unsigned int                 nmbThreads)
+{
+	if (not checkKinematicsData(prodKinMomenta, decayKinMomenta))
+		return false;
+	const size_t       nmbEvents = prodKinMomenta.size();
+	const unsigned int nmbAmps   = amplitudes.size();
+	for (unsigned int iAmp = 0; iAmp < nmbAmps; ++iAmp)
+		if (not amplitudes[iAmp]) {
+			printErr << "null pointer to amplitude [" << iAmp << "]. cannot calculate amplitudes." << endl;
+			return false;
+		}
+	amps.assign(nmbAmps, vector<complex<double> >(nmbEvents, 0));
+	if ((nmbEvents == 0) or (nmbAmps == 0))
+		return true;
+
+	// symmetrization terms of all amplitudes that lead to the same decay
+	// kinematics share one entry, so that the transformations into the
+	// Gottfried-Jackson and helicity frames are performed only once per event
+	map<string, unsigned int>     kinIndices;
+	vector<vector<unsigned int> > symTermKinIndices(nmbAmps);
+	for (unsigned int iAmp = 0; iAmp < nmbAmps; ++iAmp)
+		for (unsigned int iSymTerm = 0; iSymTerm < amplitudes[iAmp]->nmbSymTerms(); ++iSymTerm) {
+			const string key = amplitudes[iAmp]->symTermKinematicsKey(iSymTerm);
+			map<string, unsigned int>::const_iterator entry = kinIndices.find(key);
+			if (entry == kinIndices.end())
+				entry = kinIndices.insert(make_pair(key, (unsigned int)kinIndices.size())).first;
+			symTermKinIndices[iAmp].push_back(entry->second);
+		}
+	const unsigned int nmbKinematics = kinIndices.size();
+	if (_debug)
+		printDebug << "calculating " << nmbAmps << " amplitudes using " << nmbKinematics
+		           << " distinct decay kinematics" << endl;
+
+	// each chunk of events is processed by its own copies of the
+	// amplitudes; see amplitudes() for single amplitude
+	unsigned int nmbEvtChunks = nmbChunks(nmbEvents, nmbThreadsToUse(nmbThreads));
+	for (unsigned int iAmp = 0; (iAmp < nmbAmps) and (nmbEvtChunks > 1); ++iAmp)
+		if (not amplitudes[iAmp]->initThreadAmps(nmbEvtChunks - 1, *prodKinMomenta[0], *decayKinMomenta[0]))
+			nmbEvtChunks = 1;
+	vector<char> chunkSuccess(nmbEvtChunks, true);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbEvtChunks) schedule(static, 1)
+#endif
+	for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk) {
+		vector<const isobarAmplitude*>    chunkAmps        (nmbAmps);
+		vector<decayKinematics>           kinematics       (nmbKinematics);
+		vector<vector<decayKinematics*> > symTermKinematics(nmbAmps);
+		for (unsigned int iAmp = 0; iAmp < nmbAmps; ++iAmp) {
+			chunkAmps[iAmp] = (iChunk == 0) ? amplitudes[iAmp].get() : amplitudes[iAmp]->_threadAmps[iChunk - 1].get();
+			for (unsigned int iSymTerm = 0; iSymTerm < symTermKinIndices[iAmp].size(); ++iSymTerm)
+				symTermKinematics[iAmp].push_back(&kinematics[symTermKinIndices[iAmp][iSymTerm]]);
+		}
+		size_t evtBegin, evtEnd;
+		chunkRange(nmbEvents, nmbEvtChunks, iChunk, evtBegin, evtEnd);
+		for (size_t iEvt = evtBegin; iEvt < evtEnd; ++iEvt) {
+			for (unsigned int iKin = 0; iKin < nmbKinematics; ++iKin)
+				kinematics[iKin].clear();
+			for (unsigned int iAmp = 0; iAmp < nmbAmps; ++iAmp) {
+				const isobarAmplitude& amp = *chunkAmps[iAmp];
+				if (amp._decay->readKinematicsData(*prodKinMomenta[iEvt], *decayKinMomenta[iEvt]))
+					amps[iAmp][iEvt] = amp.amplitude(symTermKinematics[iAmp]);
+				else
+					chunkSuccess[iChunk] = false;
+			}
+		}
+	}
+
+	return checkChunkSuccess(chunkSuccess);
+}
+
+
+complex<double>
+isobarAmplitude::amplitude(const vector<decayKinematics*>& symTermKinematics) const
+{
+	const unsigned int nmbSymTerms = _symTermMaps.size();
+	if (nmbSymTerms < 1) {
+		printErr << "array of symmetrization terms is empty. make sure isobarAmplitude::init() "
+		         << "was called. cannot calculate amplitude. returning 0." << endl;
+		return 0;
+	}
+	if (symTermKinematics.size() != nmbSymTerms) {
+		printErr << "number of decay kinematics entries (" << symTermKinematics.size() << ") "
+		         << "differs from number of symmetrization terms (" << nmbSymTerms << "). "
+		         << "cannot calculate amplitude. returning 0." << endl;
+		return 0;
+	}
+	complex<double> amp = 0;
+	for (unsigned int i = 0; i < nmbSymTerms; ++i)
+		amp += _symTermMaps[i].factor * symTermAmp(_symTermMaps[i].fsPartPermMap, *symTermKinematics[i]);
+	return amp;
+}
+
+
+string
+isobarAmplitude::symTermKinematicsKey(const unsigned int symTermIndex) const
+{
+	// the decay kinematics are determined by the formalism, by the
+	// modifications of the event, by the production vertex, by the
+	// structure of the decay chain, and by the assignment of the
+	// final-state momenta in the input data to the final-state particles
+	ostringstream key;
+	key << name() << "|" << _decay->productionVertex()->name() << "|"
+	    << _doSpaceInversion << _doReflection << "|";
+	const vector<unsigned int>&            fsPartPermMap      = _symTermMaps[symTermIndex].fsPartPermMap;
+	const map<unsigned int, unsigned int>& fsDataPartIndexMap = _decay->fsDataPartIndexMap();
+	const vector<isobarDecayVertexPtr>&    vertices           = _decay->isobarDecayVertices();
+	for (unsigned int i = 0; i < vertices.size(); ++i) {
+		const particlePtr daughters[2] = {vertices[i]->daughter1(), vertices[i]->daughter2()};
+		for (unsigned int j = 0; j < 2; ++j) {
+			const int fsPartIndex = _decay->fsParticlesIndex(daughters[j]);
+			if (fsPartIndex >= 0) {
+				// final-state particle: index of its momentum in input data
+				const map<unsigned int, unsigned int>::const_iterator dataIndex
+					= fsDataPartIndexMap.find(fsPartPermMap[fsPartIndex]);
+				key << "f" << ((dataIndex != fsDataPartIndexMap.end()) ? (int)dataIndex->second : -1);
+			} else {
+				// isobar: index of its decay vertex
+				unsigned int k = i + 1;
+				while ((k < vertices.size()) and (vertices[k]->parent() != daughters[j]))
+					++k;
+				key << "v" << k;
+			}
+			key << ",";
+		}
+	}
+	return key.str();
+}
+
+
 TLorentzRotation
 isobarAmplitude::gjTransform(const TLorentzVector& beamLv,  // beam Lorentz-vector
                              const TLorentzVector& XLv)     // X  Lorentz-vector
@@ -179,6 +416,67 @@ isobarAmplitude::gjTransform(const TLorentzVector& beamLv,  // beam Lorentz-vect
 }
 
 
+void
+isobarAmplitude::cloneDecayTopology()
+{
+	_threadAmps.clear();
+	if (not _decay)
+		return;
+	// copy all vertices and particles including the final-state
+	// particles and the production kinematics
+	_decay = _decay->clone(true, true);
+	_decay->saveDecayToVertices(_decay);
+	// some mass dependences keep intermediate results in data members;
+	// mass dependences that cannot be copied remain shared
+	const vector<isobarDecayVertexPtr>& vertices = _decay->isobarDecayVertices();
+	for (unsigned int i = 0; i < vertices.size(); ++i) {
+		const massDependencePtr massDepClone = vertices[i]->massDependence()->clone();
+		if (massDepClone)
+			vertices[i]->setMassDependence(massDepClone);
+	}
+}
+
+
+bool
+isobarAmplitude::initThreadAmps(const unsigned int  nmbAmps,
+                                const TClonesArray& prodKinMomenta,
+                                const TClonesArray& decayKinMomenta)
+{
+	if (_threadAmps.size() >= nmbAmps)
+		return true;
+	// mass dependences that cannot be copied (e.g. those implemented in
+	// Python) must not be evaluated concurrently
+	const vector<isobarDecayVertexPtr>& vertices = _decay->isobarDecayVertices();
+	for (unsigned int i = 0; i < vertices.size(); ++i)
+		if (not vertices[i]->massDependence()->clone()) {
+			printWarn << "mass dependence '" << vertices[i]->massDependence()->name() << "' "
+			          << "of isobar '" << vertices[i]->parent()->name() << "' cannot be copied. "
+			          << "calculating amplitudes in a single thread." << endl;
+			return false;
+		}
+	while (_threadAmps.size() < nmbAmps)
+		_threadAmps.push_back(clone());
+	// the caches for D-functions, Clebsch-Gordan coefficients, and
+	// phase-space integrals are filled on first use and must not be
+	// filled concurrently; since the cache entries that are needed
+	// depend on the decay topology only, calculating one amplitude
+	// with every copy fills all entries before threads are started
+	vector<const isobarAmplitude*> amps(1, this);
+	for (unsigned int i = 0; i < _threadAmps.size(); ++i)
+		amps.push_back(_threadAmps[i].get());
+	for (unsigned int i = 0; i < amps.size(); ++i) {
+		if (not amps[i]->_decay->readKinematicsData(prodKinMomenta, decayKinMomenta)) {
+			printWarn << "problems reading kinematics data. "
+			          << "calculating amplitudes in a single thread." << endl;
+			_threadAmps.clear();
+			return false;
+		}
+		amps[i]->amplitude();
+	}
+	return true;
+}
+
+
 void
 isobarAmplitude::spaceInvertDecay() const
 {
@@ -222,13 +520,11 @@ isobarAmplitude::reflectDecay() const
 
 
 // assumes that all particles in the decay are mesons
-// !!! in this primitive recursion scheme daughter amplitudes might be
-//     called multiple times; for amplitudes with high-spin isobars a
-//     large speed gain might be achievable by precalculating the
-//     amplitudes at each vertex for all possible helicity values;
-//     additional speed can be gained by checking that daughter
-//     amplitudes are not zero before calculating the remaining parts
-//     of the amplitude
+// !!! in this primitive recursion scheme daughter amplitudes are
+//     called multiple times; memoizedDecayAmplitudeSum() calculates
+//     the same sum with the amplitudes at each vertex precalculated
+//     for all possible helicity values; the recursion is kept for
+//     debugging
 complex<double>
 isobarAmplitude::twoBodyDecayAmplitudeSum(const isobarDecayVertexPtr& vertex,           // current vertex
                                           const bool                  topVertex) const  // switches special treatment of X decay vertex; needed for reflectivity basis
@@ -277,6 +573,239 @@ isobarAmplitude::twoBodyDecayAmplitudeSum(const isobarDecayVertexPtr& vertex,
 }
 
 
+// evaluates the decay bottom-up: since the isobar vertices are
+// ordered depth-first, going through them in reverse order
+// calculates the amplitudes of all daughter vertices before the ones
+// of their parent vertex; each vertex is evaluated for all
+// helicities of its parent, the X decay vertex only for the spin
+// projection of X; helicity combinations with vanishing daughter
+// amplitudes are skipped; the terms are summed and multiplied in the
+// same order as in twoBodyDecayAmplitudeSum(), so that the result is
+// bit-identical
+complex<double>
+isobarAmplitude::memoizedDecayAmplitudeSum() const
+{
+	const vector<isobarDecayVertexPtr>& vertices = _decay->isobarDecayVertices();
+	if (_vertexCaches.size() != vertices.size())
+		initVertexCaches();
+	for (int iVert = vertices.size() - 1; iVert >= 0; --iVert)
+		memoizedVertexAmps(iVert);
+	_memoVertexIndex = -1;
+	return _vertexCaches[0].amps[0];
+}
+
+
+void
+isobarAmplitude::memoizedVertexAmps(const unsigned int vertexIndex) const
+{
+	const isobarDecayVertexPtr& vertex    = _decay->isobarDecayVertices()[vertexIndex];
+	const bool                  topVertex = (vertexIndex == 0);
+	const particlePtr&          parent    = vertex->parent();
+	const particlePtr&          daughter1 = vertex->daughter1();
+	const particlePtr&          daughter2 = vertex->daughter2();
+	vertexCache&                cache     = _vertexCaches[vertexIndex];
+	const int                   d1Index   = cache.daughterIndices[0];
+	const int                   d2Index   = cache.daughterIndices[1];
+	cache.factorsSet = false;
+	_memoVertexIndex = vertexIndex;
+	const int lambdaMin = (topVertex) ? parent->spinProj() : -parent->J();
+	const int lambdaMax = (topVertex) ? parent->spinProj() : +parent->J();
+	cache.amps.resize((lambdaMax - lambdaMin) / 2 + 1);
+	for (int lambda = lambdaMin; lambda <= lambdaMax; lambda += 2) {
+		if (not topVertex)
+			parent->setSpinProj(lambda);
+		complex<double> ampSum = 0;
+		for (int lambda1 = -daughter1->J(); lambda1 <= +daughter1->J(); lambda1 += 2) {
+			daughter1->setSpinProj(lambda1);
+			const complex<double> daughter1Amp =
+				(d1Index < 0) ? 1 : _vertexCaches[d1Index].amps[(lambda1 + daughter1->J()) / 2];
+			if (daughter1Amp == 0.)
+				continue;
+			for (int lambda2 = -daughter2->J(); lambda2 <= +daughter2->J(); lambda2 += 2) {
+				daughter2->setSpinProj(lambda2);
+				const complex<double> daughter2Amp =
+					(d2Index < 0) ? 1 : _vertexCaches[d2Index].amps[(lambda2 + daughter2->J()) / 2];
+				if (daughter2Amp == 0.)
+					continue;
+				ampSum += twoBodyDecayAmplitude(vertex, topVertex) * daughter1Amp * daughter2Amp;
+			}
+		}
+		cache.amps[(lambda - lambdaMin) / 2] = ampSum;
+	}
+}
+
+
+void
+isobarAmplitude::initVertexCaches() const
+{
+	const vector<isobarDecayVertexPtr>& vertices = _decay->isobarDecayVertices();
+	_vertexCaches.assign(vertices.size(), vertexCache());
+	for (unsigned int iVert = 0; iVert < vertices.size(); ++iVert) {
+		vertexCache& cache = _vertexCaches[iVert];
+		for (unsigned int iDaughter = 0; iDaughter < 2; ++iDaughter) {
+			const particlePtr& daughter = (iDaughter == 0) ? vertices[iVert]->daughter1() : vertices[iVert]->daughter2();
+			const isobarDecayVertexPtr daughterVertex =
+				dynamic_pointer_cast<isobarDecayVertex>(_decay->toVertex(daughter));
+			cache.daughterIndices[iDaughter] = -1;
+			if (daughterVertex)
+				for (unsigned int i = iVert + 1; i < vertices.size(); ++i)
+					if (vertices[i] == daughterVertex) {
+						cache.daughterIndices[iDaughter] = i;
+						break;
+					}
+		}
+		cache.factorsSet = false;
+		// vertices below a daughter of X belong to the decay chain of this daughter
+		if (iVert == 0)
+			cache.subsystem = -1;
+		for (unsigned int iDaughter = 0; iDaughter < 2; ++iDaughter)
+			if (cache.daughterIndices[iDaughter] >= 0)
+				_vertexCaches[cache.daughterIndices[iDaughter]].subsystem
+					= (iVert == 0) ? (int)iDaughter : cache.subsystem;
+	}
+}
+
+
+// the kinematics and the amplitudes of the decay chain below a
+// daughter of X depend only on the input momenta that are assigned
+// to the final-state particles in this chain and on the
+// Gottfried-Jackson frame; for each symmetrization term the chains
+// of both X daughters are identified by the ordered list of the
+// assigned input momenta, so that the symmetrization terms that lead
+// to the same chain can share its calculation
+void
+isobarAmplitude::initSymSubsystems() const
+{
+	const vector<isobarDecayVertexPtr>& vertices = _decay->isobarDecayVertices();
+	if (_vertexCaches.size() != vertices.size())
+		initVertexCaches();
+	// collect final-state particles in the decay chains of the X daughters
+	vector<unsigned int> fsPartIndices[2];
+	for (unsigned int iVert = 0; iVert < vertices.size(); ++iVert)
+		for (unsigned int iDaughter = 0; iDaughter < 2; ++iDaughter) {
+			if (_vertexCaches[iVert].daughterIndices[iDaughter] >= 0)
+				continue;
+			const particlePtr& daughter  = (iDaughter == 0) ? vertices[iVert]->daughter1() : vertices[iVert]->daughter2();
+			const int          subsystem = (iVert == 0) ? (int)iDaughter : _vertexCaches[iVert].subsystem;
+			fsPartIndices[subsystem].push_back(_decay->fsParticlesIndex(daughter));
+		}
+	// assign index to each distinct chain
+	_symTermSubsystems.clear();
+	map<vector<unsigned int>, unsigned int> subsystemIndices;
+	for (unsigned int iSymTerm = 0; iSymTerm < _symTermMaps.size(); ++iSymTerm)
+		for (unsigned int iDaughter = 0; iDaughter < 2; ++iDaughter) {
+			vector<unsigned int> key(1, iDaughter);
+			for (unsigned int i = 0; i < fsPartIndices[iDaughter].size(); ++i)
+				key.push_back(_symTermMaps[iSymTerm].fsPartPermMap[fsPartIndices[iDaughter][i]]);
+			map<vector<unsigned int>, unsigned int>::const_iterator entry = subsystemIndices.find(key);
+			if (entry == subsystemIndices.end())
+				entry = subsystemIndices.insert(make_pair(key, (unsigned int)subsystemIndices.size())).first;
+			_symTermSubsystems.push_back(entry->second);
+		}
+	_symSubsystems.assign(subsystemIndices.size(), symSubsystem());
+	_subsystemsShared = (_symSubsystems.size() < _symTermSubsystems.size());
+	if (_debug)
+		printDebug << "symmetrization terms contain " << _symSubsystems.size() << " distinct decay chains "
+		           << "of X daughters (out of " << _symTermSubsystems.size() << ")" << endl;
+}
+
+
+// performs the same calculation as symTermAmp() for all symmetrization
+// terms; the Lorentz-vectors of the isobars in the lab frame are
+// calculated first; if the decay chain of an X daughter was already
+// calculated in a previous term with a bit-identical Lorentz-vector
+// of X, its transformed Lorentz-vector and its amplitudes are taken
+// from there; if this is the case for both X daughters, the
+// transformation into the Gottfried-Jackson and helicity frames is
+// skipped completely; the result is bit-identical to the one of
+// symTermAmp()
+complex<double>
+isobarAmplitude::sharedSubsystemAmplitude() const
+{
+	const vector<isobarDecayVertexPtr>& vertices     = _decay->isobarDecayVertices();
+	const particlePtr                   daughters[2] = {vertices[0]->daughter1(), vertices[0]->daughter2()};
+	for (unsigned int i = 0; i < _symSubsystems.size(); ++i)
+		_symSubsystems[i].filled = false;
+	complex<double> amp = 0;
+	for (unsigned int iSymTerm = 0; iSymTerm < _symTermMaps.size(); ++iSymTerm) {
+		// (re)set final state momenta
+		if (not _decay->revertMomenta(_symTermMaps[iSymTerm].fsPartPermMap)) {
+			printErr << "problems reverting momenta in decay topology. cannot calculate amplitude. "
+			         << "returning 0." << endl;
+			continue;
+		}
+		const TLorentzVector XLv = _decay->calcIsobarLzVec();
+		symSubsystem*        subsystems[2];
+		bool                 reuse     [2];
+		for (unsigned int iDaughter = 0; iDaughter < 2; ++iDaughter) {
+			subsystems[iDaughter] = &_symSubsystems[_symTermSubsystems[2 * iSymTerm + iDaughter]];
+			reuse     [iDaughter] = subsystems[iDaughter]->filled and (subsystems[iDaughter]->XLv == XLv);
+		}
+		// transform daughters into their respective RFs
+		if (reuse[0] and reuse[1])
+			for (unsigned int iDaughter = 0; iDaughter < 2; ++iDaughter)
+				daughters[iDaughter]->setLzVec(subsystems[iDaughter]->daughterLv);
+		else
+			transformDaughters();
+		// calculate amplitudes of vertices in chains that are not reused
+		for (int iVert = vertices.size() - 1; iVert > 0; --iVert) {
+			const int subsystem = _vertexCaches[iVert].subsystem;
+			if (not reuse[subsystem])
+				memoizedVertexAmps(iVert);
+		}
+		for (unsigned int iDaughter = 0; iDaughter < 2; ++iDaughter) {
+			symSubsystem& subsystem   = *subsystems[iDaughter];
+			const int     vertexIndex = _vertexCaches[0].daughterIndices[iDaughter];
+			if (reuse[iDaughter]) {
+				if (vertexIndex >= 0)
+					_vertexCaches[vertexIndex].amps = subsystem.amps;
+			} else {
+				subsystem.filled     = true;
+				subsystem.XLv        = XLv;
+				subsystem.daughterLv = daughters[iDaughter]->lzVec();
+				if (vertexIndex >= 0)
+					subsystem.amps = _vertexCaches[vertexIndex].amps;
+			}
+		}
+		memoizedVertexAmps(0);
+		amp += _symTermMaps[iSymTerm].factor * _vertexCaches[0].amps[0];
+	}
+	_memoVertexIndex = -1;
+	return amp;
+}
+
+
+isobarAmplitude::vertexCache&
+isobarAmplitude::memoizedVertexFactors(const isobarDecayVertexPtr& vertex) const
+{
+	vertexCache& cache = _vertexCaches[_memoVertexIndex];
+	if (not cache.factorsSet) {
+		cache.barrierFactor = barrierFactor(vertex->L(), vertex->daughter1()->lzVec().Vect().Mag(), _debug);
+		cache.massDepAmp    = vertex->massDepAmplitude();
+		cache.factorsSet    = true;
+	}
+	return cache;
+}
+
+
+double
+isobarAmplitude::vertexBarrierFactor(const isobarDecayVertexPtr& vertex) const
+{
+	if (_memoVertexIndex < 0)
+		return barrierFactor(vertex->L(), vertex->daughter1()->lzVec().Vect().Mag(), _debug);
+	return memoizedVertexFactors(vertex).barrierFactor;
+}
+
+
+complex<double>
+isobarAmplitude::vertexMassDepAmplitude(const isobarDecayVertexPtr& vertex) const
+{
+	if (_memoVertexIndex < 0)
+		return vertex->massDepAmplitude();
+	return memoizedVertexFactors(vertex).massDepAmp;
+}
+
+
 complex<double>
 isobarAmplitude::symTermAmp(const vector<unsigned int>& fsPartPermMap) const
 {
@@ -289,6 +818,43 @@ isobarAmplitude::symTermAmp(const vector<unsigned int>& fsPartPermMap) const
 	// transform daughters into their respective RFs
 	transformDaughters();
 	// calculate amplitude
+	if (_memoizeHelicities and not _debug)
+		return memoizedDecayAmplitudeSum();
+	return twoBodyDecayAmplitudeSum(_decay->XIsobarDecayVertex(), true);
+}
+
+
+complex<double>
+isobarAmplitude::symTermAmp(const vector<unsigned int>& fsPartPermMap,
+                            decayKinematics&            kinematics) const
+{
+	const vector<isobarDecayVertexPtr>& vertices = _decay->isobarDecayVertices();
+	if (kinematics.empty()) {
+		// (re)set final state momenta
+		if (not _decay->revertMomenta(fsPartPermMap)) {
+			printErr << "problems reverting momenta in decay topology. cannot calculate amplitude. "
+			         << "returning 0." << endl;
+			return 0;
+		}
+		// transform daughters into their respective RFs and store result
+		transformDaughters();
+		kinematics.reserve(2 * vertices.size() + 1);
+		kinematics.push_back(_decay->XParticle()->lzVec());
+		for (unsigned int i = 0; i < vertices.size(); ++i) {
+			kinematics.push_back(vertices[i]->daughter1()->lzVec());
+			kinematics.push_back(vertices[i]->daughter2()->lzVec());
+		}
+	} else {
+		// daughters were already transformed for another amplitude
+		_decay->XParticle()->setLzVec(kinematics[0]);
+		for (unsigned int i = 0; i < vertices.size(); ++i) {
+			vertices[i]->daughter1()->setLzVec(kinematics[2 * i + 1]);
+			vertices[i]->daughter2()->setLzVec(kinematics[2 * i + 2]);
+		}
+	}
+	// calculate amplitude
+	if (_memoizeHelicities and not _debug)
+		return memoizedDecayAmplitudeSum();
 	return twoBodyDecayAmplitudeSum(_decay->XIsobarDecayVertex(), true);
 }
 
@@ -42,6 +42,9 @@
 #include "isobarDecayTopology.h"
 
 
+class TClonesArray;
+
+
 namespace rpwa {
 
 
@@ -53,10 +56,15 @@ namespace rpwa {
 
 	public:
 
+		typedef std::vector<TLorentzVector> decayKinematics;  ///< Lorentz-vectors of X and of all daughter particles after transformation into the frames in which the two-body decay amplitudes are calculated
+
+
 		isobarAmplitude();
 		isobarAmplitude(const isobarDecayTopologyPtr& decay);
 		virtual ~isobarAmplitude();
 
+		isobarAmplitudePtr clone() const { return isobarAmplitudePtr(doClone()); }  ///< creates deep copy of amplitude including decay topology, final-state particles, production kinematics, and mass dependences; must not be virtual
+
 		const isobarDecayTopologyPtr& decayTopology   () const { return _decay; }              ///< returns pointer to decay topology
 		void                          setDecayTopology(const isobarDecayTopologyPtr& decay);   ///< sets decay topology
 
@@ -65,14 +73,19 @@ namespace rpwa {
 		bool reflectivityBasis    () const { return _useReflectivityBasis; }  ///< returns whether reflectivity basis is used
 		bool boseSymmetrization   () const { return _boseSymmetrize;       }  ///< returns whether Bose symmetrization is used
 		bool isospinSymmetrization() const { return _isospinSymmetrize;    }  ///< returns whether isospin symmetrization is used
-		void enableReflectivityBasis    (const bool flag = true) { _useReflectivityBasis = flag; }  ///< en/disables use of reflectivity basis
-		void enableBoseSymmetrization   (const bool flag = true) { _boseSymmetrize       = flag; }  ///< en/disables use of Bose symmetrization
-		void enableIsospinSymmetrization(const bool flag = true) { _isospinSymmetrize    = flag; }  ///< en/disables use of isospin symmetrization
+		void enableReflectivityBasis    (const bool flag = true) { _useReflectivityBasis = flag; _threadAmps.clear(); }  ///< en/disables use of reflectivity basis
+		void enableBoseSymmetrization   (const bool flag = true) { _boseSymmetrize       = flag; _threadAmps.clear(); }  ///< en/disables use of Bose symmetrization
+		void enableIsospinSymmetrization(const bool flag = true) { _isospinSymmetrize    = flag; _threadAmps.clear(); }  ///< en/disables use of isospin symmetrization
 
 		bool doSpaceInversion() const { return _doSpaceInversion; }  ///< returns whether parity transformation is performed on decay
 		bool doReflection    () const { return _doReflection;     }  ///< returns whether decay is reflected through production plane
-		void enableSpaceInversion(const bool flag = true) { _doSpaceInversion = flag; }  ///< en/disables parity transformation of decay
-		void enableReflection    (const bool flag = true) { _doReflection     = flag; }  ///< en/disables reflection of decay through production plane
+		void enableSpaceInversion(const bool flag = true) { _doSpaceInversion = flag; _threadAmps.clear(); }  ///< en/disables parity transformation of decay
+		void enableReflection    (const bool flag = true) { _doReflection     = flag; _threadAmps.clear(); }  ///< en/disables reflection of decay through production plane
+
+		bool helicityMemoization      () const { return _memoizeHelicities; }  ///< returns whether vertex amplitudes are memoized for all helicities
+		void enableHelicityMemoization(const bool flag = true) { _memoizeHelicities = flag; _threadAmps.clear(); }  ///< en/disables bottom-up evaluation of the decay that calculates the amplitude of each vertex only once per helicity of its parent
+		bool subsystemSharing         () const { return _shareSubsystems;   }  ///< returns whether decay chains of X daughters are shared between symmetrization terms
+		void enableSubsystemSharing   (const bool flag = true) { _shareSubsystems   = flag; _threadAmps.clear(); }  ///< en/disables reuse of kinematics and amplitudes of the decay chain of an X daughter in all symmetrization terms of an event that assign the same final-state momenta to it; needs helicity memoization
 
 		static TLorentzRotation gjTransform(const TLorentzVector& beamLv,
 		                                    const TLorentzVector& XLv);  ///< constructs Lorentz-transformation to X Gottfried-Jackson frame
@@ -80,6 +93,27 @@ namespace rpwa {
 		std::complex<double> amplitude()   const;                         ///< computes amplitude
 		std::complex<double> operator ()() const { return amplitude(); }  ///< computes amplitude
 
+		bool amplitudes(const std::vector<const TClonesArray*>& prodKinMomenta,
+		                const std::vector<const TClonesArray*>& decayKinMomenta,
+		                std::vector<std::complex<double> >&     amps,
+		                const unsigned int                      nmbThreads = 1);  ///< computes amplitudes for a block of events; kinematics data have to be initialized; 0 threads means all available threads
+
+		static bool amplitudes(const std::vector<isobarAmplitudePtr>&           amplitudes,
+		                       const std::vector<const TClonesArray*>&          prodKinMomenta,
+		                       const std::vector<const TClonesArray*>&          decayKinMomenta,
+		                       std::vector<std::vector<std::complex<double> > >& amps,
+		                       const unsigned int                               nmbThreads = 1);  ///< computes amplitudes [amplitude index][event index] of several waves for a block of events in a single pass; decay kinematics that are identical for several waves are calculated only once
+
+		std::complex<double> amplitude(const std::vector<decayKinematics*>& symTermKinematics) const;  ///< computes amplitude; for each symmetrization term the decay kinematics are taken from the given entry if it is filled and are stored in it otherwise
+		std::string          symTermKinematicsKey(const unsigned int symTermIndex) const;            ///< returns string that is identical for all symmetrization terms of all amplitudes that lead to the same decay kinematics; kinematics data have to be initialized
+		unsigned int         nmbSymTerms() const { return _symTermMaps.size(); }                      ///< returns number of symmetrization terms; init() has to be called before
+		const std::vector<symTermMap>& symTermMaps() const { return _symTermMaps; }          ///< returns factors and permutation maps of symmetrization terms; init() has to be called before
+
+		bool initThreadAmps(const unsigned int  nmbAmps,
+		                    const TClonesArray& prodKinMomenta,
+		                    const TClonesArray& decayKinMomenta);  ///< creates copies of this amplitude for additional threads and fills all caches using the given event; returns false if amplitude cannot be calculated concurrently
+		const isobarAmplitude& threadAmp(const unsigned int index) const { return (index == 0) ? *this : *_threadAmps[index - 1]; }  ///< returns amplitude to be used by thread with given index; index 0 is this amplitude; initThreadAmps() has to be called before
+
 		virtual std::string   name           ()                  const { return "isobarAmplitude"; }
 		virtual std::ostream& printParameters(std::ostream& out) const;  ///< prints amplitude parameters in human-readable form
 		virtual std::ostream& print          (std::ostream& out) const;  ///< prints amplitude in human-readable form
@@ -90,6 +124,10 @@ namespace rpwa {
 
 	protected:
 
+		virtual isobarAmplitude* doClone() const = 0;  ///< helper function to use covariant return types with smart pointers; needed for public clone()
+
+		void cloneDecayTopology();  ///< replaces decay topology and mass dependences by independent copies; used by doClone() of derived classes
+
 		void spaceInvertDecay() const;  ///< performs parity transformation on all decay three-momenta
 		void reflectDecay    () const;  ///< performs reflection through production plane on all decay three-momenta
 
@@ -103,7 +141,14 @@ namespace rpwa {
 		(const isobarDecayVertexPtr& vertex,
 		 const bool                  topVertex = false) const;  ///< recursive function that sums up decay amplitudes for all allowed helicitities for all vertices below the given vertex
 
+		std::complex<double> memoizedDecayAmplitudeSum() const;  ///< calculates the same sum as twoBodyDecayAmplitudeSum() for the X decay vertex, but evaluates each vertex only once per helicity of its parent
+
+		double               vertexBarrierFactor   (const isobarDecayVertexPtr& vertex) const;  ///< returns barrier factor of given two-body decay; during memoized evaluation it is calculated only once per vertex
+		std::complex<double> vertexMassDepAmplitude(const isobarDecayVertexPtr& vertex) const;  ///< returns mass-dependent amplitude of given two-body decay; during memoized evaluation it is calculated only once per vertex
+
 		virtual std::complex<double> symTermAmp(const std::vector<unsigned int>& fsPartPermMap) const;  ///< returns decay amplitude for a certain permutation of final-state particles
+		std::complex<double> symTermAmp(const std::vector<unsigned int>& fsPartPermMap,
+		                                decayKinematics&                 kinematics) const;  ///< returns decay amplitude for a certain permutation of final-state particles using the given decay kinematics if filled; otherwise stores decay kinematics
 
 		virtual bool initSymTermMaps();
 
@@ -114,9 +159,44 @@ namespace rpwa {
 		bool                    _doSpaceInversion;      ///< is set, all three-momenta of the decay particles are parity transformed (for test purposes)
 		bool                    _doReflection;          ///< is set, all three-momenta of the decay particles are reflected through production plane (for test purposes)
 		std::vector<symTermMap> _symTermMaps;           ///< array of factors and permutation maps for symmetrization terms
+		bool                    _memoizeHelicities;     ///< if set, decay amplitude is evaluated bottom-up with amplitudes of each vertex memoized for all helicities
+		bool                    _shareSubsystems;       ///< if set, kinematics and amplitudes of the decay chains of the X daughters are calculated only once per event for all symmetrization terms that lead to the same chain
+
+		std::vector<isobarAmplitudePtr> _threadAmps;  ///< independent copies of this amplitude used by additional threads in amplitudes(); created on first use and reset by init(), setDecayTopology(), and the functions that en/disable amplitude options
 
 		static bool _debug;  ///< if set to true, debug messages are printed
 
+	private:
+
+		struct vertexCache {
+			int                                daughterIndices[2];  ///< indices of daughter vertices in isobar decay vertex array; -1 for final-state particles
+			int                                subsystem;           ///< index of X daughter whose decay chain contains this vertex; -1 for X decay vertex
+			std::vector<std::complex<double> > amps;                ///< amplitudes of vertex indexed by (parent helicity + J) / 2
+			bool                               factorsSet;          ///< indicates whether helicity-independent factors were already calculated for current event
+			double                             barrierFactor;       ///< barrier factor for current event
+			std::complex<double>               massDepAmp;          ///< mass-dependent amplitude for current event
+		};
+
+		struct symSubsystem {
+			bool                               filled;      ///< indicates whether decay chain was already calculated for current event
+			TLorentzVector                     XLv;         ///< Lorentz-vector of X in lab frame that defined the Gottfried-Jackson frame of the decay chain
+			TLorentzVector                     daughterLv;  ///< Lorentz-vector of X daughter in Gottfried-Jackson frame
+			std::vector<std::complex<double> > amps;        ///< amplitudes of decay vertex of X daughter indexed by (helicity + J) / 2; empty for final-state particles
+		};
+
+		void         initVertexCaches     ()                                   const;  ///< builds daughter-vertex indices for memoized evaluation
+		vertexCache& memoizedVertexFactors(const isobarDecayVertexPtr& vertex) const;  ///< returns cache of vertex that is currently evaluated; calculates helicity-independent factors on first call
+		void         memoizedVertexAmps   (const unsigned int vertexIndex)     const;  ///< calculates amplitudes of vertex for all helicities of its parent from the memoized amplitudes of its daughter vertices
+
+		void                 initSymSubsystems       () const;  ///< identifies decay chains of X daughters that are identical in several symmetrization terms
+		std::complex<double> sharedSubsystemAmplitude() const;  ///< computes amplitude calculating each distinct decay chain of the X daughters only once
+
+		mutable std::vector<vertexCache>  _vertexCaches;       ///< per-vertex data used by memoizedDecayAmplitudeSum(); indices follow isobarDecayVertices()
+		mutable int                       _memoVertexIndex;    ///< index of vertex that is currently evaluated by memoizedDecayAmplitudeSum(); -1 outside of memoized evaluation
+		mutable std::vector<unsigned int> _symTermSubsystems;  ///< indices of decay chains of both X daughters for each symmetrization term, i.e. [2 * term index + daughter index]
+		mutable std::vector<symSubsystem> _symSubsystems;      ///< distinct decay chains of the X daughters
+		mutable bool                      _subsystemsShared;   ///< indicates whether at least one decay chain appears in more than one symmetrization term
+
 	};
 
 
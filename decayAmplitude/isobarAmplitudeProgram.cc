@@ -0,0 +1,552 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      isobar decay amplitude compiled into a flat program
+//
+//      the program repeats the calculation of isobarHelicityAmplitude
+//      step by step with the same floating-point operations in the
+//      same order, so that the results are identical
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include <iomanip>
+#include <map>
+
+#include "TClonesArray.h"
+#include "TLorentzRotation.h"
+#include "TVector3.h"
+
+#include "dFunction.hpp"
+#include "diffractiveDissVertex.h"
+#include "isobarAmplitudeProgram.h"
+#include "isobarHelicityAmplitude.h"
+#include "massDependence.h"
+#include "physUtils.hpp"
+#include "spinUtils.hpp"
+#include "threadUtils.hpp"
+
+
+using namespace std;
+using namespace boost;
+using namespace rpwa;
+
+
+bool isobarAmplitudeProgram::_debug = false;
+
+
+namespace {
+
+	// collects slots of all particles downstream of the given vertex
+	void
+	collectSubtreeSlots(const vector<int>&    daughterVertexIndices,
+	                    const unsigned int    vertexIndex,
+	                    vector<unsigned int>& slots)
+	{
+		for (unsigned int iDaughter = 0; iDaughter < 2; ++iDaughter) {
+			slots.push_back(1 + 2 * vertexIndex + iDaughter);
+			const int daughterVertexIndex = daughterVertexIndices[2 * vertexIndex + iDaughter];
+			if (daughterVertexIndex >= 0)
+				collectSubtreeSlots(daughterVertexIndices, daughterVertexIndex, slots);
+		}
+	}
+
+}
+
+
+isobarAmplitudeProgram::isobarAmplitudeProgram()
+	: _valid         (false),
+	  _beamMass      (0),
+	  _nmbFsParticles(0),
+	  _nmbSlots      (0),
+	  _nmbVertexAmps (0)
+{ }
+
+
+isobarAmplitudeProgram::~isobarAmplitudeProgram()
+{ }
+
+
+// the Lorentz-vectors are stored in the same slot layout as in
+// isobarAmplitude::decayKinematics: slot 0 holds X, slots 2 * i + 1
+// and 2 * i + 2 hold the daughters of the i-th isobar decay vertex
+bool
+isobarAmplitudeProgram::compile(const isobarAmplitude& amplitude)
+{
+	_valid = false;
+	_symTerms.clear();
+	_instructions.clear();
+	_slotLists.clear();
+	_vertices.clear();
+
+	// check that amplitude can be compiled
+	if (not dynamic_cast<const isobarHelicityAmplitude*>(&amplitude)) {
+		printInfo << "only amplitudes in the helicity formalism can be compiled. "
+		          << "cannot compile '" << amplitude.name() << "'." << endl;
+		return false;
+	}
+	if (amplitude.doSpaceInversion() or amplitude.doReflection()) {
+		printInfo << "amplitudes with space inversion or reflection of the decay cannot be compiled." << endl;
+		return false;
+	}
+	const isobarDecayTopologyPtr& decay = amplitude.decayTopology();
+	const diffractiveDissVertexPtr prodVertex = dynamic_pointer_cast<diffractiveDissVertex>(decay->productionVertex());
+	if (not prodVertex) {
+		printInfo << "only amplitudes with diffractive-dissociation production vertex can be compiled." << endl;
+		return false;
+	}
+	const vector<symTermMap>& symTermMaps = amplitude.symTermMaps();
+	if (symTermMaps.empty()) {
+		printWarn << "array of symmetrization terms is empty. make sure isobarAmplitude::init() "
+		          << "was called. cannot compile amplitude." << endl;
+		return false;
+	}
+	_nmbFsParticles = decay->nmbFsParticles();
+	const map<unsigned int, unsigned int>& fsDataPartIndexMap = decay->fsDataPartIndexMap();
+	if (fsDataPartIndexMap.size() != _nmbFsParticles) {
+		printWarn << "kinematics data of decay topology are not initialized. cannot compile amplitude." << endl;
+		return false;
+	}
+	_beamMass = prodVertex->beam()->mass();
+
+	// assign slots to particles and find daughter vertices
+	const vector<isobarDecayVertexPtr>& vertices    = decay->isobarDecayVertices();
+	const unsigned int                  nmbVertices = vertices.size();
+	_nmbSlots = 2 * nmbVertices + 1;
+	map<const particle*, unsigned int> particleSlots;
+	map<const particle*, int>          particleVertexIndices;
+	particleSlots[vertices[0]->parent().get()] = 0;
+	for (unsigned int iVert = 0; iVert < nmbVertices; ++iVert) {
+		particleSlots[vertices[iVert]->daughter1().get()] = 2 * iVert + 1;
+		particleSlots[vertices[iVert]->daughter2().get()] = 2 * iVert + 2;
+		particleVertexIndices[vertices[iVert]->parent().get()] = iVert;
+	}
+	vector<int> daughterVertexIndices(2 * nmbVertices, -1);
+	for (unsigned int iVert = 0; iVert < nmbVertices; ++iVert)
+		for (unsigned int iDaughter = 0; iDaughter < 2; ++iDaughter) {
+			const particlePtr& daughter = (iDaughter == 0) ? vertices[iVert]->daughter1() : vertices[iVert]->daughter2();
+			map<const particle*, int>::const_iterator entry = particleVertexIndices.find(daughter.get());
+			if (entry != particleVertexIndices.end())
+				daughterVertexIndices[2 * iVert + iDaughter] = entry->second;
+		}
+	vector<unsigned int> fsSlots(_nmbFsParticles);
+	for (unsigned int iFs = 0; iFs < _nmbFsParticles; ++iFs) {
+		map<const particle*, unsigned int>::const_iterator entry = particleSlots.find(decay->fsParticles()[iFs].get());
+		if (entry == particleSlots.end()) {
+			printWarn << "final-state particle [" << iFs << "] is not a daughter of an isobar decay vertex. "
+			          << "cannot compile amplitude." << endl;
+			return false;
+		}
+		fsSlots[iFs] = entry->second;
+	}
+
+	// 1) final-state momenta of each symmetrization term; corresponds
+	//    to decayTopology::revertMomenta()
+	for (unsigned int iTerm = 0; iTerm < symTermMaps.size(); ++iTerm) {
+		const vector<unsigned int>& fsPartPermMap = symTermMaps[iTerm].fsPartPermMap;
+		if (fsPartPermMap.size() != _nmbFsParticles) {
+			printWarn << "permutation map of symmetrization term [" << iTerm << "] has wrong size "
+			          << fsPartPermMap.size() << " (expected " << _nmbFsParticles << "). "
+			          << "cannot compile amplitude." << endl;
+			return false;
+		}
+		symTerm term;
+		term.factor = symTermMaps[iTerm].factor;
+		for (unsigned int iFs = 0; iFs < _nmbFsParticles; ++iFs)
+			term.loads.push_back(instruction(LOAD_FS_MOMENTUM, fsSlots[iFs],
+			                                 fsDataPartIndexMap.find(fsPartPermMap[iFs])->second, 0,
+			                                 decay->fsParticles()[iFs]->mass()));
+		_symTerms.push_back(term);
+	}
+
+	// 2) Lorentz-vectors of isobars; corresponds to
+	//    isobarDecayTopology::calcIsobarLzVec()
+	for (int iVert = nmbVertices - 1; iVert >= 0; --iVert)
+		_instructions.push_back(instruction(ADD_LZVECS, particleSlots[vertices[iVert]->parent().get()],
+		                                    2 * iVert + 1, 2 * iVert + 2));
+
+	// 3) transformations into the frames of the two-body decays;
+	//    corresponds to isobarHelicityAmplitude::transformDaughters()
+	_instructions.push_back(instruction(GJ_TRANSFORM, 0, 1, _nmbSlots));
+	for (unsigned int iVert = 1; iVert < nmbVertices; ++iVert) {
+		const unsigned int slotsBegin = _slotLists.size();
+		collectSubtreeSlots(daughterVertexIndices, iVert, _slotLists);
+		_instructions.push_back(instruction(HF_TRANSFORM, particleSlots[vertices[iVert]->parent().get()],
+		                                    slotsBegin, _slotLists.size()));
+	}
+
+	// 4) vertex amplitudes; corresponds to
+	//    isobarAmplitude::memoizedDecayAmplitudeSum() and
+	//    isobarHelicityAmplitude::twoBodyDecayAmplitude()
+	_vertices.resize(nmbVertices);
+	_nmbVertexAmps = 0;
+	for (unsigned int iVert = 0; iVert < nmbVertices; ++iVert) {
+		const isobarDecayVertexPtr& vertex    = vertices[iVert];
+		const particlePtr&          parent    = vertex->parent();
+		const bool                  topVertex = (iVert == 0);
+		vertexProgram&              vert      = _vertices[iVert];
+		vert.parentSlot       = particleSlots[parent.get()];
+		vert.daughterSlots[0] = 2 * iVert + 1;
+		vert.daughterSlots[1] = 2 * iVert + 2;
+		vert.J                = parent->J();
+		vert.lambdaMin        = (topVertex) ? parent->spinProj() : -parent->J();
+		vert.nmbHelicities    = (topVertex) ? 1 : parent->J() + 1;
+		vert.P                = parent->P();
+		vert.refl             = parent->reflectivity();
+		vert.reflBasis        = topVertex and amplitude.reflectivityBasis();
+		vert.L                = vertex->L();
+		vert.norm             = angMomNormFactor(vert.L, false);
+		vert.ampOffset        = _nmbVertexAmps;
+		_nmbVertexAmps       += vert.nmbHelicities;
+
+		// mass dependence
+		const massDependencePtr& massDep = vertex->massDependence();
+		vert.massDepParameters[0] = parent->mass();
+		vert.massDepParameters[1] = parent->width();
+		if (dynamic_pointer_cast<flatMassDependence>(massDep))
+			vert.massDep = FLAT;
+		else if (const binnedMassDependencePtr binned = dynamic_pointer_cast<binnedMassDependence>(massDep)) {
+			vert.massDep              = BINNED;
+			vert.massDepParameters[0] = binned->getMassMin();
+			vert.massDepParameters[1] = binned->getMassMax();
+		} else if (    dynamic_pointer_cast<relativisticBreitWigner>(massDep)
+		           and vertex->daughter1()->isStable() and vertex->daughter2()->isStable())
+			vert.massDep = RELATIVISTIC_BREIT_WIGNER;
+		else if (dynamic_pointer_cast<constWidthBreitWigner>(massDep))
+			vert.massDep = CONST_WIDTH_BREIT_WIGNER;
+		else if (dynamic_pointer_cast<rhoBreitWigner>(massDep))
+			vert.massDep = RHO_BREIT_WIGNER;
+		else {
+			printInfo << "mass dependence '" << ((massDep) ? massDep->name() : "null") << "' "
+			          << "of vertex " << *vertex << " cannot be compiled." << endl;
+			return false;
+		}
+
+		// daughter-helicity combinations with non-vanishing
+		// Clebsch-Gordan coefficients; they do not depend on the
+		// helicity of the parent
+		const int S  = vertex->S();
+		const int s1 = vertex->daughter1()->J();
+		const int s2 = vertex->daughter2()->J();
+		for (int lambda1 = -s1; lambda1 <= +s1; lambda1 += 2)
+			for (int lambda2 = -s2; lambda2 <= +s2; lambda2 += 2) {
+				helicityTerm term;
+				term.daughterHelicities[0] = (lambda1 + s1) / 2;
+				term.daughterHelicities[1] = (lambda2 + s2) / 2;
+				term.lambda                = lambda1 - lambda2;
+				term.lsClebsch             = clebschGordanCoeff<double>(vert.L, 0, S, term.lambda, vert.J, term.lambda, false);
+				if (term.lsClebsch == 0)
+					continue;
+				term.ssClebsch = clebschGordanCoeff<double>(s1, lambda1, s2, -lambda2, S, term.lambda, false);
+				if (term.ssClebsch == 0)
+					continue;
+				vert.terms.push_back(term);
+			}
+	}
+	for (unsigned int iVert = 0; iVert < nmbVertices; ++iVert)
+		for (unsigned int iDaughter = 0; iDaughter < 2; ++iDaughter) {
+			const int daughterVertexIndex = daughterVertexIndices[2 * iVert + iDaughter];
+			_vertices[iVert].daughterAmpOffsets[iDaughter] =
+				(daughterVertexIndex < 0) ? -1 : (int)_vertices[daughterVertexIndex].ampOffset;
+		}
+	// daughter vertices have to be evaluated before their parent vertex
+	for (int iVert = nmbVertices - 1; iVert >= 0; --iVert)
+		_instructions.push_back(instruction(VERTEX_AMPS, iVert));
+
+	_valid = true;
+	if (_debug)
+		printDebug << "compiled amplitude '" << amplitude.name() << "':" << endl << *this;
+	return true;
+}
+
+
+bool
+isobarAmplitudeProgram::amplitude(const TClonesArray&   prodKinMomenta,
+                                  const TClonesArray&   decayKinMomenta,
+                                  complex<double>&      amp) const
+{
+	if (not _valid) {
+		printErr << "program was not compiled. cannot calculate amplitude." << endl;
+		return false;
+	}
+	workspace ws;
+	initWorkspace(ws);
+	return amplitude(prodKinMomenta, decayKinMomenta, amp, ws);
+}
+
+
+bool
+isobarAmplitudeProgram::amplitudes(const vector<const TClonesArray*>& prodKinMomenta,
+                                   const vector<const TClonesArray*>& decayKinMomenta,
+                                   vector<complex<double> >&          amps,
+                                   const unsigned int                 nmbThreads) const
+{
+	if (not _valid) {
+		printErr << "program was not compiled. cannot calculate amplitudes." << endl;
+		return false;
+	}
+	if (decayKinMomenta.size() != prodKinMomenta.size()) {
+		printErr << "number of production kinematics entries (" << prodKinMomenta.size() << ") "
+		         << "differs from number of decay kinematics entries (" << decayKinMomenta.size() << "). "
+		         << "cannot calculate amplitudes." << endl;
+		return false;
+	}
+	for (size_t iEvt = 0; iEvt < prodKinMomenta.size(); ++iEvt)
+		if (not prodKinMomenta[iEvt] or not decayKinMomenta[iEvt]) {
+			printErr << "null pointer to kinematics data of event [" << iEvt << "]. "
+			         << "cannot calculate amplitudes." << endl;
+			return false;
+		}
+	const size_t nmbEvents = prodKinMomenta.size();
+	amps.resize(nmbEvents);
+	if (nmbEvents == 0)
+		return true;
+
+	// the program is not modified during evaluation; each chunk of
+	// events only needs its own workspace
+	const unsigned int nmbEvtChunks = nmbChunks(nmbEvents, nmbThreadsToUse(nmbThreads));
+	vector<char>       chunkSuccess(nmbEvtChunks, true);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbEvtChunks) schedule(static, 1)
+#endif
+	for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk) {
+		workspace ws;
+		initWorkspace(ws);
+		size_t evtBegin, evtEnd;
+		chunkRange(nmbEvents, nmbEvtChunks, iChunk, evtBegin, evtEnd);
+		for (size_t iEvt = evtBegin; iEvt < evtEnd; ++iEvt)
+			if (not amplitude(*prodKinMomenta[iEvt], *decayKinMomenta[iEvt], amps[iEvt], ws)) {
+				amps[iEvt]           = 0;
+				chunkSuccess[iChunk] = false;
+			}
+	}
+
+	for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk)
+		if (not chunkSuccess[iChunk]) {
+			printWarn << "problems reading kinematics data of at least one event. "
+			          << "amplitudes of these events are set to 0." << endl;
+			return false;
+		}
+	return true;
+}
+
+
+ostream&
+isobarAmplitudeProgram::print(ostream& out) const
+{
+	if (not _valid) {
+		out << "isobar amplitude program: not compiled" << endl;
+		return out;
+	}
+	out << "isobar amplitude program: " << _nmbSlots << " Lorentz-vector slots, "
+	    << _nmbVertexAmps << " vertex amplitude slots, " << _symTerms.size() << " symmetrization term(s)" << endl;
+	for (unsigned int iTerm = 0; iTerm < _symTerms.size(); ++iTerm) {
+		out << "    symmetrization term [" << iTerm << "]: factor = " << maxPrecisionDouble(_symTerms[iTerm].factor) << ", loads:";
+		for (unsigned int i = 0; i < _symTerms[iTerm].loads.size(); ++i)
+			out << " slot[" << _symTerms[iTerm].loads[i].target << "] <- fs[" << _symTerms[iTerm].loads[i].arg1 << "]";
+		out << endl;
+	}
+	for (unsigned int i = 0; i < _instructions.size(); ++i) {
+		const instruction& instr = _instructions[i];
+		out << "    [" << setw(3) << i << "] ";
+		switch (instr.op) {
+		case LOAD_FS_MOMENTUM:
+			out << "LOAD_FS_MOMENTUM slot[" << instr.target << "] <- fs[" << instr.arg1 << "], m = " << instr.value;
+			break;
+		case ADD_LZVECS:
+			out << "ADD_LZVECS       slot[" << instr.target << "] <- slot[" << instr.arg1 << "] + slot[" << instr.arg2 << "]";
+			break;
+		case GJ_TRANSFORM:
+			out << "GJ_TRANSFORM     slots[" << instr.arg1 << ", " << instr.arg2 << ") into GJ frame of slot[" << instr.target << "]";
+			break;
+		case HF_TRANSFORM:
+			out << "HF_TRANSFORM     slots";
+			for (unsigned int j = instr.arg1; j < instr.arg2; ++j)
+				out << ((j == instr.arg1) ? " [" : ", ") << _slotLists[j];
+			out << "] into helicity frame of slot[" << instr.target << "]";
+			break;
+		case VERTEX_AMPS: {
+			const vertexProgram& vert = _vertices[instr.target];
+			out << "VERTEX_AMPS      vertex[" << instr.target << "]: slot[" << vert.parentSlot << "] -> "
+			    << "slot[" << vert.daughterSlots[0] << "] + slot[" << vert.daughterSlots[1] << "], "
+			    << "J = " << spinQn(vert.J) << ", L = " << spinQn(vert.L) << ", "
+			    << vert.nmbHelicities << " helicit" << ((vert.nmbHelicities == 1) ? "y" : "ies") << ", "
+			    << vert.terms.size() << " term(s), mass dependence kernel " << vert.massDep;
+			break;
+		}
+		}
+		out << endl;
+	}
+	return out;
+}
+
+
+void
+isobarAmplitudeProgram::initWorkspace(workspace& ws) const
+{
+	ws.lzVecs.assign    (_nmbSlots,       TLorentzVector());
+	ws.fsMomenta.assign (_nmbFsParticles, 0);
+	ws.vertexAmps.assign(_nmbVertexAmps,  0);
+}
+
+
+bool
+isobarAmplitudeProgram::amplitude(const TClonesArray&   prodKinMomenta,
+                                  const TClonesArray&   decayKinMomenta,
+                                  complex<double>&      amp,
+                                  workspace&            ws) const
+{
+	// read kinematics data; corresponds to decayTopology::readKinematicsData()
+	const TVector3* beamMom = (prodKinMomenta.GetEntriesFast() > 0) ? dynamic_cast<const TVector3*>(prodKinMomenta.At(0)) : 0;
+	if (not beamMom) {
+		printWarn << "production kinematics data entry [0] is not of type TVector3. "
+		          << "cannot read beam particle momentum." << endl;
+		return false;
+	}
+	const int nmbFsPart = decayKinMomenta.GetEntriesFast();
+	if ((nmbFsPart < 0) or ((unsigned int)nmbFsPart != _nmbFsParticles)) {
+		printWarn << "array of decay kinematics particle momenta has wrong size: "
+		          << nmbFsPart << " (expected " << _nmbFsParticles << "). "
+		          << "cannot read decay kinematics." << endl;
+		return false;
+	}
+	for (unsigned int i = 0; i < _nmbFsParticles; ++i) {
+		ws.fsMomenta[i] = dynamic_cast<const TVector3*>(decayKinMomenta.At(i));
+		if (not ws.fsMomenta[i]) {
+			printWarn << "decay kinematics data entry [" << i << "] is not of type TVector3. "
+			          << "cannot read decay kinematics." << endl;
+			return false;
+		}
+	}
+	const TLorentzVector beamLv(*beamMom, sqrt(beamMom->Mag2() + _beamMass * _beamMass));
+
+	// loop over all symmetrization terms
+	amp = 0;
+	for (unsigned int iTerm = 0; iTerm < _symTerms.size(); ++iTerm) {
+		const symTerm& term = _symTerms[iTerm];
+		for (unsigned int i = 0; i < term.loads.size(); ++i)
+			execute(term.loads[i], beamLv, ws);
+		for (unsigned int i = 0; i < _instructions.size(); ++i)
+			execute(_instructions[i], beamLv, ws);
+		amp += term.factor * ws.vertexAmps[_vertices[0].ampOffset];
+	}
+	return true;
+}
+
+
+void
+isobarAmplitudeProgram::execute(const instruction&    instr,
+                                const TLorentzVector& beamLv,
+                                workspace&            ws) const
+{
+	switch (instr.op) {
+	case LOAD_FS_MOMENTUM: {
+		const TVector3& mom = *ws.fsMomenta[instr.arg1];
+		ws.lzVecs[instr.target] = TLorentzVector(mom, sqrt(mom.Mag2() + instr.value * instr.value));
+		break;
+	}
+	case ADD_LZVECS:
+		ws.lzVecs[instr.target] = ws.lzVecs[instr.arg1] + ws.lzVecs[instr.arg2];
+		break;
+	case GJ_TRANSFORM: {
+		const TLorentzRotation gjTrans = isobarAmplitude::gjTransform(beamLv, ws.lzVecs[instr.target]);
+		for (unsigned int i = instr.arg1; i < instr.arg2; ++i)
+			ws.lzVecs[i].Transform(gjTrans);
+		break;
+	}
+	case HF_TRANSFORM: {
+		const TLorentzRotation hfTrans = isobarHelicityAmplitude::hfTransform(ws.lzVecs[instr.target]);
+		for (unsigned int i = instr.arg1; i < instr.arg2; ++i)
+			ws.lzVecs[_slotLists[i]].Transform(hfTrans);
+		break;
+	}
+	case VERTEX_AMPS:
+		vertexAmps(_vertices[instr.target], ws);
+		break;
+	}
+}
+
+
+void
+isobarAmplitudeProgram::vertexAmps(const vertexProgram& vert,
+                                   workspace&           ws) const
+{
+	const TLorentzVector& parentLv    = ws.lzVecs[vert.parentSlot];
+	const TLorentzVector& daughter1Lv = ws.lzVecs[vert.daughterSlots[0]];
+	const TLorentzVector& daughter2Lv = ws.lzVecs[vert.daughterSlots[1]];
+
+	// helicity-independent factors
+	const double phi   = daughter1Lv.Phi();  // use daughter1 as analyzer
+	const double theta = daughter1Lv.Theta();
+	const double bf    = barrierFactor(vert.L, daughter1Lv.Vect().Mag(), false);
+	complex<double> bw;
+	switch (vert.massDep) {
+	case FLAT:
+		bw = 1;
+		break;
+	case BINNED:
+		bw = binnedMassDependence::kernel(parentLv.M(), vert.massDepParameters[0], vert.massDepParameters[1]);
+		break;
+	case RELATIVISTIC_BREIT_WIGNER:
+		bw = relativisticBreitWigner::kernel(parentLv.M(), daughter1Lv.M(), daughter2Lv.M(),
+		                                     vert.massDepParameters[0], vert.massDepParameters[1], vert.L);
+		break;
+	case CONST_WIDTH_BREIT_WIGNER:
+		bw = constWidthBreitWigner::kernel(parentLv.M(), vert.massDepParameters[0], vert.massDepParameters[1]);
+		break;
+	case RHO_BREIT_WIGNER:
+		bw = rhoBreitWigner::kernel(parentLv.M(), daughter1Lv.M(), daughter2Lv.M(),
+		                            vert.massDepParameters[0], vert.massDepParameters[1]);
+		break;
+	}
+
+	// sum over daughter helicities for each parent helicity
+	for (unsigned int iHel = 0; iHel < vert.nmbHelicities; ++iHel) {
+		const int       Lambda = vert.lambdaMin + 2 * iHel;
+		complex<double> ampSum = 0;
+		for (unsigned int iTerm = 0; iTerm < vert.terms.size(); ++iTerm) {
+			const helicityTerm&   term         = vert.terms[iTerm];
+			const complex<double> daughter1Amp =
+				(vert.daughterAmpOffsets[0] < 0) ? 1 : ws.vertexAmps[vert.daughterAmpOffsets[0] + term.daughterHelicities[0]];
+			if (daughter1Amp == 0.)
+				continue;
+			const complex<double> daughter2Amp =
+				(vert.daughterAmpOffsets[1] < 0) ? 1 : ws.vertexAmps[vert.daughterAmpOffsets[1] + term.daughterHelicities[1]];
+			if (daughter2Amp == 0.)
+				continue;
+			complex<double> DFunc;
+			if (vert.reflBasis)
+				DFunc = DFunctionReflConj<complex<double> >(vert.J, Lambda, term.lambda, vert.P, vert.refl, phi, theta, 0, false);
+			else
+				DFunc = DFunctionConj<complex<double> >(vert.J, Lambda, term.lambda, phi, theta, 0, false);
+			const complex<double> parentAmp = vert.norm * DFunc * term.lsClebsch * term.ssClebsch * bf * bw;
+			ampSum += parentAmp * daughter1Amp * daughter2Amp;
+		}
+		ws.vertexAmps[vert.ampOffset + iHel] = ampSum;
+	}
+}
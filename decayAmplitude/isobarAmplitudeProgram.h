@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      isobar decay amplitude compiled into a flat program
+//
+//      the decay graph of an isobar amplitude is translated once
+//      into a fixed sequence of instructions that work on
+//      preallocated slots for the Lorentz-vectors of the particles
+//      and for the vertex amplitudes; quantum numbers,
+//      Clebsch-Gordan coefficients, and mass-dependence parameters
+//      are resolved at compile time; evaluating the program does
+//      not modify the program and does not touch the decay topology,
+//      so that one program can be used by several threads
+//
+//      currently only amplitudes in the helicity formalism with
+//      diffractive-dissociation production vertex and flat, binned,
+//      relativistic Breit-Wigner (for stable daughters),
+//      constant-width Breit-Wigner, or rho Breit-Wigner mass
+//      dependences can be compiled
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#ifndef ISOBARAMPLITUDEPROGRAM_H
+#define ISOBARAMPLITUDEPROGRAM_H
+
+
+#include <complex>
+#include <iostream>
+#include <vector>
+
+#include "TLorentzVector.h"
+
+#include "isobarAmplitude.h"
+
+
+class TClonesArray;
+
+
+namespace rpwa {
+
+
+	class isobarAmplitudeProgram {
+
+	public:
+
+		isobarAmplitudeProgram();
+		virtual ~isobarAmplitudeProgram();
+
+		bool compile(const isobarAmplitude& amplitude);  ///< translates amplitude into program; amplitude has to be initialized and kinematics data of its decay topology have to be initialized; returns false if amplitude cannot be compiled
+		bool valid() const { return _valid; }              ///< returns whether program was successfully compiled
+
+		bool amplitude(const TClonesArray&   prodKinMomenta,
+		               const TClonesArray&   decayKinMomenta,
+		               std::complex<double>& amp) const;  ///< computes amplitude for one event; returns false if kinematics data could not be read
+
+		bool amplitudes(const std::vector<const TClonesArray*>& prodKinMomenta,
+		                const std::vector<const TClonesArray*>& decayKinMomenta,
+		                std::vector<std::complex<double> >&     amps,
+		                const unsigned int                      nmbThreads = 1) const;  ///< computes amplitudes for a block of events; 0 threads means all available threads
+
+		unsigned int nmbInstructions() const { return _instructions.size(); }  ///< returns number of instructions executed for each symmetrization term
+		unsigned int nmbSymTerms    () const { return _symTerms.size();     }  ///< returns number of symmetrization terms
+
+		virtual std::ostream& print(std::ostream& out) const;  ///< prints program in human-readable form
+
+		static bool debug() { return _debug; }                             ///< returns debug flag
+		static void setDebug(const bool debug = true) { _debug = debug; }  ///< sets debug flag
+
+
+	private:
+
+		enum opCode {
+			LOAD_FS_MOMENTUM,  ///< sets slot target to Lorentz-vector of final-state particle with momentum index arg1 and mass value
+			ADD_LZVECS,        ///< sets slot target to sum of slots arg1 and arg2
+			GJ_TRANSFORM,      ///< transforms slots [arg1, arg2) into Gottfried-Jackson frame of X in slot target
+			HF_TRANSFORM,      ///< transforms slots _slotLists[arg1, arg2) into helicity frame of particle in slot target
+			VERTEX_AMPS        ///< calculates amplitudes of vertex target for all helicities of its parent
+		};
+
+		struct instruction {
+			instruction(const opCode       o,
+			            const unsigned int t,
+			            const unsigned int a1 = 0,
+			            const unsigned int a2 = 0,
+			            const double       v  = 0)
+				: op(o), target(t), arg1(a1), arg2(a2), value(v) { }
+			opCode       op;
+			unsigned int target;
+			unsigned int arg1;
+			unsigned int arg2;
+			double       value;
+		};
+
+		enum massDepKernel {
+			FLAT,
+			BINNED,
+			RELATIVISTIC_BREIT_WIGNER,
+			CONST_WIDTH_BREIT_WIGNER,
+			RHO_BREIT_WIGNER
+		};
+
+		struct helicityTerm {
+			unsigned int daughterHelicities[2];  ///< indices of daughter helicities, i.e. (lambda + J) / 2
+			int          lambda;                 ///< lambda_1 - lambda_2
+			double       lsClebsch;              ///< Clebsch-Gordan coefficient for L-S coupling
+			double       ssClebsch;              ///< Clebsch-Gordan coefficient for S-S coupling
+		};
+
+		struct vertexProgram {
+			unsigned int              parentSlot;
+			unsigned int              daughterSlots[2];
+			int                       daughterAmpOffsets[2];  ///< offsets of daughter vertex amplitudes; -1 for final-state particles
+			unsigned int              ampOffset;              ///< offset of amplitudes of this vertex
+			int                       J;
+			int                       lambdaMin;              ///< smallest helicity of parent; helicities are in steps of 2
+			unsigned int              nmbHelicities;          ///< number of parent helicities; 1 for X decay vertex
+			int                       P;
+			int                       refl;
+			bool                      reflBasis;              ///< if set, D-function in reflectivity basis is used
+			int                       L;
+			double                    norm;
+			massDepKernel             massDep;
+			double                    massDepParameters[2];   ///< (M0, Gamma0) for Breit-Wigners; (mMin, mMax) for binned mass dependence
+			std::vector<helicityTerm> terms;                  ///< daughter-helicity combinations with non-vanishing Clebsch-Gordan coefficients; identical for all parent helicities
+		};
+
+		struct symTerm {
+			std::complex<double>     factor;
+			std::vector<instruction> loads;
+		};
+
+		struct workspace {
+			std::vector<TLorentzVector>        lzVecs;
+			std::vector<const TVector3*>       fsMomenta;
+			std::vector<std::complex<double> > vertexAmps;
+		};
+
+		void initWorkspace(workspace& ws) const;
+
+		bool amplitude(const TClonesArray&   prodKinMomenta,
+		               const TClonesArray&   decayKinMomenta,
+		               std::complex<double>& amp,
+		               workspace&            ws) const;  ///< computes amplitude for one event using given workspace
+
+		void execute(const instruction&    instr,
+		             const TLorentzVector& beamLv,
+		             workspace&            ws) const;  ///< executes single instruction
+		void vertexAmps(const vertexProgram& vertex,
+		                workspace&           ws) const;  ///< calculates amplitudes of vertex for all helicities of its parent
+
+		bool                       _valid;
+		double                     _beamMass;
+		unsigned int               _nmbFsParticles;
+		unsigned int               _nmbSlots;
+		unsigned int               _nmbVertexAmps;
+		std::vector<symTerm>       _symTerms;      ///< factors and final-state loads for symmetrization terms
+		std::vector<instruction>   _instructions;  ///< instructions executed after loading the final-state momenta of each symmetrization term
+		std::vector<unsigned int>  _slotLists;     ///< slot indices referenced by HF_TRANSFORM instructions
+		std::vector<vertexProgram> _vertices;      ///< vertex data referenced by VERTEX_AMPS instructions; ordered like isobarDecayVertices()
+
+		static bool _debug;  ///< if set to true, debug messages are printed
+
+	};
+
+
+	inline
+	std::ostream&
+	operator <<(std::ostream&                 out,
+	            const isobarAmplitudeProgram& program)
+	{
+		return program.print(out);
+	}
+
+
+} // namespace rpwa
+
+
+#endif  // ISOBARAMPLITUDEPROGRAM_H
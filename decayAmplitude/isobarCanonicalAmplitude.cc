@@ -63,6 +63,15 @@ isobarCanonicalAmplitude::~isobarCanonicalAmplitude()
 { }
 
 
+isobarCanonicalAmplitude*
+isobarCanonicalAmplitude::doClone() const
+{
+	isobarCanonicalAmplitude* ampClone = new isobarCanonicalAmplitude(*this);
+	ampClone->cloneDecayTopology();
+	return ampClone;
+}
+
+
 void
 isobarCanonicalAmplitude::transformDaughters() const
 {
@@ -140,11 +149,10 @@ isobarCanonicalAmplitude::twoBodyDecayAmplitude(const isobarDecayVertexPtr& vert
 
 	// calulate barrier factor
 	const int    L  = vertex->L();
-	const double q  = daughter1->lzVec().Vect().Mag();
-	const double bf = barrierFactor(L, q, _debug);
+	const double bf = vertexBarrierFactor(vertex);
 
 	// calculate Breit-Wigner
-	const complex<double> bw = vertex->massDepAmplitude();
+	const complex<double> bw = vertexMassDepAmplitude(vertex);
 
 	// calculate normalization factor
 	const double norm = sqrt(fourPi);  // this factor comes from the fact that the (PWA2000)
@@ -61,6 +61,8 @@ namespace rpwa {
 
 	private:
 
+		virtual isobarCanonicalAmplitude* doClone() const;  ///< helper function to use covariant return types with smart pointers; needed for public clone()
+
 		void transformDaughters() const;  ///< boosts Lorentz-vectors of decay daughters into frames where angular distributions are defined
 
 		std::complex<double> twoBodyDecayAmplitude
@@ -88,7 +88,7 @@ namespace rpwa {
 		inline void setL(const unsigned int L) { _L = L; }  ///< sets the relative orbital angular momentum between the two daughters * 2 (!!!)
 		inline void setS(const unsigned int S) { _S = S; }  ///< sets the total spin of the two daughters * 2 (!!!)
 
-		inline std::complex<double>     massDepAmplitude() const { return _massDep->amp(*this); }  ///< returns mass-dependent amplitude
+		inline std::complex<double>     massDepAmplitude() const { return _massDep->tabulatedAmp(*this); }  ///< returns mass-dependent amplitude; interpolated from a table if tabulation is enabled
 		inline const massDependencePtr& massDependence  () const { return _massDep;             }  ///< returns mass-dependence
 		inline void setMassDependence(const massDependencePtr& massDep) { _massDep = massDep; }    ///< sets mass dependence
 
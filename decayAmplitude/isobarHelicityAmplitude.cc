@@ -63,6 +63,15 @@ isobarHelicityAmplitude::~isobarHelicityAmplitude()
 { }
 
 
+isobarHelicityAmplitude*
+isobarHelicityAmplitude::doClone() const
+{
+	isobarHelicityAmplitude* ampClone = new isobarHelicityAmplitude(*this);
+	ampClone->cloneDecayTopology();
+	return ampClone;
+}
+
+
 TLorentzRotation
 isobarHelicityAmplitude::hfTransform(const TLorentzVector& daughterLv)
 {
@@ -180,11 +189,10 @@ isobarHelicityAmplitude::twoBodyDecayAmplitude(const isobarDecayVertexPtr& verte
 		DFunc = DFunctionConj<complex<double> >(J, Lambda, lambda, phi, theta, 0, _debug);
 
 	// calulate barrier factor
-	const double q  = daughter1->lzVec().Vect().Mag();
-	const double bf = barrierFactor(L, q, _debug);
+	const double bf = vertexBarrierFactor(vertex);
 
 	// calculate Breit-Wigner
-	const complex<double> bw = vertex->massDepAmplitude();
+	const complex<double> bw = vertexMassDepAmplitude(vertex);
 
 	// calculate normalization factor
 	const double norm = angMomNormFactor(L, _debug);
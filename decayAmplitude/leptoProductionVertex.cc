@@ -66,6 +66,7 @@ leptoProductionVertex::leptoProductionVertex(const particlePtr& beamLepton,
                                              const particlePtr& recoil)
 	: productionVertex        (),
 	  _longPol                (0),
+	  _nmbProdKinPart         (0),
 	  _beamLeptonMomCache     (),
 	  _scatteredLeptonMomCache(),
 	  _recoilMomCache         (),
@@ -113,6 +114,8 @@ leptoProductionVertex::operator =(const leptoProductionVertex& vert)
 {
 	if (this != &vert) {
 		interactionVertex::operator =(vert);
+		_longPol                 = vert._longPol;
+		_nmbProdKinPart          = vert._nmbProdKinPart;
 		_beamLeptonMomCache      = vert._beamLeptonMomCache;
 		_scatteredLeptonMomCache = vert._scatteredLeptonMomCache;
 		_recoilMomCache          = vert._recoilMomCache;
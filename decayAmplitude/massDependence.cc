@@ -33,6 +33,8 @@
 
 #include "massDependence.h"
 
+#include <iomanip>
+#include <limits>
 #include <type_traits>
 #include <regex>
 
@@ -105,6 +107,19 @@ namespace {
 			throw;
 		}
 	}
+
+
+	// key for tabulation of a mass dependence that depends on the
+	// given parameters
+	string
+	tabulationKeyWithParameters(const string& name, const std::vector<double>& parameters)
+	{
+		ostringstream key;
+		key << name << setprecision(numeric_limits<double>::max_digits10);
+		for (size_t i = 0; i < parameters.size(); ++i)
+			key << "|" << parameters[i];
+		return key.str();
+	}
 }
 
 
@@ -145,7 +160,29 @@ rpwa::createMassDependence(const std::string& massDepType, const libconfig::Sett
 
 
 ////////////////////////////////////////////////////////////////////////////////
-bool massDependence::_debug = false;
+bool massDependence::_debug    = false;
+bool massDependence::_tabulate = false;
+
+
+// the table is looked up again whenever the full table key changes,
+// i.e. if the mass dependence is used at another vertex, if the
+// parameters of the amplitude or of the tables have changed
+complex<double>
+massDependence::tabulatedAmp(const isobarDecayVertex& v)
+{
+	if (not _tabulate or _debug)
+		return amp(v);
+	const string key = massDependenceTable::tableKey(*this, v);
+	if (key != _tableKey) {
+		_table    = massDependenceTable::table(*this, v);
+		_tableKey = key;
+	}
+	complex<double> tabulatedAmp;
+	if (_table and _table->interpolate(v.parent()->lzVec().M(), tabulatedAmp))
+		return tabulatedAmp;
+	return amp(v);
+}
+
 
 std::string
 massDependence::parentLabelForWaveName(const isobarDecayVertex& v) const
@@ -218,14 +255,11 @@ binnedMassDependence::Create(const libconfig::Setting* settings)
 complex<double>
 binnedMassDependence::amp(const isobarDecayVertex& v)
 {
-	complex<double> amp = 0.;
-
 	const particlePtr& parent = v.parent();
 
 	const double M = parent->lzVec().M();
 
-	if (_mMin <= M && M < _mMax)
-		amp = 1.;
+	const complex<double> amp = kernel(M, _mMin, _mMax);
 
 	if (_debug)
 		printDebug << name() << " M = " << parent->lzVec().M()
@@ -237,6 +271,18 @@ binnedMassDependence::amp(const isobarDecayVertex& v)
 }
 
 
+complex<double>
+binnedMassDependence::kernel(const double M,
+                             const double mMin,
+                             const double mMax)
+{
+	complex<double> amp = 0.;
+	if (mMin <= M && M < mMax)
+		amp = 1.;
+	return amp;
+}
+
+
 std::string
 binnedMassDependence::parentLabelForWaveName(const isobarDecayVertex& v) const
 {
@@ -261,23 +307,20 @@ relativisticBreitWigner::amp(const isobarDecayVertex& v)
 	if(daughter1->isStable() and daughter2->isStable()) {
 
 		// get Breit-Wigner parameters
-		const double       M      = parent->lzVec().M();         // parent mass
+		const double       M      = parent->lzVec().M();     // parent mass
 		const double       m1     = daughter1->lzVec().M();  // daughter 1 mass
 		const double       m2     = daughter2->lzVec().M();  // daughter 2 mass
-		const double       q      = breakupMomentum(M,  m1, m2);
-		const double       M0     = parent->mass();              // resonance peak position
-		const double       q02    = breakupMomentumSquared(M0, m1, m2, true);
-		// !NOTE! the following is incorrect but this is how it was done in PWA2000
-		const double       q0     = sqrt(fabs(q02));
-		const double       Gamma0 = parent->width();             // resonance peak width
+		const double       M0     = parent->mass();          // resonance peak position
+		const double       Gamma0 = parent->width();         // resonance peak width
 		const unsigned int L      = v.L();
 
-		bw = breitWigner(M, M0, Gamma0, L, q, q0);
+		bw = kernel(M, m1, m2, M0, Gamma0, L);
 		if (_debug)
 			printDebug << name() << "(m = " << maxPrecision(M) << " GeV/c^2, m_0 = " << maxPrecision(M0)
 			           << " GeV/c^2, Gamma_0 = " << maxPrecision(Gamma0) << " GeV/c^2, L = " << spinQn(L)
-			           << ", q = " << maxPrecision(q) << " GeV/c, q0 = "
-			           << maxPrecision(q0) << " GeV/c) = " << maxPrecisionDouble(bw) << endl;
+			           << ", q = " << maxPrecision(breakupMomentum(M, m1, m2)) << " GeV/c, q0 = "
+			           << maxPrecision(sqrt(fabs(breakupMomentumSquared(M0, m1, m2, true)))) << " GeV/c) = "
+			           << maxPrecisionDouble(bw) << endl;
 	} else {
 
 		bw = (*phaseSpaceIntegral::instance())(v);
@@ -288,6 +331,22 @@ relativisticBreitWigner::amp(const isobarDecayVertex& v)
 }
 
 
+complex<double>
+relativisticBreitWigner::kernel(const double       M,
+                                const double       m1,
+                                const double       m2,
+                                const double       M0,
+                                const double       Gamma0,
+                                const unsigned int L)
+{
+	const double q   = breakupMomentum(M,  m1, m2);
+	const double q02 = breakupMomentumSquared(M0, m1, m2, true);
+	// !NOTE! the following is incorrect but this is how it was done in PWA2000
+	const double q0  = sqrt(fabs(q02));
+	return breitWigner(M, M0, Gamma0, L, q, q0);
+}
+
+
 std::string
 relativisticBreitWigner::parentLabelForWaveName(const isobarDecayVertex& v) const
 {
@@ -295,6 +354,19 @@ relativisticBreitWigner::parentLabelForWaveName(const isobarDecayVertex& v) cons
 }
 
 
+std::string
+relativisticBreitWigner::tabulationKey(const isobarDecayVertex& v) const
+{
+	// for stable daughters the Breit-Wigner depends on the daughter masses
+	// and is cheap to calculate
+	if (v.daughter1()->isStable() and v.daughter2()->isStable())
+		return "";
+	const particlePtr& parent = v.parent();
+	return tabulationKeyWithParameters(name() + "|" + integralTableContainer::getSubWaveNameFromVertex(v),
+	                                   {parent->mass(), parent->width(), integralTableContainer::upperMassBound()});
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 complex<double>
 constWidthBreitWigner::amp(const isobarDecayVertex& v)
@@ -306,11 +378,7 @@ constWidthBreitWigner::amp(const isobarDecayVertex& v)
 	const double M0     = parent->mass();       // resonance peak position
 	const double Gamma0 = parent->width();      // resonance peak width
 
-	// A / (B - iA) = (A / (B^2 + A^2)) * (B + iA)
-	const double          A  = M0 * Gamma0;
-	const double          B  = M0 * M0 - M * M;
-	const complex<double> bw = (A / (B * B + A * A)) * complex<double>(B, A);
-	// const complex<double> bw = (M0 * Gamma0) / (M0 * M0 - M * M - imag * M0 * Gamma0);
+	const complex<double> bw = kernel(M, M0, Gamma0);
 	if (_debug)
 		printDebug << name() << "(m = " << maxPrecision(M) << " GeV/c^2, m_0 = " << maxPrecision(M0)
 		           << " GeV/c^2, Gamma_0 = " << maxPrecision(Gamma0) << " GeV/c^2) = "
@@ -319,6 +387,19 @@ constWidthBreitWigner::amp(const isobarDecayVertex& v)
 }
 
 
+complex<double>
+constWidthBreitWigner::kernel(const double M,
+                              const double M0,
+                              const double Gamma0)
+{
+	// A / (B - iA) = (A / (B^2 + A^2)) * (B + iA)
+	const double A = M0 * Gamma0;
+	const double B = M0 * M0 - M * M;
+	return (A / (B * B + A * A)) * complex<double>(B, A);
+	// return (M0 * Gamma0) / (M0 * M0 - M * M - imag * M0 * Gamma0);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 complex<double>
 rhoBreitWigner::amp(const isobarDecayVertex& v)
@@ -329,32 +410,45 @@ rhoBreitWigner::amp(const isobarDecayVertex& v)
 	const double M      = parent->lzVec().M();         // parent mass
 	const double m1     = v.daughter1()->lzVec().M();  // daughter 1 mass
 	const double m2     = v.daughter2()->lzVec().M();  // daughter 2 mass
-	const double q2     = breakupMomentumSquared(M,  m1, m2);
-	const double q      = sqrt(q2);
 	const double M0     = parent->mass();              // resonance peak position
-	const double q02    = breakupMomentumSquared(M0, m1, m2);
-	const double q0     = sqrt(q02);
 	const double Gamma0 = parent->width();             // resonance peak width
 
-	const double F      = 2 * q2 / (q02 + q2);
-	const double Gamma  = Gamma0 * (M0 / M) * (q / q0) * F;
+	const complex<double> bw = kernel(M, m1, m2, M0, Gamma0);
+	if (_debug)
+		printDebug << name() << "(m = " << maxPrecision(M) << " GeV/c^2, m_0 = " << maxPrecision(M0)
+		           << " GeV/c^2, Gamma_0 = " << maxPrecision(Gamma0) << " GeV/c^2, "
+		           << "q = " << maxPrecision(sqrt(breakupMomentumSquared(M, m1, m2))) << " GeV/c, "
+		           << "q0 = " << maxPrecision(sqrt(breakupMomentumSquared(M0, m1, m2))) << " GeV/c) "
+		           << "= " << maxPrecisionDouble(bw) << endl;
+	return bw;
+}
+
+
+complex<double>
+rhoBreitWigner::kernel(const double M,
+                       const double m1,
+                       const double m2,
+                       const double M0,
+                       const double Gamma0)
+{
+	const double q2    = breakupMomentumSquared(M,  m1, m2);
+	const double q     = sqrt(q2);
+	const double q02   = breakupMomentumSquared(M0, m1, m2);
+	const double q0    = sqrt(q02);
+
+	const double F     = 2 * q2 / (q02 + q2);
+	const double Gamma = Gamma0 * (M0 / M) * (q / q0) * F;
 	// in the original publication the width reads
 	// Gamma = Gamma0 * (q / q0) * F
 
 	// A / (B - iC) = (A / (B^2 + C^2)) * (B + iC)
-	const double          A  = M0 * Gamma0 * sqrt(F);
+	const double A = M0 * Gamma0 * sqrt(F);
 	// in the original publication A reads
 	// A = sqrt(M0 * Gamma0 * (m / q0) * F)
-	const double          B  = M0 * M0 - M * M;
-	const double          C  = M0 * Gamma;
-	const complex<double> bw = (A / (B * B + C * C)) * std::complex<double>(B, C);
+	const double B = M0 * M0 - M * M;
+	const double C = M0 * Gamma;
+	return (A / (B * B + C * C)) * std::complex<double>(B, C);
 	// return (M0 * Gamma0 * sqrt(F)) / (M0 * M0 - M * M - imag * M0 * Gamma);
-	if (_debug)
-		printDebug << name() << "(m = " << maxPrecision(M) << " GeV/c^2, m_0 = " << maxPrecision(M0)
-		           << " GeV/c^2, Gamma_0 = " << maxPrecision(Gamma0) << " GeV/c^2, "
-		           << "q = " << maxPrecision(q) << " GeV/c, q0 = " << maxPrecision(q0) << " GeV/c) "
-		           << "= " << maxPrecisionDouble(bw) << endl;
-	return bw;
 }
 
 
@@ -444,6 +538,13 @@ f0980FlatteBesII::amp(const isobarDecayVertex& v)
 }
 
 
+std::string
+f0980FlatteBesII::tabulationKey(const isobarDecayVertex& /*v*/) const
+{
+	return tabulationKeyWithParameters(name(), {_piChargedMass, _kaonChargedMass});
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 template<class T>
 piPiSWaveAuMorganPenningtonImpl<T>::piPiSWaveAuMorganPenningtonImpl()
@@ -557,6 +658,34 @@ piPiSWaveAuMorganPenningtonImpl<T>::amp(const isobarDecayVertex& v)
 }
 
 
+template<class T>
+std::string
+piPiSWaveAuMorganPenningtonImpl<T>::tabulationKey(const isobarDecayVertex& /*v*/) const
+{
+	std::vector<double> parameters;
+	for (unsigned int i = 0; i < _a.size(); ++i)
+		for (unsigned int j = 0; j < _a[i].size1(); ++j)
+			for (unsigned int k = 0; k < _a[i].size2(); ++k) {
+				parameters.push_back(_a[i](j, k).real());
+				parameters.push_back(_a[i](j, k).imag());
+			}
+	for (unsigned int i = 0; i < _c.size(); ++i)
+		for (unsigned int j = 0; j < _c[i].size1(); ++j)
+			for (unsigned int k = 0; k < _c[i].size2(); ++k) {
+				parameters.push_back(_c[i](j, k).real());
+				parameters.push_back(_c[i](j, k).imag());
+			}
+	for (unsigned int i = 0; i < _sP.size2(); ++i)
+		parameters.push_back(_sP(0, i));
+	parameters.push_back(_vesSheet);
+	parameters.push_back(_piChargedMass);
+	parameters.push_back(_piNeutralMass);
+	parameters.push_back(_kaonChargedMass);
+	parameters.push_back(_kaonNeutralMass);
+	return tabulationKeyWithParameters(this->name(), parameters);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // explicitely instantiate parent class for piPiSWaveAuMorganPenningtonM
 template class rpwa::piPiSWaveAuMorganPenningtonImpl<piPiSWaveAuMorganPenningtonM>;
@@ -727,6 +856,13 @@ KPiSGLASS::amp(const isobarDecayVertex& v)
 
 }
 
+std::string
+KPiSGLASS::tabulationKey(const isobarDecayVertex& /*v*/) const
+{
+	return tabulationKeyWithParameters(name(), {_a, _r, _M0, _G0, _phiF, _phiR, _phiRsin, _F, _R, _MMax,
+	                                            _piChargedMass, _kaonChargedMass});
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 KPiSPalanoPennington::KPiSPalanoPennington(const double MMax)
 :
@@ -824,6 +960,12 @@ KPiSPalanoPennington::amp(const isobarDecayVertex& v)
 
 }
 
+std::string
+KPiSPalanoPennington::tabulationKey(const isobarDecayVertex& /*v*/) const
+{
+	return tabulationKeyWithParameters(name(), {_MMax, _piChargedMass, _kaonChargedMass, _etaMass});
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 complex<double>
@@ -42,6 +42,8 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
 
+#include "massDependenceTable.h"
+
 
 namespace libconfig {
 	class Setting;
@@ -53,6 +55,8 @@ namespace rpwa {
 
 	class isobarDecayVertex;
 	typedef boost::shared_ptr<isobarDecayVertex> isobarDecayVertexPtr;
+	class massDependence;
+	typedef boost::shared_ptr<massDependence> massDependencePtr;
 
 
 	//////////////////////////////////////////////////////////////////////////////
@@ -66,8 +70,13 @@ namespace rpwa {
 
 		virtual std::complex<double> amp(const isobarDecayVertex& v) = 0;
 
+		std::complex<double> tabulatedAmp(const isobarDecayVertex& v);  ///< returns amplitude interpolated from a table in the parent mass, if tabulation is enabled and the mass dependence can be tabulated; returns amp() otherwise
+		virtual std::string  tabulationKey(const isobarDecayVertex& /*v*/) const { return ""; }  ///< returns string that identifies the amplitude as a function of the parent mass; empty if the amplitude depends on more than the parent mass and cannot be tabulated
+
 		virtual std::complex<double> operator ()(const isobarDecayVertex& v) { return amp(v); }
 
+		virtual massDependencePtr clone() const { return massDependencePtr(); }  ///< creates independent copy of mass dependence; returns null pointer if mass dependence cannot be copied
+
 		virtual std::string name() const = 0;  ///< returns label used in graph visualization, reporting, and key file
 
 		virtual std::string parentLabelForWaveName(const isobarDecayVertex& v) const;  ///< returns label for parent of decay used in wave name
@@ -80,6 +89,9 @@ namespace rpwa {
 		static bool debug() { return _debug; }                             ///< returns debug flag
 		static void setDebug(const bool debug = true) { _debug = debug; }  ///< sets debug flag
 
+		static bool tabulation() { return _tabulate; }                                 ///< returns whether mass-dependent amplitudes are interpolated from tables
+		static void enableTabulation(const bool flag = true) { _tabulate = flag; }  ///< en/disables interpolation of mass-dependent amplitudes from tables; see massDependenceTable for table parameters
+
 
 	protected:
 
@@ -88,10 +100,14 @@ namespace rpwa {
 
 		static bool _debug;  ///< if set to true, debug messages are printed
 
-	};
+	private:
 
+		massDependenceTableConstPtr _table;     ///< table used by tabulatedAmp(); null if mass dependence cannot be tabulated
+		std::string                 _tableKey;  ///< full key of _table; empty if mass dependence cannot be tabulated
 
-	typedef boost::shared_ptr<massDependence> massDependencePtr;
+		static bool _tabulate;  ///< if set, mass-dependent amplitudes are interpolated from tables
+
+	};
 
 
 	/// create a mass dependence object as specified by 'massDepType'
@@ -126,6 +142,8 @@ namespace rpwa {
 
 		virtual std::string name() const { return Name(); }  ///< returns label used in graph visualization, reporting, and key file
 
+		virtual massDependencePtr clone() const { return boost::make_shared<T>(static_cast<const T&>(*this)); }  ///< creates independent copy of mass dependence
+
 		static std::string Name() { return T::cName; } ///< returns the name used to trigger the creation of a mass dependence
 
 		template<typename... Args>
@@ -169,6 +187,10 @@ namespace rpwa {
 
 		virtual std::string parentLabelForWaveName(const isobarDecayVertex& v) const;  ///< returns label for parent of decay used in wave name
 
+		static std::complex<double> kernel(const double M,
+		                                   const double mMin,
+		                                   const double mMax);  ///< calculates amplitude for parent mass M in mass bin [mMin, mMax)
+
 		double getMassMin() const { return _mMin; }
 		double getMassMax() const { return _mMax; }
 
@@ -199,6 +221,14 @@ namespace rpwa {
 		virtual std::complex<double> amp(const isobarDecayVertex& v);
 
 		virtual std::string parentLabelForWaveName(const isobarDecayVertex& v) const;  ///< returns label for parent of decay used in wave name
+		virtual std::string tabulationKey         (const isobarDecayVertex& v) const;  ///< returns key only for decays into unstable daughters, where the width is calculated from phase-space integrals
+
+		static std::complex<double> kernel(const double       M,
+		                                   const double       m1,
+		                                   const double       m2,
+		                                   const double       M0,
+		                                   const double       Gamma0,
+		                                   const unsigned int L);  ///< calculates Breit-Wigner for parent mass M and stable daughters with masses m1 and m2
 
 		static constexpr const char* cName = "relativisticBreitWigner";
 
@@ -219,6 +249,10 @@ namespace rpwa {
 
 		virtual std::complex<double> amp(const isobarDecayVertex& v);
 
+		static std::complex<double> kernel(const double M,
+		                                   const double M0,
+		                                   const double Gamma0);  ///< calculates Breit-Wigner for parent mass M
+
 		static constexpr const char* cName = "constWidthBreitWigner";
 
 	};
@@ -243,6 +277,12 @@ namespace rpwa {
 
 		virtual std::complex<double> amp(const isobarDecayVertex& v);
 
+		static std::complex<double> kernel(const double M,
+		                                   const double m1,
+		                                   const double m2,
+		                                   const double M0,
+		                                   const double Gamma0);  ///< calculates Breit-Wigner for parent mass M and daughter masses m1 and m2
+
 		static constexpr const char* cName = "rhoBreitWigner";
 
 	};
@@ -284,6 +324,8 @@ namespace rpwa {
 
 		virtual std::complex<double> amp(const isobarDecayVertex& v);
 
+		virtual std::string tabulationKey(const isobarDecayVertex& v) const;
+
 		static constexpr const char* cName = "f0980FlatteBesII";
 
 	private:
@@ -313,6 +355,8 @@ namespace rpwa {
 
 		virtual std::complex<double> amp(const isobarDecayVertex& v);
 
+		virtual std::string tabulationKey(const isobarDecayVertex& v) const;
+
 	protected:
 
 		ublas::matrix<std::complex<double> >               _T;
@@ -439,6 +483,8 @@ namespace rpwa {
 
 		virtual std::complex<double> amp(const isobarDecayVertex& v);
 
+		virtual std::string tabulationKey(const isobarDecayVertex& v) const;
+
 		static constexpr const char* cName = "KPiSGLASS";
 
 	private:
@@ -482,6 +528,8 @@ namespace rpwa {
 
 		virtual std::complex<double> amp(const isobarDecayVertex& v);
 
+		virtual std::string tabulationKey(const isobarDecayVertex& v) const;
+
 		static constexpr const char* cName = "KPiSPalanoPennington";
 
 	private:
@@ -0,0 +1,263 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      table of a mass-dependent amplitude as a function of the
+//      parent mass
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include "massDependenceTable.h"
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#include <boost/make_shared.hpp>
+
+#include "TLorentzVector.h"
+
+#include "isobarDecayVertex.h"
+#include "massDependence.h"
+#include "reportingUtils.hpp"
+
+
+using namespace std;
+using namespace rpwa;
+
+
+map<string, massDependenceTableConstPtr> massDependenceTable::_tables;
+
+double       massDependenceTable::_lowerMassBound = 0.;
+double       massDependenceTable::_upperMassBound = 3.;
+unsigned int massDependenceTable::_nmbCells       = 3000;
+double       massDependenceTable::_tolerance      = 1e-10;
+
+const unsigned int massDependenceTable::N_NODES = 8;
+
+bool massDependenceTable::_debug = false;
+
+
+namespace {
+
+	bool
+	__isFinite(const complex<double>& value)
+	{
+		return std::isfinite(value.real()) and std::isfinite(value.imag());
+	}
+
+}
+
+
+// the amplitude is sampled by putting the parent particle at rest
+// with the respective mass; this is valid only for mass dependences
+// that provide a tabulation key, i.e. that depend only on the parent
+// mass
+massDependenceTable::massDependenceTable(massDependence&          massDep,
+                                         const isobarDecayVertex& vertex,
+                                         const string&            key)
+	: _key             (key),
+	  _mMin            (_lowerMassBound),
+	  _mMax            (_upperMassBound),
+	  _cellWidth       ((_upperMassBound - _lowerMassBound) / _nmbCells),
+	  _coefficients    (_nmbCells * N_NODES, 0),
+	  _cellValid       (_nmbCells, true),
+	  _maxAbsAmp       (0),
+	  _maxRelativeError(0)
+{
+	const particlePtr&   parent   = vertex.parent();
+	const TLorentzVector parentLv = parent->lzVec();
+
+	// sample amplitude at the Chebyshev nodes of each cell and calculate
+	// coefficients of the interpolating polynomial
+	vector<complex<double> > samples(N_NODES);
+	vector<double>           cellMaxAbsAmp(_nmbCells, 0);
+	for (unsigned int iCell = 0; iCell < _nmbCells; ++iCell) {
+		for (unsigned int k = 0; k < N_NODES; ++k) {
+			parent->setLzVec(TLorentzVector(0, 0, 0, cellMass(iCell, cos(M_PI * (k + 0.5) / N_NODES))));
+			samples[k] = massDep.amp(vertex);
+			if (__isFinite(samples[k]))
+				cellMaxAbsAmp[iCell] = max(cellMaxAbsAmp[iCell], abs(samples[k]));
+			else
+				_cellValid[iCell] = false;
+		}
+		_maxAbsAmp = max(_maxAbsAmp, cellMaxAbsAmp[iCell]);
+		for (unsigned int j = 0; j < N_NODES; ++j) {
+			complex<double> sum = 0;
+			for (unsigned int k = 0; k < N_NODES; ++k)
+				sum += samples[k] * cos(M_PI * j * (k + 0.5) / N_NODES);
+			_coefficients[iCell * N_NODES + j] = ((j == 0) ? 1. : 2.) / N_NODES * sum;
+		}
+	}
+
+	// the interpolation error is largest at the cell boundaries and at
+	// the extrema of the Chebyshev polynomial of order N_NODES, which lie
+	// between the nodes; the error is measured relative to the magnitude
+	// of the amplitude within the cell, so that the tolerance also holds
+	// far away from the peak of the amplitude; cells where it exceeds the
+	// tolerance are not used
+	for (unsigned int iCell = 0; iCell < _nmbCells; ++iCell) {
+		if (not _cellValid[iCell])
+			continue;
+		double cellError = 0;
+		for (unsigned int k = 0; k <= N_NODES; ++k) {
+			const double t = cos(M_PI * k / N_NODES);
+			parent->setLzVec(TLorentzVector(0, 0, 0, cellMass(iCell, t)));
+			const complex<double> amp = massDep.amp(vertex);
+			if (not __isFinite(amp)) {
+				cellError = numeric_limits<double>::infinity();
+				break;
+			}
+			cellMaxAbsAmp[iCell] = max(cellMaxAbsAmp[iCell], abs(amp));
+			cellError            = max(cellError, abs(chebyshevSum(iCell, t) - amp));
+		}
+		if (cellError > _tolerance * cellMaxAbsAmp[iCell])
+			_cellValid[iCell] = false;
+		else if (cellMaxAbsAmp[iCell] > 0)
+			_maxRelativeError = max(_maxRelativeError, cellError / cellMaxAbsAmp[iCell]);
+	}
+	parent->setLzVec(parentLv);
+
+	printInfo << "built table for '" << _key << "' with " << nmbValidCells() << " of "
+	          << _nmbCells << " valid cells in mass range [" << _mMin << ", " << _mMax << "] GeV/c^2; "
+	          << "maximum relative interpolation error = " << _maxRelativeError << endl;
+}
+
+
+bool
+massDependenceTable::interpolate(const double     M,
+                                 complex<double>& amp) const
+{
+	if (not ((M >= _mMin) and (M < _mMax)))
+		return false;
+	const unsigned int cell = (unsigned int)((M - _mMin) / _cellWidth);
+	if ((cell >= _cellValid.size()) or not _cellValid[cell])
+		return false;
+	amp = chebyshevSum(cell, 2 * (M - (_mMin + cell * _cellWidth)) / _cellWidth - 1);
+	if (_debug)
+		printDebug << "interpolated amplitude of '" << _key << "' at m = " << maxPrecision(M)
+		           << " GeV/c^2 = " << maxPrecisionDouble(amp) << endl;
+	return true;
+}
+
+
+unsigned int
+massDependenceTable::nmbValidCells() const
+{
+	unsigned int nmbValid = 0;
+	for (unsigned int iCell = 0; iCell < _cellValid.size(); ++iCell)
+		if (_cellValid[iCell])
+			++nmbValid;
+	return nmbValid;
+}
+
+
+string
+massDependenceTable::tableKey(const massDependence&    massDep,
+                              const isobarDecayVertex& vertex)
+{
+	const string massDepKey = massDep.tabulationKey(vertex);
+	if (massDepKey == "")
+		return "";
+	ostringstream key;
+	key << massDepKey << "|" << setprecision(numeric_limits<double>::max_digits10)
+	    << _lowerMassBound << "|" << _upperMassBound << "|" << _nmbCells << "|" << _tolerance;
+	return key.str();
+}
+
+
+// tables are looked up and inserted in a critical section; they are
+// built outside of it, because building a table might calculate
+// other mass-dependent amplitudes, e.g. for phase-space integrals,
+// possibly using several threads
+massDependenceTableConstPtr
+massDependenceTable::table(massDependence&          massDep,
+                           const isobarDecayVertex& vertex)
+{
+	const string key = tableKey(massDep, vertex);
+	if (key == "")
+		return massDependenceTableConstPtr();
+	if ((_nmbCells == 0) or (_upperMassBound <= _lowerMassBound)) {
+		printWarn << "invalid table parameters: " << _nmbCells << " cells in mass range ["
+		          << _lowerMassBound << ", " << _upperMassBound << "] GeV/c^2. "
+		          << "not tabulating '" << massDep.name() << "'." << endl;
+		return massDependenceTableConstPtr();
+	}
+
+	massDependenceTableConstPtr table;
+#ifdef _OPENMP
+#pragma omp critical(massDependenceTables)
+#endif
+	{
+		const map<string, massDependenceTableConstPtr>::const_iterator entry = _tables.find(key);
+		if (entry != _tables.end())
+			table = entry->second;
+	}
+	if (table)
+		return table;
+
+	const massDependenceTableConstPtr newTable = boost::make_shared<massDependenceTable>(massDep, vertex, key);
+#ifdef _OPENMP
+#pragma omp critical(massDependenceTables)
+#endif
+	{
+		// another thread might have built the same table in the meantime
+		const map<string, massDependenceTableConstPtr>::const_iterator entry = _tables.find(key);
+		if (entry != _tables.end())
+			table = entry->second;
+		else
+			table = _tables[key] = newTable;
+	}
+	return table;
+}
+
+
+double
+massDependenceTable::cellMass(const unsigned int cell,
+                              const double       t) const
+{
+	return _mMin + (cell + (t + 1) / 2) * _cellWidth;
+}
+
+
+complex<double>
+massDependenceTable::chebyshevSum(const unsigned int cell,
+                                  const double       t) const
+{
+	// Clenshaw recurrence
+	const complex<double>* coefficients = &_coefficients[cell * N_NODES];
+	complex<double>        b1           = 0;
+	complex<double>        b2           = 0;
+	for (unsigned int j = N_NODES - 1; j >= 1; --j) {
+		const complex<double> b0 = coefficients[j] + 2 * t * b1 - b2;
+		b2 = b1;
+		b1 = b0;
+	}
+	return coefficients[0] + t * b1 - b2;
+}
@@ -0,0 +1,140 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      table of a mass-dependent amplitude as a function of the
+//      parent mass
+//
+//      the mass range is divided into cells of equal width; in each
+//      cell the amplitude is sampled at Chebyshev nodes and
+//      interpolated by the corresponding Chebyshev polynomial; when
+//      the table is built, the interpolation is compared to the
+//      amplitude between the nodes and cells where the deviation
+//      exceeds the tolerance are marked invalid; for masses in
+//      invalid cells and outside of the mass range the amplitude has
+//      to be calculated directly
+//
+//      tables are identified by the key provided by the mass
+//      dependence and the table parameters; they are kept in memory
+//      for the lifetime of the process and are shared by all mass
+//      dependences with the same key; tables are not persistent,
+//      i.e. they are neither written to nor read from disk, and are
+//      built again in every process
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#ifndef MASSDEPENDENCETABLE_H
+#define MASSDEPENDENCETABLE_H
+
+
+#include <complex>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+
+namespace rpwa {
+
+	class isobarDecayVertex;
+	class massDependence;
+	class massDependenceTable;
+	typedef boost::shared_ptr<const massDependenceTable> massDependenceTableConstPtr;
+
+
+	class massDependenceTable {
+
+	public:
+
+		massDependenceTable(massDependence&          massDep,
+		                    const isobarDecayVertex& vertex,
+		                    const std::string&       key);  ///< samples amplitude of given mass dependence at given vertex and checks interpolation error
+		virtual ~massDependenceTable() { }
+
+		bool interpolate(const double          M,
+		                 std::complex<double>& amp) const;  ///< sets amp to interpolated amplitude at parent mass M; returns false if M is outside of the mass range or in an invalid cell
+
+		const std::string& key             () const { return _key;              }  ///< returns key that identifies table
+		unsigned int       nmbValidCells   () const;                               ///< returns number of cells in which the interpolation error is within the tolerance
+		double             maxAbsAmp       () const { return _maxAbsAmp;        }  ///< returns maximum absolute value of amplitude at the sampled masses
+		double             maxRelativeError() const { return _maxRelativeError; }  ///< returns maximum deviation between interpolation and amplitude in valid cells relative to the maximum absolute value of the amplitude in the respective cell
+
+		static massDependenceTableConstPtr table(massDependence&          massDep,
+		                                         const isobarDecayVertex& vertex);  ///< returns table for given mass dependence at given vertex; table is built on first use; returns null pointer if mass dependence cannot be tabulated
+		static std::string tableKey(const massDependence&    massDep,
+		                            const isobarDecayVertex& vertex);  ///< returns key of table for given mass dependence at given vertex built from the key of the mass dependence and the current table parameters; empty if mass dependence cannot be tabulated
+
+		static double       lowerMassBound() { return _lowerMassBound; }  ///< returns lower bound of mass range of new tables
+		static double       upperMassBound() { return _upperMassBound; }  ///< returns upper bound of mass range of new tables
+		static unsigned int nmbCells      () { return _nmbCells;       }  ///< returns number of cells of new tables
+		static double       tolerance     () { return _tolerance;      }  ///< returns maximum interpolation error of new tables relative to maximum absolute value of amplitude in the cell
+		static void setMassRange(const double       lowerBound,
+		                         const double       upperBound) { _lowerMassBound = lowerBound; _upperMassBound = upperBound; }  ///< sets mass range of new tables
+		static void setNmbCells (const unsigned int nmbCells  ) { _nmbCells       = nmbCells;   }  ///< sets number of cells of new tables
+		static void setTolerance(const double       tolerance ) { _tolerance      = tolerance;  }  ///< sets maximum interpolation error of new tables relative to maximum absolute value of amplitude in the cell
+
+		static bool debug() { return _debug; }                             ///< returns debug flag
+		static void setDebug(const bool debug = true) { _debug = debug; }  ///< sets debug flag
+
+
+	private:
+
+		double cellMass(const unsigned int cell,
+		                const double       t) const;  ///< returns mass at position t in [-1, 1] within given cell
+
+		std::complex<double> chebyshevSum(const unsigned int cell,
+		                                  const double       t) const;  ///< evaluates interpolating polynomial of given cell at position t in [-1, 1]
+
+		std::string                        _key;
+		double                             _mMin;
+		double                             _mMax;
+		double                             _cellWidth;
+		std::vector<std::complex<double> > _coefficients;  ///< Chebyshev coefficients of all cells, i.e. [cell * nmbNodes + order]
+		std::vector<char>                  _cellValid;
+		double                             _maxAbsAmp;
+		double                             _maxRelativeError;
+
+		static std::map<std::string, massDependenceTableConstPtr> _tables;  ///< tables built so far indexed by key
+
+		static double       _lowerMassBound;
+		static double       _upperMassBound;
+		static unsigned int _nmbCells;
+		static double       _tolerance;
+
+		static const unsigned int N_NODES;
+
+		static bool _debug;  ///< if set to true, debug messages are printed
+
+	};
+
+
+}  // namespace rpwa
+
+
+#endif  // MASSDEPENDENCETABLE_H
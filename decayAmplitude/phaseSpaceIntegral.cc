@@ -1,3 +1,11 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+#include <unistd.h>
+
 #include <boost/algorithm/string.hpp>
 
 #include <TClonesArray.h>
@@ -5,6 +13,7 @@
 #include <TF1.h>
 #include <TFile.h>
 #include <TGraphErrors.h>
+#include <TNamed.h>
 #include <TObjString.h>
 #include <TTree.h>
 
@@ -15,6 +24,7 @@
 #include "phaseSpaceIntegral.h"
 #include "physUtils.hpp"
 #include "progress_display.hpp"
+#include "threadUtils.hpp"
 #include "waveDescription.h"
 
 
@@ -24,6 +34,18 @@ using namespace rpwa;
 
 phaseSpaceIntegral* phaseSpaceIntegral::_instance = 0;
 
+
+namespace {
+
+	// serializes additions to the maps of phaseSpaceIntegral and to the
+	// integral tables, which happen when the amplitudes are evaluated by
+	// several threads; recursive, because the calculation of a new table
+	// evaluates the amplitudes of the sub-decay, which may look up
+	// further tables in the same thread
+	recursive_mutex integralTableMutex;
+
+}
+
 phaseSpaceIntegral* phaseSpaceIntegral::instance()
 {
 	if(not _instance) {
@@ -36,16 +58,27 @@ phaseSpaceIntegral* phaseSpaceIntegral::instance()
 
 complex<double> phaseSpaceIntegral::operator()(const isobarDecayVertex& vertex) {
 
-	map<const isobarDecayVertex*, string>::iterator name_it = _vertexToSubwaveName.find(&vertex);
+	// the vertices and tables are usually added before the amplitudes are
+	// evaluated in parallel, see isobarAmplitude::initThreadAmps(); the
+	// lookup therefore only uses find(), entries are added under a lock
+	map<const isobarDecayVertex*, string>::const_iterator name_it = _vertexToSubwaveName.find(&vertex);
 	if(name_it == _vertexToSubwaveName.end()) {
-		string waveName = integralTableContainer::getSubWaveNameFromVertex(vertex);
-		_vertexToSubwaveName[&vertex] = waveName;
+		lock_guard<recursive_mutex> lock(integralTableMutex);
+		name_it = _vertexToSubwaveName.find(&vertex);
+		if(name_it == _vertexToSubwaveName.end()) {
+			const string waveName = integralTableContainer::getSubWaveNameFromVertex(vertex);
+			name_it = _vertexToSubwaveName.insert(make_pair(&vertex, waveName)).first;
+		}
 	}
-	const string& waveName = _vertexToSubwaveName[&vertex];
+	const string& waveName = name_it->second;
 	map<string, integralTableContainer>::iterator cont_it = _subwaveNameToIntegral.find(waveName);
 	if(cont_it == _subwaveNameToIntegral.end()) {
-		printInfo << "adding new integralTableContainer for waveName=\"" << waveName << "\"." << endl;
-		_subwaveNameToIntegral[waveName] = integralTableContainer(vertex);
+		lock_guard<recursive_mutex> lock(integralTableMutex);
+		cont_it = _subwaveNameToIntegral.find(waveName);
+		if(cont_it == _subwaveNameToIntegral.end()) {
+			printInfo << "adding new integralTableContainer for waveName=\"" << waveName << "\"." << endl;
+			cont_it = _subwaveNameToIntegral.insert(make_pair(waveName, integralTableContainer(vertex))).first;
+		}
 	}
 
 	// get Breit-Wigner parameters
@@ -54,12 +87,13 @@ complex<double> phaseSpaceIntegral::operator()(const isobarDecayVertex& vertex)
 	const double       M0     = parent->mass();                  // resonance peak position
 	const double       Gamma0 = parent->width();                 // resonance peak width
 
-	return _subwaveNameToIntegral[waveName](M, M0, Gamma0);
+	return cont_it->second(M, M0, Gamma0);
 
 }
 
 
 void phaseSpaceIntegral::removeVertex(const isobarDecayVertex* vertex) {
+	lock_guard<recursive_mutex> lock(integralTableMutex);
 	map<const isobarDecayVertex*, string>::iterator name_it = _vertexToSubwaveName.find(vertex);
 	if(name_it != _vertexToSubwaveName.end()) {
 		_vertexToSubwaveName.erase(name_it);
@@ -94,15 +128,85 @@ namespace {
 			return name;
 		}
 	}
+
+
+	// finalizer of the SplitMix64 generator by S. Vigna; mixes the bits
+	// of x, so that close inputs give unrelated outputs
+	uint64_t
+	splitMix64(uint64_t x)
+	{
+		x += 0x9E3779B97F4A7C15ULL;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+		return x ^ (x >> 31);
+	}
+
+
+	// seed of the random number stream of the phase-space events; it
+	// depends only on the parent mass, the events are identified by their
+	// index in the stream, so that the integrals do not depend on the
+	// number of threads; the seed is calculated from the bit pattern of
+	// the mass without library hash functions, so that it is the same
+	// for all library versions and machines
+	uint64_t
+	massSeed(const int    seed,
+	         const double M)
+	{
+		uint64_t massBits;
+		memcpy(&massBits, &M, sizeof(massBits));
+		return splitMix64(splitMix64((uint64_t)(uint32_t)seed) ^ massBits);
+	}
+
+
+	// number, mean, and sum of squared deviations from the mean of a set
+	// of samples; sets are combined using the pairwise update formula
+	// by Chan et al.
+	struct sampleMoments {
+
+		sampleMoments() : n(0.), mean(0.), sumSqDev(0.) { }
+
+		void add(const double x)
+		{
+			n += 1.;
+			const double delta = x - mean;
+			mean     += delta / n;
+			sumSqDev += delta * (x - mean);
+		}
+
+		void add(const sampleMoments& other)
+		{
+			if (other.n == 0.)
+				return;
+			const double nSum  = n + other.n;
+			const double delta = other.mean - mean;
+			mean     += delta * (other.n / nSum);
+			sumSqDev += other.sumSqDev + delta * delta * (n * other.n / nSum);
+			n         = nSum;
+		}
+
+		double n;
+		double mean;
+		double sumSqDev;
+
+	};
+
 }
 
 
 string integralTableContainer::_directory = "";
 double integralTableContainer::_upperBound = 0.;
+unsigned int integralTableContainer::_nmbThreads = 1;
 const string integralTableContainer::TREE_NAME = "psint";
+// has to be changed whenever the phase-space events for a given seed change,
+// so that points calculated with other events are not added to existing tables
+const string integralTableContainer::GENERATOR_NAME = "nBodyPhaseSpaceGenerator::generateDecays/Philox4x32-10/SplitMix64";
 const int integralTableContainer::N_POINTS = 50;
 const int integralTableContainer::N_MC_EVENTS = 1000000;
 const int integralTableContainer::N_MC_EVENTS_FOR_M0 = 10000000;
+const int integralTableContainer::N_MC_EVENTS_PER_STREAM = 100000;
+const int integralTableContainer::N_MAX_REFINEMENT_POINTS = 50;
+const int integralTableContainer::N_REFINEMENT_STEPS = 3;
+const double integralTableContainer::REFINEMENT_N_SIGMA = 3.;
 const int integralTableContainer::MC_SEED = 987654321;
 const bool integralTableContainer::CALCULATE_ERRORS = true;
 
@@ -150,7 +254,8 @@ string integralTableContainer::getSubWaveNameFromVertex(const isobarDecayVertex&
 
 
 integralTableContainer::integralTableContainer(const isobarDecayVertex& vertex)
-: _init(true)
+: _otherGenerator(false),
+  _init(true)
 {
 
 	_subWaveName = getSubWaveNameFromVertex(vertex, _vertex, _subDecay);
@@ -199,25 +304,36 @@ double integralTableContainer::dyn(double M, double M0) {
 double integralTableContainer::interpolate(const double& M) const
 {
 
-	double currentM = _integralTable[0].M;
-	double psInt = _integralTable[0].integralValue;
-	double lastM = currentM;
-	double lastPsInt = psInt;
-	for(unsigned int i = 1; i < _integralTable.size(); ++i) {
-		currentM = _integralTable[i].M;
-		psInt = _integralTable[i].integralValue;
-		if((lastM <= M) and (M < currentM)) {
-			break;
-		}
-		lastM = currentM;
-		lastPsInt = psInt;
-	}
-	return (lastPsInt + (((psInt - lastPsInt) / (currentM - lastM)) * (M - lastM)));
+	// find the first point above M by bisection; masses outside of the
+	// table are extrapolated from the first or the last interval; the
+	// table has at least two points, see readIntegralFile()
+	const vector<integralTablePoint>::const_iterator current
+		= upper_bound(_integralTable.begin() + 1, _integralTable.end() - 1, M,
+		              [](const double& mass, const integralTablePoint& point) { return mass < point.M; });
+	const integralTablePoint& last = *(current - 1);
+	return (last.integralValue + (((current->integralValue - last.integralValue) / (current->M - last.M)) * (M - last.M)));
 
 }
 
 
 double integralTableContainer::getInt0(const double& M0) {
+	// points are added to the table under a lock; as for the maps of
+	// phaseSpaceIntegral, usually all M0 are known before the amplitudes
+	// are evaluated in parallel
+	for(unsigned int i = 0; i < _M0s.size(); ++i) {
+		if(fabs(_M0s[i] - M0) < 1e-10) {
+			if(_otherGenerator) {
+				return interpolate(M0);
+			}
+			for(unsigned int j = 0; j < _integralTable.size(); ++j) {
+				if(fabs(_integralTable[j].M - M0) < 1e-10) {
+					return interpolate(M0);
+				}
+			}
+			break;
+		}
+	}
+	lock_guard<recursive_mutex> lock(integralTableMutex);
 	bool found = false;
 	for(unsigned int i = 0; i < _M0s.size(); ++i) {
 		if(fabs(_M0s[i] - M0) < 1e-10) {
@@ -233,9 +349,19 @@ double integralTableContainer::getInt0(const double& M0) {
 			return interpolate(M0);
 		}
 	}
+	// points calculated with the current generator are not mixed into
+	// tables calculated with another one, and such files are never
+	// rewritten
+	if(_otherGenerator) {
+		if(not found) {
+			printWarn << "integral table in file '" << _fullPathToFile << "' was calculated with phase-space events "
+			          << "from a different generator. not adding new value for M0=" << M0 << ", interpolating instead." << endl;
+		}
+		return interpolate(M0);
+	}
 	printInfo << "adding new value for M0=" << M0 << " to integral table." << endl;
 	addToIntegralTable(evalInt(M0, N_MC_EVENTS_FOR_M0));
-	writeIntegralTableToDisk(true);
+	writeIntegralTableToDisk();
 	return getInt0(M0);
 }
 
@@ -269,52 +395,79 @@ integralTablePoint integralTableContainer::evalInt(const double& M, const unsign
 	subAmp.enableReflectivityBasis(false);
 	subAmp.init();
 
-	// create phase-space generator and set some options
-	// currently those are in any case the default values, but just to be safe
+	// the events are generated in streams of fixed size, which are
+	// distributed over the threads, each of which uses its own copy of
+	// the amplitude; the phase-space generator does not change its state
+	// when generating blocks of events and is shared by all threads
 	nBodyPhaseSpaceGenerator psGen;
+	// currently those are in any case the default values, but just to be safe
 	psGen.setKinematicsType(rpwa::nBodyPhaseSpaceKinematics::BLOCK);
 	psGen.setWeightType(rpwa::nBodyPhaseSpaceKinematics::S_U_CHUNG);
-
 	psGen.setDecay(daughterMasses);
+	const uint64_t       seed              = massSeed(MC_SEED, M);
+	const unsigned int   nmbEventsPerBlock = 10000;
 	const TLorentzVector parent(0., 0., 0., M);
-
-	double integral = 0.;
-	vector<double> samples;
-	if(CALCULATE_ERRORS) {
-		samples.resize(nEvents, 0.);
+	const unsigned int nmbStreams = (nEvents + N_MC_EVENTS_PER_STREAM - 1) / N_MC_EVENTS_PER_STREAM;
+	unsigned int nmbStreamThreads = min(nmbThreadsToUse(_nmbThreads), nmbStreams);
+	if(nmbStreamThreads > 1) {
+		// fill caches with an event that is not used for the integral
+		nBodyPhaseSpaceEventBlock events;
+		psGen.generateDecays(parent, 1, events, seed, nEvents);
+		TClonesArray prodKinMom("TVector3", 1);
+		TClonesArray decayKinMom("TVector3", nmbFsParticles);
+		new (prodKinMom[0]) TVector3(parent.Vect());
+		for(unsigned int j = 0; j < nmbFsParticles; ++j) {
+			new (decayKinMom[j]) TVector3(events.daughter(j, 0).Vect());
+		}
+		if(not subAmp.initThreadAmps(nmbStreamThreads - 1, prodKinMom, decayKinMom)) {
+			nmbStreamThreads = 1;
+		}
 	}
 
+	vector<sampleMoments> streamMoments(nmbStreams);
 	progress_display progressIndicator(nEvents, cout, "");
-	for(unsigned int i = 0; i < nEvents; ++i) {
-		const double weight = psGen.generateDecay(parent);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbStreamThreads) schedule(dynamic, 1)
+#endif
+	for(unsigned int iStream = 0; iStream < nmbStreams; ++iStream) {
+		const isobarAmplitude& amp = subAmp.threadAmp(threadIndex());
+
+		nBodyPhaseSpaceEventBlock events;
 		TClonesArray prodKinMom("TVector3", 1);
 		TClonesArray decayKinMom("TVector3", nmbFsParticles);
-		for(unsigned int j = 0; j < nmbFsParticles; ++j) {
-			const TLorentzVector& daughter = psGen.daughter(j);
-			new (decayKinMom[j]) TVector3(daughter.Vect());
-		}
-		new (prodKinMom[0]) TVector3(parent.Vect());
-		subAmp.decayTopology()->readKinematicsData(prodKinMom, decayKinMom);
-		const double ampVal = norm(subAmp());
-		const double sample = ampVal * weight;
-		integral += sample;
-		if(CALCULATE_ERRORS) {
-			samples[i] = sample;
+		const unsigned int evtBegin = iStream * N_MC_EVENTS_PER_STREAM;
+		const unsigned int evtEnd = min(nEvents, evtBegin + N_MC_EVENTS_PER_STREAM);
+		for(unsigned int blockBegin = evtBegin; blockBegin < evtEnd; blockBegin += nmbEventsPerBlock) {
+			psGen.generateDecays(parent, min(nmbEventsPerBlock, evtEnd - blockBegin), events, seed, blockBegin);
+			for(size_t i = 0; i < events.nmbEvents; ++i) {
+				for(unsigned int j = 0; j < nmbFsParticles; ++j) {
+					const size_t index = j * events.nmbEvents + i;
+					new (decayKinMom[j]) TVector3(events.px[index], events.py[index], events.pz[index]);
+				}
+				new (prodKinMom[0]) TVector3(parent.Vect());
+				amp.decayTopology()->readKinematicsData(prodKinMom, decayKinMom);
+				const double ampVal = norm(amp());
+				streamMoments[iStream].add(ampVal * events.weights[i]);
+			}
 		}
-		++progressIndicator;
+#ifdef _OPENMP
+#pragma omp critical(integralTableContainerProgress)
+#endif
+		progressIndicator += evtEnd - evtBegin;
 	}
 
 	_vertex->setMassDependence(originalMassDep);
-	integral /= (double)nEvents;
+
+	// combine streams in fixed order
+	sampleMoments moments;
+	for(unsigned int iStream = 0; iStream < nmbStreams; ++iStream) {
+		moments.add(streamMoments[iStream]);
+	}
+	const double integral = moments.mean;
 
 	double error = 0.;
 	if(CALCULATE_ERRORS) {
-		double sig2 = 0.;
-		for(unsigned int i = 0; i < nEvents; ++i) {
-			double diff = samples[i] - integral;
-			sig2 += diff * diff;
-		}
-		sig2 /= (nEvents - 1);
+		const double sig2 = moments.sumSqDev / (nEvents - 1);
 		error = sqrt(sig2 / nEvents);
 	}
 
@@ -329,9 +482,22 @@ void integralTableContainer::readIntegralFile() {
 
 	TDirectory* pwd = gDirectory;
 	TFile* integralTableFile = TFile::Open(_fullPathToFile.c_str(), "READ");
+	if(integralTableFile) {
+		// tables from files without generator information were calculated
+		// before the generator was stored; they are used as they are, so
+		// that existing analyses give the same amplitudes
+		const TNamed* generator = dynamic_cast<const TNamed*>(integralTableFile->Get("generator"));
+		if(not generator or GENERATOR_NAME != generator->GetTitle()) {
+			printWarn << "integral table in file '" << _fullPathToFile << "' was calculated with "
+			          << "phase-space events from a different generator. using it as it is, "
+			          << "but no points will be added to it." << endl;
+			_otherGenerator = true;
+		}
+	}
 	if(not integralTableFile) {
 		printInfo << "no file '" << _fullPathToFile << "' with integral table found. Creating it..." << endl;
 		fillIntegralTable();
+		refineIntegralTable();
 		writeIntegralTableToDisk();
 		printInfo << "created integral file '" << _fullPathToFile << "." << endl;
 		integralTableFile = TFile::Open(_fullPathToFile.c_str(), "READ");
@@ -339,6 +505,10 @@ void integralTableContainer::readIntegralFile() {
 		printInfo << "reading integral table from file '" << _fullPathToFile << "'." << endl;
 	}
 	TTree* tree = (TTree*)integralTableFile->Get(TREE_NAME.c_str());
+	if(not tree) {
+		printErr << "could not find tree '" << TREE_NAME << "' in integral file '" << _fullPathToFile << "'. Aborting..." << endl;
+		throw;
+	}
 	double M, psInt, psIntErr;
 	tree->SetBranchAddress("M", &M);
 	tree->SetBranchAddress("int", &psInt);
@@ -351,22 +521,36 @@ void integralTableContainer::readIntegralFile() {
 		_integralTable[i].integralError = psIntErr;
 	}
 	pwd->cd();
+	// the interpolation needs at least one interval
+	if(_integralTable.size() < 2) {
+		printErr << "integral table in file '" << _fullPathToFile << "' has " << _integralTable.size()
+		         << " point(s), but at least 2 are needed. Aborting..." << endl;
+		throw;
+	}
 
 }
 
 
-void integralTableContainer::writeIntegralTableToDisk(bool overwriteFile) const {
+void integralTableContainer::writeIntegralTableToDisk() const {
 
+	// several processes might create the same integral file at the same
+	// time; the file is written under a temporary name and then renamed,
+	// so that readers never see an incomplete file; since the integrals
+	// are calculated with fixed random seeds, all processes write the same
+	// table
+	stringstream tmpFileName;
+	tmpFileName << _fullPathToFile << ".tmp" << getpid();
 	TDirectory* pwd = gDirectory;
-	TFile* integralFile = 0;
-	if(overwriteFile) {
-		integralFile = TFile::Open(_fullPathToFile.c_str(), "RECREATE");
-	} else {
-		integralFile = TFile::Open(_fullPathToFile.c_str(), "NEW");
+	TFile* integralFile = TFile::Open(tmpFileName.str().c_str(), "RECREATE");
+	if(not integralFile or integralFile->IsZombie()) {
+		printErr << "could not open temporary integral file '" << tmpFileName.str() << "' for writing. Aborting..." << endl;
+		throw;
 	}
 	integralFile->cd();
 	TObjString filenameForRoot(_subWaveName.c_str());
 	filenameForRoot.Write();
+	TNamed generator("generator", GENERATOR_NAME.c_str());
+	generator.Write();
 	TTree* outTree = new TTree(TREE_NAME.c_str(), TREE_NAME.c_str());
 	double M, psInt, psIntErr;
 	outTree->Branch("M", &M);
@@ -422,6 +606,11 @@ void integralTableContainer::writeIntegralTableToDisk(bool overwriteFile) const
 	outTree->Write();
 	integralFile->Close();
 	pwd->cd();
+	if(rename(tmpFileName.str().c_str(), _fullPathToFile.c_str()) != 0) {
+		printErr << "could not rename '" << tmpFileName.str() << "' to '" << _fullPathToFile << "'. Aborting..." << endl;
+		remove(tmpFileName.str().c_str());
+		throw;
+	}
 
 }
 
@@ -457,6 +646,11 @@ void integralTableContainer::fillIntegralTable() {
         }
 		_integralTable.push_back(evalInt(M, N_MC_EVENTS));
 	}
+	if(_integralTable.size() < 2) {
+		printErr << "integral table for " << _subWaveName << " has only " << _integralTable.size() << " point(s), "
+		         << "the upper mass bound (" << _upperBound << ") is probably below the threshold. Aborting..." << endl;
+		throw;
+	}
 
 }
 
@@ -482,3 +676,53 @@ void integralTableContainer::addToIntegralTable(const integralTablePoint& newPoi
 	_integralTable = newIntegralTable;
 
 }
+
+
+void integralTableContainer::refineIntegralTable() {
+
+	// adds points in the middle of the intervals in which the linear
+	// interpolation between the neighboring points deviates significantly
+	// from the calculated integral, i.e. where the curvature is resolved by
+	// the Monte Carlo precision; the intervals with the largest deviations
+	// are refined first
+	int nmbAddedPoints = 0;
+	for(int iStep = 0; iStep < N_REFINEMENT_STEPS and nmbAddedPoints < N_MAX_REFINEMENT_POINTS; ++iStep) {
+		vector<pair<double, double> > candidates;  // (significance, mass)
+		for(unsigned int i = 1; i + 1 < _integralTable.size(); ++i) {
+			const integralTablePoint& last = _integralTable[i-1];
+			const integralTablePoint& current = _integralTable[i];
+			const integralTablePoint& next = _integralTable[i+1];
+			if((current.M - last.M <= 0.) or (next.M - current.M <= 0.)) {
+				continue;
+			}
+			const double t = (current.M - last.M) / (next.M - last.M);
+			const double deviation = fabs(current.integralValue - ((1. - t) * last.integralValue + t * next.integralValue));
+			const double error = sqrt(current.integralError * current.integralError
+			                          + (1. - t) * (1. - t) * last.integralError * last.integralError
+			                          + t * t * next.integralError * next.integralError);
+			if(deviation <= REFINEMENT_N_SIGMA * error or deviation == 0.) {
+				continue;
+			}
+			const double significance = (error > 0.) ? deviation / error : numeric_limits<double>::max();
+			candidates.push_back(make_pair(significance, 0.5 * (last.M + current.M)));
+			candidates.push_back(make_pair(significance, 0.5 * (current.M + next.M)));
+		}
+		if(candidates.empty()) {
+			break;
+		}
+		stable_sort(candidates.begin(), candidates.end(), [](const pair<double, double>& a, const pair<double, double>& b) { return a.first > b.first; });
+		vector<double> newMs;
+		for(unsigned int i = 0; i < candidates.size() and nmbAddedPoints + (int)newMs.size() < N_MAX_REFINEMENT_POINTS; ++i) {
+			if(find(newMs.begin(), newMs.end(), candidates[i].second) == newMs.end()) {
+				newMs.push_back(candidates[i].second);
+			}
+		}
+		sort(newMs.begin(), newMs.end());
+		printInfo << "refining integral table for " << _subWaveName << " with " << newMs.size() << " new points." << endl;
+		for(unsigned int i = 0; i < newMs.size(); ++i) {
+			addToIntegralTable(evalInt(newMs[i], N_MC_EVENTS));
+		}
+		nmbAddedPoints += newMs.size();
+	}
+
+}
@@ -31,7 +31,7 @@ namespace rpwa {
 
 	  public:
 
-		integralTableContainer() : _init(false) { }
+		integralTableContainer() : _otherGenerator(false), _init(false) { }
 		integralTableContainer(const isobarDecayVertex& vertex);
 		~integralTableContainer() { }
 
@@ -48,6 +48,9 @@ namespace rpwa {
 		static const double& upperMassBound() { return _upperBound; }
 		static void setUpperMassBound(const double& upperBound) { _upperBound = upperBound; }
 
+		static unsigned int nmbThreads() { return _nmbThreads; }
+		static void setNmbThreads(const unsigned int nmbThreads) { _nmbThreads = nmbThreads; }  ///< sets number of threads used to calculate new integral table points; 0 uses all available threads; the integrals do not depend on the number of threads
+
 	  private:
 
 		double dyn(double M, double M0);
@@ -55,10 +58,11 @@ namespace rpwa {
 		double getInt0(const double& M0);
 
 		void fillIntegralTable();
+		void refineIntegralTable();
 		void addToIntegralTable(const integralTablePoint& newPoint);
 
 		void readIntegralFile();
-		void writeIntegralTableToDisk(bool overwriteFile = false) const;
+		void writeIntegralTableToDisk() const;
 
 		integralTablePoint evalInt(const double& M, const unsigned int& nEvents) const;
 
@@ -70,19 +74,26 @@ namespace rpwa {
 		std::string _fullPathToFile;
 		isobarDecayTopologyPtr _subDecay;
 
+		bool _otherGenerator;  // table was read from a file calculated with another generator of the phase-space events
 		bool _init;
 
 		static std::string _directory;
 		static double _upperBound;
+		static unsigned int _nmbThreads;
 
 		const static int N_POINTS;
 		const static int N_MC_EVENTS;
 		const static int N_MC_EVENTS_FOR_M0;
+		const static int N_MC_EVENTS_PER_STREAM;
+		const static int N_MAX_REFINEMENT_POINTS;
+		const static int N_REFINEMENT_STEPS;
+		const static double REFINEMENT_N_SIGMA;
 		const static int MC_SEED;
 		const static bool NEW_FILENAME_CONVENTION;
 		const static bool CALCULATE_ERRORS;
 
 		const static std::string TREE_NAME;
+		const static std::string GENERATOR_NAME;  // identifies the generator of the phase-space events, which is stored in the integral files
 
 	};
 
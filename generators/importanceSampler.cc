@@ -48,6 +48,7 @@
 #include"multibinTypes.h"
 #include"nBodyPhaseSpaceKinematics.h"
 #include"randomNumberGenerator.h"
+#include"threadUtils.hpp"
 
 
 rpwa::importanceSampler::importanceSampler(rpwa::modelIntensityPtr         model,
@@ -58,6 +59,7 @@ rpwa::importanceSampler::importanceSampler(rpwa::modelIntensityPtr         model
                                            const rpwa::FinalState&         finalState)
 	: BCModel("phaseSpaceImportanceSampling"),
 	  _model(model),
+	  _modelReentrant(false),
 	  _beamAndVertexGenerator(beamAndVertexGenerator),
 	  _massAndTPrimePicker(massAndTPrimePicker),
 	  _beam(beam),
@@ -65,7 +67,9 @@ rpwa::importanceSampler::importanceSampler(rpwa::modelIntensityPtr         model
 	  _finalState(finalState),
 	  _nPart(_finalState.particles.size()),
 	  _phaseSpaceOnly(false),
-	  _massPrior(0)
+	  _massPrior(0),
+	  _storeMassAndTPrime(false),
+	  _eventBufferSize(1000)
 {
 	std::vector<std::string> decayKinParticleNames(_nPart);
 	_masses.resize(_nPart);
@@ -148,6 +152,32 @@ rpwa::importanceSampler::importanceSampler(rpwa::modelIntensityPtr         model
 		}
 	}
 
+	// create copies of the decay amplitudes for the threads running the
+	// Markov chains, so that the model can be evaluated concurrently. the
+	// caches of the copies are filled with an arbitrary event at the
+	// largest X mass
+	std::vector<double> parameters(3*(_nPart-1));
+	double mSumPart = _masses[0];
+	for (size_t part = 1; part < _nPart; ++part) {
+		mSumPart += _masses[part];
+		parameters[3*part-3] = mSumPart + (mMax - _mSum) * part / (_nPart-1);
+		parameters[3*part-2] = 0.5;
+		parameters[3*part-1] = 1.;
+	}
+	rpwa::nBodyPhaseSpaceKinematics nBodyPhaseSpace;
+	if (rpwa::maxNmbThreads() > 1 and initializeNBodyPhaseSpace(nBodyPhaseSpace, parameters, true)) {
+		nBodyPhaseSpace.calcBreakupMomenta();
+		nBodyPhaseSpace.calcEventKinematics(TLorentzVector(0., 0., 0., parameters[3*_nPart-6]));
+		std::vector<TVector3> decayKinMomenta(_nPart);
+		for (size_t part = 0; part < _nPart; ++part) {
+			decayKinMomenta[part] = nBodyPhaseSpace.daughter(part).Vect();
+		}
+		_modelReentrant = _model->initThreads(rpwa::maxNmbThreads(), decayKinMomenta);
+	}
+	if (rpwa::maxNmbThreads() > 1 and not _modelReentrant) {
+		printWarn << "model cannot be evaluated concurrently. evaluation of model will be serialized." << std::endl;
+	}
+
 	resetFuncInfo();
 	BCAux::SetStyle();
 }
@@ -217,12 +247,19 @@ rpwa::importanceSampler::LogLikelihood(const std::vector<double>& parameters)
 		decayKinMomenta[part] = nBodyPhaseSpace.daughter(part).Vect();
 	}
 
+	// threads without their own copies of the decay amplitudes share the
+	// original ones with the first thread and have to be serialized
 	double intensity;
+	const unsigned int threadIndex = rpwa::threadIndex();
+	if (_modelReentrant and threadIndex > 0 and threadIndex < _model->nmbThreads()) {
+		intensity = _model->getIntensity(decayKinMomenta);
+	} else {
 #ifdef _OPENMP
 #pragma omp critical(model)
 #endif
-	{
-		intensity = _model->getIntensity(decayKinMomenta);
+		{
+			intensity = _model->getIntensity(decayKinMomenta);
+		}
 	}
 
 	timerTot.Stop();
@@ -310,11 +347,25 @@ rpwa::importanceSampler::CalculateObservables(const std::vector<double>& paramet
 			additionalVars.push_back(tPrime);
 		}
 		std::vector<TVector3> prodKinMomenta(1, pBeam.Vect());
+
+		// the file writer is only accessed once the buffer of this thread is
+		// full, threads without their own buffer write their events directly
+		const unsigned int threadIndex = rpwa::threadIndex();
+		if (threadIndex < _eventBuffers.size()) {
+			eventBuffer& buffer = _eventBuffers[threadIndex];
+			buffer.prodKinMomenta.push_back(prodKinMomenta);
+			buffer.decayKinMomenta.push_back(decayKinMomenta);
+			buffer.additionalVars.push_back(additionalVars);
+			if (buffer.prodKinMomenta.size() >= _eventBufferSize) {
+				flushEventBuffer(buffer);
+			}
+		} else {
 #ifdef _OPENMP
 #pragma omp critical(fileWriter)
 #endif
-		{
-			_fileWriter.addEvent(prodKinMomenta, decayKinMomenta, additionalVars);
+			{
+				_fileWriter.addEvent(prodKinMomenta, decayKinMomenta, additionalVars);
+			}
 		}
 	}
 
@@ -351,6 +402,13 @@ rpwa::importanceSampler::initializeFileWriter(TFile*             outFile,
 		additionalVarLabels.push_back(tPrimeVariableName);
 	}
 
+	_eventBuffers.assign(rpwa::maxNmbThreads(), eventBuffer());
+	for (size_t i = 0; i < _eventBuffers.size(); ++i) {
+		_eventBuffers[i].prodKinMomenta.reserve (_eventBufferSize);
+		_eventBuffers[i].decayKinMomenta.reserve(_eventBufferSize);
+		_eventBuffers[i].additionalVars.reserve (_eventBufferSize);
+	}
+
 	const bool valid = _fileWriter.initialize(*outFile,
 	                                          auxString,
 	                                          rpwa::eventMetadata::REAL,
@@ -366,10 +424,32 @@ rpwa::importanceSampler::initializeFileWriter(TFile*             outFile,
 bool
 rpwa::importanceSampler::finalizeFileWriter()
 {
+	for (size_t i = 0; i < _eventBuffers.size(); ++i) {
+		flushEventBuffer(_eventBuffers[i]);
+	}
+	_eventBuffers.clear();
+
 	return _fileWriter.finalize();
 }
 
 
+void
+rpwa::importanceSampler::flushEventBuffer(eventBuffer& buffer)
+{
+#ifdef _OPENMP
+#pragma omp critical(fileWriter)
+#endif
+	{
+		for (size_t i = 0; i < buffer.prodKinMomenta.size(); ++i) {
+			_fileWriter.addEvent(buffer.prodKinMomenta[i], buffer.decayKinMomenta[i], buffer.additionalVars[i]);
+		}
+	}
+	buffer.prodKinMomenta.clear();
+	buffer.decayKinMomenta.clear();
+	buffer.additionalVars.clear();
+}
+
+
 boost::tuples::tuple<bool, double, TLorentzVector, TLorentzVector>
 rpwa::importanceSampler::getProductionKinematics(const double xMass) const
 {
@@ -57,7 +57,18 @@ namespace rpwa {
 		                               const std::vector<double>&       parameters,
 		                               const bool                       angles = true) const;
 
+		// events of each thread are collected in a separate buffer, which
+		// is only passed to the file writer once it is full
+		struct eventBuffer {
+			std::vector<std::vector<TVector3> > prodKinMomenta;
+			std::vector<std::vector<TVector3> > decayKinMomenta;
+			std::vector<std::vector<double> >   additionalVars;
+		};
+
+		void flushEventBuffer(eventBuffer& buffer);
+
 		rpwa::modelIntensityPtr         _model;
+		bool                            _modelReentrant;
 
 		rpwa::beamAndVertexGeneratorPtr _beamAndVertexGenerator;
 		rpwa::massAndTPrimePickerPtr    _massAndTPrimePicker;
@@ -73,6 +84,8 @@ namespace rpwa {
 
 		rpwa::eventFileWriter           _fileWriter;
 		bool                            _storeMassAndTPrime;
+		std::vector<eventBuffer>        _eventBuffers;
+		size_t                          _eventBufferSize;
 
 
 		// function call statistics (copied from pwaLikelihood)
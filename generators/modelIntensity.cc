@@ -1,5 +1,9 @@
 #include"modelIntensity.h"
+
+#include<TClonesArray.h>
+
 #include"ampIntegralMatrix.h"
+#include"threadUtils.hpp"
 #include"waveDescription.h"
 
 
@@ -10,7 +14,8 @@ rpwa::modelIntensity::modelIntensity(fitResultPtr fitResult)
 	  _refls(fitResult->nmbWaves(), 0),
 	  _phaseSpaceIntegralsLoaded(false),
 	  _phaseSpaceIntegrals(fitResult->nmbWaves()),
-	  _decayAmplitudesFromXDecay(false)
+	  _decayAmplitudesFromXDecay(false),
+	  _nmbThreads(1)
 {
 	// use the phase-space integrals from fit result if available
 	if (fitResult->phaseSpaceIntegralVector().size() == fitResult->nmbWaves()) {
@@ -37,6 +42,7 @@ rpwa::modelIntensity::addDecayAmplitude(rpwa::isobarAmplitudePtr decayAmplitude)
 	}
 
 	_decayAmplitudesInitialized = false;
+	_nmbThreads                 = 1;
 	_decayAmplitudes[waveIndex] = decayAmplitude;
 	_refls          [waveIndex] = decayAmplitude->decayTopology()->XIsobarDecayVertex()->parent()->reflectivity();
 	_allRefls.insert(decayAmplitude->decayTopology()->XIsobarDecayVertex()->parent()->reflectivity());
@@ -122,6 +128,8 @@ rpwa::modelIntensity::initDecayAmplitudes(T&                              prodKi
 {
 	_decayAmplitudesInitialized = false;
 	_decayAmplitudesFromXDecay  = fromXDecay;
+	// the copies of the decay amplitudes are reset by 'init'
+	_nmbThreads                 = 1;
 
 	//initialize the decay amplitudes
 	for (size_t wave = 0; wave < _fitResult->nmbWaves(); ++wave) {
@@ -166,6 +174,45 @@ rpwa::modelIntensity::initDecayAmplitudes(T&                              prodKi
 }
 
 
+bool
+rpwa::modelIntensity::initThreads(const unsigned int           nmbThreads,
+                                  const std::vector<TVector3>& prodKinMomenta,
+                                  const std::vector<TVector3>& decayKinMomenta)
+{
+	_nmbThreads = 1;
+	if (not _decayAmplitudesInitialized) {
+		printWarn << "decay amplitudes not initialized, cannot create copies for threads." << std::endl;
+		return false;
+	}
+	if (nmbThreads <= 1) {
+		return true;
+	}
+
+	TClonesArray prodKinMomentaClonesArray("TVector3", prodKinMomenta.size());
+	for (size_t i = 0; i < prodKinMomenta.size(); ++i) {
+		new(prodKinMomentaClonesArray[i]) TVector3(prodKinMomenta[i]);
+	}
+	TClonesArray decayKinMomentaClonesArray("TVector3", decayKinMomenta.size());
+	for (size_t i = 0; i < decayKinMomenta.size(); ++i) {
+		new(decayKinMomentaClonesArray[i]) TVector3(decayKinMomenta[i]);
+	}
+
+	for (size_t wave = 0; wave < _fitResult->nmbWaves(); ++wave) {
+		// 'flat' wave
+		if (not _decayAmplitudes[wave]) {
+			continue;
+		}
+		if (not _decayAmplitudes[wave]->initThreadAmps(nmbThreads - 1, prodKinMomentaClonesArray, decayKinMomentaClonesArray)) {
+			printWarn << "could not create copies of decay amplitude for wave '" << _fitResult->waveName(wave) << "'." << std::endl;
+			return false;
+		}
+	}
+
+	_nmbThreads = nmbThreads;
+	return true;
+}
+
+
 double
 rpwa::modelIntensity::getIntensity(const std::vector<unsigned int>& waveIndices,
                                    const std::vector<TVector3>&     prodKinMomenta,
@@ -202,6 +249,10 @@ rpwa::modelIntensity::getDecayAmplitudes(const std::vector<TVector3>& prodKinMom
 		throw;
 	}
 
+	// every thread uses its own copies of the decay amplitudes, threads
+	// without copies use the original ones and have to be serialized
+	const unsigned int threadIndex = (rpwa::threadIndex() < _nmbThreads) ? rpwa::threadIndex() : 0;
+
 	std::vector<std::complex<double> > decayAmplitudes(_decayAmplitudes.size());
 	for (size_t wave = 0; wave < _fitResult->nmbWaves(); ++wave) {
 		// 'flat' wave
@@ -210,11 +261,12 @@ rpwa::modelIntensity::getDecayAmplitudes(const std::vector<TVector3>& prodKinMom
 			continue;
 		}
 
-		if (not _decayAmplitudes[wave]->decayTopology()->readKinematicsData(prodKinMomenta, decayKinMomenta)) {
+		const isobarAmplitude& decayAmplitude = _decayAmplitudes[wave]->threadAmp(threadIndex);
+		if (not decayAmplitude.decayTopology()->readKinematicsData(prodKinMomenta, decayKinMomenta)) {
 			printErr << "could not read kinematics data for wave '" << _fitResult->waveName(wave) << "'. Aborting..." << std::endl;
 			throw;
 		}
-		decayAmplitudes[wave] = _decayAmplitudes[wave]->amplitude() / _phaseSpaceIntegrals[wave];
+		decayAmplitudes[wave] = decayAmplitude.amplitude() / _phaseSpaceIntegrals[wave];
 	}
 	return decayAmplitudes;
 }
@@ -231,6 +283,7 @@ rpwa::modelIntensity::print(std::ostream& out) const
 	}
 	out << "    decay amplitudes initialized .... " << yesNo(_decayAmplitudesInitialized) << std::endl
 	    << "    integrals loaded ................ " << yesNo(_phaseSpaceIntegralsLoaded) << std::endl
-	    << "    decay amplitudes from X decay ... " << yesNo(_decayAmplitudesFromXDecay) << std::endl;
+	    << "    decay amplitudes from X decay ... " << yesNo(_decayAmplitudesFromXDecay) << std::endl
+	    << "    number of threads ............... " << _nmbThreads << std::endl;
 	return out;
 }
@@ -37,6 +37,20 @@ namespace rpwa {
 		bool initDecayAmplitudes(const std::vector<std::string>& prodKinParticleNames,
 		                         const std::vector<std::string>& decayKinParticleNames);
 
+		// create copies of the decay amplitudes, so that the intensity can
+		// be calculated concurrently by threads with an index smaller than
+		// 'nmbThreads'; the given event is used to fill all caches before
+		// the threads are started. returns false if the decay amplitudes
+		// cannot be copied, in which case calls have to be serialized
+		bool initThreads(const unsigned int           nmbThreads,
+		                 const std::vector<TVector3>& decayKinMomenta);
+
+		bool initThreads(const unsigned int           nmbThreads,
+		                 const std::vector<TVector3>& prodKinMomenta,
+		                 const std::vector<TVector3>& decayKinMomenta);
+
+		unsigned int nmbThreads() const { return _nmbThreads; }
+
 		// get intensity of all waves except flat wave
 
 		// get intensity if decay amplitudes have been initialized to start from X decay
@@ -82,6 +96,8 @@ namespace rpwa {
 
 		bool                               _decayAmplitudesFromXDecay;
 
+		unsigned int                       _nmbThreads;
+
 	};
 
 
@@ -116,6 +132,20 @@ namespace rpwa {
 	}
 
 
+	inline
+	bool
+	modelIntensity::initThreads(const unsigned int           nmbThreads,
+	                            const std::vector<TVector3>& decayKinMomenta)
+	{
+		if (not _decayAmplitudesFromXDecay) {
+			printWarn << "decay amplitudes are not starting from X decay, but no production kinematics provided." << std::endl;
+			return false;
+		}
+
+		return initThreads(nmbThreads, std::vector<TVector3>(1), decayKinMomenta);
+	}
+
+
 } // namespace rpwa
 
 
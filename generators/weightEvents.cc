@@ -59,6 +59,7 @@
 #include "partialWaveFitHelper.h"
 #include "progress_display.hpp"
 #include "reportingUtilsEnvironment.h"
+#include "threadUtils.hpp"
 
 
 using namespace std;
@@ -133,7 +134,7 @@ usage(const string& progName,
 	     << progName
 	     << " [-o output file -s -w fit-result file -n # of samples "
 	     << "-i integral file -d amplitude directory -R] "
-	     << "-m mass [-b mass bin width -t tree name -v -h]" << endl
+	     << "-m mass [-b mass bin width -t tree name -j # threads -v -h]" << endl
 	     << "    where:" << endl
 	     << "        -o file    ROOT output file (default: './genpw.root')"<< endl
 	     << "        -s         write out weights for each single wave (caution: this vastly increase the size of the output file)" << endl
@@ -144,6 +145,7 @@ usage(const string& progName,
 	     << "        -m #       central mass of mass bin [MeV/c^2]"<< endl
 	     << "        -b #       width of mass bin [MeV/c^2] (default: 60 MeV/c^2)"<< endl
 	     << "        -t name    name of tree in output file (default: rootPwaWeightTree)" << endl
+	     << "        -j #       number of threads used to calculate weights; 0 uses all available threads (default: 1)" << endl
 	     << "        -v         verbose; print debug output (default: false)" << endl
 	     << "        -h         print help" << endl
 	     << endl;
@@ -179,10 +181,11 @@ main(int    argc,
 	double         massBinCenter            = 0;                       // [MeV/c^2]
 	double         massBinWidth             = 60;                      // [MeV/c^2]
 	string         outTreeName              = "rootPwaWeightTree";
+	unsigned int   nmbThreads               = 1;
 	bool           debug                    = false;
 
 	int c;
-	while ((c = getopt(argc, argv, "o:sw:n:i:d:m:b:t:vh")) != -1) {
+	while ((c = getopt(argc, argv, "o:sw:n:i:d:m:b:t:j:vh")) != -1) {
 		switch (c) {
 		case 'o':
 			outFileName = optarg;
@@ -211,6 +214,9 @@ main(int    argc,
 		case 't':
 			outTreeName = optarg;
 			break;
+		case 'j':
+			nmbThreads = atoi(optarg);
+			break;
 		case 'v':
 			debug = true;
 			break;
@@ -431,86 +437,151 @@ main(int    argc,
 		outTree->Branch(weightName.Data(), &weightProdAmpSamples[iSample], (weightName + "/D").Data());
 	}
 
+	// all weights are stored in one row per event; the branch variables
+	// of the columns are filled from these rows
+	vector<double*> weightColumns;
+	weightColumns.push_back(&weight);
+	weightColumns.push_back(&weightPosRef);
+	weightColumns.push_back(&weightNegRef);
+	weightColumns.push_back(&weightFlat);
+	for (unsigned int iSample = 0; iSample < nmbProdAmpSamples; ++iSample)
+		weightColumns.push_back(&weightProdAmpSamples[iSample]);
+	const unsigned int firstWaveColumn = weightColumns.size();
+	if (writeSingleWaveWeights) {
+		for (unsigned int iWave = 0; iWave < nmbWaves; ++iWave)
+			weightColumns.push_back(&weightWaves[iWave]);
+		for (unsigned int iProdAmp = 0; iProdAmp < nmbProdAmps; ++iProdAmp)
+			weightColumns.push_back(&weightProdAmps[iProdAmp]);
+	}
+	const unsigned int nmbWeightColumns = weightColumns.size();
+
+	// the normalized production amplitudes are calculated once, so that
+	// the reflectivity- and rank-dependent sums of amplitudes for all
+	// samples are a sparse matrix (one entry per production amplitude)
+	// times the vector of decay amplitudes of an event
+	const double              nmbNormEvents = integral->nmbEvents();
+	vector<unsigned int>      ampSumIndex(nmbProdAmps, 0);                                      // [production amplitude index]
+	vector<bool>              contributesToAmpSum(nmbProdAmps, false);                          // [production amplitude index]
+	vector<complex<double> >  normProdAmps(nmbProdAmpSamples * nmbProdAmps);                    // [sample index][production amplitude index]
+	vector<double>            flatWeights(nmbProdAmpSamples, 0);                                // [sample index]
+	for (unsigned int iProdAmp = 0; iProdAmp < nmbProdAmps; ++iProdAmp) {
+		const string& waveName = waveNames[waveIndex[iProdAmp]];
+		if (waveName == "flat") {
+			for (unsigned int iSample = 0; iSample < nmbProdAmpSamples; ++iSample) {
+				normProdAmps[iSample * nmbProdAmps + iProdAmp] = prodAmps[iSample][iProdAmp] / sqrt(nmbNormEvents);
+				flatWeights[iSample] = norm(normProdAmps[iSample * nmbProdAmps + iProdAmp]);
+			}
+			continue;
+		}
+		const double normFactor = sqrt(integral->element(waveName, waveName).real() * nmbNormEvents);
+		for (unsigned int iSample = 0; iSample < nmbProdAmpSamples; ++iSample)
+			normProdAmps[iSample * nmbProdAmps + iProdAmp] = prodAmps[iSample][iProdAmp] / normFactor;
+		if (reflectivities[iProdAmp] == +1 or reflectivities[iProdAmp] == -1) {
+			contributesToAmpSum[iProdAmp] = true;
+			ampSumIndex[iProdAmp]         = ((reflectivities[iProdAmp] == +1) ? 0 : maxRank) + ranks[iProdAmp];
+		}
+	}
+
 	// read data from tree(s) and calculate weight for each event
 	TStopwatch timer;
 	timer.Reset();
 	timer.Start();
 
-	// loop over amplitudes and calculate weight
+	// the decay amplitudes are read for a block of events, the weights
+	// of the events in the block are calculated in parallel, and the
+	// weights are written in the order of the events
+	const unsigned long      nmbEventsPerBlock = 10000;
+	vector<complex<double> > decayAmpsBlock(nmbEventsPerBlock * nmbWaves);  // [event index][wave index]
+	vector<double>           weightsBlock  (nmbEventsPerBlock * nmbWeightColumns);  // [event index][column index]
+	const unsigned int       nmbThreadsToUse = rpwa::nmbThreadsToUse(nmbThreads);
+	printInfo << "calculating weights using " << nmbThreadsToUse << " thread" << ((nmbThreadsToUse != 1) ? "s" : "") << "." << endl;
 	progress_display progressIndicator(nmbEvents, cout, "");
-	for (unsigned long iEvent = 0; iEvent < nmbEvents; ++iEvent) {
-		++progressIndicator;
-
-		// read decay amplitudes for this event
-		vector<complex<double> > decayAmps(nmbWaves);
-			for (unsigned int iWave = 0; iWave < nmbWaves; ++iWave) {
-			if (not ampRootTrees[iWave])  // e.g. flat wave
-				decayAmps[iWave] = complex<double>(0);
-			else {
-				ampRootTrees[iWave]->GetEntry(iEvent);
-				assert(ampRootLeafs[iWave]->nmbIncohSubAmps() == 1);
-				decayAmps[iWave] = ampRootLeafs[iWave]->incohSubAmp(0);
-			}
-		}
-
-		// calculate weight for each sample of production amplitudes
-		for (unsigned int iSample = 0; iSample < nmbProdAmpSamples; ++iSample) {
-
-			vector<complex<double> > posReflAmpSums(maxRank, 0);  // positive-reflectivity amplitude sums [rank]
-			vector<complex<double> > negReflAmpSums(maxRank, 0);  // negative-reflectivity amplitude sums [rank]
-			complex<double>          flatAmp = 0;
+	for (unsigned long blockBegin = 0; blockBegin < nmbEvents; blockBegin += nmbEventsPerBlock) {
+		const unsigned long nmbEventsBlock = min(nmbEventsPerBlock, nmbEvents - blockBegin);
 
-			for (unsigned int iProdAmp = 0; iProdAmp < nmbProdAmps; ++iProdAmp) {
-				const unsigned int    iWave     = waveIndex        [iProdAmp];
-				const complex<double> decayAmp  = decayAmps        [iWave];
-				const complex<double> prodAmp   = prodAmps[iSample][iProdAmp];
-				const string          waveName  = waveNames        [iWave];
-				const double          nmbEvents = integral->nmbEvents();
-				if (waveName == "flat") {
-					flatAmp = prodAmp / sqrt(nmbEvents);
-					if (iSample == 0)  // set weights of individual production amplitudes
-						weightProdAmps[iProdAmp] = norm(flatAmp);
-				} else {
-					const complex<double> amp = decayAmp * prodAmp / sqrt(integral->element(waveName, waveName).real() * nmbEvents);
-					if (iSample == 0)  // set weights of individual production amplitudes
-						weightProdAmps[iProdAmp] = norm(amp);
-					if (reflectivities[iProdAmp] == +1)
-						posReflAmpSums[ranks[iProdAmp]] += amp;
-					else if (reflectivities[iProdAmp] == -1)
-						negReflAmpSums[ranks[iProdAmp]] += amp;
+		// read decay amplitudes for this block
+		for (unsigned int iWave = 0; iWave < nmbWaves; ++iWave) {
+			for (unsigned long iEvent = 0; iEvent < nmbEventsBlock; ++iEvent) {
+				if (not ampRootTrees[iWave])  // e.g. flat wave
+					decayAmpsBlock[iEvent * nmbWaves + iWave] = complex<double>(0);
+				else {
+					ampRootTrees[iWave]->GetEntry(blockBegin + iEvent);
+					assert(ampRootLeafs[iWave]->nmbIncohSubAmps() == 1);
+					decayAmpsBlock[iEvent * nmbWaves + iWave] = ampRootLeafs[iWave]->incohSubAmp(0);
 				}
-			}  // end loop over waves
-
-			// incoherent sum over rank
-			double sampleWeightPosRef = 0;
-			double sampleWeightNegRef = 0;
-			for (int iRank = 0; iRank < maxRank; ++iRank) {
-				sampleWeightPosRef += norm(posReflAmpSums[iRank]);
-				sampleWeightNegRef += norm(negReflAmpSums[iRank]);
-			}
-			// total weight is incoherent sum of the two reflectivities and the flat wave
-			double sampleWeightFlat = norm(flatAmp);
-			double sampleWeight     = sampleWeightPosRef + sampleWeightNegRef + sampleWeightFlat;
-
-			if (iSample == 0) {
-				for (unsigned int iWave = 0; iWave < nmbWaves; ++iWave)
-					weightWaves[iWave] = 0;
-				// in the end the following corresponds to a sum over ranks,
-				// which is an incoherent sum
-				for (unsigned int iProdAmp = 0; iProdAmp < nmbProdAmps; ++iProdAmp)
-					weightWaves[waveIndex[iProdAmp]] += weightProdAmps[iProdAmp];
-
-				weightPosRef = sampleWeightPosRef;
-				weightNegRef = sampleWeightNegRef;
-				weightFlat   = sampleWeightFlat;
-				weight       = sampleWeight;
 			}
+		}
 
-			weightProdAmpSamples[iSample] = sampleWeight;
+		// calculate weights for this block
+		const unsigned int nmbChunks = rpwa::nmbChunks(nmbEventsBlock, nmbThreadsToUse);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbChunks) schedule(static, 1)
+#endif
+		for (unsigned int iChunk = 0; iChunk < nmbChunks; ++iChunk) {
+			size_t eventBegin, eventEnd;
+			rpwa::chunkRange(nmbEventsBlock, nmbChunks, iChunk, eventBegin, eventEnd);
+
+			vector<complex<double> > ampSums(2 * maxRank);  // amplitude sums [reflectivity index][rank]
+			for (size_t iEvent = eventBegin; iEvent < eventEnd; ++iEvent) {
+				const complex<double>* decayAmps = &decayAmpsBlock[iEvent * nmbWaves];
+				double*                weights   = &weightsBlock  [iEvent * nmbWeightColumns];
+
+				// calculate weight for each sample of production amplitudes
+				for (unsigned int iSample = 0; iSample < nmbProdAmpSamples; ++iSample) {
+					const complex<double>* sampleNormProdAmps = &normProdAmps[iSample * nmbProdAmps];
+					ampSums.assign(2 * maxRank, 0);
+					for (unsigned int iProdAmp = 0; iProdAmp < nmbProdAmps; ++iProdAmp) {
+						if (contributesToAmpSum[iProdAmp])
+							ampSums[ampSumIndex[iProdAmp]] += decayAmps[waveIndex[iProdAmp]] * sampleNormProdAmps[iProdAmp];
+					}
 
-		}  // end loop over production-amplitude samples
-		outTree->Fill();
-	}
+					// incoherent sum over rank
+					double sampleWeightPosRef = 0;
+					double sampleWeightNegRef = 0;
+					for (int iRank = 0; iRank < maxRank; ++iRank) {
+						sampleWeightPosRef += norm(ampSums[iRank]);
+						sampleWeightNegRef += norm(ampSums[maxRank + iRank]);
+					}
+					// total weight is incoherent sum of the two reflectivities and the flat wave
+					const double sampleWeight = sampleWeightPosRef + sampleWeightNegRef + flatWeights[iSample];
+
+					if (iSample == 0) {
+						weights[0] = sampleWeight;
+						weights[1] = sampleWeightPosRef;
+						weights[2] = sampleWeightNegRef;
+						weights[3] = flatWeights[iSample];
+					}
+					weights[4 + iSample] = sampleWeight;
+				}  // end loop over production-amplitude samples
+
+				// weights of individual waves and production amplitudes
+				if (writeSingleWaveWeights) {
+					double* weightsWaves    = &weights[firstWaveColumn];
+					double* weightsProdAmps = &weights[firstWaveColumn + nmbWaves];
+					for (unsigned int iWave = 0; iWave < nmbWaves; ++iWave)
+						weightsWaves[iWave] = 0;
+					// in the end the following corresponds to a sum over ranks,
+					// which is an incoherent sum
+					for (unsigned int iProdAmp = 0; iProdAmp < nmbProdAmps; ++iProdAmp) {
+						const unsigned int iWave = waveIndex[iProdAmp];
+						if (waveNames[iWave] == "flat")
+							weightsProdAmps[iProdAmp] = flatWeights[0];
+						else
+							weightsProdAmps[iProdAmp] = norm(decayAmps[iWave] * normProdAmps[iProdAmp]);
+						weightsWaves[iWave] += weightsProdAmps[iProdAmp];
+					}
+				}
+			}  // end loop over events
+		}  // end loop over chunks
+
+		// write weights in the order of the events
+		for (unsigned long iEvent = 0; iEvent < nmbEventsBlock; ++iEvent) {
+			++progressIndicator;
+			for (unsigned int iColumn = 0; iColumn < nmbWeightColumns; ++iColumn)
+				*weightColumns[iColumn] = weightsBlock[iEvent * nmbWeightColumns + iColumn];
+			outTree->Fill();
+		}
+	}  // end loop over blocks of events
 
 	printSucc << "calculated weight for " << nmbEvents << " events" << endl;
 	timer.Stop();
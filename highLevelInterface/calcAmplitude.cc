@@ -2,22 +2,216 @@
 #include <TTree.h>
 #include <TTreePerfStats.h>
 
+#include "ampIntegralMatrix.h"
+#include "amplitudeFileWriter.h"
 #include "calcAmplitude.h"
+#include "hashCalculator.h"
+#include "isobarAmplitudeProgram.h"
 #include "progress_display.hpp"
 #include "reportingUtils.hpp"
+#include "threadUtils.hpp"
 
 
 using namespace std;
 using namespace rpwa;
 
 
+namespace {
+
+	// reads the kinematics data from the event tree in blocks of events;
+	// if a multibin is given, only events within the multibin are read
+	class eventBlockReader {
+
+	public:
+
+		eventBlockReader(const eventMetadata&          eventMeta,
+		                 const long int                maxNmbEvents,
+		                 const bool                    printProgress,
+		                 const string&                 treePerfStatOutFileName,
+		                 const long int                treeCacheSize,
+		                 const long int                nmbEventsPerBlock,
+		                 const long int                startEvent = 0,
+		                 const multibinBoundariesType& otfBin     = multibinBoundariesType())
+			: _tree                   (eventMeta.eventTree()),
+			  _prodKinMomenta         (0),
+			  _decayKinMomenta        (0),
+			  _otfBin                 (otfBin),
+			  _firstEvent             (0),
+			  _endEvent               (0),
+			  _nmbEventsBlock         (1),
+			  _nmbEventsSkipped       (0),
+			  _blockBegin             (0),
+			  _blockEnd               (0),
+			  _printProgress          (printProgress),
+			  _progressIndicator      (0),
+			  _treePerfStatOutFileName(treePerfStatOutFileName),
+			  _treePerfStats          (0)
+		{
+			if(not _tree) {
+				printErr << "event tree not found." << endl;
+				return;
+			}
+
+			// connect leaf variables to tree branches
+			TBranch* prodKinMomentaBr  = 0;
+			TBranch* decayKinMomentaBr = 0;
+			_tree->SetBranchAddress(eventMetadata::productionKinematicsMomentaBranchName.c_str(),  &_prodKinMomenta,  &prodKinMomentaBr );
+			_tree->SetBranchAddress(eventMetadata::decayKinematicsMomentaBranchName.c_str(), &_decayKinMomenta, &decayKinMomentaBr);
+			_tree->SetCacheSize(treeCacheSize);
+			_tree->AddBranchToCache(eventMetadata::productionKinematicsMomentaBranchName.c_str(),  true);
+			_tree->AddBranchToCache(eventMetadata::decayKinematicsMomentaBranchName.c_str(), true);
+			if(not _otfBin.empty()) {
+				if(not _additionalVariables.setBranchAddresses(eventMeta)) {
+					printErr << "cannot set branch address to additional variables." << endl;
+					_tree = 0;
+					return;
+				}
+				for(multibinBoundariesType::const_iterator it = _otfBin.begin(); it != _otfBin.end(); ++it) {
+					_tree->AddBranchToCache(it->first.c_str(), true);
+				}
+			}
+			_tree->StopCacheLearningPhase();
+			if(_treePerfStatOutFileName != "") {
+				_treePerfStats = new TTreePerfStats("ioPerf", _tree);
+			}
+
+			const long nmbEventsTree = _tree->GetEntries();
+			_firstEvent     = min(max(startEvent, 0L), nmbEventsTree);
+			_endEvent       = ((maxNmbEvents > 0) ? min(_firstEvent + maxNmbEvents, nmbEventsTree) : nmbEventsTree);
+			_blockEnd       = _firstEvent;
+			_nmbEventsBlock = max(min(nmbEventsPerBlock, nmbEvents()), 1L);
+			_prodKinMomentaBlock.assign (_nmbEventsBlock, TClonesArray("TVector3"));
+			_decayKinMomentaBlock.assign(_nmbEventsBlock, TClonesArray("TVector3"));
+		}
+
+		~eventBlockReader()
+		{
+			if(_tree and _printProgress) {
+				_tree->PrintCacheStats();
+			}
+			if(_treePerfStats) {
+				_treePerfStats->SaveAs(_treePerfStatOutFileName.c_str());
+				delete _treePerfStats;
+			}
+			delete _progressIndicator;
+		}
+
+		bool valid() const { return _tree; }
+
+		long int nmbEvents       () const { return _endEvent - _firstEvent; }  // number of events in range, including the ones outside the multibin
+		long int nmbEventsSkipped() const { return _nmbEventsSkipped;        }  // number of events outside the multibin
+		long int blockBegin      () const { return _blockBegin;              }
+		long int blockEnd        () const { return _blockEnd;                }
+
+		// reads next block of events; returns false if all events were read or if there was an error
+		bool readBlock(bool& success)
+		{
+			success = true;
+			if(_progressIndicator) {
+				(*_progressIndicator) += _blockEnd - _blockBegin;
+			} else if(_printProgress) {
+				_progressIndicator = new progress_display(nmbEvents(), cout, "");
+			}
+			_blockBegin = _blockEnd;
+			_prodKinMomentaBlockPtrs.clear();
+			_decayKinMomentaBlockPtrs.clear();
+			// read events until the block is full; events outside the multibin are skipped
+			long int eventIndex = _blockBegin;
+			for(; (eventIndex < _endEvent) and ((long int)_prodKinMomentaBlockPtrs.size() < _nmbEventsBlock); ++eventIndex) {
+				_tree->GetEntry(eventIndex);
+				if(not _otfBin.empty() and not _additionalVariables.inBoundaries(_otfBin)) {
+					++_nmbEventsSkipped;
+					continue;
+				}
+
+				if(not _prodKinMomenta or not _decayKinMomenta) {
+					printWarn << "at least one of the input data arrays is a null pointer: "
+					          << "        production kinematics: " << "momenta = " << _prodKinMomenta  << endl
+					          << "        decay kinematics:      " << "momenta = " << _decayKinMomenta << endl
+					          << "skipping event." << endl;
+					success = false;
+					return false;
+				}
+
+				// copy kinematics data, because the branch buffers are overwritten by the next event
+				TClonesArray& prodKinMomentaEvent  = _prodKinMomentaBlock [_prodKinMomentaBlockPtrs.size()];
+				TClonesArray& decayKinMomentaEvent = _decayKinMomentaBlock[_decayKinMomentaBlockPtrs.size()];
+				prodKinMomentaEvent  = *_prodKinMomenta;
+				decayKinMomentaEvent = *_decayKinMomenta;
+				_prodKinMomentaBlockPtrs.push_back (&prodKinMomentaEvent);
+				_decayKinMomentaBlockPtrs.push_back(&decayKinMomentaEvent);
+			}
+			_blockEnd = eventIndex;
+			if(_prodKinMomentaBlockPtrs.empty()) {
+				// all remaining events are outside the multibin
+				if(_progressIndicator) {
+					(*_progressIndicator) += _blockEnd - _blockBegin;
+				}
+				_blockBegin = _blockEnd;
+				return false;
+			}
+			return true;
+		}
+
+		const vector<const TClonesArray*>& prodKinMomenta () const { return _prodKinMomentaBlockPtrs;  }
+		const vector<const TClonesArray*>& decayKinMomenta() const { return _decayKinMomentaBlockPtrs; }
+
+	private:
+
+		TTree*                       _tree;
+		TClonesArray*                _prodKinMomenta;
+		TClonesArray*                _decayKinMomenta;
+		const multibinBoundariesType _otfBin;
+		additionalTreeVariables      _additionalVariables;
+		long int                     _firstEvent;
+		long int                     _endEvent;
+		long int                     _nmbEventsBlock;
+		long int                     _nmbEventsSkipped;
+		long int                     _blockBegin;
+		long int                     _blockEnd;
+		vector<TClonesArray>         _prodKinMomentaBlock;
+		vector<TClonesArray>         _decayKinMomentaBlock;
+		vector<const TClonesArray*>  _prodKinMomentaBlockPtrs;
+		vector<const TClonesArray*>  _decayKinMomentaBlockPtrs;
+		const bool                   _printProgress;
+		progress_display*            _progressIndicator;
+		const string                 _treePerfStatOutFileName;
+		TTreePerfStats*              _treePerfStats;
+
+	};
+
+
+	// initializes the amplitudes and the kinematics data of their decay topologies
+	bool initAmplitudes(const eventMetadata&              eventMeta,
+	                    const vector<isobarAmplitudePtr>& amplitudes)
+	{
+		for(size_t i = 0; i < amplitudes.size(); ++i) {
+			if(not amplitudes[i]) {
+				printWarn << "null pointer to isobar decay amplitude [" << i << "]. cannot process tree." << endl;
+				return false;
+			}
+			amplitudes[i]->init();
+			if(not amplitudes[i]->decayTopology()->initKinematicsData(eventMeta.productionKinematicsParticleNames(), eventMeta.decayKinematicsParticleNames())) {
+				printWarn << "problems initializing input data for amplitude [" << i << "]. cannot read input data." << endl;
+				return false;
+			}
+		}
+		return true;
+	}
+
+}
+
+
 vector<complex<double> >
 rpwa::hli::calcAmplitude(const eventMetadata&      eventMeta,
                          const isobarAmplitudePtr& amplitude,
                          const long int            maxNmbEvents,
                          const bool                printProgress,
                          const string&             treePerfStatOutFileName,         // root file name for tree performance result
-                         const long int            treeCacheSize)
+                         const long int            treeCacheSize,
+                         const unsigned int        nmbThreads,
+                         const long int            nmbEventsPerBlock,
+                         const bool                useCompiledProgram)
 {
 	vector<complex<double> > retval;
 
@@ -29,68 +223,166 @@ rpwa::hli::calcAmplitude(const eventMetadata&      eventMeta,
 	amplitude->init();
 	const isobarDecayTopologyPtr& decayTopo = amplitude->decayTopology();
 
-	TTree* tree = eventMeta.eventTree();
-	if(not tree) {
-		printErr << "event tree not found." << endl;
+	eventBlockReader reader(eventMeta, maxNmbEvents, printProgress, treePerfStatOutFileName, treeCacheSize, nmbEventsPerBlock);
+	if(not reader.valid()) {
 		return retval;
 	}
 
-	// create branch pointers and leaf variables
-	TBranch*      prodKinMomentaBr  = 0;
-	TBranch*      decayKinMomentaBr = 0;
-	TClonesArray* prodKinMomenta    = 0;
-	TClonesArray* decayKinMomenta   = 0;
-
-	// connect leaf variables to tree branches
-	tree->SetBranchAddress(eventMetadata::productionKinematicsMomentaBranchName.c_str(),  &prodKinMomenta,  &prodKinMomentaBr );
-	tree->SetBranchAddress(eventMetadata::decayKinematicsMomentaBranchName.c_str(), &decayKinMomenta, &decayKinMomentaBr);
-	tree->SetCacheSize(treeCacheSize);
-	tree->AddBranchToCache(eventMetadata::productionKinematicsMomentaBranchName.c_str(),  true);
-	tree->AddBranchToCache(eventMetadata::decayKinematicsMomentaBranchName.c_str(), true);
-	tree->StopCacheLearningPhase();
-	TTreePerfStats* treePerfStats = 0;
-	if(treePerfStatOutFileName != "") {
-		treePerfStats = new TTreePerfStats("ioPerf", tree);
-	}
-
 	// loop over events
 	if(not decayTopo->initKinematicsData(eventMeta.productionKinematicsParticleNames(), eventMeta.decayKinematicsParticleNames())) {
 		printWarn << "problems initializing input data. cannot read input data." << endl;
 		return retval;
 	}
-	const long nmbEventsTree = tree->GetEntries();
-	const long nmbEvents     = ((maxNmbEvents > 0) ? min(maxNmbEvents, nmbEventsTree)
-	                                               : nmbEventsTree);
-	progress_display* progressIndicator = (printProgress) ? new progress_display(nmbEvents, cout, "") : 0;
-	for (long int eventIndex = 0; eventIndex < nmbEvents; ++eventIndex) {
-		if(progressIndicator) {
-			++(*progressIndicator);
+	// if requested, amplitudes that can be compiled are calculated by the
+	// flat program instead of walking the decay topology for every event;
+	// checkKeyFile compares both evaluations
+	isobarAmplitudeProgram program;
+	if(useCompiledProgram and program.compile(*amplitude)) {
+		printInfo << "calculating amplitudes with compiled program of " << program.nmbInstructions() << " instructions "
+		          << "and " << program.nmbSymTerms() << " symmetrization term(s)." << endl;
+	}
+	// events are read in blocks; the amplitudes of all events in a block
+	// are calculated in parallel
+	retval.reserve(reader.nmbEvents());
+	vector<complex<double> > ampsBlock;
+	bool                     success;
+	while(reader.readBlock(success)) {
+		const bool blockSuccess = (program.valid())
+			? program.amplitudes(reader.prodKinMomenta(), reader.decayKinMomenta(), ampsBlock, nmbThreads)
+			: amplitude->amplitudes(reader.prodKinMomenta(), reader.decayKinMomenta(), ampsBlock, nmbThreads);
+		if(blockSuccess) {
+			retval.insert(retval.end(), ampsBlock.begin(), ampsBlock.end());
+		} else {
+			printWarn << "problems reading events in range [" << reader.blockBegin() << ", " << reader.blockEnd() << ")" << endl;
+			return vector<complex<double> >();
 		}
+	}
+	if(not success) {
+		return vector<complex<double> >();
+	}
+
+	return retval;
+}
 
-		tree->GetEntry(eventIndex);
 
-		if(not prodKinMomenta or not decayKinMomenta) {
-			printWarn << "at least one of the input data arrays is a null pointer: "
-			          << "        production kinematics: " << "momenta = " << prodKinMomenta  << endl
-			          << "        decay kinematics:      " << "momenta = " << decayKinMomenta << endl
-			          << "skipping event." << endl;
-			return vector<complex<double> >();
+bool
+rpwa::hli::calcAmplitudes(const eventMetadata&              eventMeta,
+                          const vector<isobarAmplitudePtr>& amplitudes,
+                          vector<amplitudeFileWriter*>&     ampFileWriters,
+                          const long int                    maxNmbEvents,
+                          const bool                        printProgress,
+                          const string&                     treePerfStatOutFileName,         // root file name for tree performance result
+                          const long int                    treeCacheSize,
+                          const unsigned int                nmbThreads,
+                          const long int                    nmbEventsPerBlock)
+{
+	if(amplitudes.size() != ampFileWriters.size()) {
+		printWarn << "number of amplitudes (" << amplitudes.size() << ") does not match "
+		          << "number of amplitude file writers (" << ampFileWriters.size() << "). cannot process tree." << endl;
+		return false;
+	}
+	for(size_t i = 0; i < amplitudes.size(); ++i) {
+		if(not ampFileWriters[i] or not ampFileWriters[i]->initialized()) {
+			printWarn << "amplitude file writer [" << i << "] is not initialized. cannot process tree." << endl;
+			return false;
 		}
+	}
 
-		if(decayTopo->readKinematicsData(*prodKinMomenta, *decayKinMomenta)) {
-			retval.push_back((*amplitude)());
-		} else {
-			printWarn << "problems reading event[" << eventIndex << "]" << endl;
-			return vector<complex<double> >();
+	eventBlockReader reader(eventMeta, maxNmbEvents, printProgress, treePerfStatOutFileName, treeCacheSize, nmbEventsPerBlock);
+	if(not reader.valid()) {
+		return false;
+	}
+
+	if(not initAmplitudes(eventMeta, amplitudes)) {
+		return false;
+	}
+
+	// every event is read only once and the decay kinematics that
+	// several amplitudes have in common are calculated only once
+	vector<vector<complex<double> > > ampsBlock;
+	bool                              success;
+	while(reader.readBlock(success)) {
+		if(not isobarAmplitude::amplitudes(amplitudes, reader.prodKinMomenta(), reader.decayKinMomenta(), ampsBlock, nmbThreads)) {
+			printWarn << "problems reading events in range [" << reader.blockBegin() << ", " << reader.blockEnd() << ")" << endl;
+			return false;
+		}
+		for(size_t i = 0; i < amplitudes.size(); ++i) {
+			ampFileWriters[i]->addAmplitudes(ampsBlock[i]);
 		}
 	}
 
-	if(printProgress) {
-		tree->PrintCacheStats();
+	return success;
+}
+
+
+bool
+rpwa::hli::calcIntegralsOnTheFly(const eventMetadata&              eventMeta,
+                                 const vector<isobarAmplitudePtr>& amplitudes,
+                                 const vector<string>&             waveNames,
+                                 const multibinBoundariesType&     otfBin,
+                                 ampIntegralMatrix&                integralMatrix,
+                                 vector<string>&                   ampHashes,
+                                 const long int                    startEvent,
+                                 const long int                    maxNmbEvents,
+                                 const bool                        printProgress,
+                                 const unsigned int                nmbThreads,
+                                 const long int                    nmbEventsPerBlock)
+{
+	ampHashes.clear();
+	if(amplitudes.size() != waveNames.size()) {
+		printWarn << "number of amplitudes (" << amplitudes.size() << ") does not match "
+		          << "number of wave names (" << waveNames.size() << "). cannot process tree." << endl;
+		return false;
 	}
-	if(treePerfStats) {
-		treePerfStats->SaveAs(treePerfStatOutFileName.c_str());
-		delete treePerfStats;
+	if(not integralMatrix.setWaveNames(waveNames)) {
+		printWarn << "cannot set wave names of integral matrix. cannot process tree." << endl;
+		return false;
 	}
-	return retval;
+
+	// a negative maximum number of events means all events, 0 means
+	// that no events are used
+	vector<hashCalculator> hashers(amplitudes.size());
+	if(maxNmbEvents != 0) {
+		eventBlockReader reader(eventMeta, maxNmbEvents, printProgress, "", 25000000, nmbEventsPerBlock, startEvent, otfBin);
+		if(not reader.valid()) {
+			return false;
+		}
+		if(not initAmplitudes(eventMeta, amplitudes)) {
+			return false;
+		}
+
+		// the amplitudes of all waves are calculated for a block of events
+		// and are then added to the integral matrix and to the hashes of the
+		// amplitudes in event order
+		vector<vector<complex<double> > > ampsBlock;
+		bool                              success;
+		while(reader.readBlock(success)) {
+			if(not isobarAmplitude::amplitudes(amplitudes, reader.prodKinMomenta(), reader.decayKinMomenta(), ampsBlock, nmbThreads)) {
+				printWarn << "problems reading events in range [" << reader.blockBegin() << ", " << reader.blockEnd() << ")" << endl;
+				return false;
+			}
+			// the hashes of the different waves are independent
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(rpwa::nmbThreadsToUse(nmbThreads)) schedule(dynamic, 1)
+#endif
+			for(size_t i = 0; i < amplitudes.size(); ++i) {
+				if(not ampsBlock[i].empty()) {
+					hashers[i].Update(ampsBlock[i].data(), ampsBlock[i].size());
+				}
+			}
+			if(not integralMatrix.addEvents(ampsBlock, nmbThreads)) {
+				printWarn << "could not add events in range [" << reader.blockBegin() << ", " << reader.blockEnd() << ") to integral matrix" << endl;
+				return false;
+			}
+		}
+		if(not success) {
+			return false;
+		}
+		printInfo << reader.nmbEventsSkipped() << " events rejected because they are outside the binning." << endl;
+	}
+
+	for(size_t i = 0; i < hashers.size(); ++i) {
+		ampHashes.push_back(hashers[i].hash());
+	}
+	return true;
 }
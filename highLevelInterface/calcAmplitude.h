@@ -2,6 +2,8 @@
 #define HLI_CALCAMPLITUDE_H
 
 #include <complex>
+#include <string>
+#include <vector>
 
 #include <eventMetadata.h>
 #include <isobarAmplitude.h>
@@ -9,6 +11,9 @@
 
 namespace rpwa {
 
+	class ampIntegralMatrix;
+	class amplitudeFileWriter;
+
 	namespace hli {
 
 		std::vector<std::complex<double> > calcAmplitude(const rpwa::eventMetadata&      eventMeta,
@@ -16,7 +21,40 @@ namespace rpwa {
 		                                                 const long int                  maxNmbEvents            = -1,
 		                                                 const bool                      printProgress           = true,
 		                                                 const std::string&              treePerfStatOutFileName = "",         // root file name for tree performance result
-		                                                 const long int                  treeCacheSize           = 25000000);
+		                                                 const long int                  treeCacheSize           = 25000000,
+		                                                 const unsigned int              nmbThreads              = 1,          // number of threads used to calculate the amplitudes; 0 uses all available threads
+		                                                 const long int                  nmbEventsPerBlock       = 10000,      // number of events that are read before the amplitudes are calculated
+		                                                 const bool                      useCompiledProgram      = false);     // calculate the amplitudes with an isobarAmplitudeProgram if the amplitude can be compiled
+
+		// calculates the amplitudes of several waves in a single pass over the
+		// event tree and adds them to the given initialized amplitude file writers;
+		// decay kinematics that several waves have in common are calculated only once
+		bool calcAmplitudes(const rpwa::eventMetadata&                    eventMeta,
+		                    const std::vector<rpwa::isobarAmplitudePtr>&  amplitudes,
+		                    std::vector<rpwa::amplitudeFileWriter*>&      ampFileWriters,
+		                    const long int                                maxNmbEvents            = -1,
+		                    const bool                                    printProgress           = true,
+		                    const std::string&                            treePerfStatOutFileName = "",         // root file name for tree performance result
+		                    const long int                                treeCacheSize           = 25000000,
+		                    const unsigned int                            nmbThreads              = 1,          // number of threads used to calculate the amplitudes; 0 uses all available threads
+		                    const long int                                nmbEventsPerBlock       = 10000);     // number of events that are read before the amplitudes are calculated
+
+		// calculates the integral matrix of the given waves directly from
+		// the event tree without writing amplitude files; only events
+		// within the given multibin are taken into account; the MD5 hashes
+		// of the amplitude values of each wave are returned in ampHashes;
+		// a negative maxNmbEvents means all events, 0 means no events
+		bool calcIntegralsOnTheFly(const rpwa::eventMetadata&                    eventMeta,
+		                           const std::vector<rpwa::isobarAmplitudePtr>&  amplitudes,
+		                           const std::vector<std::string>&               waveNames,
+		                           const rpwa::multibinBoundariesType&           otfBin,
+		                           rpwa::ampIntegralMatrix&                      integralMatrix,
+		                           std::vector<std::string>&                     ampHashes,
+		                           const long int                                startEvent        = 0,
+		                           const long int                                maxNmbEvents      = -1,
+		                           const bool                                    printProgress     = true,
+		                           const unsigned int                            nmbThreads        = 1,         // number of threads used to calculate the amplitudes and the integrals; 0 uses all available threads
+		                           const long int                                nmbEventsPerBlock = 10000);    // number of events that are read before the amplitudes are calculated
 
 	}
 
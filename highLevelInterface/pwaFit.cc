@@ -1,6 +1,9 @@
 #include "pwaFit.h"
 
 #include <complex>
+#include <streambuf>
+
+#include <boost/array.hpp>
 
 #include <Math/Factory.h>
 #include <Math/Minimizer.h>
@@ -16,6 +19,7 @@
 #include <partialWaveFitHelper.h>
 #include <pwaLikelihood.h>
 #include <reportingUtils.hpp>
+#include <threadUtils.hpp>
 #ifdef USE_CUDA
 #include "complex.cuh"
 #include "likelihoodInterface.cuh"
@@ -61,14 +65,165 @@ namespace ROOT {
 }
 
 
+namespace {
+
+	typedef boost::array<pwaLikelihood<complex<double> >::functionCallInfo,
+	                     pwaLikelihood<complex<double> >::NMB_FUNCTIONCALLENUM> fitCallInfoType;  // function call statistics of one fit
+
+
+	// minimizer interface to a likelihood object; the minimizer works on
+	// a clone of the function it is given, and in contrast to
+	// pwaLikelihood::Clone() cloning this interface does not copy the
+	// decay amplitudes, so that several minimizations can share one
+	// likelihood object
+	// if callInfo is given, the calls made by the minimizer are counted
+	// there, so that concurrent fits keep separate call statistics
+	class sharedLikelihood : public IGradientFunctionMultiDim {
+
+	public:
+
+		sharedLikelihood(const pwaLikelihood<complex<double> >& L,
+		                 fitCallInfoType*                       callInfo = 0)
+			: _L       (L),
+			  _callInfo(callInfo) { }
+
+		virtual sharedLikelihood* Clone() const { return new sharedLikelihood(_L, _callInfo); }
+		virtual unsigned int NDim() const { return _L.NDim(); }
+		virtual void Gradient(const double* par,
+		                      double*       gradient) const
+		{
+			TStopwatch timer;
+			timer.Start();
+			_L.Gradient(par, gradient);
+			countCall(pwaLikelihood<complex<double> >::GRADIENT, timer);
+		}
+		virtual void FdF(const double* par,
+		                 double&       funcVal,
+		                 double*       gradient) const
+		{
+			TStopwatch timer;
+			timer.Start();
+			_L.FdF(par, funcVal, gradient);
+			countCall(pwaLikelihood<complex<double> >::FDF, timer);
+		}
+
+	private:
+
+		virtual double DoEval(const double* par) const
+		{
+			TStopwatch timer;
+			timer.Start();
+			const double funcVal = _L.DoEval(par);
+			countCall(pwaLikelihood<complex<double> >::DOEVAL, timer);
+			return funcVal;
+		}
+		virtual double DoDerivative(const double*      par,
+		                            const unsigned int derivativeIndex) const
+		{
+			TStopwatch timer;
+			timer.Start();
+			const double derivative = _L.DoDerivative(par, derivativeIndex);
+			countCall(pwaLikelihood<complex<double> >::DODERIVATIVE, timer);
+			return derivative;
+		}
+
+		void countCall(const pwaLikelihood<complex<double> >::functionCallEnum func,
+		               TStopwatch&                                             timer) const
+		{
+			if (not _callInfo)
+				return;
+			timer.Stop();
+			++((*_callInfo)[func].nmbCalls);
+			(*_callInfo)[func].totalTime(timer.RealTime());
+		}
+
+		const pwaLikelihood<complex<double> >& _L;
+		fitCallInfoType*                       _callInfo;  // not owned; all clones of one minimizer refer to the same statistics
+
+	};
+
+
+	ostream&
+	printFitCallInfo(ostream&               out,
+	                 const fitCallInfoType& callInfo)
+	{
+		const string funcNames[pwaLikelihood<complex<double> >::NMB_FUNCTIONCALLENUM] = {"FdF", "Gradient", "DoEval", "DoDerivative", "Hessian"};
+		for (unsigned int i = 0; i < pwaLikelihood<complex<double> >::NMB_FUNCTIONCALLENUM; ++i)
+			if (callInfo[i].nmbCalls > 0)
+				out << "    " << callInfo[i].nmbCalls
+				    << " calls to pwaLikelihood<complexT>::" << funcNames[i] << "()" << endl
+				    << "    total time spent in pwaLikelihood<complexT>::" << funcNames[i] << "(): "
+				    << boost::accumulators::sum(callInfo[i].totalTime) << " sec" << endl;
+		return out;
+	}
+
+
+	// stream buffer that collects the output of each thread of a
+	// parallel region separately; flush() passes the output collected
+	// by the calling thread on to the original stream buffer
+	class threadOutputBuffer : public streambuf {
+
+	public:
+
+		threadOutputBuffer(streambuf*         original,
+		                   const unsigned int nmbThreads)
+			: _original(original),
+			  _buffers (nmbThreads) { }
+
+		void
+		flush()
+		{
+			string& buffer = _buffers[threadIndex()];
+			_original->sputn(buffer.data(), buffer.size());
+			_original->pubsync();
+			buffer.clear();
+		}
+
+	protected:
+
+		virtual
+		int_type
+		overflow(int_type c)
+		{
+			if (not traits_type::eq_int_type(c, traits_type::eof()))
+				_buffers[threadIndex()].push_back(traits_type::to_char_type(c));
+			return traits_type::not_eof(c);
+		}
+
+		virtual
+		streamsize
+		xsputn(const char* s,
+		       streamsize  n)
+		{
+			_buffers[threadIndex()].append(s, n);
+			return n;
+		}
+
+	private:
+
+		streambuf*     _original;
+		vector<string> _buffers;
+
+	};
+
+}
+
+
+// performs the fit; if callInfo is given, the function call statistics
+// of this fit are collected there and the caller is responsible for
+// printing them, otherwise the statistics of the likelihood object are
+// printed
+// returns a null pointer if the fit could not be performed
+static
 fitResultPtr
-rpwa::hli::pwaFit(const pwaLikelihood<complex<double> >& L,
-                  const multibinBoundariesType&          multibinBoundaries,
-                  const unsigned int                     seed,
-                  const string&                          startValFileName,
-                  const bool                             checkHessian,
-                  const bool                             saveSpace,
-                  const bool                             verbose)
+runPwaFit(const pwaLikelihood<complex<double> >& L,
+          const multibinBoundariesType&          multibinBoundaries,
+          const unsigned int                     seed,
+          const string&                          startValFileName,
+          const bool                             checkHessian,
+          const bool                             saveSpace,
+          const bool                             verbose,
+          fitCallInfoType*                       callInfo)
 {
 
 #if ROOT_VERSION_CODE < ROOT_VERSION(6, 0, 0)
@@ -140,10 +295,15 @@ rpwa::hli::pwaFit(const pwaLikelihood<complex<double> >& L,
 	// setup minimizer
 	printInfo << "creating and setting up minimizer '" << minimizerType[0] << "' "
 	          << "using algorithm '" << minimizerType[1] << "'" << endl;
-	Minimizer* minimizer = Factory::CreateMinimizer(minimizerType[0], minimizerType[1]);
+	Minimizer* minimizer = 0;
+	// the plugin manager used by the factory must not be called by several threads at the same time
+#ifdef _OPENMP
+#pragma omp critical(pwaFitCreateMinimizer)
+#endif
+	minimizer = Factory::CreateMinimizer(minimizerType[0], minimizerType[1]);
 	if (not minimizer) {
 		printErr << "could not create minimizer. exiting." << endl;
-		throw;
+		return fitResultPtr();
 	}
 
 	// special for Minuit2
@@ -154,7 +314,7 @@ rpwa::hli::pwaFit(const pwaLikelihood<complex<double> >& L,
 	}
 #endif
 
-	minimizer->SetFunction        (L);
+	minimizer->SetFunction        (sharedLikelihood(L, callInfo));
 	minimizer->SetStrategy        (minimizerStrategy);
 	minimizer->SetTolerance       (minimizerTolerance);
 
@@ -268,7 +428,12 @@ rpwa::hli::pwaFit(const pwaLikelihood<complex<double> >& L,
 		}
 		if (not success) {
 			printErr << "something went wrong when setting log likelihood parameters. Aborting..." << endl;
-			throw;
+			if (startValFile) {
+				startValFile->Close();
+				delete startValFile;
+			}
+			delete minimizer;
+			return fitResultPtr();
 		}
 		// cleanup
 		if(startValFile) {
@@ -295,7 +460,8 @@ rpwa::hli::pwaFit(const pwaLikelihood<complex<double> >& L,
 		const double newLikelihood = L.DoEval(correctParams.data());
 		if(minimizer->MinValue() != newLikelihood) {
 			printErr << "Flipping signs according to sign conventions changed the likelihood (from " << maxPrecisionAlign(minimizer->MinValue()) << " to " << maxPrecisionAlign(newLikelihood) << ")." << endl;
-			throw;
+			delete minimizer;
+			return fitResultPtr();
 		} else {
 			printInfo << "Likelihood unchanged at " << maxPrecisionAlign(newLikelihood) << " by flipping signs according to conventions." << endl;
 		}
@@ -378,8 +544,10 @@ rpwa::hli::pwaFit(const pwaLikelihood<complex<double> >& L,
 		}
 		cout << endl;
 	}
-	printInfo << "function call summary:" << endl;
-	L.printFuncInfo(cout);
+	if (not callInfo) {
+		printInfo << "function call summary:" << endl;
+		L.printFuncInfo(cout);
+	}
 #ifdef USE_CUDA
 	printInfo << "total CUDA kernel time: "
 	          << cuda::likelihoodInterface<cuda::complex<double> >::kernelTime() << " sec" << endl;
@@ -430,3 +598,94 @@ rpwa::hli::pwaFit(const pwaLikelihood<complex<double> >& L,
 
 	return fitResultPtr(result);
 }
+
+
+fitResultPtr
+rpwa::hli::pwaFit(const pwaLikelihood<complex<double> >& L,
+                  const multibinBoundariesType&          multibinBoundaries,
+                  const unsigned int                     seed,
+                  const string&                          startValFileName,
+                  const bool                             checkHessian,
+                  const bool                             saveSpace,
+                  const bool                             verbose)
+{
+	fitResultPtr result = runPwaFit(L, multibinBoundaries, seed, startValFileName, checkHessian, saveSpace, verbose, 0);
+	if (not result)
+		throw;
+	return result;
+}
+
+
+vector<fitResultPtr>
+rpwa::hli::pwaMultiStartFit(const pwaLikelihood<complex<double> >& L,
+                            const multibinBoundariesType&          multibinBoundaries,
+                            const vector<unsigned int>&            seeds,
+                            const string&                          startValFileName,
+                            const bool                             checkHessian,
+                            const bool                             saveSpace,
+                            const bool                             verbose,
+                            const unsigned int                     nmbThreads)
+{
+	const unsigned int nmbFitThreads = min((size_t)nmbThreadsToUse(nmbThreads), max(seeds.size(), (size_t)1));
+	printInfo << "running " << seeds.size() << " fit" << ((seeds.size() != 1) ? "s" : "") << " "
+	          << "using " << nmbFitThreads << " thread" << ((nmbFitThreads != 1) ? "s" : "") << "." << endl;
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 4, 0)
+	if (nmbFitThreads > 1)
+		ROOT::EnableThreadSafety();
+#endif
+
+	// all fits share the decay amplitudes in L; the event loops of the
+	// likelihood run in a single thread within each fit, if nested
+	// parallelism is disabled, which is the OpenMP default
+	// each fit collects its own function call statistics, which are
+	// printed after all fits have finished; a fit that fails leaves a
+	// null pointer in its result slot
+	// if several fits run at the same time, the output of each fit is
+	// collected and printed in one piece after the fit has finished, so
+	// that the logs of the fits do not interleave
+	vector<fitResultPtr>    results (seeds.size());
+	vector<fitCallInfoType> callInfo(seeds.size());
+	for (unsigned int iFit = 0; iFit < seeds.size(); ++iFit)
+		for (unsigned int i = 0; i < pwaLikelihood<complex<double> >::NMB_FUNCTIONCALLENUM; ++i)
+			callInfo[iFit][i].nmbCalls = 0;
+	threadOutputBuffer coutBuffer(cout.rdbuf(), nmbFitThreads);
+	threadOutputBuffer cerrBuffer(cerr.rdbuf(), nmbFitThreads);
+	streambuf*         coutOriginal = 0;
+	streambuf*         cerrOriginal = 0;
+	if (nmbFitThreads > 1) {
+		cout.flush();
+		cerr.flush();
+		coutOriginal = cout.rdbuf(&coutBuffer);
+		cerrOriginal = cerr.rdbuf(&cerrBuffer);
+	}
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbFitThreads) schedule(dynamic, 1)
+#endif
+	for (unsigned int iFit = 0; iFit < seeds.size(); ++iFit) {
+		if (nmbFitThreads > 1)
+			printInfo << "output of fit " << iFit << " (seed " << seeds[iFit] << "):" << endl;
+		results[iFit] = runPwaFit(L, multibinBoundaries, seeds[iFit], startValFileName, checkHessian, saveSpace, verbose, &callInfo[iFit]);
+		if (nmbFitThreads > 1) {
+#ifdef _OPENMP
+#pragma omp critical(pwaMultiStartFitOutput)
+#endif
+			{
+				cerrBuffer.flush();
+				coutBuffer.flush();
+			}
+		}
+	}
+	if (nmbFitThreads > 1) {
+		cout.rdbuf(coutOriginal);
+		cerr.rdbuf(cerrOriginal);
+	}
+
+	for (unsigned int iFit = 0; iFit < seeds.size(); ++iFit) {
+		printInfo << "function call summary of fit " << iFit << " (seed " << seeds[iFit] << ")";
+		if (not results[iFit])
+			cout << "; fit failed";
+		cout << ":" << endl;
+		printFitCallInfo(cout, callInfo[iFit]);
+	}
+	return results;
+}
@@ -16,6 +16,19 @@ namespace rpwa {
 		                          const bool                                        saveSpace = false,
 		                          const bool                                        verbose = false);
 
+		/// runs one fit for each of the given seeds; nmbThreads fits are run
+		/// concurrently on the same likelihood object; 0 uses all available threads
+		/// the output of concurrent fits is printed fit by fit after each fit has finished
+		/// the result of a fit that could not be performed is a null pointer
+		std::vector<rpwa::fitResultPtr> pwaMultiStartFit(const rpwa::pwaLikelihood<std::complex<double> >& L,
+		                                                 const rpwa::multibinBoundariesType&               multibinBoundaries,
+		                                                 const std::vector<unsigned int>&                  seeds,
+		                                                 const std::string&                                startValFileName = "",
+		                                                 const bool                                        checkHessian = false,
+		                                                 const bool                                        saveSpace = false,
+		                                                 const bool                                        verbose = false,
+		                                                 const unsigned int                                nmbThreads = 1);
+
 	}
 
 }
@@ -34,15 +34,302 @@
 
 #include <algorithm>
 
+#include "counterBasedRandom.hpp"
 #include "nBodyPhaseSpaceGenerator.h"
+#include "physUtils.hpp"
+#include "threadUtils.hpp"
 
 
 using namespace std;
 using namespace rpwa;
 
 
+namespace {
+
+	// number of events that are processed together by the kernels of
+	// generateDecays(); the working arrays of one block fit into the L1 cache
+	const size_t eventBlockSize = 256;
+
+	// the event index is the lower half of the counter of the random
+	// number generator, the upper half is the index of the random number
+	// pair within the event; the offsets separate the numbers used in the
+	// different steps of the event generation, the number of the attempt
+	// to pick the masses is stored in the upper 32 bits
+	const uint64_t massesCounter     = 0;
+	const uint64_t anglesCounter     = 0x10000;
+	const uint64_t acceptanceCounter = 0x20000;
+
+
+	// randomly choses the (n - 2) effective masses of the (i + 1)-body
+	// systems of a block of events in the same way as pickMasses() for all
+	// weight types except NUPHAZ; M[i * nmbEvents + j] is the mass of the
+	// (i + 1)-body system in event j
+	void
+	pickMassesBlock(const counterBasedRandom& random,
+	                const uint64_t*           eventIndices,
+	                const size_t              nmbEvents,
+	                const vector<double>&     mSum,
+	                const double              nBodyMass,
+	                double*                   M)
+	{
+		const unsigned int n            = mSum.size();
+		const double       massInterval = nBodyMass - mSum[n - 1];  // kinematically allowed mass interval
+		for (size_t j = 0; j < nmbEvents; ++j) {
+			M[j]                       = mSum[0];
+			M[(n - 1) * nmbEvents + j] = nBodyMass;
+		}
+		if (n < 3) {
+			return;
+		}
+
+		// (n - 2) random numbers are needed, which are drawn in pairs for
+		// all events at once and stored in the rows of the masses of the
+		// (i + 1)-body systems with i = 1, ..., n - 2 (plus one spare row)
+		vector<double> spare(nmbEvents);
+		for (unsigned int i = 0; i < (n - 2); i += 2) {
+			double* r0 = M + (i + 1) * nmbEvents;
+			double* r1 = (i + 2 < n - 1) ? M + (i + 2) * nmbEvents : &spare[0];
+			for (size_t j = 0; j < nmbEvents; ++j) {
+				random.uniform2(eventIndices[j], massesCounter + i / 2, r0[j], r1[j]);
+			}
+		}
+
+		// sort random numbers of each event; insertion sort is fastest for
+		// the small number of values
+		vector<double> r(n, 0);
+		for (size_t j = 0; j < nmbEvents; ++j) {
+			for (unsigned int i = 0; i < (n - 2); ++i) {
+				const double val = M[(i + 1) * nmbEvents + j];
+				unsigned int k = i;
+				for (; (k > 0) and (r[k - 1] > val); --k) {
+					r[k] = r[k - 1];
+				}
+				r[k] = val;
+			}
+			// random numbers must be strictly increasing, cf. pickMasses();
+			// in the very rare case of a duplicate new numbers are drawn
+			for (uint64_t attempt = 1; adjacent_find(r.begin(), r.begin() + (n - 2)) != r.begin() + (n - 2); ++attempt) {
+				for (unsigned int i = 0; i < (n - 2); i += 2) {
+					random.uniform2(eventIndices[j], (attempt << 32) | (massesCounter + i / 2), r[i], r[i + 1]);
+				}
+				sort(r.begin(), r.begin() + (n - 2));
+			}
+			for (unsigned int i = 0; i < (n - 2); ++i) {
+				M[(i + 1) * nmbEvents + j] = r[i];
+			}
+		}
+
+		// set effective masses of (intermediate) two-body decays
+		for (unsigned int i = 1; i < (n - 1); ++i) {  // loop over intermediate 2- to (n - 1)-bodies
+			double* Mi = M + i * nmbEvents;
+			for (size_t j = 0; j < nmbEvents; ++j) {
+				Mi[j] = mSum[i] + Mi[j] * massInterval;
+			}
+		}
+	}
+
+
+	// calculates breakup momenta and weights of a block of events from the
+	// effective masses in the same way as calcWeight(); the layout of the
+	// breakup momenta is the same as the one of the masses
+	void
+	calcWeightsBlock(const nBodyPhaseSpaceGenerator& gen,
+	                 const double                    nBodyMass,
+	                 const size_t                    nmbEvents,
+	                 const double*                   M,
+	                 double*                         q,
+	                 double*                         weights)
+	{
+		const unsigned int n = gen.nmbOfDaughters();
+		for (unsigned int i = 1; i < n; ++i) {  // loop over 2- to n-bodies
+			const double  m     = gen.daughterMass(i);
+			const double* MMoth = M + i * nmbEvents;
+			const double* MDau  = M + (i - 1) * nmbEvents;
+			double*       qi    = q + i * nmbEvents;
+			for (size_t j = 0; j < nmbEvents; ++j) {
+				const double mSum  = MDau[j] + m;
+				const double mDiff = MDau[j] - m;
+				const double q2    = (MMoth[j] - mSum) * (MMoth[j] + mSum) * (MMoth[j] - mDiff) * (MMoth[j] + mDiff) / (4 * MMoth[j] * MMoth[j]);
+				qi[j] = sqrt(max(q2, 0.));
+			}
+		}
+
+		// factors that depend only on the n-body mass
+		double factor = 1;
+		switch (gen.weightType()) {
+			case nBodyPhaseSpaceKinematics::S_U_CHUNG:
+				{
+					const double massInterval = nBodyMass - gen.sumOfDaughterMasses(n - 1);  // kinematically allowed mass interval
+					factor = gen.normalization() * rpwa::pow(massInterval, (int)n - 2) / nBodyMass;
+				}
+				break;
+			case nBodyPhaseSpaceKinematics::GENBOD:
+				{
+					double motherMassMax = nBodyMass - gen.sumOfDaughterMasses(n - 1) + gen.daughterMass(0);  // maximum possible value of decaying effective mass
+					double momProdMax    = 1;                                                                  // product of maximum breakup momenta
+					for (unsigned int i = 1; i < n; ++i) {  // loop over 2- to n-bodies
+						motherMassMax += gen.daughterMass(i);
+						momProdMax    *= breakupMomentum(motherMassMax, gen.sumOfDaughterMasses(i - 1), gen.daughterMass(i));
+					}
+					factor = 1 / momProdMax;
+				}
+				break;
+			default:
+				// no weighting
+				for (size_t j = 0; j < nmbEvents; ++j) {
+					weights[j] = 1;
+				}
+				return;
+		}
+		for (size_t j = 0; j < nmbEvents; ++j) {
+			weights[j] = factor;
+		}
+		for (unsigned int i = 1; i < n; ++i) {
+			const double* qi = q + i * nmbEvents;
+			for (size_t j = 0; j < nmbEvents; ++j) {
+				weights[j] *= qi[j];
+			}
+		}
+		for (size_t j = 0; j < nmbEvents; ++j) {
+			if (std::isnan(weights[j])) {
+				weights[j] = 0;
+			}
+		}
+	}
+
+
+	// calculates cos(2 pi u) and sin(2 pi u) without calls to the math
+	// library, so that the compiler can vectorize loops over events; the
+	// argument is reduced to [-pi / 4, pi / 4] and the Taylor series are
+	// evaluated up to the order at which they are exact to double precision
+	inline
+	void
+	cosSinTwoPi(const double u,
+	            double&      cosVal,
+	            double&      sinVal)
+	{
+		// index of quadrant k = 0, ..., 4 by rounding to nearest integer;
+		// unlike floor() adding and subtracting 1.5 * 2^52 can be vectorized
+		const double k  = (4 * u + 6755399441055744.) - 6755399441055744.;
+		const double x  = rpwa::twoPi * (u - 0.25 * k);  // range [-pi / 4, pi / 4]
+		const double x2 = x * x;
+		const double s  = x * (1 + x2 * (-1. / 6 + x2 * (1. / 120 + x2 * (-1. / 5040 + x2 * (1. / 362880
+		                  + x2 * (-1. / 39916800 + x2 * (1. / 6227020800. + x2 * (-1. / 1307674368000.
+		                  + x2 * (1. / 355687428096000.)))))))));
+		const double c  = 1 + x2 * (-1. / 2 + x2 * (1. / 24 + x2 * (-1. / 720 + x2 * (1. / 40320
+		                  + x2 * (-1. / 3628800 + x2 * (1. / 479001600 + x2 * (-1. / 87178291200.
+		                  + x2 * (1. / 20922789888000. + x2 * (-1. / 6402373705728000.)))))))));
+		// rotate by k * pi / 2 using cos(k * pi / 2) = |k - 2| - 1 and
+		// sin(k * pi / 2) = 1 - |k - 1| for k = 0, ..., 3 without branches
+		const double quadrant = (k == 4) ? 0 : k;
+		const double cosK     = fabs(quadrant - 2) - 1;
+		const double sinK     = 1 - fabs(quadrant - 1);
+		cosVal = c * cosK - s * sinK;
+		sinVal = s * cosK + c * sinK;
+	}
+
+
+	// calculates the kinematics of a block of events in the same way as
+	// calcEventKinematics() with the BLOCK algorithm; the decay angles
+	// are picked from the random number stream of each event and the
+	// daughter momenta are stored in the block starting at event offset
+	void
+	calcEventKinematicsBlock(const counterBasedRandom&  random,
+	                         const uint64_t*            eventIndices,
+	                         const size_t               nmbEvents,
+	                         const vector<double>&      m,
+	                         const double*              q,
+	                         const TLorentzVector&      nBody,
+	                         nBodyPhaseSpaceEventBlock& block,
+	                         const size_t               offset)
+	{
+		const unsigned int n = m.size();
+		// local arrays are used for the working variables, which the
+		// compiler knows not to alias with the output arrays
+		// Lorentz vectors of (i + 1)-body systems in lab frame
+		double Px[eventBlockSize];
+		double Py[eventBlockSize];
+		double Pz[eventBlockSize];
+		double PE[eventBlockSize];
+		for (size_t j = 0; j < nmbEvents; ++j) {
+			Px[j] = nBody.Px();
+			Py[j] = nBody.Py();
+			Pz[j] = nBody.Pz();
+			PE[j] = nBody.E();
+		}
+		double cosTheta[eventBlockSize];
+		double phi     [eventBlockSize];
+		double cosPhi  [eventBlockSize];
+		double sinPhi  [eventBlockSize];
+		for (unsigned int i = n - 1; i >= 1; --i) {  // loop from n-body down to 2-body
+			for (size_t j = 0; j < nmbEvents; ++j) {
+				random.uniform2(eventIndices[j], anglesCounter + i, cosTheta[j], phi[j]);
+			}
+			for (size_t j = 0; j < nmbEvents; ++j) {
+				cosSinTwoPi(phi[j], cosPhi[j], sinPhi[j]);  // phi in range [0, 2 pi]
+			}
+			const double  m2 = m[i] * m[i];
+			const double* qi = q + i * nmbEvents;
+			double*       px = &block.px[i * block.nmbEvents + offset];
+			double*       py = &block.py[i * block.nmbEvents + offset];
+			double*       pz = &block.pz[i * block.nmbEvents + offset];
+			double*       E  = &block.E [i * block.nmbEvents + offset];
+			for (size_t j = 0; j < nmbEvents; ++j) {
+				// construct Lorentz vector of daughter m[i] in (i + 1)-body RF
+				const double cT  = 2 * cosTheta[j] - 1;  // range [-1, 1]
+				const double pT  = qi[j] * sqrt(1 - cT * cT);
+				const double dx  = pT * cosPhi[j];
+				const double dy  = pT * sinPhi[j];
+				const double dz  = qi[j] * cT;
+				const double dE  = sqrt(m2 + qi[j] * qi[j]);
+				// boost daughter into lab frame
+				const double bx     = Px[j] / PE[j];
+				const double by     = Py[j] / PE[j];
+				const double bz     = Pz[j] / PE[j];
+				const double b2     = bx * bx + by * by + bz * bz;
+				const double gamma  = 1 / sqrt(1 - b2);
+				const double bp     = bx * dx + by * dy + bz * dz;
+				const double gamma2 = gamma * gamma / (gamma + 1);  // = (gamma - 1) / beta^2, but also defined for beta = 0
+				const double f      = gamma2 * bp + gamma * dE;
+				px[j] = dx + f * bx;
+				py[j] = dy + f * by;
+				pz[j] = dz + f * bz;
+				E [j] = gamma * (dE + bp);
+				// calculate Lorentz vector of i-body system in lab frame
+				Px[j] -= px[j];
+				Py[j] -= py[j];
+				Pz[j] -= pz[j];
+				PE[j] -= E [j];
+			}
+		}
+		// set last daughter
+		copy(Px, Px + nmbEvents, block.px.begin() + offset);
+		copy(Py, Py + nmbEvents, block.py.begin() + offset);
+		copy(Pz, Pz + nmbEvents, block.pz.begin() + offset);
+		copy(PE, PE + nmbEvents, block.E.begin()  + offset);
+	}
+
+}
+
+
+void
+nBodyPhaseSpaceEventBlock::resize(const unsigned int nmbDaughters,
+                                  const size_t       nmbEvents)
+{
+	this->nmbDaughters = nmbDaughters;
+	this->nmbEvents    = nmbEvents;
+	eventIndices.resize(nmbEvents);
+	weights.resize     (nmbEvents);
+	px.resize(nmbDaughters * nmbEvents);
+	py.resize(nmbDaughters * nmbEvents);
+	pz.resize(nmbDaughters * nmbEvents);
+	E.resize (nmbDaughters * nmbEvents);
+}
+
+
 nBodyPhaseSpaceGenerator::nBodyPhaseSpaceGenerator()
-	: _maxWeight(0)
+	: _maxWeight(0),
+	  _random   (0)
 { }
 
 
@@ -99,6 +386,137 @@ nBodyPhaseSpaceGenerator::generateDecayAccepted(const TLorentzVector& nBody,
 }
 
 
+// generates block of events with certain n-body mass and momentum
+// in a first pass the effective masses and weights of all events are
+// calculated and the hit-miss MC is applied; the kinematics are then
+// calculated only for the accepted events
+bool
+nBodyPhaseSpaceGenerator::generateDecays(const TLorentzVector&      nBody,            // Lorentz vector of n-body system in lab frame
+                                         const size_t               nmbEvents,        // number of events to generate (before hit-miss MC)
+                                         nBodyPhaseSpaceEventBlock& block,            // generated events
+                                         const uint64_t             seed,             // seed of random number stream
+                                         const uint64_t             firstEventIndex,  // index of first event in random number stream
+                                         const bool                 accepted,
+                                         const double               maxWeight,        // if positive, given value is used as maximum weight, otherwise _maxWeight
+                                         const unsigned int         nmbThreads) const
+{
+	const unsigned int n         = nmbOfDaughters();
+	const double       nBodyMass = nBody.M();
+	block.resize(n, 0);
+	if (n < 2) {
+		printWarn << "number of daughter particles = " << n << " is smaller than 2. no events generated." << endl;
+		return false;
+	} else if (nBodyMass < sumOfDaughterMasses(n - 1)) {
+		printWarn << "n-body mass = " << nBodyMass << " is smaller than sum of daughter masses = "
+			<< sumOfDaughterMasses(n - 1) << ". no events generated." << endl;
+		return false;
+	} else if (weightType() == NUPHAZ) {
+		printWarn << "NUPHAZ weight is not supported for the generation of blocks of events. no events generated." << endl;
+		return false;
+	}
+	const bool   hitMiss = accepted and (weightType() != FLAT);
+	const double max     = (maxWeight <= 0) ? _maxWeight : maxWeight;
+	if (hitMiss and (max <= 0)) {
+		printErr << "maximum weight = " << max << " does not make sense. no events generated." << endl;
+		return false;
+	}
+
+	const counterBasedRandom random(seed);
+	vector<double> m   (n);
+	vector<double> mSum(n);
+	for (unsigned int i = 0; i < n; ++i) {
+		m   [i] = daughterMass(i);
+		mSum[i] = sumOfDaughterMasses(i);
+	}
+
+	// first pass: effective masses, breakup momenta, and weights; the
+	// breakup momenta of the accepted events are stored as [event][i - 1]
+	const unsigned int nmbEvtChunks = nmbChunks(nmbEvents, nmbThreadsToUse(nmbThreads));
+	vector<vector<uint64_t> > chunkEventIndices(nmbEvtChunks);
+	vector<vector<double> >   chunkWeights     (nmbEvtChunks);
+	vector<vector<double> >   chunkBreakupMoms (nmbEvtChunks);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbEvtChunks) schedule(static, 1)
+#endif
+	for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk) {
+		size_t evtBegin, evtEnd;
+		chunkRange(nmbEvents, nmbEvtChunks, iChunk, evtBegin, evtEnd);
+		vector<uint64_t>& acceptedEventIndices = chunkEventIndices[iChunk];
+		vector<double>&   acceptedWeights      = chunkWeights     [iChunk];
+		vector<double>&   acceptedBreakupMoms  = chunkBreakupMoms [iChunk];
+		acceptedEventIndices.resize(evtEnd - evtBegin);
+		acceptedWeights.resize     (evtEnd - evtBegin);
+		acceptedBreakupMoms.resize ((evtEnd - evtBegin) * (n - 1));
+		size_t nmbAccepted = 0;
+		vector<uint64_t> eventIndices(eventBlockSize);
+		vector<double>   M           (n * eventBlockSize);
+		vector<double>   q           (n * eventBlockSize);
+		vector<double>   weights     (eventBlockSize);
+		vector<double>   r           (eventBlockSize, 0);
+		for (size_t blockBegin = evtBegin; blockBegin < evtEnd; blockBegin += eventBlockSize) {
+			const size_t nmbBlockEvents = min(eventBlockSize, evtEnd - blockBegin);
+			for (size_t j = 0; j < nmbBlockEvents; ++j) {
+				eventIndices[j] = firstEventIndex + blockBegin + j;
+			}
+			pickMassesBlock (random, &eventIndices[0], nmbBlockEvents, mSum, nBodyMass, &M[0]);
+			calcWeightsBlock(*this, nBodyMass, nmbBlockEvents, &M[0], &q[0], &weights[0]);
+			if (hitMiss) {
+				double unused;
+				for (size_t j = 0; j < nmbBlockEvents; ++j) {
+					random.uniform2(eventIndices[j], acceptanceCounter, r[j], unused);
+				}
+			}
+			for (size_t j = 0; j < nmbBlockEvents; ++j) {
+				if (hitMiss and not ((weights[j] / max) > r[j])) {
+					continue;
+				}
+				acceptedEventIndices[nmbAccepted] = eventIndices[j];
+				acceptedWeights     [nmbAccepted] = weights[j];
+				for (unsigned int i = 1; i < n; ++i) {
+					acceptedBreakupMoms[nmbAccepted * (n - 1) + (i - 1)] = q[i * nmbBlockEvents + j];
+				}
+				++nmbAccepted;
+			}
+		}
+		acceptedEventIndices.resize(nmbAccepted);
+		acceptedWeights.resize     (nmbAccepted);
+		acceptedBreakupMoms.resize (nmbAccepted * (n - 1));
+	}
+
+	// the accepted events of the chunks are stored in chunk order
+	vector<size_t> chunkOffsets(nmbEvtChunks, 0);
+	size_t nmbAccepted = 0;
+	for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk) {
+		chunkOffsets[iChunk] = nmbAccepted;
+		nmbAccepted         += chunkEventIndices[iChunk].size();
+	}
+	block.resize(n, nmbAccepted);
+
+	// second pass: decay angles and event kinematics of accepted events
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbEvtChunks) schedule(static, 1)
+#endif
+	for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk) {
+		const size_t nmbChunkEvents = chunkEventIndices[iChunk].size();
+		copy(chunkEventIndices[iChunk].begin(), chunkEventIndices[iChunk].end(), block.eventIndices.begin() + chunkOffsets[iChunk]);
+		copy(chunkWeights     [iChunk].begin(), chunkWeights     [iChunk].end(), block.weights.begin()      + chunkOffsets[iChunk]);
+		vector<double> q(n * eventBlockSize, 0);
+		for (size_t blockBegin = 0; blockBegin < nmbChunkEvents; blockBegin += eventBlockSize) {
+			const size_t nmbBlockEvents = min(eventBlockSize, nmbChunkEvents - blockBegin);
+			for (size_t j = 0; j < nmbBlockEvents; ++j) {
+				for (unsigned int i = 1; i < n; ++i) {
+					q[i * nmbBlockEvents + j] = chunkBreakupMoms[iChunk][(blockBegin + j) * (n - 1) + (i - 1)];
+				}
+			}
+			calcEventKinematicsBlock(random, &chunkEventIndices[iChunk][blockBegin], nmbBlockEvents, m, &q[0],
+			                         nBody, block, chunkOffsets[iChunk] + blockBegin);
+		}
+	}
+
+	return true;
+}
+
+
 // randomly choses the (n - 2) effective masses of the respective (i + 1)-body systems
 void
 nBodyPhaseSpaceGenerator::pickMasses(const double nBodyMass)  // total energy of the system in its RF
@@ -125,11 +543,10 @@ nBodyPhaseSpaceGenerator::pickMasses(const double nBodyMass)  // total energy of
 					const double prob   = 1 / (i - (i - 1) * deltaX / term);                                          // cf. eq. (20)
 					// 2) calculate generator for distribution
 					double x;
-					randomNumberGenerator* random = randomNumberGenerator::instance();
-					if (random->rndm() < prob) {
-						x = xMin + deltaX * pow(random->rndm(), 1 / (double)i) * pow(random->rndm(), 1 / (double)(i - 1));  // cf. eq. (21)
+					if (rndm() < prob) {
+						x = xMin + deltaX * pow(rndm(), 1 / (double)i) * pow(rndm(), 1 / (double)(i - 1));  // cf. eq. (21)
 					} else {
-						x = xMin + deltaX * pow(random->rndm(), 1 / (double)i);                                             // cf. eq. (22)
+						x = xMin + deltaX * pow(rndm(), 1 / (double)i);                                     // cf. eq. (22)
 					}
 					// 3) set effective isobar mass of i-body using x_i = _M(i - 1)^2 / _Mi^2
 					_M[i - 1] = _M[i] * sqrt(x);
@@ -143,7 +560,7 @@ nBodyPhaseSpaceGenerator::pickMasses(const double nBodyMass)  // total energy of
 				bool done = false;
 				do {
 					for (unsigned int i = 0; i < (nmbOfDaughters() - 2); ++i) {
-						r[i] = randomNumberGenerator::instance()->rndm();
+						r[i] = rndm();
 					}
 					sort(r.begin(), r.end());
 					// random numbers must be strictly increasing, no number may appear twice
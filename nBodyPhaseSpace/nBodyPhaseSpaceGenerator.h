@@ -39,6 +39,8 @@
 #include <iostream>
 #include <vector>
 
+#include <stdint.h>
+
 #include <TLorentzVector.h>
 
 #ifndef __CINT__
@@ -53,6 +55,35 @@
 namespace rpwa {
 
 
+	/// \brief block of events generated by nBodyPhaseSpaceGenerator::generateDecays()
+	/// the momentum components are stored as structure of arrays; the
+	/// component of daughter i in event j is at index (i * nmbEvents + j)
+	struct nBodyPhaseSpaceEventBlock {
+
+		nBodyPhaseSpaceEventBlock() : nmbDaughters(0), nmbEvents(0) { }
+
+		unsigned int          nmbDaughters;
+		size_t                nmbEvents;
+		std::vector<uint64_t> eventIndices;  ///< indices of the events in the random number stream
+		std::vector<double>   weights;       ///< phase-space weights of the events
+		std::vector<double>   px;
+		std::vector<double>   py;
+		std::vector<double>   pz;
+		std::vector<double>   E;
+
+		void resize(const unsigned int nmbDaughters,
+		            const size_t       nmbEvents);
+
+		TLorentzVector daughter(const unsigned int iDaughter,
+		                        const size_t       iEvent) const
+		{
+			const size_t i = iDaughter * nmbEvents + iEvent;
+			return TLorentzVector(px[i], py[i], pz[i], E[i]);
+		}
+
+	};
+
+
 	class nBodyPhaseSpaceGenerator : public nBodyPhaseSpaceKinematics {
 
 	public:
@@ -69,6 +100,24 @@ namespace rpwa {
 		bool   generateDecayAccepted(const TLorentzVector& nBody,           // Lorentz vector of n-body system in lab frame
 		                             const double          maxWeight = 0);  // if positive, given value is used as maximum weight, otherwise _maxWeight
 
+		/// \brief generates block of events with certain n-body mass and momentum
+		/// event i is the event with index (firstEventIndex + i) in the stream of
+		/// a counter-based random number generator with the given seed, so that
+		/// the same events are obtained independent of how the stream is split
+		/// into blocks and of the number of threads; the function does not
+		/// change the state of the generator and can be called concurrently
+		/// if accepted is true, the events are weighted in form of hit-miss MC
+		/// and only the accepted ones are stored in the block; the NUPHAZ
+		/// weight is not supported; returns false in case of errors
+		bool generateDecays(const TLorentzVector&      nBody,                // Lorentz vector of n-body system in lab frame
+		                    const size_t               nmbEvents,            // number of events to generate (before hit-miss MC)
+		                    nBodyPhaseSpaceEventBlock& block,                // generated events
+		                    const uint64_t             seed,                 // seed of random number stream
+		                    const uint64_t             firstEventIndex = 0,  // index of first event in random number stream
+		                    const bool                 accepted        = false,
+		                    const double               maxWeight       = 0,  // if positive, given value is used as maximum weight, otherwise _maxWeight
+		                    const unsigned int         nmbThreads      = 1) const;  // 0 means all available threads
+
 
 		//----------------------------------------------------------------------------
 		// low-level generator interface
@@ -84,6 +133,11 @@ namespace rpwa {
 		void   setMaxWeight          (const double maxWeight) { _maxWeight = maxWeight;    }  ///< sets maximum weight used for hit-miss MC
 		double maxWeight             () const                 { return _maxWeight;         }  ///< returns maximum weight used for hit-miss MC
 
+		/// sets random number generator used by this instance; if 0 (default), the global randomNumberGenerator is used
+		/// the generator is not owned by this instance; independent instances with their own generators can be used in parallel
+		void      setRandomNumberGenerator(TRandom3* random) { _random = random; }
+		TRandom3* randomGenerator         () const           { return _random;   }  ///< returns random number generator set for this instance; 0 if the global one is used
+
 		/// estimates maximum weight for given n-body mass
 		double estimateMaxWeight(const double       nBodyMass,                 // sic!
 		                         const unsigned int nmbOfIterations = 10000);  // number of generated events
@@ -100,8 +154,11 @@ namespace rpwa {
 
 	private:
 
+		inline double rndm() const;  ///< returns uniform random number in ]0, 1] from the generator of this instance
+
 		// internal variables
-		double _maxWeight;  ///< maximum weight used to weight events in hit-miss MC
+		double    _maxWeight;  ///< maximum weight used to weight events in hit-miss MC
+		TRandom3* _random;     //! random number generator of this instance; if 0, the global randomNumberGenerator is used
 
 		ClassDef(nBodyPhaseSpaceGenerator, 1)
 
@@ -110,14 +167,21 @@ namespace rpwa {
 }  // namespace rpwa
 
 
+inline
+double
+rpwa::nBodyPhaseSpaceGenerator::rndm() const
+{
+	return (_random) ? _random->Rndm() : randomNumberGenerator::instance()->rndm();
+}
+
+
 inline
 void
 rpwa::nBodyPhaseSpaceGenerator::pickAngles()
 {
-	randomNumberGenerator* random = randomNumberGenerator::instance();
 	for (unsigned int i = 1; i < nmbOfDaughters(); ++i) {  // loop over 2- to n-bodies
-		_cosTheta[i] = 2 * random->rndm() - 1;  // range [-1,    1]
-		_phi[i]      = rpwa::twoPi * random->rndm();  // range [ 0, 2 pi]
+		_cosTheta[i] = 2 * rndm() - 1;  // range [-1,    1]
+		_phi[i]      = rpwa::twoPi * rndm();  // range [ 0, 2 pi]
 	}
 }
 
@@ -133,7 +197,7 @@ rpwa::nBodyPhaseSpaceGenerator::eventAccepted(const double maxWeight)  // if max
 		printErr << "maximum weight = " << max << " does not make sense. rejecting event." << std::endl;
 		return false;
 	}
-	if ((eventWeight() / max) > randomNumberGenerator::instance()->rndm())
+	if ((eventWeight() / max) > rndm())
 		return true;
 	return false;
 }
@@ -0,0 +1,437 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      implementation of the vectorized likelihood kernels
+//      see likelihoodSimdKernels.h for details
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include "likelihoodSimdKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+// generate AVX-512, AVX2, and baseline versions of the kernels and
+// dispatch at load time via GNU indirect functions
+#if defined(__GNUC__) and not defined(__clang__) and (__GNUC__ >= 6) and defined(__x86_64__) and defined(__linux__)
+#define RPWA_SIMD_MULTIVERSIONED
+#define RPWA_SIMD_TARGET_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define RPWA_SIMD_TARGET_CLONES
+#endif
+
+#ifdef __GNUC__
+#define RPWA_SIMD_INLINE inline __attribute__((always_inline))
+#define RPWA_RESTRICT    __restrict__
+#else
+#define RPWA_SIMD_INLINE inline
+#define RPWA_RESTRICT
+#endif
+
+
+using namespace std;
+using namespace rpwa;
+
+
+namespace {
+
+
+	// adds term to compensated (Kahan) sum
+	template<typename T>
+	RPWA_SIMD_INLINE
+	void
+	kahanAdd(T&      sum,
+	         T&      compensation,
+	         const T term)
+	{
+		const T y = term - compensation;
+		const T t = sum + y;
+		compensation = (t - sum) - y;
+		sum          = t;
+	}
+
+
+	// adds up lane sums in lane order with compensation
+	template<typename T, unsigned int nmbLanes>
+	RPWA_SIMD_INLINE
+	T
+	reduceLanes(const T* sum,
+	            const T* compensation)
+	{
+		T laneSum = 0;
+		T laneComp = 0;
+		for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane)
+			kahanAdd(laneSum, laneComp, sum[iLane] - compensation[iLane]);
+		return laneSum - laneComp;
+	}
+
+
+	// calculates the coherent sums over waves for all ranks and
+	// reflectivities and the resulting intensities for one event block
+	// the decay amplitudes are stored with type storageT and converted
+	// to the arithmetic type T when they are loaded
+	template<typename T, typename storageT>
+	RPWA_SIMD_INLINE
+	void
+	blockIntensities(const simd::decayAmpsSoA<storageT>& decayAmps,
+	                 const complex<T>*                   prodAmps,
+	                 const unsigned int                  rank,
+	                 const unsigned int                  maxNmbWaves,
+	                 const T                             prodAmpFlat2,
+	                 const size_t                        iBlock,
+	                 T* RPWA_RESTRICT                    ampProdSums,  // [rank][reflectivity][re/im][lane]
+	                 T* RPWA_RESTRICT                    intensities)  // [lane]
+	{
+		const unsigned int nmbLanes = simd::decayAmpsSoA<storageT>::nmbLanes;
+		for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane)
+			intensities[iLane] = prodAmpFlat2;
+		for (unsigned int iRank = 0; iRank < rank; ++iRank)  // incoherent sum over ranks
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+				T* RPWA_RESTRICT  ampProdRe = ampProdSums + (iRank * 2 + iRefl) * 2 * nmbLanes;
+				T* RPWA_RESTRICT  ampProdIm = ampProdRe + nmbLanes;
+				const complex<T>* prodAmp   = prodAmps + (iRank * 2 + iRefl) * maxNmbWaves;
+				for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+					ampProdRe[iLane] = 0;
+					ampProdIm[iLane] = 0;
+				}
+				for (unsigned int iWave = 0; iWave < decayAmps.nmbWaves(iRefl); ++iWave) {  // coherent sum over waves
+					const storageT* RPWA_RESTRICT decayAmpRe = decayAmps.block(iRefl, iBlock, iWave);
+					const storageT* RPWA_RESTRICT decayAmpIm = decayAmpRe + nmbLanes;
+					const T prodAmpRe = prodAmp[iWave].real();
+					const T prodAmpIm = prodAmp[iWave].imag();
+					for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+						ampProdRe[iLane] += prodAmpRe * decayAmpRe[iLane] - prodAmpIm * decayAmpIm[iLane];
+						ampProdIm[iLane] += prodAmpRe * decayAmpIm[iLane] + prodAmpIm * decayAmpRe[iLane];
+					}
+				}
+				for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane)
+					intensities[iLane] += ampProdRe[iLane] * ampProdRe[iLane] + ampProdIm[iLane] * ampProdIm[iLane];
+			}
+	}
+
+
+	template<typename T, typename storageT>
+	RPWA_SIMD_INLINE
+	T
+	logLikelihoodImpl(const simd::decayAmpsSoA<storageT>& decayAmps,
+	                  const complex<T>*                   prodAmps,
+	                  const unsigned int                  rank,
+	                  const unsigned int                  maxNmbWaves,
+	                  const T                             prodAmpFlat2,
+	                  const size_t                        blockBegin,
+	                  const size_t                        blockEnd)
+	{
+		const unsigned int nmbLanes  = simd::decayAmpsSoA<storageT>::nmbLanes;
+		const size_t       nmbEvents = decayAmps.nmbEvents();
+		vector<T> ampProdSums(rank * 2 * 2 * nmbLanes);
+		T intensities      [nmbLanes];
+		T logLikelihoodSum [nmbLanes];
+		T logLikelihoodComp[nmbLanes];
+		for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+			logLikelihoodSum [iLane] = 0;
+			logLikelihoodComp[iLane] = 0;
+		}
+		for (size_t iBlock = blockBegin; iBlock < blockEnd; ++iBlock) {
+			blockIntensities(decayAmps, prodAmps, rank, maxNmbWaves, prodAmpFlat2, iBlock, ampProdSums.data(), intensities);
+			// padded events are not taken into account
+			for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane)
+				kahanAdd(logLikelihoodSum[iLane], logLikelihoodComp[iLane],
+				         (iBlock * nmbLanes + iLane < nmbEvents) ? -log(intensities[iLane]) : (T)0);
+		}
+		return reduceLanes<T, nmbLanes>(logLikelihoodSum, logLikelihoodComp);
+	}
+
+
+	template<typename T, typename storageT>
+	RPWA_SIMD_INLINE
+	void
+	logLikelihoodDerivImpl(const simd::decayAmpsSoA<storageT>& decayAmps,
+	                       const complex<T>*                   prodAmps,
+	                       const unsigned int                  rank,
+	                       const unsigned int                  maxNmbWaves,
+	                       const T                             prodAmpFlat,
+	                       const size_t                        blockBegin,
+	                       const size_t                        blockEnd,
+	                       T&                                  logLikelihood,
+	                       complex<T>*                         derivatives,
+	                       T&                                  derivativeFlat)
+	{
+		const unsigned int nmbLanes     = simd::decayAmpsSoA<storageT>::nmbLanes;
+		const size_t       nmbEvents    = decayAmps.nmbEvents();
+		const T            prodAmpFlat2 = prodAmpFlat * prodAmpFlat;
+		const size_t       nmbDerivs    = rank * 2 * maxNmbWaves;
+		vector<T> ampProdSums(rank * 2 * 2 * nmbLanes);
+		// lane sums and compensations for derivatives [rank][reflectivity][wave index][re/im][sum/compensation][lane]
+		vector<T> derivativeAcc(nmbDerivs * 2 * 2 * nmbLanes, 0);
+		T intensities       [nmbLanes];
+		T factors           [nmbLanes];
+		T logLikelihoodSum  [nmbLanes];
+		T logLikelihoodComp [nmbLanes];
+		T derivativeFlatSum [nmbLanes];
+		T derivativeFlatComp[nmbLanes];
+		for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+			logLikelihoodSum  [iLane] = 0;
+			logLikelihoodComp [iLane] = 0;
+			derivativeFlatSum [iLane] = 0;
+			derivativeFlatComp[iLane] = 0;
+		}
+		for (size_t iBlock = blockBegin; iBlock < blockEnd; ++iBlock) {
+			blockIntensities(decayAmps, prodAmps, rank, maxNmbWaves, prodAmpFlat2, iBlock, ampProdSums.data(), intensities);
+			// incorporate factor -2 / sigma; padded events get a factor of zero
+			for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+				const bool validEvent = (iBlock * nmbLanes + iLane < nmbEvents);
+				kahanAdd(logLikelihoodSum[iLane], logLikelihoodComp[iLane],
+				         validEvent ? -log(intensities[iLane]) : (T)0);
+				factors[iLane] = validEvent ? -2 / intensities[iLane] : (T)0;
+				kahanAdd(derivativeFlatSum[iLane], derivativeFlatComp[iLane], factors[iLane] * prodAmpFlat);
+			}
+			for (unsigned int iRank = 0; iRank < rank; ++iRank)
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
+					// scale amplitude sums for current rank and reflectivity by factor
+					T scaledAmpProdRe[nmbLanes];
+					T scaledAmpProdIm[nmbLanes];
+					const T* RPWA_RESTRICT ampProdRe = ampProdSums.data() + (iRank * 2 + iRefl) * 2 * nmbLanes;
+					const T* RPWA_RESTRICT ampProdIm = ampProdRe + nmbLanes;
+					for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+						scaledAmpProdRe[iLane] = factors[iLane] * ampProdRe[iLane];
+						scaledAmpProdIm[iLane] = factors[iLane] * ampProdIm[iLane];
+					}
+					// multiply with complex conjugate of decay amplitude of the wave with the derivative wave index
+					for (unsigned int iWave = 0; iWave < decayAmps.nmbWaves(iRefl); ++iWave) {
+						const storageT* RPWA_RESTRICT decayAmpRe = decayAmps.block(iRefl, iBlock, iWave);
+						const storageT* RPWA_RESTRICT decayAmpIm = decayAmpRe + nmbLanes;
+						T* RPWA_RESTRICT derivReSum  = &derivativeAcc[((iRank * 2 + iRefl) * maxNmbWaves + iWave) * 4 * nmbLanes];
+						T* RPWA_RESTRICT derivReComp = derivReSum  + nmbLanes;
+						T* RPWA_RESTRICT derivImSum  = derivReComp + nmbLanes;
+						T* RPWA_RESTRICT derivImComp = derivImSum  + nmbLanes;
+						for (unsigned int iLane = 0; iLane < nmbLanes; ++iLane) {
+							kahanAdd(derivReSum[iLane], derivReComp[iLane],
+							         scaledAmpProdRe[iLane] * decayAmpRe[iLane] + scaledAmpProdIm[iLane] * decayAmpIm[iLane]);
+							kahanAdd(derivImSum[iLane], derivImComp[iLane],
+							         scaledAmpProdIm[iLane] * decayAmpRe[iLane] - scaledAmpProdRe[iLane] * decayAmpIm[iLane]);
+						}
+					}
+				}
+		}
+		logLikelihood  = reduceLanes<T, nmbLanes>(logLikelihoodSum,  logLikelihoodComp );
+		derivativeFlat = reduceLanes<T, nmbLanes>(derivativeFlatSum, derivativeFlatComp);
+		for (size_t iDeriv = 0; iDeriv < nmbDerivs; ++iDeriv) {
+			const T* acc = &derivativeAcc[iDeriv * 4 * nmbLanes];
+			derivatives[iDeriv] = complex<T>(reduceLanes<T, nmbLanes>(acc,                acc +     nmbLanes),
+			                                 reduceLanes<T, nmbLanes>(acc + 2 * nmbLanes, acc + 3 * nmbLanes));
+		}
+	}
+
+
+	// the tile buffer is processed row by row; for each vector the
+	// innermost loop runs over contiguous columns of one row, so that it
+	// is vectorized without reassociation of floating-point operations
+	template<typename T>
+	RPWA_SIMD_INLINE
+	void
+	addWeightedOuterProductsImpl(const T*           vectors,
+	                             const T*           weights,
+	                             const size_t       nmbVectors,
+	                             const unsigned int dim,
+	                             const unsigned int rowBegin,
+	                             const unsigned int rowEnd,
+	                             const unsigned int colBegin,
+	                             const unsigned int colEnd,
+	                             T*                 sum,
+	                             T*                 compensation,
+	                             T*                 tile)
+	{
+		const unsigned int nmbCols = colEnd - colBegin;
+		fill(tile, tile + (rowEnd - rowBegin) * nmbCols, (T)0);
+		for (size_t iVector = 0; iVector < nmbVectors; ++iVector) {
+			const T* RPWA_RESTRICT vec  = vectors + iVector * dim;
+			const T* RPWA_RESTRICT cols = vec + colBegin;
+			for (unsigned int iRow = rowBegin; iRow < rowEnd; ++iRow) {
+				const T weightedRow = weights[iVector] * vec[iRow];
+				T* RPWA_RESTRICT tileRow = &tile[(iRow - rowBegin) * nmbCols];
+				for (unsigned int iCol = 0; iCol < nmbCols; ++iCol)
+					tileRow[iCol] += weightedRow * cols[iCol];
+			}
+		}
+		for (unsigned int iRow = rowBegin; iRow < rowEnd; ++iRow) {
+			const T* tileRow = &tile[(iRow - rowBegin) * nmbCols];
+			for (unsigned int iCol = 0; iCol < nmbCols; ++iCol)
+				kahanAdd(sum[iRow * dim + colBegin + iCol], compensation[iRow * dim + colBegin + iCol], tileRow[iCol]);
+		}
+	}
+
+
+}  // anonymous namespace
+
+
+string
+simd::instructionSet()
+{
+#ifdef RPWA_SIMD_MULTIVERSIONED
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		return "AVX-512";
+	if (__builtin_cpu_supports("avx2"))
+		return "AVX2";
+#endif
+	return "baseline";
+}
+
+
+RPWA_SIMD_TARGET_CLONES
+double
+simd::logLikelihood(const decayAmpsSoA<double>& decayAmps,
+                    const complex<double>*      prodAmps,
+                    const unsigned int          rank,
+                    const unsigned int          maxNmbWaves,
+                    const double                prodAmpFlat2,
+                    const size_t                blockBegin,
+                    const size_t                blockEnd)
+{
+	return logLikelihoodImpl(decayAmps, prodAmps, rank, maxNmbWaves, prodAmpFlat2, blockBegin, blockEnd);
+}
+
+
+RPWA_SIMD_TARGET_CLONES
+float
+simd::logLikelihood(const decayAmpsSoA<float>& decayAmps,
+                    const complex<float>*      prodAmps,
+                    const unsigned int         rank,
+                    const unsigned int         maxNmbWaves,
+                    const float                prodAmpFlat2,
+                    const size_t               blockBegin,
+                    const size_t               blockEnd)
+{
+	return logLikelihoodImpl(decayAmps, prodAmps, rank, maxNmbWaves, prodAmpFlat2, blockBegin, blockEnd);
+}
+
+
+RPWA_SIMD_TARGET_CLONES
+double
+simd::logLikelihood(const decayAmpsSoA<float>& decayAmps,
+                    const complex<double>*     prodAmps,
+                    const unsigned int         rank,
+                    const unsigned int         maxNmbWaves,
+                    const double               prodAmpFlat2,
+                    const size_t               blockBegin,
+                    const size_t               blockEnd)
+{
+	return logLikelihoodImpl(decayAmps, prodAmps, rank, maxNmbWaves, prodAmpFlat2, blockBegin, blockEnd);
+}
+
+
+RPWA_SIMD_TARGET_CLONES
+void
+simd::logLikelihoodDeriv(const decayAmpsSoA<double>& decayAmps,
+                         const complex<double>*      prodAmps,
+                         const unsigned int          rank,
+                         const unsigned int          maxNmbWaves,
+                         const double                prodAmpFlat,
+                         const size_t                blockBegin,
+                         const size_t                blockEnd,
+                         double&                     logLikelihood,
+                         complex<double>*            derivatives,
+                         double&                     derivativeFlat)
+{
+	logLikelihoodDerivImpl(decayAmps, prodAmps, rank, maxNmbWaves, prodAmpFlat, blockBegin, blockEnd,
+	                       logLikelihood, derivatives, derivativeFlat);
+}
+
+
+RPWA_SIMD_TARGET_CLONES
+void
+simd::logLikelihoodDeriv(const decayAmpsSoA<float>& decayAmps,
+                         const complex<float>*      prodAmps,
+                         const unsigned int         rank,
+                         const unsigned int         maxNmbWaves,
+                         const float                prodAmpFlat,
+                         const size_t               blockBegin,
+                         const size_t               blockEnd,
+                         float&                     logLikelihood,
+                         complex<float>*            derivatives,
+                         float&                     derivativeFlat)
+{
+	logLikelihoodDerivImpl(decayAmps, prodAmps, rank, maxNmbWaves, prodAmpFlat, blockBegin, blockEnd,
+	                       logLikelihood, derivatives, derivativeFlat);
+}
+
+
+RPWA_SIMD_TARGET_CLONES
+void
+simd::logLikelihoodDeriv(const decayAmpsSoA<float>& decayAmps,
+                         const complex<double>*     prodAmps,
+                         const unsigned int         rank,
+                         const unsigned int         maxNmbWaves,
+                         const double               prodAmpFlat,
+                         const size_t               blockBegin,
+                         const size_t               blockEnd,
+                         double&                    logLikelihood,
+                         complex<double>*           derivatives,
+                         double&                    derivativeFlat)
+{
+	logLikelihoodDerivImpl(decayAmps, prodAmps, rank, maxNmbWaves, prodAmpFlat, blockBegin, blockEnd,
+	                       logLikelihood, derivatives, derivativeFlat);
+}
+
+
+RPWA_SIMD_TARGET_CLONES
+void
+simd::addWeightedOuterProducts(const double*      vectors,
+                               const double*      weights,
+                               const size_t       nmbVectors,
+                               const unsigned int dim,
+                               const unsigned int rowBegin,
+                               const unsigned int rowEnd,
+                               const unsigned int colBegin,
+                               const unsigned int colEnd,
+                               double*            sum,
+                               double*            compensation,
+                               double*            tile)
+{
+	addWeightedOuterProductsImpl(vectors, weights, nmbVectors, dim, rowBegin, rowEnd, colBegin, colEnd, sum, compensation, tile);
+}
+
+
+RPWA_SIMD_TARGET_CLONES
+void
+simd::addWeightedOuterProducts(const float*       vectors,
+                               const float*       weights,
+                               const size_t       nmbVectors,
+                               const unsigned int dim,
+                               const unsigned int rowBegin,
+                               const unsigned int rowEnd,
+                               const unsigned int colBegin,
+                               const unsigned int colEnd,
+                               float*             sum,
+                               float*             compensation,
+                               float*             tile)
+{
+	addWeightedOuterProductsImpl(vectors, weights, nmbVectors, dim, rowBegin, rowEnd, colBegin, colEnd, sum, compensation, tile);
+}
@@ -0,0 +1,252 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      vectorized CPU kernels for the real-data term of the extended
+//      log likelihood, its gradient, and its Hessian
+//
+//      the decay amplitudes are stored in blocks of nmbLanes events
+//      (one cache line per block row); within a block the real and
+//      the imaginary parts of each wave are stored in separate,
+//      64-byte aligned lane vectors:
+//          [reflectivity][event block][wave index][re/im][lane]
+//      the number of events is padded to a multiple of nmbLanes with
+//      zero amplitudes; padded events are masked in the kernels
+//
+//      the kernels process all events of a block in lock step, so that
+//      the innermost loops run over independent lanes and are
+//      vectorized by the compiler without reassociation of
+//      floating-point operations; if supported by the compiler, AVX2
+//      and AVX-512 versions of the kernels are generated and the
+//      version that matches the CPU is selected at load time
+//
+//      precision: the sum over events is compensated (Kahan) in each
+//      lane; the lane sums are added with compensation as well; the
+//      coherent sum over waves is done without compensation, so that
+//      the event intensities may deviate from the fully compensated
+//      sum in pwaLikelihood by at most about nmbWaves * epsilon
+//      relative to the sum of the moduli of the terms; for double
+//      precision and typical wave sets this results in relative
+//      deviations of the log likelihood and its gradient of
+//      O(1e-13) or less
+//
+//      mixed precision: for decay amplitudes stored in single
+//      precision there are kernels that convert the amplitudes to
+//      double precision when loading them and do all arithmetic and
+//      sums in double precision; the amplitudes then carry a relative
+//      rounding error of about 6e-8, but the sums over waves and
+//      events do not lose further precision
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#ifndef LIKELIHOODSIMDKERNELS_H
+#define LIKELIHOODSIMDKERNELS_H
+
+
+#include <complex>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "boost/align/aligned_allocator.hpp"
+
+
+namespace rpwa {
+
+
+	namespace simd {
+
+
+		std::string instructionSet();  ///< returns name of instruction set used by the kernels on this CPU
+
+
+		template<typename T>
+		class decayAmpsSoA {
+
+		public:
+
+			static const unsigned int alignment = 64;                  // alignment of lane vectors in bytes
+			static const unsigned int nmbLanes  = alignment / sizeof(T);  // number of events per block
+
+			decayAmpsSoA()
+				: _nmbEvents(0),
+				  _nmbBlocks(0)
+			{
+				_nmbWaves[0] = 0;
+				_nmbWaves[1] = 0;
+			}
+
+			void resize(const std::size_t  nmbEvents,
+			            const unsigned int nmbWavesRefl[2])  ///< allocates zero-initialized storage
+			{
+				_nmbEvents = nmbEvents;
+				_nmbBlocks = (nmbEvents + nmbLanes - 1) / nmbLanes;
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
+					_nmbWaves[iRefl] = nmbWavesRefl[iRefl];
+					_amps    [iRefl].assign(_nmbBlocks * _nmbWaves[iRefl] * 2 * nmbLanes, 0);
+				}
+			}
+
+			void clear()
+			{
+				const unsigned int nmbWavesRefl[2] = {0, 0};
+				resize(0, nmbWavesRefl);
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+					std::vector<T, boost::alignment::aligned_allocator<T, alignment> >().swap(_amps[iRefl]);
+			}
+
+			void set(const unsigned int        iRefl,
+			         const std::size_t         iEvt,
+			         const unsigned int        iWave,
+			         const std::complex<T>&    amp)
+			{
+				T* block = &_amps[iRefl][((iEvt / nmbLanes) * _nmbWaves[iRefl] + iWave) * 2 * nmbLanes];
+				block[           iEvt % nmbLanes] = amp.real();
+				block[nmbLanes + iEvt % nmbLanes] = amp.imag();
+			}
+
+			std::size_t  nmbEvents()                         const { return _nmbEvents;       }  ///< returns number of events without padding
+			std::size_t  nmbBlocks()                         const { return _nmbBlocks;       }  ///< returns number of event blocks
+			unsigned int nmbWaves (const unsigned int iRefl) const { return _nmbWaves[iRefl]; }  ///< returns number of waves for given reflectivity
+
+			/// returns pointer to real parts of given wave in given event block; imaginary parts follow after nmbLanes elements
+			const T* block(const unsigned int iRefl,
+			               const std::size_t  iBlock,
+			               const unsigned int iWave) const
+			{ return &_amps[iRefl][(iBlock * _nmbWaves[iRefl] + iWave) * 2 * nmbLanes]; }
+
+			std::size_t memoryUsage() const { return (_amps[0].size() + _amps[1].size()) * sizeof(T); }  ///< returns size of amplitude storage in bytes
+
+		private:
+
+			std::size_t  _nmbEvents;    // number of events
+			std::size_t  _nmbBlocks;    // number of event blocks
+			unsigned int _nmbWaves[2];  // number of waves for negative (= 0) and positive (= 1) reflectivity
+			std::vector<T, boost::alignment::aligned_allocator<T, alignment> > _amps[2];  // decay amplitudes [reflectivity][event block][wave index][re/im][lane]
+
+		};
+
+
+		// the production amplitudes are expected in the layout of
+		// pwaLikelihood::prodAmpsArrayType, i.e. [rank][reflectivity][wave index]
+		// with maxNmbWaves entries per reflectivity; all kernels
+		// process the event blocks in the range [blockBegin, blockEnd)
+
+		/// returns sum of -log(intensity) over the events in the given block range
+		double logLikelihood(const decayAmpsSoA<double>&  decayAmps,
+		                     const std::complex<double>*  prodAmps,
+		                     const unsigned int           rank,
+		                     const unsigned int           maxNmbWaves,
+		                     const double                 prodAmpFlat2,
+		                     const std::size_t            blockBegin,
+		                     const std::size_t            blockEnd);
+		float  logLikelihood(const decayAmpsSoA<float>&   decayAmps,
+		                     const std::complex<float>*   prodAmps,
+		                     const unsigned int           rank,
+		                     const unsigned int           maxNmbWaves,
+		                     const float                  prodAmpFlat2,
+		                     const std::size_t            blockBegin,
+		                     const std::size_t            blockEnd);
+		double logLikelihood(const decayAmpsSoA<float>&   decayAmps,  ///< mixed precision: single-precision storage, double-precision arithmetic
+		                     const std::complex<double>*  prodAmps,
+		                     const unsigned int           rank,
+		                     const unsigned int           maxNmbWaves,
+		                     const double                 prodAmpFlat2,
+		                     const std::size_t            blockBegin,
+		                     const std::size_t            blockEnd);
+
+		/// calculates sum of -log(intensity) and its derivatives w.r.t. the real and imaginary parts of the production amplitudes over the events in the given block range
+		/// derivatives has the same layout as prodAmps and is overwritten
+		void logLikelihoodDeriv(const decayAmpsSoA<double>&  decayAmps,
+		                        const std::complex<double>*  prodAmps,
+		                        const unsigned int           rank,
+		                        const unsigned int           maxNmbWaves,
+		                        const double                 prodAmpFlat,
+		                        const std::size_t            blockBegin,
+		                        const std::size_t            blockEnd,
+		                        double&                      logLikelihood,
+		                        std::complex<double>*        derivatives,
+		                        double&                      derivativeFlat);
+		void logLikelihoodDeriv(const decayAmpsSoA<float>&   decayAmps,
+		                        const std::complex<float>*   prodAmps,
+		                        const unsigned int           rank,
+		                        const unsigned int           maxNmbWaves,
+		                        const float                  prodAmpFlat,
+		                        const std::size_t            blockBegin,
+		                        const std::size_t            blockEnd,
+		                        float&                       logLikelihood,
+		                        std::complex<float>*         derivatives,
+		                        float&                       derivativeFlat);
+		void logLikelihoodDeriv(const decayAmpsSoA<float>&   decayAmps,  ///< mixed precision: single-precision storage, double-precision arithmetic
+		                        const std::complex<double>*  prodAmps,
+		                        const unsigned int           rank,
+		                        const unsigned int           maxNmbWaves,
+		                        const double                 prodAmpFlat,
+		                        const std::size_t            blockBegin,
+		                        const std::size_t            blockEnd,
+		                        double&                      logLikelihood,
+		                        std::complex<double>*        derivatives,
+		                        double&                      derivativeFlat);
+
+		/// adds sum_e weights[e] * vectors[e][row] * vectors[e][col] over the given number of vectors
+		/// to the tile [rowBegin, rowEnd) x [colBegin, colEnd) of the dim x dim row-major matrix sum
+		/// the vectors are stored consecutively with dim components each; the products of all
+		/// vectors are summed up in the caller-provided buffer tile of at least
+		/// (rowEnd - rowBegin) * (colEnd - colBegin) elements first, which is then added to sum
+		/// with compensation; compensation holds the compensation terms with the same layout as sum
+		void addWeightedOuterProducts(const double*      vectors,
+		                              const double*      weights,
+		                              const std::size_t  nmbVectors,
+		                              const unsigned int dim,
+		                              const unsigned int rowBegin,
+		                              const unsigned int rowEnd,
+		                              const unsigned int colBegin,
+		                              const unsigned int colEnd,
+		                              double*            sum,
+		                              double*            compensation,
+		                              double*            tile);
+		void addWeightedOuterProducts(const float*       vectors,
+		                              const float*       weights,
+		                              const std::size_t  nmbVectors,
+		                              const unsigned int dim,
+		                              const unsigned int rowBegin,
+		                              const unsigned int rowEnd,
+		                              const unsigned int colBegin,
+		                              const unsigned int colEnd,
+		                              float*             sum,
+		                              float*             compensation,
+		                              float*             tile);
+
+
+	}  // namespace simd
+
+
+}  // namespace rpwa
+
+
+#endif  // LIKELIHOODSIMDKERNELS_H
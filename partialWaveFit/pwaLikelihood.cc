@@ -46,13 +46,16 @@
 #include "TSystem.h"
 #include "TTree.h"
 
+#include "amplitudeCacheFile.h"
 #include "amplitudeMetadata.h"
 #include "amplitudeTreeLeaf.h"
 #include "complexMatrix.h"
 #include "conversionUtils.hpp"
 #include "eventMetadata.h"
 #include "fileUtils.hpp"
+#include "likelihoodSimdKernels.h"
 #include "reportingUtils.hpp"
+#include "threadUtils.hpp"
 #ifdef USE_CUDA
 #include "arrayUtils.hpp"
 #include "complex.cuh"
@@ -144,7 +147,11 @@ pwaLikelihood<complexT>::pwaLikelihood()
 #ifdef USE_CUDA
 	  _cudaEnabled      (false),
 #endif
+	  _nmbThreads       (1),
+	  _simdEnabled      (false),
+	  _singlePrecisionAmps(false),
 	  _useNormalizedAmps(true),
+	  _ampCacheDirectory(""),
 	  _priorType        (FLAT),
 	  _cauchyWidth      (0.5),
 	  _numbAccEvents    (0)
@@ -178,16 +185,12 @@ pwaLikelihood<complexT>::FdF
 		printErr << "pwaLikelihood::finishInit has not been called. Aborting..." << endl;
 		throw;
 	}
-	++(_funcCallInfo[FDF].nmbCalls);
+	countFuncCall(FDF);
 
 	// timer for total time
 	TStopwatch timerTot;
 	timerTot.Start();
 
-	// copy arguments into parameter cache
-	for (unsigned int i = 0; i < _nmbPars; ++i)
-		_parCache[i] = par[i];
-
 	// build complex production amplitudes from function parameters taking into account rank restrictions
 	value_type        prodAmpFlat;
 	prodAmpsArrayType prodAmps;
@@ -204,52 +207,52 @@ pwaLikelihood<complexT>::FdF
 
 	// loop over events and calculate real-data term of log likelihood
 	// as well as derivatives with respect to parameters
+	// the event range is split into one contiguous chunk per thread;
+	// the partial sums of the chunks are added up in chunk order
 	TStopwatch timer;
 	timer.Start();
-	accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
-	accumulator_set<value_type, stats<tag::sum(compensated)> > derivativeFlatAcc;
-	multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3>
-		derivativesAcc(derivShape);
-	for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt) {
-		accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
-		prodAmpsArrayType derivative(derivShape);  // likelihood derivatives for this event
-		for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
-			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
-				accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
-					ampProdAcc(prodAmps[iRank][iRefl][iWave] * _decayAmps[iRefl][iEvt][iWave]);
-				}
-				const complexT ampProdSum = sum(ampProdAcc);
-				likelihoodAcc(norm(ampProdSum));
-				// set derivative term that is independent on derivative wave index
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-					// amplitude sums for current rank and for waves with same reflectivity
-					derivative[iRank][iRefl][iWave] = ampProdSum;
-			}
-			// loop again over waves for current rank and multiply with complex conjugate
-			// of decay amplitude of the wave with the derivative wave index
-			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-					derivative[iRank][iRefl][iWave] *= conj(_decayAmps[iRefl][iEvt][iWave]);
-		}  // end loop over rank
-		likelihoodAcc   (prodAmpFlat2            );
-		logLikelihoodAcc(-log(sum(likelihoodAcc)));
-		// incorporate factor 2 / sigma
-		const value_type factor = 2. / sum(likelihoodAcc);
+	value_type logLikelihood = 0;
+	if (_simdEnabled) {
+		simdLogLikelihoodDeriv(prodAmps, prodAmpFlat, logLikelihood, derivatives, derivativeFlat);
+	} else {
+		const unsigned int nmbEvtChunks = nmbChunks(_nmbEvents, _nmbThreads);
+		vector<accumulator_set<value_type, stats<tag::sum(compensated)> > > logLikelihoodChunkAcc (nmbEvtChunks);
+		vector<accumulator_set<value_type, stats<tag::sum(compensated)> > > derivativeFlatChunkAcc(nmbEvtChunks);
+		vector<multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3> >
+			derivativesChunkAcc(nmbEvtChunks, multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3>(derivShape));
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbEvtChunks) schedule(static, 1)
+#endif
+		for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk) {
+			size_t evtBegin, evtEnd;
+			chunkRange(_nmbEvents, nmbEvtChunks, iChunk, evtBegin, evtEnd);
+			if (_singlePrecisionAmps)
+				logLikelihoodDerivEvents(_decayAmpsSingle, prodAmps, prodAmpFlat, evtBegin, evtEnd, &logLikelihoodChunkAcc[iChunk],
+				                         derivativesChunkAcc[iChunk], derivativeFlatChunkAcc[iChunk]);
+			else
+				logLikelihoodDerivEvents(_decayAmps, prodAmps, prodAmpFlat, evtBegin, evtEnd, &logLikelihoodChunkAcc[iChunk],
+				                         derivativesChunkAcc[iChunk], derivativeFlatChunkAcc[iChunk]);
+		}
+		accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
+		accumulator_set<value_type, stats<tag::sum(compensated)> > derivativeFlatAcc;
+		for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk) {
+			logLikelihoodAcc (sum(logLikelihoodChunkAcc [iChunk]));
+			derivativeFlatAcc(sum(derivativeFlatChunkAcc[iChunk]));
+		}
 		for (unsigned int iRank = 0; iRank < _rank; ++iRank)
 			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-					derivativesAcc[iRank][iRefl][iWave](-factor * derivative[iRank][iRefl][iWave]);
-		derivativeFlatAcc(-factor * prodAmpFlat);
-	}  // end loop over events
-	for (unsigned int iRank = 0; iRank < _rank; ++iRank)
-		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-				derivatives[iRank][iRefl][iWave] = sum(derivativesAcc[iRank][iRefl][iWave]);
-	derivativeFlat = sum(derivativeFlatAcc);
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
+					accumulator_set<complexT, stats<tag::sum(compensated)> > derivativeAcc;
+					for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk)
+						derivativeAcc(sum(derivativesChunkAcc[iChunk][iRank][iRefl][iWave]));
+					derivatives[iRank][iRefl][iWave] = sum(derivativeAcc);
+				}
+		derivativeFlat = sum(derivativeFlatAcc);
+		logLikelihood  = sum(logLikelihoodAcc);
+	}
 	// log time needed for likelihood calculation
 	timer.Stop();
-	_funcCallInfo[FDF].funcTime(timer.RealTime());
+	addFuncCallTime(_funcCallInfo[FDF].funcTime, timer.RealTime());
 
 	// compute normalization term of log likelihood and normalize derivatives w.r.t. parameters
 	timer.Start();
@@ -273,7 +276,7 @@ pwaLikelihood<complexT>::FdF
 	derivativeFlat += prodAmpFlat * twiceNmbEvt * _totAcc;
 	// log time needed for normalization
 	timer.Stop();
-	_funcCallInfo[FDF].normTime(timer.RealTime());
+	addFuncCallTime(_funcCallInfo[FDF].normTime, timer.RealTime());
 
 	double priorValue = 0.;
 	switch(_priorType)
@@ -298,20 +301,20 @@ pwaLikelihood<complexT>::FdF
 
 	// sort derivative results into output array and cache
 	copyToParArray(derivatives, derivativeFlat, gradient);
-	copyToParArray(derivatives, derivativeFlat, _derivCache.data());
+	storeInDerivCache(par, gradient);
 
 	// calculate log likelihood value
-	funcVal = sum(logLikelihoodAcc) + nmbEvt * sum(normFactorAcc) + priorValue;
+	funcVal = logLikelihood + nmbEvt * sum(normFactorAcc) + priorValue;
 
 	// log total consumed time
 	timerTot.Stop();
-	_funcCallInfo[FDF].totalTime(timerTot.RealTime());
+	addFuncCallTime(_funcCallInfo[FDF].totalTime, timerTot.RealTime());
 
 	if (_debug)
-		printDebug << "raw log likelihood = "        << maxPrecisionAlign(sum(logLikelihoodAcc)) << ", "
-		           << "normalization = "             << maxPrecisionAlign(sum(normFactorAcc)   ) << ", "
-		           << "prior = "                     << maxPrecisionAlign(priorValue           ) << ", "
-		           << "normalized log likelihood = " << maxPrecisionAlign(funcVal              ) << endl;
+		printDebug << "raw log likelihood = "        << maxPrecisionAlign(logLikelihood     ) << ", "
+		           << "normalization = "             << maxPrecisionAlign(sum(normFactorAcc)) << ", "
+		           << "prior = "                     << maxPrecisionAlign(priorValue        ) << ", "
+		           << "normalized log likelihood = " << maxPrecisionAlign(funcVal           ) << endl;
 }
 
 
@@ -323,7 +326,7 @@ pwaLikelihood<complexT>::DoEval(const double* par) const
 		printErr << "pwaLikelihood::finishInit has not been called. Aborting..." << endl;
 		throw;
 	}
-	++(_funcCallInfo[DOEVAL].nmbCalls);
+	countFuncCall(DOEVAL);
 
 #ifdef USE_FDF
 
@@ -356,28 +359,53 @@ pwaLikelihood<complexT>::DoEval(const double* par) const
 			 prodAmps.num_elements(), prodAmpFlat, _rank);
 	} else
 #endif
-	{
+	if (_simdEnabled) {
+		// the event blocks are split into one contiguous chunk per thread;
+		// the partial sums of the chunks are added up in chunk order
+		const size_t       nmbBlocks    = (_singlePrecisionAmps) ? _decayAmpsSoASingle.nmbBlocks() : _decayAmpsSoA.nmbBlocks();
+		const unsigned int nmbEvtChunks = nmbChunks(nmbBlocks, _nmbThreads);
+		vector<value_type> logLikelihoodChunks(nmbEvtChunks, 0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbEvtChunks) schedule(static, 1)
+#endif
+		for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk) {
+			size_t blockBegin, blockEnd;
+			chunkRange(nmbBlocks, nmbEvtChunks, iChunk, blockBegin, blockEnd);
+			if (_singlePrecisionAmps)
+				logLikelihoodChunks[iChunk] = simd::logLikelihood(_decayAmpsSoASingle, prodAmps.data(), _rank, _nmbWavesReflMax,
+				                                                  prodAmpFlat2, blockBegin, blockEnd);
+			else
+				logLikelihoodChunks[iChunk] = simd::logLikelihood(_decayAmpsSoA, prodAmps.data(), _rank, _nmbWavesReflMax,
+				                                                  prodAmpFlat2, blockBegin, blockEnd);
+		}
 		accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
-		for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt) {
-			accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
-			for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
-				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
-					accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
-					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
-						ampProdAcc(prodAmps[iRank][iRefl][iWave] * _decayAmps[iRefl][iEvt][iWave]);
-					}
-					const complexT ampProdSum = sum(ampProdAcc);
-					likelihoodAcc(norm(ampProdSum));
-				}
-			}  // end loop over rank
-			likelihoodAcc   (prodAmpFlat2            );
-			logLikelihoodAcc(-log(sum(likelihoodAcc)));
-		}  // end loop over events
+		for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk)
+			logLikelihoodAcc(logLikelihoodChunks[iChunk]);
+		logLikelihood = sum(logLikelihoodAcc);
+	} else {
+		// the event range is split into one contiguous chunk per thread;
+		// the partial sums of the chunks are added up in chunk order
+		const unsigned int nmbEvtChunks = nmbChunks(_nmbEvents, _nmbThreads);
+		vector<accumulator_set<value_type, stats<tag::sum(compensated)> > > logLikelihoodChunkAcc(nmbEvtChunks);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbEvtChunks) schedule(static, 1)
+#endif
+		for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk) {
+			size_t evtBegin, evtEnd;
+			chunkRange(_nmbEvents, nmbEvtChunks, iChunk, evtBegin, evtEnd);
+			if (_singlePrecisionAmps)
+				logLikelihoodEvents(_decayAmpsSingle, prodAmps, prodAmpFlat2, evtBegin, evtEnd, logLikelihoodChunkAcc[iChunk]);
+			else
+				logLikelihoodEvents(_decayAmps, prodAmps, prodAmpFlat2, evtBegin, evtEnd, logLikelihoodChunkAcc[iChunk]);
+		}
+		accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
+		for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk)
+			logLikelihoodAcc(sum(logLikelihoodChunkAcc[iChunk]));
 		logLikelihood = sum(logLikelihoodAcc);
 	}
 	// log time needed for likelihood calculation
 	timer.Stop();
-	_funcCallInfo[DOEVAL].funcTime(timer.RealTime());
+	addFuncCallTime(_funcCallInfo[DOEVAL].funcTime, timer.RealTime());
 
 	// compute normalization term of log likelihood
 	timer.Start();
@@ -396,7 +424,7 @@ pwaLikelihood<complexT>::DoEval(const double* par) const
 	normFactorAcc(prodAmpFlat2 * _totAcc);
 	// log time needed for normalization
 	timer.Stop();
-	_funcCallInfo[DOEVAL].normTime(timer.RealTime());
+	addFuncCallTime(_funcCallInfo[DOEVAL].normTime, timer.RealTime());
 
 	double priorValue = 0.;
 	switch(_priorType)
@@ -421,7 +449,7 @@ pwaLikelihood<complexT>::DoEval(const double* par) const
 
 	// log total consumed time
 	timerTot.Stop();
-	_funcCallInfo[DOEVAL].totalTime(timerTot.RealTime());
+	addFuncCallTime(_funcCallInfo[DOEVAL].totalTime, timerTot.RealTime());
 
 	if (_debug)
 		printDebug << "raw log likelihood = "        << maxPrecisionAlign(logLikelihood     ) << ", "
@@ -444,28 +472,23 @@ pwaLikelihood<complexT>::DoDerivative(const double*      par,
 		printErr << "pwaLikelihood::finishInit has not been called. Aborting..." << endl;
 		throw;
 	}
-	++(_funcCallInfo[DODERIVATIVE].nmbCalls);
+	countFuncCall(DODERIVATIVE);
 
 	// timer for total time
 	TStopwatch timerTot;
 	timerTot.Start();
 
 	// check whether parameter is in cache
-	bool samePar = true;
-	for (unsigned int i = 0; i < _nmbPars; ++i)
-		if (_parCache[i] != par[i]) {
-			samePar = false;
-			break;
-		}
+	double gradient[_nmbPars];
+	const bool samePar = lookUpDerivCache(par, gradient);
 	timerTot.Stop();
-	_funcCallInfo[DODERIVATIVE].totalTime(timerTot.RealTime());
+	addFuncCallTime(_funcCallInfo[DODERIVATIVE].totalTime, timerTot.RealTime());
 	if (samePar) {
 		//cout << "using cached derivative! " << endl;
-		return _derivCache[derivativeIndex];
+		return gradient[derivativeIndex];
 	}
 	// call FdF
 	double logLikelihood;
-	double gradient[_nmbPars];
 	FdF(par, logLikelihood, gradient);
 	return gradient[derivativeIndex];
 }
@@ -482,7 +505,7 @@ pwaLikelihood<complexT>::Gradient
 		printErr << "pwaLikelihood::finishInit has not been called. Aborting..." << endl;
 		throw;
 	}
-	++(_funcCallInfo[GRADIENT].nmbCalls);
+	countFuncCall(GRADIENT);
 
 	// timer for total time
 	TStopwatch timerTot;
@@ -491,29 +514,17 @@ pwaLikelihood<complexT>::Gradient
 #ifdef USE_FDF
 
 	// check whether parameter is in cache
-	bool samePar = true;
-	for (unsigned int i = 0; i < _nmbPars; ++i)
-		if (_parCache[i] != par[i]) {
-			samePar = false;
-			break;
-		}
+	const bool samePar = lookUpDerivCache(par, gradient);
 	timerTot.Stop();
-	_funcCallInfo[GRADIENT].totalTime(timerTot.RealTime());
-	if (samePar) {
-		for (unsigned int i = 0; i < _nmbPars ; ++i)
-			gradient[i] = _derivCache[i];
+	addFuncCallTime(_funcCallInfo[GRADIENT].totalTime, timerTot.RealTime());
+	if (samePar)
 		return;
-	}
 	// call FdF
 	double logLikelihood;
 	FdF(par, logLikelihood, gradient);
 
 #else  // USE_FDF
 
-	// copy arguments into parameter cache
-	for (unsigned int i = 0; i < _nmbPars; ++i)
-		_parCache[i] = par[i];
-
 	// build complex production amplitudes from function parameters taking into account rank restrictions
 	value_type        prodAmpFlat;
 	prodAmpsArrayType prodAmps;
@@ -539,51 +550,45 @@ pwaLikelihood<complexT>::Gradient
 			 derivativeFlat);
 	} else
 #endif
-	{
+	if (_simdEnabled) {
+		value_type logLikelihood;
+		simdLogLikelihoodDeriv(prodAmps, prodAmpFlat, logLikelihood, derivatives, derivativeFlat);
+	} else {
+		// the event range is split into one contiguous chunk per thread;
+		// the partial sums of the chunks are added up in chunk order
+		const unsigned int nmbEvtChunks = nmbChunks(_nmbEvents, _nmbThreads);
+		vector<accumulator_set<value_type, stats<tag::sum(compensated)> > > derivativeFlatChunkAcc(nmbEvtChunks);
+		vector<multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3> >
+			derivativesChunkAcc(nmbEvtChunks, multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3>(derivShape));
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbEvtChunks) schedule(static, 1)
+#endif
+		for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk) {
+			size_t evtBegin, evtEnd;
+			chunkRange(_nmbEvents, nmbEvtChunks, iChunk, evtBegin, evtEnd);
+			if (_singlePrecisionAmps)
+				logLikelihoodDerivEvents(_decayAmpsSingle, prodAmps, prodAmpFlat, evtBegin, evtEnd, 0,
+				                         derivativesChunkAcc[iChunk], derivativeFlatChunkAcc[iChunk]);
+			else
+				logLikelihoodDerivEvents(_decayAmps, prodAmps, prodAmpFlat, evtBegin, evtEnd, 0,
+				                         derivativesChunkAcc[iChunk], derivativeFlatChunkAcc[iChunk]);
+		}
 		accumulator_set<value_type, stats<tag::sum(compensated)> > derivativeFlatAcc;
-		multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3>
-			derivativesAcc(derivShape);
-		const value_type prodAmpFlat2 = prodAmpFlat * prodAmpFlat;
-		for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt) {
-			accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
-			prodAmpsArrayType derivative(derivShape);  // likelihood derivatives for this event
-			for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
-				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
-					accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
-					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
-						ampProdAcc(prodAmps[iRank][iRefl][iWave] * _decayAmps[iRefl][iEvt][iWave]);
-					}
-					const complexT ampProdSum = sum(ampProdAcc);
-					likelihoodAcc(norm(ampProdSum));
-					// set derivative term that is independent on derivative wave index
-					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-						// amplitude sums for current rank and for waves with same reflectivity
-						derivative[iRank][iRefl][iWave] = ampProdSum;
-				}
-				// loop again over waves for current rank and multiply with complex conjugate
-				// of decay amplitude of the wave with the derivative wave index
-				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-						derivative[iRank][iRefl][iWave] *= conj(_decayAmps[iRefl][iEvt][iWave]);
-			}  // end loop over rank
-			likelihoodAcc(prodAmpFlat2);
-			// incorporate factor 2 / sigma
-			const value_type factor = 2. / sum(likelihoodAcc);
-			for (unsigned int iRank = 0; iRank < _rank; ++iRank)
-				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-						derivativesAcc[iRank][iRefl][iWave](-factor * derivative[iRank][iRefl][iWave]);
-			derivativeFlatAcc(-factor * prodAmpFlat);
-		}  // end loop over events
+		for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk)
+			derivativeFlatAcc(sum(derivativeFlatChunkAcc[iChunk]));
 		for (unsigned int iRank = 0; iRank < _rank; ++iRank)
 			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-					derivatives[iRank][iRefl][iWave] = sum(derivativesAcc[iRank][iRefl][iWave]);
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
+					accumulator_set<complexT, stats<tag::sum(compensated)> > derivativeAcc;
+					for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk)
+						derivativeAcc(sum(derivativesChunkAcc[iChunk][iRank][iRefl][iWave]));
+					derivatives[iRank][iRefl][iWave] = sum(derivativeAcc);
+				}
 		derivativeFlat = sum(derivativeFlatAcc);
 	}
 	// log time needed for likelihood calculation
 	timer.Stop();
-	_funcCallInfo[GRADIENT].funcTime(timer.RealTime());
+	addFuncCallTime(_funcCallInfo[GRADIENT].funcTime, timer.RealTime());
 
 	// normalize derivatives w.r.t. parameters
 	timer.Start();
@@ -603,7 +608,7 @@ pwaLikelihood<complexT>::Gradient
 	derivativeFlat += prodAmpFlat * twiceNmbEvt * _totAcc;
 	// log time needed for normalization
 	timer.Stop();
-	_funcCallInfo[GRADIENT].normTime(timer.RealTime());
+	addFuncCallTime(_funcCallInfo[GRADIENT].normTime, timer.RealTime());
 
 	switch(_priorType)
 	{
@@ -626,11 +631,11 @@ pwaLikelihood<complexT>::Gradient
 
 	// sort derivative results into output array and cache
 	copyToParArray(derivatives, derivativeFlat, gradient);
-	copyToParArray(derivatives, derivativeFlat, _derivCache.data());
+	storeInDerivCache(par, gradient);
 
 	// log total consumed time
 	timerTot.Stop();
-	_funcCallInfo[GRADIENT].totalTime(timerTot.RealTime());
+	addFuncCallTime(_funcCallInfo[GRADIENT].totalTime, timerTot.RealTime());
 
 #endif  // USE_FDF
 }
@@ -646,7 +651,7 @@ pwaLikelihood<complexT>::Hessian
 		printErr << "pwaLikelihood::finishInit has not been called. Aborting..." << endl;
 		throw;
 	}
-	++(_funcCallInfo[HESSIAN].nmbCalls);
+	countFuncCall(HESSIAN);
 
 	// timer for total time
 	TStopwatch timerTot;
@@ -669,87 +674,153 @@ pwaLikelihood<complexT>::Hessian
 
 	// loop over events and calculate second derivatives with respect to
 	// parameters for the raw likelihood part
+	// with the derivatives d_k = ampProdSum(rank_k, refl_k) * conj(decayAmp_k)
+	// of the intensity w.r.t. the production amplitudes V_k and the
+	// factor f = 2 / intensity, the second derivatives are sums over
+	// events of weighted outer products of per-event vectors:
+	//     d^2 / d(Re|Im V_k) d(Re|Im V_l) = sum f^2 (Re|Im d_k) (Re|Im d_l) - delta(rank, refl) sum f (decayAmp_k conj(decayAmp_l))
+	// the first sum is accumulated from the vectors x = [Re d, Im d, prodAmpFlat]
+	// with weight f^2, the second from the vectors y = [Re decayAmp, Im decayAmp, 1]
+	// with weight f, so that only two symmetric matrices of dimension
+	// 2 * #prodAmps + 1 and 2 * #waves + 1 are stored
+	// the vectors are calculated for blocks of events; the outer
+	// products of each block are added to the upper triangles of the
+	// matrices tile by tile, one tile per thread, so that the result
+	// does not depend on the number of threads
 	TStopwatch timer;
 	timer.Start();
-	accumulator_set<value_type, stats<tag::sum(compensated)> > hessianFlatAcc;
-	multi_array<accumulator_set<complexT, stats<tag::sum(compensated)> >, 3>
-		flatTermsAcc(derivShape);
-	multi_array<accumulator_set<value_type, stats<tag::sum(compensated)> >, 7>
-		hessianAcc(hessianShape);
-	for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt) {
-		accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
-		prodAmpsArrayType derivative(derivShape);  // likelihood derivatives for this event
-		for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
-			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
-				accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
-					ampProdAcc(prodAmps[iRank][iRefl][iWave] * _decayAmps[iRefl][iEvt][iWave]);
-				}
-				const complexT ampProdSum = sum(ampProdAcc);
-				likelihoodAcc(norm(ampProdSum));
-				// set derivative term that is independent on derivative wave index
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-					// amplitude sums for current rank and for waves with same reflectivity
-					derivative[iRank][iRefl][iWave] = ampProdSum;
+	vector<unsigned int> derivRanks, derivRefls, derivWaves;  // rank, reflectivity, and wave index of production amplitude k
+	for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
+				derivRanks.push_back(iRank);
+				derivRefls.push_back(iRefl);
+				derivWaves.push_back(iWave);
 			}
-			// loop again over waves for current rank and multiply with complex conjugate
-			// of decay amplitude of the wave with the derivative wave index
-			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
-					derivative[iRank][iRefl][iWave] *= conj(_decayAmps[iRefl][iEvt][iWave]);
-		}  // end loop over rank
-		likelihoodAcc(prodAmpFlat2);
-		// incorporate factor 2 / sigma
-		const value_type factor  = 2. / sum(likelihoodAcc);
-		const value_type factor2 = factor*factor;
-		for (unsigned int iRank = 0; iRank < _rank; ++iRank) {
-			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
-				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
-					for (unsigned int jRank = 0; jRank < _rank; ++jRank) {
-						for (unsigned int jRefl = 0; jRefl < 2; ++jRefl) {
-							for (unsigned int jWave = 0; jWave < _nmbWavesRefl[jRefl]; ++jWave) {
-								// last array index 0 indicates derivative w.r.t. real part of first prodAmp and real part of the second prodAmp
-								hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][0](factor2 * derivative[jRank][jRefl][jWave].real() * derivative[iRank][iRefl][iWave].real());
-								// last array index 1 indicates derivative w.r.t. real part of first prodAmp and imaginary part of the second prodAmp
-								hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][1](factor2 * derivative[jRank][jRefl][jWave].imag() * derivative[iRank][iRefl][iWave].real());
-								// last array index 2 indicates derivative w.r.t. imaginary part of first prodAmp and imaginary part of the second prodAmp
-								hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][2](factor2 * derivative[jRank][jRefl][jWave].imag() * derivative[iRank][iRefl][iWave].imag());
-								if(iRank == jRank and iRefl == jRefl) {
-									const complexT uPrime = conj(_decayAmps[jRefl][iEvt][jWave]) * _decayAmps[iRefl][iEvt][iWave];
-									hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][0](-factor * uPrime.real());
-									hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][1](-factor * uPrime.imag());
-									hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][2](-factor * uPrime.real());
-								}
-							}
-						}
+	const unsigned int nmbDerivs      = derivRanks.size();
+	const unsigned int nmbAmps        = _nmbWavesRefl[0] + _nmbWavesRefl[1];
+	const unsigned int ampOffsets[2]  = {0, _nmbWavesRefl[0]};  // index of first decay amplitude of each reflectivity in y
+	const unsigned int derivDim       = 2 * nmbDerivs + 1;
+	const unsigned int ampDim         = 2 * nmbAmps   + 1;
+	const size_t       evtBlockSize   = 256;
+	const unsigned int tileSize       = 64;
+	// upper-triangle tiles of both matrices: [matrix][row tile][column tile]
+	vector<bt::tuple<unsigned int, unsigned int, unsigned int> > tiles;
+	for (unsigned int iMatrix = 0; iMatrix < 2; ++iMatrix) {
+		const unsigned int dim = (iMatrix == 0) ? derivDim : ampDim;
+		for (unsigned int rowBegin = 0; rowBegin < dim; rowBegin += tileSize)
+			for (unsigned int colBegin = rowBegin; colBegin < dim; colBegin += tileSize)
+				tiles.push_back(bt::make_tuple(iMatrix, rowBegin, colBegin));
+	}
+	vector<complexT>   blockAmpProdSums(evtBlockSize * _rank * 2);
+	vector<value_type> derivVectors    (evtBlockSize * derivDim);
+	vector<value_type> ampVectors      (evtBlockSize * ampDim);
+	vector<value_type> weights         (2 * evtBlockSize);  // f^2 for x followed by f for y
+	vector<value_type> derivSum        (derivDim * derivDim, 0);  // upper triangle of sum f^2 x x^T
+	vector<value_type> derivComp       (derivDim * derivDim, 0);
+	vector<value_type> ampSum          (ampDim   * ampDim,   0);  // upper triangle of sum f y y^T
+	vector<value_type> ampComp         (ampDim   * ampDim,   0);
+	vector<value_type> tileBuffers     (_nmbThreads * tileSize * tileSize);  // one tile buffer per thread
+	for (size_t blockBegin = 0; blockBegin < _nmbEvents; blockBegin += evtBlockSize) {
+		const size_t nmbBlockEvts = min(evtBlockSize, _nmbEvents - blockBegin);
+		// the decay amplitudes of the block are copied into the vectors y
+		// first, the remaining per-event quantities are calculated from them
+		if (_singlePrecisionAmps)
+			fillDecayAmpVectors(_decayAmpsSingle, blockBegin, nmbBlockEvts, ampVectors.data());
+		else
+			fillDecayAmpVectors(_decayAmps, blockBegin, nmbBlockEvts, ampVectors.data());
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(_nmbThreads) schedule(static)
+#endif
+		for (size_t iBlockEvt = 0; iBlockEvt < nmbBlockEvts; ++iBlockEvt) {
+			const value_type* y = &ampVectors[iBlockEvt * ampDim];
+			complexT* ampProdSums = &blockAmpProdSums[iBlockEvt * _rank * 2];  // [rank][reflectivity]
+			accumulator_set<value_type, stats<tag::sum(compensated)> > likelihoodAcc;
+			for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
+				for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+					accumulator_set<complexT, stats<tag::sum(compensated)> > ampProdAcc;
+					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {  // coherent sum over waves
+						const unsigned int iAmp = ampOffsets[iRefl] + iWave;
+						ampProdAcc(prodAmps[iRank][iRefl][iWave] * complexT(y[iAmp], y[nmbAmps + iAmp]));
 					}
-					flatTermsAcc[iRank][iRefl][iWave](factor2 * prodAmpFlat * derivative[iRank][iRefl][iWave]);  // calculate terms where we first derive w.r.t. real/imag part
-					                                                                                             // of a prodAmp and then w.r.t. the flat wave
+					ampProdSums[iRank * 2 + iRefl] = sum(ampProdAcc);
+					likelihoodAcc(norm(ampProdSums[iRank * 2 + iRefl]));
 				}
+			}  // end loop over rank
+			likelihoodAcc(prodAmpFlat2);
+			// incorporate factor 2 / sigma
+			const value_type factor = 2. / sum(likelihoodAcc);
+			value_type* x = &derivVectors[iBlockEvt * derivDim];
+			for (unsigned int k = 0; k < nmbDerivs; ++k) {
+				const unsigned int iAmp       = ampOffsets[derivRefls[k]] + derivWaves[k];
+				const complexT     derivative = ampProdSums[derivRanks[k] * 2 + derivRefls[k]] * complexT(y[iAmp], -y[nmbAmps + iAmp]);
+				x[k]             = derivative.real();
+				x[nmbDerivs + k] = derivative.imag();
 			}
-		}
-		hessianFlatAcc(factor2 * prodAmpFlat2 - factor);
-	}  // end loop over events
-	for (unsigned int iRank = 0; iRank < _rank; ++iRank) {
-		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {
-			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
-				for (unsigned int jRank = 0; jRank < _rank; ++jRank) {
-					for (unsigned int jRefl = 0; jRefl < 2; ++jRefl) {
-						for (unsigned int jWave = 0; jWave < _nmbWavesRefl[jRefl]; ++jWave) {
-							hessian[iRank][iRefl][iWave][jRank][jRefl][jWave][0] = sum(hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][0]);
-							hessian[iRank][iRefl][iWave][jRank][jRefl][jWave][1] = sum(hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][1]);
-							hessian[iRank][iRefl][iWave][jRank][jRefl][jWave][2] = sum(hessianAcc[iRank][iRefl][iWave][jRank][jRefl][jWave][2]);
-						}
-					}
-				}
-				flatTerms[iRank][iRefl][iWave] = sum(flatTermsAcc[iRank][iRefl][iWave]);
+			x[2 * nmbDerivs] = prodAmpFlat;
+			weights[iBlockEvt]                = factor * factor;
+			weights[evtBlockSize + iBlockEvt] = factor;
+		}  // end loop over events
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(_nmbThreads) schedule(dynamic, 1)
+#endif
+		for (size_t iTile = 0; iTile < tiles.size(); ++iTile) {
+			const unsigned int rowBegin = get<1>(tiles[iTile]);
+			const unsigned int colBegin = get<2>(tiles[iTile]);
+			value_type*        tile     = &tileBuffers[threadIndex() * tileSize * tileSize];
+			if (get<0>(tiles[iTile]) == 0)
+				simd::addWeightedOuterProducts(derivVectors.data(), &weights[0], nmbBlockEvts, derivDim,
+				                               rowBegin, min(rowBegin + tileSize, derivDim), colBegin, min(colBegin + tileSize, derivDim),
+				                               derivSum.data(), derivComp.data(), tile);
+			else
+				simd::addWeightedOuterProducts(ampVectors.data(), &weights[evtBlockSize], nmbBlockEvts, ampDim,
+				                               rowBegin, min(rowBegin + tileSize, ampDim), colBegin, min(colBegin + tileSize, ampDim),
+				                               ampSum.data(), ampComp.data(), tile);
+		}  // end loop over tiles
+	}  // end loop over event blocks
+	// returns element (i, j) of a symmetric matrix from its compensated upper triangle
+	auto element = [] (const vector<value_type>& sum,
+	                   const vector<value_type>& comp,
+	                   const unsigned int        dim,
+	                   const unsigned int        i,
+	                   const unsigned int        j) -> value_type
+		{
+			const unsigned int index = (i <= j) ? i * dim + j : j * dim + i;
+			return sum[index] - comp[index];
+		};
+	for (unsigned int k = 0; k < nmbDerivs; ++k) {
+		for (unsigned int l = 0; l < nmbDerivs; ++l) {
+			// last array index 0 indicates derivative w.r.t. real part of first prodAmp and real part of the second prodAmp
+			value_type hessianRR = element(derivSum, derivComp, derivDim, k,             l);
+			// last array index 1 indicates derivative w.r.t. real part of first prodAmp and imaginary part of the second prodAmp
+			value_type hessianRI = element(derivSum, derivComp, derivDim, k,             nmbDerivs + l);
+			// last array index 2 indicates derivative w.r.t. imaginary part of first prodAmp and imaginary part of the second prodAmp
+			value_type hessianII = element(derivSum, derivComp, derivDim, nmbDerivs + k, nmbDerivs + l);
+			if (derivRanks[k] == derivRanks[l] and derivRefls[k] == derivRefls[l]) {
+				// sum of f * conj(decayAmp_l) * decayAmp_k
+				const unsigned int ampK  = ampOffsets[derivRefls[k]] + derivWaves[k];
+				const unsigned int ampL  = ampOffsets[derivRefls[l]] + derivWaves[l];
+				const value_type   uReal =   element(ampSum, ampComp, ampDim, ampK,           ampL)
+				                           + element(ampSum, ampComp, ampDim, nmbAmps + ampK, nmbAmps + ampL);
+				const value_type   uImag =   element(ampSum, ampComp, ampDim, nmbAmps + ampK, ampL)
+				                           - element(ampSum, ampComp, ampDim, ampK,           nmbAmps + ampL);
+				hessianRR -= uReal;
+				hessianRI -= uImag;
+				hessianII -= uReal;
 			}
+			hessian[derivRanks[k]][derivRefls[k]][derivWaves[k]][derivRanks[l]][derivRefls[l]][derivWaves[l]][0] = hessianRR;
+			hessian[derivRanks[k]][derivRefls[k]][derivWaves[k]][derivRanks[l]][derivRefls[l]][derivWaves[l]][1] = hessianRI;
+			hessian[derivRanks[k]][derivRefls[k]][derivWaves[k]][derivRanks[l]][derivRefls[l]][derivWaves[l]][2] = hessianII;
 		}
+		// terms where we first derive w.r.t. real/imag part of a prodAmp and then w.r.t. the flat wave
+		flatTerms[derivRanks[k]][derivRefls[k]][derivWaves[k]] = complexT(element(derivSum, derivComp, derivDim, k,             2 * nmbDerivs),
+		                                                                  element(derivSum, derivComp, derivDim, nmbDerivs + k, 2 * nmbDerivs));
 	}
-	hessianFlat = sum(hessianFlatAcc);
+	hessianFlat =   element(derivSum, derivComp, derivDim, 2 * nmbDerivs, 2 * nmbDerivs)
+	              - element(ampSum,   ampComp,   ampDim,   2 * nmbAmps,   2 * nmbAmps);
 	// log time needed for calculation of second derivatives of raw likelhood part
 	timer.Stop();
-	_funcCallInfo[HESSIAN].funcTime(timer.RealTime());
+	addFuncCallTime(_funcCallInfo[HESSIAN].funcTime, timer.RealTime());
 
 	// normalize second derivatives w.r.t. parameters
 	timer.Start();
@@ -767,7 +838,7 @@ pwaLikelihood<complexT>::Hessian
 	hessianFlat += twiceNmbEvt * _totAcc;
 	// log time needed for normalization
 	timer.Stop();
-	_funcCallInfo[HESSIAN].normTime(timer.RealTime());
+	addFuncCallTime(_funcCallInfo[HESSIAN].normTime, timer.RealTime());
 
 	switch(_priorType)
 	{
@@ -853,7 +924,7 @@ pwaLikelihood<complexT>::Hessian
 
 	// log total consumed time
 	timerTot.Stop();
-	_funcCallInfo[HESSIAN].totalTime(timerTot.RealTime());
+	addFuncCallTime(_funcCallInfo[HESSIAN].totalTime, timerTot.RealTime());
 
 	return hessianMatrix;
 }
@@ -1047,6 +1118,49 @@ pwaLikelihood<complexT>::cudaEnabled() const
 }
 
 
+template<typename complexT>
+void
+pwaLikelihood<complexT>::setNmbThreads(const unsigned int nmbThreads)
+{
+	_nmbThreads = nmbThreadsToUse(nmbThreads);
+	if ((nmbThreads != 0) and (_nmbThreads != nmbThreads))
+		printWarn << "requested " << nmbThreads << " threads, but only " << _nmbThreads << " "
+		          << "thread" << ((_nmbThreads != 1) ? "s are" : " is") << " available." << endl;
+	if (_debug)
+		printDebug << "using " << _nmbThreads << " thread" << ((_nmbThreads != 1) ? "s" : "") << " "
+		           << "to calculate likelihood." << endl;
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::enableSimd(const bool enableSimd)
+{
+	_simdEnabled = enableSimd;
+	if (not _initFinished)
+		return;  // decay amplitudes are rearranged in finishInit()
+	if (_simdEnabled)
+		fillDecayAmpsSoA();
+	else {
+		_decayAmpsSoA.clear();
+		_decayAmpsSoASingle.clear();
+	}
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::useSinglePrecisionAmps(const bool useSingle)
+{
+	if (_nmbEvents != 0) {
+		printWarn << "decay amplitudes were already read. "
+		          << "cannot change precision of their storage anymore." << endl;
+		return;
+	}
+	_singlePrecisionAmps = useSingle;
+}
+
+
 template<typename complexT>
 bool
 pwaLikelihood<complexT>::init(const vector<waveDescThresType>& waveDescThresType,
@@ -1189,12 +1303,33 @@ pwaLikelihood<complexT>::addAmplitude(const vector<const amplitudeMetadata*>& am
 	size_t eventCount = 0; // Running count for event number over all single files
 	for (size_t iAmpMeta = 0; iAmpMeta < ampMetas.size(); ++iAmpMeta) {
 		const amplitudeMetadata* ampMeta = ampMetas[iAmpMeta];
+		// if a cache directory is set, the amplitudes are taken from the
+		// memory-mapped cache file of the amplitude file, which is
+		// written if it does not exist yet
+		amplitudeCacheFile ampCache;
+		if (not _ampCacheDirectory.empty()) {
+			const string cacheFileName = amplitudeCacheFile::cacheFileName(_ampCacheDirectory, ampMeta->contentHash());
+			if (not ampCache.open(cacheFileName, ampMeta->contentHash())) {
+				if (amplitudeCacheFile::writeCacheFile(*ampMeta, cacheFileName))
+					ampCache.open(cacheFileName, ampMeta->contentHash());
+			}
+			if (ampCache.isOpen() and ampCache.nmbEvents() != (size_t)ampMeta->amplitudeTree()->GetEntriesFast()) {
+				printWarn << "number of events in amplitude cache file '" << cacheFileName << "' (" << ampCache.nmbEvents() << ") "
+				          << "does not match that of the amplitude tree (" << ampMeta->amplitudeTree()->GetEntriesFast() << "). "
+				          << "reading amplitude tree." << endl;
+				ampCache.close();
+			}
+		}
+		const complex<double>* cachedAmps = ampCache.amplitudes();
+
 		// connect tree leaf
 		amplitudeTreeLeaf* ampTreeLeaf = 0;
-		ampMeta->amplitudeTree()->SetBranchAddress(amplitudeMetadata::amplitudeLeafName.c_str(), &ampTreeLeaf);
-		if (not ampTreeLeaf) {
-			printWarn << "null pointer to amplitude leaf. Aborting..." << endl;
-			return false;
+		if (not cachedAmps) {
+			ampMeta->amplitudeTree()->SetBranchAddress(amplitudeMetadata::amplitudeLeafName.c_str(), &ampTreeLeaf);
+			if (not ampTreeLeaf) {
+				printWarn << "null pointer to amplitude leaf. Aborting..." << endl;
+				return false;
+			}
 		}
 
 		if (onTheFlyBinning) {
@@ -1203,6 +1338,11 @@ pwaLikelihood<complexT>::addAmplitude(const vector<const amplitudeMetadata*>& am
 				const string& eventFileHash = ampMeta->eventMetadata()[iEvtMeta].contentHash();
 				const vector<size_t>& entriesInBin = _eventFileProperties[eventFileHash].second;
 				for(size_t iEvent = 0; iEvent < entriesInBin.size(); ++iEvent, ++eventCount) {
+					if (cachedAmps) {
+						const complex<double>& cachedAmp = cachedAmps[skipEvents + entriesInBin[iEvent]];
+						amps[eventCount] = complexT(cachedAmp.real(), cachedAmp.imag());
+						continue;
+					}
 					ampMeta->amplitudeTree()->GetEntry(skipEvents + entriesInBin[iEvent]);
 					assert(ampTreeLeaf->nmbIncohSubAmps() == 1);
 					complexT amp(ampTreeLeaf->incohSubAmp(0).real(), ampTreeLeaf->incohSubAmp(0).imag());
@@ -1212,6 +1352,10 @@ pwaLikelihood<complexT>::addAmplitude(const vector<const amplitudeMetadata*>& am
 			}
 		} else {
 			for(long iEvent = 0; iEvent < ampMeta->amplitudeTree()->GetEntriesFast(); ++iEvent, ++eventCount) {
+				if (cachedAmps) {
+					amps[eventCount] = complexT(cachedAmps[iEvent].real(), cachedAmps[iEvent].imag());
+					continue;
+				}
 				ampMeta->amplitudeTree()->GetEntry(iEvent);
 				assert(ampTreeLeaf->nmbIncohSubAmps() == 1);
 				complexT amp(ampTreeLeaf->incohSubAmp(0).real(), ampTreeLeaf->incohSubAmp(0).imag());
@@ -1223,8 +1367,13 @@ pwaLikelihood<complexT>::addAmplitude(const vector<const amplitudeMetadata*>& am
 	if (_nmbEvents == 0) {
 		// first amplitude file read
 		_nmbEvents = totalEvents;
-		_decayAmps[0].resize(extents[_nmbEvents][_nmbWavesRefl[0]]);
-		_decayAmps[1].resize(extents[_nmbEvents][_nmbWavesRefl[1]]);
+		if (_singlePrecisionAmps) {
+			_decayAmpsSingle[0].resize(extents[_nmbEvents][_nmbWavesRefl[0]]);
+			_decayAmpsSingle[1].resize(extents[_nmbEvents][_nmbWavesRefl[1]]);
+		} else {
+			_decayAmps[0].resize(extents[_nmbEvents][_nmbWavesRefl[0]]);
+			_decayAmps[1].resize(extents[_nmbEvents][_nmbWavesRefl[1]]);
+		}
 	}
 	if (totalEvents != _nmbEvents) {
 		printWarn << "size mismatch in amplitude files: this file contains " << totalEvents
@@ -1249,7 +1398,10 @@ pwaLikelihood<complexT>::addAmplitude(const vector<const amplitudeMetadata*>& am
 			if (normInt != (value_type)0.)
 				amps[iEvt] /= sqrt(normInt.real());  // rescale decay amplitude
 		}
-		_decayAmps[refl][iEvt][waveIndex] = amps[iEvt];
+		if (_singlePrecisionAmps)
+			_decayAmpsSingle[refl][iEvt][waveIndex] = complex<float>(amps[iEvt].real(), amps[iEvt].imag());
+		else
+			_decayAmps[refl][iEvt][waveIndex] = amps[iEvt];
 	}
 
 	_waveAmpAdded[refl][waveIndex] = true; // note that this amplitude has been added to the likelihood
@@ -1337,7 +1489,10 @@ pwaLikelihood<complexT>::finishInit()
 					for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
 						const unsigned int indices[3] = {iRefl, iWave, iEvt};
 						const unsigned int offset     = indicesToOffset(indices, dim, nmbDim);
-						decayAmpsArray[offset]        = _decayAmps[iRefl][iEvt][iWave];
+						if (_singlePrecisionAmps)
+							decayAmpsArray[offset] = complexT(_decayAmpsSingle[iRefl][iEvt][iWave]);
+						else
+							decayAmpsArray[offset] = complexT(_decayAmps[iRefl][iEvt][iWave]);
 					}
 				}
 			}
@@ -1348,6 +1503,9 @@ pwaLikelihood<complexT>::finishInit()
 	}
 #endif
 
+	if (_simdEnabled)
+		fillDecayAmpsSoA();
+
 	printSucc << "set up likelihood function for rank-" << _rank << " fit with "
 	          << _nmbWaves << " wave" << ((_nmbWaves != 1) ? "s" : "") << " (excluding 'flat' wave; "
 	          << _nmbWavesRefl[1] << " wave" << ((_nmbWaves != 1) ? "s" : "") << " with positive reflectivity, "
@@ -1638,6 +1796,204 @@ pwaLikelihood<complexT>::clear()
 {
 	_decayAmps[0].resize(extents[0][0]);
 	_decayAmps[1].resize(extents[0][0]);
+	_decayAmpsSingle[0].resize(extents[0][0]);
+	_decayAmpsSingle[1].resize(extents[0][0]);
+	_decayAmpsSoA.clear();
+	_decayAmpsSoASingle.clear();
+}
+
+
+// copies decay amplitudes into layout used by the vectorized kernels
+template<typename complexT>
+void
+pwaLikelihood<complexT>::fillDecayAmpsSoA()
+{
+	if (_singlePrecisionAmps) {
+		_decayAmpsSoASingle.resize(_nmbEvents, _nmbWavesRefl);
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt)
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					_decayAmpsSoASingle.set(iRefl, iEvt, iWave, _decayAmpsSingle[iRefl][iEvt][iWave]);
+		if (_debug)
+			printDebug << "rearranged single-precision decay amplitudes for vectorized likelihood kernels "
+			           << "(" << _decayAmpsSoASingle.nmbBlocks() << " blocks of " << simd::decayAmpsSoA<float>::nmbLanes << " events, "
+			           << _decayAmpsSoASingle.memoryUsage() / (1024. * 1024.) << " MiB; instruction set " << simd::instructionSet() << ")." << endl;
+		return;
+	}
+	_decayAmpsSoA.resize(_nmbEvents, _nmbWavesRefl);
+	for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+		for (unsigned int iEvt = 0; iEvt < _nmbEvents; ++iEvt)
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+				_decayAmpsSoA.set(iRefl, iEvt, iWave, _decayAmps[iRefl][iEvt][iWave]);
+	if (_debug)
+		printDebug << "rearranged decay amplitudes for vectorized likelihood kernels "
+		           << "(" << _decayAmpsSoA.nmbBlocks() << " blocks of " << simd::decayAmpsSoA<value_type>::nmbLanes << " events, "
+		           << _decayAmpsSoA.memoryUsage() / (1024. * 1024.) << " MiB; instruction set " << simd::instructionSet() << ")." << endl;
+}
+
+
+// calculates real-data term of log likelihood and its derivatives
+// with respect to the production amplitudes using the vectorized
+// kernels; the event blocks are split into one contiguous chunk per
+// thread and the partial sums of the chunks are added up in chunk
+// order
+template<typename complexT>
+void
+pwaLikelihood<complexT>::simdLogLikelihoodDeriv(const prodAmpsArrayType& prodAmps,
+                                                const value_type         prodAmpFlat,
+                                                value_type&              logLikelihood,
+                                                prodAmpsArrayType&       derivatives,
+                                                value_type&              derivativeFlat) const
+{
+	const size_t       nmbBlocks    = (_singlePrecisionAmps) ? _decayAmpsSoASingle.nmbBlocks() : _decayAmpsSoA.nmbBlocks();
+	const unsigned int nmbEvtChunks = nmbChunks(nmbBlocks, _nmbThreads);
+	vector<value_type>        logLikelihoodChunks (nmbEvtChunks, 0);
+	vector<value_type>        derivativeFlatChunks(nmbEvtChunks, 0);
+	vector<prodAmpsArrayType> derivativesChunks   (nmbEvtChunks, prodAmpsArrayType(derivatives));
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbEvtChunks) schedule(static, 1)
+#endif
+	for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk) {
+		size_t blockBegin, blockEnd;
+		chunkRange(nmbBlocks, nmbEvtChunks, iChunk, blockBegin, blockEnd);
+		if (_singlePrecisionAmps)
+			simd::logLikelihoodDeriv(_decayAmpsSoASingle, prodAmps.data(), _rank, _nmbWavesReflMax, prodAmpFlat, blockBegin, blockEnd,
+			                         logLikelihoodChunks[iChunk], derivativesChunks[iChunk].data(), derivativeFlatChunks[iChunk]);
+		else
+			simd::logLikelihoodDeriv(_decayAmpsSoA, prodAmps.data(), _rank, _nmbWavesReflMax, prodAmpFlat, blockBegin, blockEnd,
+			                         logLikelihoodChunks[iChunk], derivativesChunks[iChunk].data(), derivativeFlatChunks[iChunk]);
+	}
+	accumulator_set<value_type, stats<tag::sum(compensated)> > logLikelihoodAcc;
+	accumulator_set<value_type, stats<tag::sum(compensated)> > derivativeFlatAcc;
+	for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk) {
+		logLikelihoodAcc (logLikelihoodChunks [iChunk]);
+		derivativeFlatAcc(derivativeFlatChunks[iChunk]);
+	}
+	for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
+				accumulator_set<complexT, stats<tag::sum(compensated)> > derivativeAcc;
+				for (unsigned int iChunk = 0; iChunk < nmbEvtChunks; ++iChunk)
+					derivativeAcc(derivativesChunks[iChunk][iRank][iRefl][iWave]);
+				derivatives[iRank][iRefl][iWave] = sum(derivativeAcc);
+			}
+	logLikelihood  = sum(logLikelihoodAcc);
+	derivativeFlat = sum(derivativeFlatAcc);
+}
+
+
+// accumulates real-data term of log likelihood for the events in
+// [evtBegin, evtEnd); the storage type of the decay amplitudes is a
+// template parameter, so that it is selected once per call and not
+// for every amplitude
+template<typename complexT>
+template<typename decayAmpsT>
+void
+pwaLikelihood<complexT>::logLikelihoodEvents(const decayAmpsT*        decayAmps,
+                                             const prodAmpsArrayType& prodAmps,
+                                             const value_type         prodAmpFlat2,
+                                             const size_t             evtBegin,
+                                             const size_t             evtEnd,
+                                             valueAccType&            logLikelihoodAcc) const
+{
+	for (size_t iEvt = evtBegin; iEvt < evtEnd; ++iEvt) {
+		valueAccType likelihoodAcc;
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+				complexAccType ampProdAcc;
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)  // coherent sum over waves
+					ampProdAcc(prodAmps[iRank][iRefl][iWave] * complexT(decayAmps[iRefl][iEvt][iWave]));
+				likelihoodAcc(norm(sum(ampProdAcc)));
+			}
+		}  // end loop over rank
+		likelihoodAcc   (prodAmpFlat2            );
+		logLikelihoodAcc(-log(sum(likelihoodAcc)));
+	}  // end loop over events
+}
+
+
+// accumulates derivatives of real-data term of log likelihood with
+// respect to the production amplitudes and, if logLikelihoodAcc is
+// not null, the real-data term itself for the events in [evtBegin,
+// evtEnd); see logLikelihoodEvents() for the template parameter
+template<typename complexT>
+template<typename decayAmpsT>
+void
+pwaLikelihood<complexT>::logLikelihoodDerivEvents(const decayAmpsT*               decayAmps,
+                                                  const prodAmpsArrayType&        prodAmps,
+                                                  const value_type                prodAmpFlat,
+                                                  const size_t                    evtBegin,
+                                                  const size_t                    evtEnd,
+                                                  valueAccType*                   logLikelihoodAcc,
+                                                  multi_array<complexAccType, 3>& derivativesAcc,
+                                                  valueAccType&                   derivativeFlatAcc) const
+{
+	const value_type                                   prodAmpFlat2 = prodAmpFlat * prodAmpFlat;
+	boost::array<typename prodAmpsArrayType::index, 3> derivShape   = {{ _rank, 2, _nmbWavesReflMax }};
+	prodAmpsArrayType                                  derivative(derivShape);  // likelihood derivatives for current event
+	for (size_t iEvt = evtBegin; iEvt < evtEnd; ++iEvt) {
+		valueAccType likelihoodAcc;
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank) {  // incoherent sum over ranks
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl) {  // incoherent sum over reflectivities
+				complexAccType ampProdAcc;
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)  // coherent sum over waves
+					ampProdAcc(prodAmps[iRank][iRefl][iWave] * complexT(decayAmps[iRefl][iEvt][iWave]));
+				const complexT ampProdSum = sum(ampProdAcc);
+				likelihoodAcc(norm(ampProdSum));
+				// set derivative term that is independent on derivative wave index
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					// amplitude sums for current rank and for waves with same reflectivity
+					derivative[iRank][iRefl][iWave] = ampProdSum;
+			}
+			// loop again over waves for current rank and multiply with complex conjugate
+			// of decay amplitude of the wave with the derivative wave index
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					derivative[iRank][iRefl][iWave] *= conj(complexT(decayAmps[iRefl][iEvt][iWave]));
+		}  // end loop over rank
+		likelihoodAcc(prodAmpFlat2);
+		if (logLikelihoodAcc)
+			(*logLikelihoodAcc)(-log(sum(likelihoodAcc)));
+		// incorporate factor 2 / sigma
+		const value_type factor = 2. / sum(likelihoodAcc);
+		for (unsigned int iRank = 0; iRank < _rank; ++iRank)
+			for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+				for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave)
+					derivativesAcc[iRank][iRefl][iWave](-factor * derivative[iRank][iRefl][iWave]);
+		derivativeFlatAcc(-factor * prodAmpFlat);
+	}  // end loop over events
+}
+
+
+// copies the decay amplitudes of the events in [blockBegin,
+// blockBegin + nmbBlockEvts) into the vectors y = [Re decayAmp, Im
+// decayAmp, 1] used for the Hessian; see logLikelihoodEvents() for
+// the template parameter
+template<typename complexT>
+template<typename decayAmpsT>
+void
+pwaLikelihood<complexT>::fillDecayAmpVectors(const decayAmpsT* decayAmps,
+                                             const size_t      blockBegin,
+                                             const size_t      nmbBlockEvts,
+                                             value_type*       ampVectors) const
+{
+	const unsigned int nmbAmps       = _nmbWavesRefl[0] + _nmbWavesRefl[1];
+	const unsigned int ampOffsets[2] = {0, _nmbWavesRefl[0]};
+	const unsigned int ampDim        = 2 * nmbAmps + 1;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(_nmbThreads) schedule(static)
+#endif
+	for (size_t iBlockEvt = 0; iBlockEvt < nmbBlockEvts; ++iBlockEvt) {
+		const size_t iEvt = blockBegin + iBlockEvt;
+		value_type*  y    = &ampVectors[iBlockEvt * ampDim];
+		for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
+			for (unsigned int iWave = 0; iWave < _nmbWavesRefl[iRefl]; ++iWave) {
+				const complexT amp = complexT(decayAmps[iRefl][iEvt][iWave]);
+				y[ampOffsets[iRefl] + iWave]           = amp.real();
+				y[ampOffsets[iRefl] + iWave + nmbAmps] = amp.imag();
+			}
+		y[2 * nmbAmps] = 1;
+	}
 }
 
 
@@ -1714,6 +2070,8 @@ pwaLikelihood<complexT>::print(ostream& out) const
 #ifdef USE_CUDA
 	    << "use CUDA kernels ........................ " << _cudaEnabled       << endl
 #endif
+	    << "number of threads ....................... " << _nmbThreads        << endl
+	    << "use vectorized kernels .................. " << _simdEnabled       << endl
 	    << "use normalized amplitudes ............... " << _useNormalizedAmps << endl
 	    << "list of waves: " << endl;
 	for (unsigned int iRefl = 0; iRefl < 2; ++iRefl)
@@ -1746,6 +2104,71 @@ pwaLikelihood<complexT>::printFuncInfo(ostream& out) const
 }
 
 
+// the function call statistics and the derivative cache are the only
+// state that is modified by the const member functions; they are
+// guarded, so that several minimizations can use the same likelihood
+// object concurrently
+template<typename complexT>
+void
+pwaLikelihood<complexT>::countFuncCall(const functionCallEnum func) const
+{
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+	++(_funcCallInfo[func].nmbCalls);
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::addFuncCallTime(typename functionCallInfo::timeAccType& timeAcc,
+                                         const double                           time) const
+{
+#ifdef _OPENMP
+#pragma omp critical(pwaLikelihoodFuncCallInfo)
+#endif
+	timeAcc(time);
+}
+
+
+template<typename complexT>
+void
+pwaLikelihood<complexT>::storeInDerivCache(const double* par,
+                                           const double* gradient) const
+{
+#ifdef _OPENMP
+#pragma omp critical(pwaLikelihoodDerivCache)
+#endif
+	for (unsigned int i = 0; i < _nmbPars; ++i) {
+		_parCache  [i] = par     [i];
+		_derivCache[i] = gradient[i];
+	}
+}
+
+
+template<typename complexT>
+bool
+pwaLikelihood<complexT>::lookUpDerivCache(const double* par,
+                                          double*       gradient) const
+{
+	bool samePar = true;
+#ifdef _OPENMP
+#pragma omp critical(pwaLikelihoodDerivCache)
+#endif
+	{
+		for (unsigned int i = 0; i < _nmbPars; ++i)
+			if (_parCache[i] != par[i]) {
+				samePar = false;
+				break;
+			}
+		if (samePar)
+			for (unsigned int i = 0; i < _nmbPars; ++i)
+				gradient[i] = _derivCache[i];
+	}
+	return samePar;
+}
+
+
 template<typename complexT>
 void
 pwaLikelihood<complexT>::resetFuncCallInfo() const
@@ -51,6 +51,7 @@
 #include "ampIntegralMatrix.h"
 #include "sumAccumulators.hpp"
 #include "eventMetadata.h"
+#include "likelihoodSimdKernels.h"
 
 
 class TString;
@@ -76,6 +77,7 @@ namespace rpwa {
 		typedef boost::multi_array<boost::tuples::tuple<int, int>,            3> ampToParMapType;       // array for mapping of amplitudes to parameters
 		typedef boost::multi_array<complexT,                                  3> prodAmpsArrayType;     // array for production and decay amplitudes
 		typedef boost::multi_array<complexT,                                  2> decayAmpsArrayType;    // with memory layout to save memory
+		typedef boost::multi_array<std::complex<float>,                       2> decayAmpsSingleArrayType;  // decay amplitudes stored in single precision
 		typedef boost::multi_array<complexT,                                  4> normMatrixArrayType;   // array for normalization matrices
 		typedef boost::multi_array<value_type,                                2> phaseSpaceIntType;     // array for phase space integrals
 		typedef boost::multi_array<bool,                                      2> waveAmpAddedArrayType; // array for wave amplitudes read
@@ -205,8 +207,16 @@ namespace rpwa {
 		// modifiers
 		void          enableCuda        (const bool      enableCuda = true);
 		bool          cudaEnabled       () const;
+		void          setNmbThreads     (const unsigned int nmbThreads = 0);                      ///< sets number of threads used in event loops; 0 uses all available threads
+		unsigned int  nmbThreads        () const                            { return _nmbThreads;             }
+		void          enableSimd        (const bool      enableSimd = true);                      ///< use vectorized CPU kernels for likelihood and gradient; rearranges decay amplitudes, which doubles their memory footprint
+		bool          simdEnabled       () const                            { return _simdEnabled;            }
 		void          useNormalizedAmps (const bool      useNorm    = true) { _useNormalizedAmps = useNorm;   }
 		bool          normalizedAmpsUsed() const                            { return _useNormalizedAmps;      }
+		void          useSinglePrecisionAmps(const bool useSingle = true);                      ///< stores decay amplitudes in single precision to halve their memory footprint; all arithmetic and sums are still done in the precision of complexT; has to be called before addAmplitude()
+		bool          singlePrecisionAmpsUsed() const                       { return _singlePrecisionAmps;    }
+		void          setAmpCacheDirectory(const std::string& ampCacheDirectory) { _ampCacheDirectory = ampCacheDirectory; }  ///< sets directory of memory-mapped amplitude cache files used by addAmplitude(); missing cache files are created; empty string disables the cache
+		const std::string& ampCacheDirectory() const                      { return _ampCacheDirectory;      }
 		void          setPriorType      (const priorEnum priorType  = FLAT) { _priorType         = priorType; }
 		priorEnum     priorType         () const                            { return _priorType;              }
 		void          setCauchyWidth    (const double    cauchyWidth)       { _cauchyWidth = cauchyWidth;     }
@@ -270,6 +280,52 @@ namespace rpwa {
 	private:
 
 		void resetFuncCallInfo() const;
+		void countFuncCall    (const functionCallEnum func) const;  ///< thread-safe increment of call counter
+		void addFuncCallTime  (typename functionCallInfo::timeAccType& timeAcc,
+		                       const double                           time) const;  ///< thread-safe update of timing statistics
+		void storeInDerivCache(const double* par,
+		                       const double* gradient) const;  ///< thread-safe update of derivative cache
+		bool lookUpDerivCache (const double* par,
+		                       double*       gradient) const;  ///< copies cached derivatives to gradient, if they were calculated for par; thread-safe
+
+		typedef boost::accumulators::accumulator_set
+		  <value_type, boost::accumulators::stats
+			<boost::accumulators::tag::sum(boost::accumulators::compensated)> > valueAccType;
+		typedef boost::accumulators::accumulator_set
+		  <complexT, boost::accumulators::stats
+			<boost::accumulators::tag::sum(boost::accumulators::compensated)> > complexAccType;
+
+		// event loops over the decay amplitudes; they are templated on the
+		// storage type (_decayAmps or _decayAmpsSingle), which is selected
+		// once per call and not for every amplitude
+		template<typename decayAmpsT>
+		void logLikelihoodEvents     (const decayAmpsT*                      decayAmps,
+		                              const prodAmpsArrayType&               prodAmps,
+		                              const value_type                       prodAmpFlat2,
+		                              const size_t                           evtBegin,
+		                              const size_t                           evtEnd,
+		                              valueAccType&                          logLikelihoodAcc) const;  ///< accumulates real-data term of log likelihood
+		template<typename decayAmpsT>
+		void logLikelihoodDerivEvents(const decayAmpsT*                      decayAmps,
+		                              const prodAmpsArrayType&               prodAmps,
+		                              const value_type                       prodAmpFlat,
+		                              const size_t                           evtBegin,
+		                              const size_t                           evtEnd,
+		                              valueAccType*                          logLikelihoodAcc,
+		                              boost::multi_array<complexAccType, 3>& derivativesAcc,
+		                              valueAccType&                          derivativeFlatAcc) const;  ///< accumulates derivatives of real-data term of log likelihood and, if logLikelihoodAcc is not null, the term itself
+		template<typename decayAmpsT>
+		void fillDecayAmpVectors     (const decayAmpsT*                      decayAmps,
+		                              const size_t                           blockBegin,
+		                              const size_t                           nmbBlockEvts,
+		                              value_type*                            ampVectors) const;  ///< copies decay amplitudes of a block of events into the vectors used for the Hessian
+
+		void fillDecayAmpsSoA();  ///< copies decay amplitudes into layout used by vectorized kernels
+		void simdLogLikelihoodDeriv(const prodAmpsArrayType& prodAmps,
+		                            const value_type         prodAmpFlat,
+		                            value_type&              logLikelihood,
+		                            prodAmpsArrayType&       derivatives,
+		                            value_type&              derivativeFlat) const;
 
 		unsigned int _nmbEvents;        // number of events
 		unsigned int _rank;             // rank of spin density matrix
@@ -286,7 +342,11 @@ namespace rpwa {
 	#ifdef USE_CUDA
 		bool                _cudaEnabled;        // if true CUDA kernels are used for some calculations
 	#endif
+		unsigned int        _nmbThreads;         // number of threads used in event loops
+		bool                _simdEnabled;        // if true vectorized CPU kernels are used for likelihood and gradient
+		bool                _singlePrecisionAmps;  // if true decay amplitudes are stored in single precision
 		bool                _useNormalizedAmps;  // if true normalized amplitudes are used
+		std::string         _ampCacheDirectory;  // directory of amplitude cache files; empty if no cache is used
 		priorEnum           _priorType;          // which prior to apply to parameters
 		double              _cauchyWidth;        // width for the half-Cauchy prior
 
@@ -305,6 +365,9 @@ namespace rpwa {
                                                                 // is not existing due to rank restrictions
 
                 decayAmpsArrayType _decayAmps[2];  // precalculated decay amplitudes [reflectivity][event index][wave index]
+                decayAmpsSingleArrayType _decayAmpsSingle[2];  // same as _decayAmps, but in single precision; used instead of _decayAmps if _singlePrecisionAmps is set
+		simd::decayAmpsSoA<value_type> _decayAmpsSoA;  // copy of decay amplitudes in layout of vectorized kernels; only filled if _simdEnabled is set
+		simd::decayAmpsSoA<float>      _decayAmpsSoASingle;  // same as _decayAmpsSoA for single-precision storage
 
                 mutable std::vector<double> _parCache;    // parameter cache for derivative calc.
                 mutable std::vector<double> _derivCache;  // cache for derivatives
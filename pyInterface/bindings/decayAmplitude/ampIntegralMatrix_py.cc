@@ -49,7 +49,9 @@ namespace {
 	                                 const long maxNmbEvents,
 	                                 const std::string& weightFileName,
 	                                 const rpwa::eventMetadata* eventMeta,
-	                                 const bp::dict& pyOtfBin)
+	                                 const bp::dict& pyOtfBin,
+	                                 const unsigned int nmbThreads,
+	                                 const long nmbEventsPerBlock)
 	{
 		std::vector<const rpwa::amplitudeMetadata*> amplitudeMeta;
 		if(not rpwa::py::convertBPObjectToVector<const rpwa::amplitudeMetadata*>(pyAmplitudeMetadata, amplitudeMeta)) {
@@ -57,7 +59,7 @@ namespace {
 			bp::throw_error_already_set();
 		}
 		const rpwa::multibinBoundariesType otfBin = rpwa::py::convertMultibinBoundariesFromPy(pyOtfBin);
-		return self.integrate(amplitudeMeta, maxNmbEvents, weightFileName, eventMeta, otfBin);
+		return self.integrate(amplitudeMeta, maxNmbEvents, weightFileName, eventMeta, otfBin, nmbThreads, nmbEventsPerBlock);
 	}
 
 	bool ampIntegralMatrix_setWaveNames(rpwa::ampIntegralMatrix& self,
@@ -154,7 +156,9 @@ void rpwa::py::exportAmpIntegralMatrix() {
 		        bp::arg("maxNmbEvents")=0,
 		        bp::arg("weightFileName")="",
 		        bp::arg("eventMeta")=bp::object(),
-		        bp::arg("otfBin")=bp::dict())
+		        bp::arg("otfBin")=bp::dict(),
+		        bp::arg("nmbThreads")=1,
+		        bp::arg("nmbEventsPerBlock")=10000)
 		)
 		.def("setWaveNames"
 		     , &ampIntegralMatrix_setWaveNames
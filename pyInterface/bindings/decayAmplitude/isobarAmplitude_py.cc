@@ -68,6 +68,10 @@ namespace {
 		return rpwa::py::convertToPy<TLorentzRotation>(rpwa::isobarAmplitude::gjTransform(*beamLv, *XLv));
 	}
 
+	std::complex<double> isobarAmplitude_amplitude(const rpwa::isobarAmplitude& self) {
+		return self.amplitude();
+	}
+
 	std::string isobarAmplitude_printParameters(const rpwa::isobarAmplitude& self) {
 		std::stringstream sstr;
 		self.printParameters(sstr);
@@ -98,11 +102,13 @@ void rpwa::py::exportIsobarAmplitude() {
 		.add_property("isospinSymmetrization", &rpwa::isobarAmplitude::isospinSymmetrization, &rpwa::isobarAmplitude::enableIsospinSymmetrization)
 		.add_property("doSpaceInversion", &rpwa::isobarAmplitude::doSpaceInversion, &rpwa::isobarAmplitude::enableSpaceInversion)
 		.add_property("doReflection", &rpwa::isobarAmplitude::doReflection, &rpwa::isobarAmplitude::enableReflection)
+		.add_property("helicityMemoization", &rpwa::isobarAmplitude::helicityMemoization, &rpwa::isobarAmplitude::enableHelicityMemoization)
+		.add_property("subsystemSharing", &rpwa::isobarAmplitude::subsystemSharing, &rpwa::isobarAmplitude::enableSubsystemSharing)
 
 		.def("gjTransform", &isobarAmplitude_gjTransform)
 		.staticmethod("gjTransform")
 
-		.def("amplitude", &rpwa::isobarAmplitude::amplitude)
+		.def("amplitude", &isobarAmplitude_amplitude)
 
 		.def("__call__", &rpwa::isobarAmplitude::operator())
 
@@ -496,7 +496,8 @@ void rpwa::py::exportMassDependence() {
 		)
 		.def("__call__", &rpwa::massDependence::operator())
 		.def("name", bp::pure_virtual(&rpwa::massDependence::name))
-		.add_static_property("debugMassDependence", &rpwa::massDependence::debug, &rpwa::massDependence::setDebug);
+		.add_static_property("debugMassDependence", &rpwa::massDependence::debug, &rpwa::massDependence::setDebug)
+		.add_static_property("tabulation", &rpwa::massDependence::tabulation, &rpwa::massDependence::enableTabulation);
 
 	bp::class_<flatMassDependenceWrapper, bp::bases<rpwa::massDependence> >("flatMassDependence")
 		.def(bp::self_ns::str(bp::self))
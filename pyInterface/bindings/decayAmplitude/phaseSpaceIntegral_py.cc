@@ -41,10 +41,14 @@ void rpwa::py::exportPhaseSpaceIntegral() {
 		.def("setDirectory", &rpwa::integralTableContainer::setDirectory)
 		.def("upperMassBound", &rpwa::integralTableContainer::upperMassBound, bp::return_value_policy<bp::copy_const_reference>())
 		.def("setUpperMassBound", &rpwa::integralTableContainer::setUpperMassBound)
+		.def("nmbThreads", &rpwa::integralTableContainer::nmbThreads)
+		.def("setNmbThreads", &rpwa::integralTableContainer::setNmbThreads)
 		.staticmethod("directory")
 		.staticmethod("setDirectory")
 		.staticmethod("upperMassBound")
 		.staticmethod("setUpperMassBound")
+		.staticmethod("nmbThreads")
+		.staticmethod("setNmbThreads")
 
 		.def("getSubWaveNameFromVertex", &integralTableContainer_getSubWaveNameFromVertex)
 		.staticmethod("getSubWaveNameFromVertex");
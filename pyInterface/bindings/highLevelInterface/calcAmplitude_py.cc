@@ -2,7 +2,10 @@
 
 #include <boost/python.hpp>
 
+#include "ampIntegralMatrix.h"
+#include "amplitudeFileWriter.h"
 #include "calcAmplitude.h"
+#include "stlContainers_py.h"
 
 namespace bp = boost::python;
 
@@ -14,14 +17,97 @@ namespace {
 	                       const long int                  maxNmbEvents,
 	                       const bool                      printProgress,
 	                       const std::string&              treePerfStatOutFileName,
-	                       const long int                  treeCacheSize)
+	                       const long int                  treeCacheSize,
+	                       const unsigned int              nmbThreads,
+	                       const long int                  nmbEventsPerBlock,
+	                       const bool                      useCompiledProgram)
 	{
 		return bp::list(rpwa::hli::calcAmplitude(eventMeta,
 		                                         amplitude,
 		                                         maxNmbEvents,
 		                                         printProgress,
 		                                         treePerfStatOutFileName,
-		                                         treeCacheSize));
+		                                         treeCacheSize,
+		                                         nmbThreads,
+		                                         nmbEventsPerBlock,
+		                                         useCompiledProgram));
+	}
+
+
+	bool calcAmplitudes(rpwa::eventMetadata& eventMeta,
+	                    bp::object           pyAmplitudes,
+	                    bp::object           pyAmpFileWriters,
+	                    const long int       maxNmbEvents,
+	                    const bool           printProgress,
+	                    const std::string&   treePerfStatOutFileName,
+	                    const long int       treeCacheSize,
+	                    const unsigned int   nmbThreads,
+	                    const long int       nmbEventsPerBlock)
+	{
+		std::vector<rpwa::isobarAmplitudePtr> amplitudes;
+		if(not rpwa::py::convertBPObjectToVector<rpwa::isobarAmplitudePtr>(pyAmplitudes, amplitudes))
+		{
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for amplitudes when executing rpwa::hli::calcAmplitudes()");
+			bp::throw_error_already_set();
+		}
+		std::vector<rpwa::amplitudeFileWriter*> ampFileWriters;
+		if(not rpwa::py::convertBPObjectToVector<rpwa::amplitudeFileWriter*>(pyAmpFileWriters, ampFileWriters))
+		{
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for ampFileWriters when executing rpwa::hli::calcAmplitudes()");
+			bp::throw_error_already_set();
+		}
+		return rpwa::hli::calcAmplitudes(eventMeta,
+		                                 amplitudes,
+		                                 ampFileWriters,
+		                                 maxNmbEvents,
+		                                 printProgress,
+		                                 treePerfStatOutFileName,
+		                                 treeCacheSize,
+		                                 nmbThreads,
+		                                 nmbEventsPerBlock);
+	}
+
+
+	bp::object calcIntegralsOnTheFly(rpwa::eventMetadata&     eventMeta,
+	                                 bp::object               pyAmplitudes,
+	                                 bp::object               pyWaveNames,
+	                                 const bp::dict&          pyOtfBin,
+	                                 rpwa::ampIntegralMatrix& integralMatrix,
+	                                 const long int           startEvent,
+	                                 const long int           maxNmbEvents,
+	                                 const bool               printProgress,
+	                                 const unsigned int       nmbThreads,
+	                                 const long int           nmbEventsPerBlock)
+	{
+		std::vector<rpwa::isobarAmplitudePtr> amplitudes;
+		if(not rpwa::py::convertBPObjectToVector<rpwa::isobarAmplitudePtr>(pyAmplitudes, amplitudes))
+		{
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for amplitudes when executing rpwa::hli::calcIntegralsOnTheFly()");
+			bp::throw_error_already_set();
+		}
+		std::vector<std::string> waveNames;
+		if(not rpwa::py::convertBPObjectToVector<std::string>(pyWaveNames, waveNames))
+		{
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for waveNames when executing rpwa::hli::calcIntegralsOnTheFly()");
+			bp::throw_error_already_set();
+		}
+		const rpwa::multibinBoundariesType otfBin = rpwa::py::convertMultibinBoundariesFromPy(pyOtfBin);
+		std::vector<std::string> ampHashes;
+		if(not rpwa::hli::calcIntegralsOnTheFly(eventMeta,
+		                                        amplitudes,
+		                                        waveNames,
+		                                        otfBin,
+		                                        integralMatrix,
+		                                        ampHashes,
+		                                        startEvent,
+		                                        maxNmbEvents,
+		                                        printProgress,
+		                                        nmbThreads,
+		                                        nmbEventsPerBlock))
+		{
+			return bp::object();
+		}
+		return bp::list(ampHashes);
 	}
 
 }
@@ -38,7 +124,39 @@ void rpwa::py::exportCalcAmplitude()
 		   bp::arg("maxNmbEvents") = -1,
 		   bp::arg("printProgress") = true,
 		   bp::arg("treePerfStatOutFileName") = "",
-		   bp::arg("treeCacheSize") = 25000000)
+		   bp::arg("treeCacheSize") = 25000000,
+		   bp::arg("nmbThreads") = 1,
+		   bp::arg("nmbEventsPerBlock") = 10000,
+		   bp::arg("useCompiledProgram") = false)
+	);
+
+	bp::def(
+		"calcAmplitudes"
+		, &::calcAmplitudes
+		, (bp::arg("eventMeta"),
+		   bp::arg("amplitudes"),
+		   bp::arg("ampFileWriters"),
+		   bp::arg("maxNmbEvents") = -1,
+		   bp::arg("printProgress") = true,
+		   bp::arg("treePerfStatOutFileName") = "",
+		   bp::arg("treeCacheSize") = 25000000,
+		   bp::arg("nmbThreads") = 1,
+		   bp::arg("nmbEventsPerBlock") = 10000)
+	);
+
+	bp::def(
+		"calcIntegralsOnTheFly"
+		, &::calcIntegralsOnTheFly
+		, (bp::arg("eventMeta"),
+		   bp::arg("amplitudes"),
+		   bp::arg("waveNames"),
+		   bp::arg("otfBin"),
+		   bp::arg("integralMatrix"),
+		   bp::arg("startEvent") = 0,
+		   bp::arg("maxNmbEvents") = -1,
+		   bp::arg("printProgress") = true,
+		   bp::arg("nmbThreads") = 1,
+		   bp::arg("nmbEventsPerBlock") = 10000)
 	);
 
 }
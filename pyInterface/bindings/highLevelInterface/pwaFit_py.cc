@@ -22,6 +22,30 @@ namespace {
 		return rpwa::hli::pwaFit(L, multibinBoundaries, seed, startValFileName, checkHessian, saveSpace, verbose);
 	}
 
+	bp::list pwaFit_pwaMultiStartFit(const rpwa::pwaLikelihood<std::complex<double> >& L,
+	                                 const bp::dict& pyMultibinBoundaries,
+	                                 const bp::object& pySeeds,
+	                                 const std::string& startValFileName = "",
+	                                 const bool checkHessian = false,
+	                                 const bool saveSpace = false,
+	                                 const bool verbose = false,
+	                                 const unsigned int nmbThreads = 1)
+	{
+		const rpwa::multibinBoundariesType multibinBoundaries = rpwa::py::convertMultibinBoundariesFromPy(pyMultibinBoundaries);
+		std::vector<unsigned int> seeds;
+		if(not rpwa::py::convertBPObjectToVector<unsigned int>(pySeeds, seeds)) {
+			PyErr_SetString(PyExc_TypeError, "Got invalid input for seeds when executing rpwa::hli::pwaMultiStartFit()");
+			bp::throw_error_already_set();
+		}
+		const std::vector<rpwa::fitResultPtr> results = rpwa::hli::pwaMultiStartFit(L, multibinBoundaries, seeds, startValFileName,
+		                                                                             checkHessian, saveSpace, verbose, nmbThreads);
+		bp::list pyResults;
+		for(unsigned int i = 0; i < results.size(); ++i) {
+			pyResults.append(results[i]);
+		}
+		return pyResults;
+	}
+
 }
 
 void rpwa::py::exportPwaFit()
@@ -39,4 +63,17 @@ void rpwa::py::exportPwaFit()
 		   bp::arg("verbose") = false)
 	);
 
+	bp::def(
+		"pwaMultiStartFit"
+		, &pwaFit_pwaMultiStartFit
+		, (bp::arg("likelihood"),
+		   bp::arg("multibinBoundaries"),
+		   bp::arg("seeds"),
+		   bp::arg("startValFileName") = "",
+		   bp::arg("checkHessian") = false,
+		   bp::arg("saveSpace") = false,
+		   bp::arg("verbose") = false,
+		   bp::arg("nmbThreads") = 1)
+	);
+
 }
@@ -295,8 +295,32 @@ void rpwa::py::exportPwaLikelihood() {
 			, &rpwa::pwaLikelihood<std::complex<double> >::parameters
 			, bp::return_internal_reference<>()
 		)
+		.def(
+			"setNmbThreads"
+			, &rpwa::pwaLikelihood<std::complex<double> >::setNmbThreads
+			, (bp::arg("nmbThreads") = 0)
+		)
+		.def("nmbThreads", &rpwa::pwaLikelihood<std::complex<double> >::nmbThreads)
+		.def(
+			"enableSimd"
+			, &rpwa::pwaLikelihood<std::complex<double> >::enableSimd
+			, (bp::arg("enableSimd") = true)
+		)
+		.def("simdEnabled", &rpwa::pwaLikelihood<std::complex<double> >::simdEnabled)
 		.def("useNormalizedAmps", &rpwa::pwaLikelihood<std::complex<double> >::useNormalizedAmps)
 		.def("normalizedAmpsUsed", &rpwa::pwaLikelihood<std::complex<double> >::normalizedAmpsUsed)
+		.def(
+			"useSinglePrecisionAmps"
+			, &rpwa::pwaLikelihood<std::complex<double> >::useSinglePrecisionAmps
+			, (bp::arg("useSingle") = true)
+		)
+		.def("singlePrecisionAmpsUsed", &rpwa::pwaLikelihood<std::complex<double> >::singlePrecisionAmpsUsed)
+		.def("setAmpCacheDirectory", &rpwa::pwaLikelihood<std::complex<double> >::setAmpCacheDirectory)
+		.def(
+			"ampCacheDirectory"
+			, &rpwa::pwaLikelihood<std::complex<double> >::ampCacheDirectory
+			, bp::return_value_policy<bp::copy_const_reference>()
+		)
 		.def("setPriorType", &rpwa::pwaLikelihood<std::complex<double> >::setPriorType)
 		.def("priorType", &rpwa::pwaLikelihood<std::complex<double> >::priorType)
 		.def("setCauchyWidth", &rpwa::pwaLikelihood<std::complex<double> >::setCauchyWidth)
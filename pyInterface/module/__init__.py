@@ -1,5 +1,6 @@
 
 from _amplitude import calcAmplitude
+from _amplitude import calcAmplitudes
 from _config import rootPwaConfig
 from _fileManager import fileManager
 from _fileManager import saveFileManager
@@ -9,7 +9,8 @@ def calcAmplitude(inputFileName,
                   waveName,
                   waveDescription,
                   outputFileName,
-                  printProgress = True):
+                  printProgress = True,
+                  nmbThreads = 1):
 
 	printInfo = pyRootPwa.utils.printInfo
 	printSucc = pyRootPwa.utils.printSucc
@@ -47,7 +48,7 @@ def calcAmplitude(inputFileName,
 		printWarn("could not initialize amplitudeFileWriter.")
 		outputFile.Close()
 		return False
-	amplitudes = pyRootPwa.core.calcAmplitude(eventMeta, amplitude, -1, printProgress)
+	amplitudes = pyRootPwa.core.calcAmplitude(eventMeta, amplitude, -1, printProgress, nmbThreads = nmbThreads)
 	if not amplitudes:
 		printWarn("could not calculate amplitudes.")
 		outputFile.Close()
@@ -66,3 +67,74 @@ def calcAmplitude(inputFileName,
 	outputFile.Close()
 	printSucc("successfully calculated amplitude for " + str(nEvents) + " events.")
 	return True
+
+def calcAmplitudes(inputFileName,
+                   waveNames,
+                   waveDescriptions,
+                   outputFileNames,
+                   printProgress = True,
+                   nmbThreads = 1):
+
+	printInfo = pyRootPwa.utils.printInfo
+	printSucc = pyRootPwa.utils.printSucc
+	printWarn = pyRootPwa.utils.printWarn
+
+	printInfo("Calculating amplitudes for " + str(len(waveNames)) + " waves" +
+	          " with input file '" + inputFileName + "' in a single pass.")
+
+	if 'ROOTPWA' not in _os.environ:
+		printWarn("$ROOTPWA not set.")
+		return False
+
+	inputFile = ROOT.TFile.Open(inputFileName, "READ")
+	if not inputFile:
+		printWarn("could not open input file '" + inputFileName + "'.")
+		return False
+	eventMeta = pyRootPwa.core.eventMetadata.readEventFile(inputFile, True)
+	if not eventMeta:
+		printWarn("could not read metadata from input file '" + inputFileName + "'.")
+		return False
+
+	success = True
+	amplitudes = []
+	ampFileWriters = []
+	outputFiles = []
+	for waveName, waveDescription, outputFileName in zip(waveNames, waveDescriptions, outputFileNames):
+		outputFile = ROOT.TFile.Open(outputFileName, "NEW")
+		if not outputFile:
+			printWarn("could not open output file '" + outputFileName + "'.")
+			success = False
+			continue
+		(result, amplitude) = waveDescription.constructAmplitude()
+		if not result:
+			printWarn("could not construct amplitude for wave '" + waveName + "'.")
+			outputFile.Close()
+			success = False
+			continue
+		ampFileWriter = pyRootPwa.core.amplitudeFileWriter()
+		objectBaseName = waveDescription.waveNameFromTopology(amplitude.decayTopology())
+		if not ampFileWriter.initialize(outputFile, [eventMeta], waveDescription.keyFileContent(), objectBaseName):
+			printWarn("could not initialize amplitudeFileWriter for wave '" + waveName + "'.")
+			outputFile.Close()
+			success = False
+			continue
+		amplitudes.append(amplitude)
+		ampFileWriters.append(ampFileWriter)
+		outputFiles.append(outputFile)
+	if not amplitudes:
+		return False
+
+	if not pyRootPwa.core.calcAmplitudes(eventMeta, amplitudes, ampFileWriters, -1, printProgress, nmbThreads = nmbThreads):
+		printWarn("could not calculate amplitudes.")
+		for outputFile in outputFiles:
+			outputFile.Close()
+		return False
+	for ampFileWriter, outputFile in zip(ampFileWriters, outputFiles):
+		if not ampFileWriter.finalize():
+			printWarn("could not finalize amplitudeFileWriter for output file '" + outputFile.GetName() + "'.")
+			success = False
+		outputFile.Close()
+
+	nEvents = eventMeta.eventTree().GetEntries()
+	printSucc("successfully calculated amplitudes of " + str(len(amplitudes)) + " waves for " + str(nEvents) + " events.")
+	return success
@@ -20,11 +20,18 @@ def pwaFit(eventAndAmpFileDict,
            checkHessian=False,
            saveSpace=False,
            rank=1,
+           nmbThreads=1,
+           useSimd=False,
+           singlePrecisionAmps=False,
+           ampCacheDirectory="",
            verbose=False,
            attempts=1,
-           keepMatricesOnlyOfBest= False
+           keepMatricesOnlyOfBest= False,
+           nmbParallelFits=1
           ):
 	return _pwaFit(fitFunction            = pyRootPwa.core.pwaFit,
+	               multiStartFitFunction  = pyRootPwa.core.pwaMultiStartFit,
+	               nmbParallelFits        = nmbParallelFits,
 	               eventAndAmpFileDict    = eventAndAmpFileDict,
 	               normIntegralFileName   = normIntegralFileName,
 	               accIntegralFileName    = accIntegralFileName,
@@ -40,6 +47,10 @@ def pwaFit(eventAndAmpFileDict,
 	               checkHessian           = checkHessian,
 	               saveSpace              = saveSpace,
 	               rank                   = rank,
+	               nmbThreads             = nmbThreads,
+	               useSimd                = useSimd,
+	               singlePrecisionAmps    = singlePrecisionAmps,
+	               ampCacheDirectory      = ampCacheDirectory,
 	               verbose                = verbose,
 	               attempts               = attempts,
 	               keepMatricesOnlyOfBest = keepMatricesOnlyOfBest)
@@ -60,11 +71,17 @@ def pwaNloptFit(eventAndAmpFileDict,
                 checkHessian=False,
                 saveSpace=False,
                 rank=1,
+                nmbThreads=1,
+                useSimd=False,
+                singlePrecisionAmps=False,
+                ampCacheDirectory="",
                 verbose=False,
                 attempts=1,
                 keepMatricesOnlyOfBest= False
                ):
 	return _pwaFit(fitFunction            = pyRootPwa.core.pwaNloptFit,
+	               multiStartFitFunction  = None,
+	               nmbParallelFits        = 1,
 	               eventAndAmpFileDict    = eventAndAmpFileDict,
 	               normIntegralFileName   = normIntegralFileName,
 	               accIntegralFileName    = accIntegralFileName,
@@ -80,12 +97,18 @@ def pwaNloptFit(eventAndAmpFileDict,
 	               checkHessian           = checkHessian,
 	               saveSpace              = saveSpace,
 	               rank                   = rank,
+	               nmbThreads             = nmbThreads,
+	               useSimd                = useSimd,
+	               singlePrecisionAmps    = singlePrecisionAmps,
+	               ampCacheDirectory      = ampCacheDirectory,
 	               verbose                = verbose,
 	               attempts               = attempts,
 	               keepMatricesOnlyOfBest = keepMatricesOnlyOfBest)
 
 
 def _pwaFit(fitFunction,
+            multiStartFitFunction,
+            nmbParallelFits,
             eventAndAmpFileDict,
             normIntegralFileName,
             accIntegralFileName,
@@ -101,6 +124,10 @@ def _pwaFit(fitFunction,
             checkHessian=False,
             saveSpace=False,
             rank=1,
+            nmbThreads=1,
+            useSimd=False,
+            singlePrecisionAmps=False,
+            ampCacheDirectory="",
             verbose=False,
             attempts=1,
             keepMatricesOnlyOfBest= False
@@ -123,6 +150,10 @@ def _pwaFit(fitFunction,
 	                                      cauchy = cauchy,
 	                                      cauchyWidth = cauchyWidth,
 	                                      rank = rank,
+	                                      nmbThreads = nmbThreads,
+	                                      useSimd = useSimd,
+	                                      singlePrecisionAmps = singlePrecisionAmps,
+	                                      ampCacheDirectory = ampCacheDirectory,
 	                                      verbose = verbose)
 	if not likelihood:
 		pyRootPwa.utils.printErr("error while initializing likelihood. Aborting...")
@@ -143,20 +174,35 @@ def _pwaFit(fitFunction,
 			seeds.append(randVal)
 
 	fitResults = [ ]
+	if multiStartFitFunction is not None and nmbParallelFits != 1 and len(seeds) > 1:
+		# run fits concurrently on the same likelihood object
+		fitResults = multiStartFitFunction(likelihood         = likelihood,
+		                                   multibinBoundaries = multiBin.boundaries,
+		                                   seeds              = seeds,
+		                                   startValFileName   = startValFileName,
+		                                   checkHessian       = checkHessian,
+		                                   saveSpace          = saveSpace,
+		                                   verbose            = verbose,
+		                                   nmbThreads         = nmbParallelFits)
+	else:
+		for fitSeed in seeds:
+			fitResults.append(fitFunction(likelihood         = likelihood,
+			                              multibinBoundaries = multiBin.boundaries,
+			                              seed               = fitSeed,
+			                              startValFileName   = startValFileName,
+			                              checkHessian       = checkHessian,
+			                              saveSpace          = saveSpace,
+			                              verbose            = verbose))
+	nmbFailedFits = len([ fitResult for fitResult in fitResults if fitResult is None ])
+	if nmbFailedFits > 0:
+		pyRootPwa.utils.printWarn(str(nmbFailedFits) + " of " + str(len(fitResults)) + " fit attempts could not be performed.")
+		fitResults = [ fitResult for fitResult in fitResults if fitResult is not None ]
+
 	iBest = -1
 	iBestValid = -1
 	negLogLikeBest = np.inf
 	negLogLikeBestValid = np.inf
-	for fitSeed in seeds:
-		fitResult = fitFunction(likelihood         = likelihood,
-		                        multibinBoundaries = multiBin.boundaries,
-		                        seed               = fitSeed,
-		                        startValFileName   = startValFileName,
-		                        checkHessian       = checkHessian,
-		                        saveSpace          = saveSpace,
-		                        verbose            = verbose)
-		fitResults.append(fitResult)
-		iFitResult = len(fitResults)-1
+	for iFitResult, fitResult in enumerate(fitResults):
 		if fitResult.logLikelihood() < negLogLikeBest:
 			negLogLikeBest = fitResult.logLikelihood()
 			iBest = iFitResult
@@ -164,7 +210,7 @@ def _pwaFit(fitFunction,
 			negLogLikeBestValid = fitResult.logLikelihood()
 			iBestValid = iFitResult
 
-	if keepMatricesOnlyOfBest: # calculate covariance matrix only of best result and best valid result
+	if keepMatricesOnlyOfBest and fitResults: # calculate covariance matrix only of best result and best valid result
 		# get matrices
 		norm, acc, psVector = likelihood.integralMatrices(True)
 		fitResults[iBestValid] = _addMatrices(fitResults[iBestValid], likelihood, norm, acc, psVector)
@@ -1,4 +1,3 @@
-import numpy
 import pyRootPwa.utils
 import pyRootPwa.core
 
@@ -25,52 +24,17 @@ def _getAmplitudes(keyFileNameList, prodNames, decayNames, integralMetaData):
 	return amplitudes, waveNames
 
 
-def _integrate(amplitudes, eventTree, waveNames, minEvent, maxEvent, multibinBoundaries):
-	prodKinMomenta  = pyRootPwa.ROOT.TClonesArray("TVector3")
-	decayKinMomenta = pyRootPwa.ROOT.TClonesArray("TVector3")
-	eventTree.SetBranchAddress(pyRootPwa.core.eventMetadata.productionKinematicsMomentaBranchName, prodKinMomenta)
-	eventTree.SetBranchAddress(pyRootPwa.core.eventMetadata.decayKinematicsMomentaBranchName, decayKinMomenta)
+def _integrate(amplitudes, eventMeta, waveNames, startEvent, maxNmbEvents, multibinBoundaries, nmbThreads):
 	integralMatrix = pyRootPwa.core.ampIntegralMatrix()
-	hashers = [pyRootPwa.core.hashCalculator() for _ in range(len(amplitudes))]
-	integralMatrix.setWaveNames(waveNames)
-	ampWaveNameMap   = {}
-	binningVariables = {}
-	for key in multibinBoundaries:
-		binningVariables[key] = numpy.array(1, dtype = float)
-		eventTree.SetBranchAddress(key, binningVariables[key])
-	for waveName in waveNames:
-		ampWaveNameMap[waveName] = 0.+0.j
 	pyRootPwa.utils.printInfo("starting event loop.")
-	skippedEvents = 0
-	progressBar = pyRootPwa.utils.progressBar(minEvent, maxEvent)
-	progressBar.start()
-	for evt_i in range(minEvent, maxEvent):
-		progressBar.update(evt_i)
-		eventTree.GetEvent(evt_i)
-		skipEvent = False
-		for key in multibinBoundaries:
-			if binningVariables[key] < multibinBoundaries[key][0] or  binningVariables[key] >= multibinBoundaries[key][1]:
-				skippedEvents += 1
-				skipEvent = True
-				break
-		if skipEvent:
-			continue
-		for amp_i, amplitude in enumerate(amplitudes):
-			topo = amplitude.decayTopology()
-			if not topo.readKinematicsData(prodKinMomenta, decayKinMomenta):
-				pyRootPwa.utils.printErr("could not load kinematics data. Aborting...")
-				return False, False
-			ampl = amplitude()
-			hashers[amp_i].Update(ampl)
-			ampWaveNameMap[waveNames[amp_i]] = ampl
-		if not integralMatrix.addEvent(ampWaveNameMap):
-			pyRootPwa.utils.printErr("could not add event to integral matrix. Aborting...")
-			return False, False
-	pyRootPwa.utils.printInfo(str(skippedEvents) + " events rejected because they are outside the binning.")
-	return integralMatrix, hashers
+	hashes = pyRootPwa.core.calcIntegralsOnTheFly(eventMeta, amplitudes, waveNames, multibinBoundaries, integralMatrix,
+	                                              startEvent, maxNmbEvents, nmbThreads = nmbThreads)
+	if hashes is None:
+		return False, False
+	return integralMatrix, hashes
 
 
-def calcIntegralsOnTheFly(integralFileName, eventFileName, keyFileNameList, multibinBoundaries = None, maxNmbEvents = -1, startEvent = 0):
+def calcIntegralsOnTheFly(integralFileName, eventFileName, keyFileNameList, multibinBoundaries = None, maxNmbEvents = -1, startEvent = 0, nmbThreads = 1):
 
 	outFile = pyRootPwa.ROOT.TFile.Open(integralFileName, "CREATE")
 	if not outFile: # Do this up here. Without the output file, nothing else makes sense
@@ -89,12 +53,6 @@ def calcIntegralsOnTheFly(integralFileName, eventFileName, keyFileNameList, mult
 	if not amplitudes or not waveNames:
 		pyRootPwa.utils.printErr("could initialize amplitudes. Aborting...")
 		return False
-	eventTree = eventMeta.eventTree()
-	nEvents   = eventTree.GetEntries()
-	minEvent = startEvent
-	maxEvent = nEvents
-	if maxNmbEvents	> -1:
-		maxEvent = min(maxEvent, startEvent + maxNmbEvents)
 	if not metadataObject.addEventMetadata(eventMeta):
 		pyRootPwa.utils.printErr("could not add event metadata to integral metadata. Aborting...")
 		return False
@@ -106,15 +64,15 @@ def calcIntegralsOnTheFly(integralFileName, eventFileName, keyFileNameList, mult
 		if multibinBoundaries["mass"][0] > 200.:
 			multibinBoundaries["mass"] = (multibinBoundaries["mass"][0]/1000.,multibinBoundaries["mass"][1]/1000.)
 	metadataObject.setMultibinBoundaries(multibinBoundaries)
-	integralMatrix, hashers = _integrate(amplitudes, eventTree, waveNames, minEvent, maxEvent, multibinBoundaries)
-	if not integralMatrix or not hashers:
+	integralMatrix, hashes = _integrate(amplitudes, eventMeta, waveNames, startEvent, maxNmbEvents, multibinBoundaries, nmbThreads)
+	if not integralMatrix or hashes is False:
 		pyRootPwa.utils.printErr("could not integrate. Aborting...")
 		return False
 	if not metadataObject.setAmpIntegralMatrix(integralMatrix):
 		pyRootPwa.utils.printErr("could not add the integral matrix to the metadata object. Aborting...")
 		return False
-	for hasher in hashers:
-		if not metadataObject.addAmplitudeHash(hasher.hash()):
+	for ampHash in hashes:
+		if not metadataObject.addAmplitudeHash(ampHash):
 			pyRootPwa.utils.printWarn("could not add the amplitude hash.")
 			# This error is not fatal, since in special cases the same hash can appear twice:
 			# e.g. in freed-isobar analyses with spin zero, the angular dependences are constant
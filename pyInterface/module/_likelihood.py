@@ -12,12 +12,20 @@ def initLikelihood(waveDescThres,
                    cauchy = False,
                    cauchyWidth = 0.5,
                    rank = 1,
+                   nmbThreads = 1,
+                   useSimd = False,
+                   singlePrecisionAmps = False,
+                   ampCacheDirectory = "",
                    verbose = False
                   ):
 	likelihood = pyRootPwa.core.pwaLikelihood()
 	likelihood.useNormalizedAmps(useNormalizedAmps)
 	if not verbose:
 		likelihood.setQuiet()
+	likelihood.setNmbThreads(nmbThreads)
+	likelihood.enableSimd(useSimd)
+	likelihood.useSinglePrecisionAmps(singlePrecisionAmps)
+	likelihood.setAmpCacheDirectory(ampCacheDirectory)
 	if cauchy:
 		likelihood.setPriorType(pyRootPwa.core.pwaLikelihood.HALF_CAUCHY)
 		likelihood.setCauchyWidth(cauchyWidth)
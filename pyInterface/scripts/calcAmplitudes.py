@@ -23,6 +23,7 @@ if __name__ == "__main__":
 	parser.add_argument("-f", "--no-progress-bar", action="store_true", dest="noProgressBar", help="disable progress bars (decreases computing time)")
 	parser.add_argument("-k", "--keyfileIndex", type=int, metavar="#", default=-1,
 	                    help="keyfile index to calculate amplitude for (overrides settings from the config file, index from 0 to number of keyfiles - 1)")
+	parser.add_argument("-t", type=int, metavar="#", dest="nmbThreads", default=1, help="number of threads used to calculate the amplitudes; 0 uses all available threads (default: 1)")
 	parser.add_argument("-w", type=str, metavar="wavelistFileName", default="", dest="wavelistFileName", help="path to wavelist file (default: none)")
 	args = parser.parse_args()
 
@@ -38,6 +39,7 @@ if __name__ == "__main__":
 
 	pyRootPwa.core.integralTableContainer.setDirectory(config.phaseSpaceIntegralDirectory)
 	pyRootPwa.core.integralTableContainer.setUpperMassBound(config.phaseSpaceUpperMassBound)
+	pyRootPwa.core.integralTableContainer.setNmbThreads(args.nmbThreads)
 
 	if not args.wavelistFileName == "" and not args.keyfileIndex == -1:
 		pyRootPwa.utils.printErr("Setting both options -k and -w is conflicting. Aborting...")
@@ -71,6 +73,9 @@ if __name__ == "__main__":
 		pyRootPwa.utils.printErr("Invalid events type given ('" + args.eventsType + "'). Aborting...")
 		sys.exit(1)
 
+	# collect all waves for each event file, so that every event file is read only once
+	eventFilePaths = []
+	wavesForEventFile = {}
 	for waveName in waveList:
 		for eventsType in eventsTypes:
 			eventAmpFilePairs = fileManager.getEventAndAmplitudePairPathsForWave(eventsType, waveName)
@@ -80,6 +85,13 @@ if __name__ == "__main__":
 					sys.exit(1)
 				eventAmpFilePairs = eventAmpFilePairs[args.eventFileId:args.eventFileId+1]
 			for eventFilePath, amplitudeFilePath in eventAmpFilePairs:
-				if not pyRootPwa.calcAmplitude(eventFilePath, waveName, fileManager.getWaveDescription(waveName),
-				                               amplitudeFilePath, not args.noProgressBar):
-					pyRootPwa.utils.printWarn("could not calculate amplitude.")
+				if eventFilePath not in wavesForEventFile:
+					eventFilePaths.append(eventFilePath)
+					wavesForEventFile[eventFilePath] = []
+				wavesForEventFile[eventFilePath].append((waveName, amplitudeFilePath))
+	for eventFilePath in eventFilePaths:
+		waveNames = [ waveName for waveName, _ in wavesForEventFile[eventFilePath] ]
+		amplitudeFilePaths = [ amplitudeFilePath for _, amplitudeFilePath in wavesForEventFile[eventFilePath] ]
+		if not pyRootPwa.calcAmplitudes(eventFilePath, waveNames, [ fileManager.getWaveDescription(waveName) for waveName in waveNames ],
+		                                amplitudeFilePaths, not args.noProgressBar, args.nmbThreads):
+			pyRootPwa.utils.printWarn("could not calculate amplitudes.")
@@ -20,6 +20,7 @@ if __name__ == "__main__":
 	parser.add_argument("-b", type=int, metavar="#", dest="integralBin", default=0, help="integral bin id of fit (default: 0)")
 	parser.add_argument("-C", "--cauchyPriors", help="use half-Cauchy priors (default: false)", action="store_true")
 	parser.add_argument("-P", "--cauchyPriorWidth", type=float, metavar ="WIDTH", default=0.5, help="width of half-Cauchy prior (default: 0.5)")
+	parser.add_argument("-t", type=int, metavar="#", dest="nmbThreads", default=1, help="number of threads used to calculate the Hessian; 0 uses all available threads (default: 1)")
 	parser.add_argument("-A", type=int, metavar="#", dest="accEventsOverride", default=0,
 	                    help="number of input events to normalize acceptance to (default: use number of events from normalization integral file)")
 	parser.add_argument("--noAcceptance", help="do not take acceptance into account (default: false)", action="store_true")
@@ -87,6 +88,7 @@ if __name__ == "__main__":
 	                                      cauchy = args.cauchyPriors,
 	                                      cauchyWidth = args.cauchyPriorWidth,
 	                                      rank = result.rank(),
+	                                      nmbThreads = args.nmbThreads,
 	                                      verbose = args.verbose)
 	if not likelihood:
 		pyRootPwa.utils.printErr("error while initializing likelihood. Aborting...")
@@ -16,6 +16,7 @@ if __name__ == "__main__":
 	parser.add_argument("-b", type=int, metavar="integralBin", default=-1, dest="integralBin", help="bin to be calculated (default: all)")
 	parser.add_argument("-e", type=str, metavar="eventsType", default="all", dest="eventsType", help="events type to be calculated ('generated' or 'accepted', default: both)")
 	parser.add_argument("-w", type=str, metavar="path", dest="weightsFileName", default="", help="path to MC weight file for de-weighting (default: none)")
+	parser.add_argument("-t", type=int, metavar="#", dest="nmbThreads", default=1, help="number of threads used to calculate the integral matrices; 0 uses all available threads (default: 1)")
 	args = parser.parse_args()
 
 	printErr  = pyRootPwa.utils.printErr
@@ -62,7 +63,7 @@ if __name__ == "__main__":
 				printErr("could not retrieve valid amplitude file list. Aborting...")
 				sys.exit(1)
 			printInfo("calculating integral matrix from " + str(len(eventAndAmpFileDict)) + " amplitude files:")
-			if not pyRootPwa.calcIntegrals(outputFileName, eventAndAmpFileDict, multiBin, args.weightsFileName):
+			if not pyRootPwa.calcIntegrals(outputFileName, eventAndAmpFileDict, multiBin, args.weightsFileName, args.nmbThreads):
 				printErr("integral calculation failed. Aborting...")
 				sys.exit(1)
 			printSucc("wrote integral to TKey '" + pyRootPwa.core.ampIntegralMatrix.integralObjectName + "' "
@@ -18,11 +18,18 @@ if __name__ == "__main__":
 	parser.add_argument("-b", type=int, metavar="#", dest="integralBin", default=0, help="integral bin id of fit (default: 0)")
 	parser.add_argument("-s", type=int, metavar="#", dest="seed", default=0, help="random seed (default: 0)")
 	parser.add_argument("-N", type=int, metavar="#", dest="nAttempts", default=1, help="number of fit attempts to perform")
+	parser.add_argument("--parallelFits", type=int, metavar="#", dest="nmbParallelFits", default=1,
+	                    help="number of fit attempts that run concurrently on the same decay amplitudes; 0 uses all available threads (default: 1)")
 	parser.add_argument("-C", "--cauchyPriors", help="use half-Cauchy priors (default: false)", action="store_true")
 	parser.add_argument("-P", "--cauchyPriorWidth", type=float, metavar ="WIDTH", default=0.5, help="width of half-Cauchy prior (default: 0.5)")
 	parser.add_argument("-w", type=str, metavar="path", dest="waveListFileName", default="", help="path to wavelist file (default: none)")
 	parser.add_argument("-S", type=str, metavar="path", dest="startValFileName", default="", help="path to start value fit result file (default: none)")
 	parser.add_argument("-r", type=int, metavar="#", dest="rank", default=1, help="rank of spin density matrix (default: 1)")
+	parser.add_argument("-t", type=int, metavar="#", dest="nmbThreads", default=1, help="number of threads used to calculate the likelihood; 0 uses all available threads (default: 1)")
+	parser.add_argument("--simd", dest="useSimd", action="store_true", help="use vectorized kernels to calculate the likelihood (default: false)")
+	parser.add_argument("--singlePrecisionAmps", dest="singlePrecisionAmps", action="store_true",
+	                    help="store decay amplitudes in single precision to halve their memory footprint; sums are still calculated in double precision (default: false)")
+	parser.add_argument("--ampCache", type=str, metavar="path", dest="ampCacheDirectory", default="", help="directory of memory-mapped amplitude cache files; missing cache files are created (default: none)")
 	parser.add_argument("-A", type=int, metavar="#", dest="accEventsOverride", default=0,
 	                    help="number of input events to normalize acceptance to (default: use number of events from normalization integral file)")
 	parser.add_argument("--do-not-normalize-amplitudes", dest="useNormalizedAmps", action="store_false", help="do not normalize amlitudes (default: normalize amplitudes)")
@@ -92,8 +99,13 @@ if __name__ == "__main__":
 	                              checkHessian = args.checkHessian,
 	                              saveSpace = args.saveSpace,
 	                              rank = args.rank,
+	                              nmbThreads = args.nmbThreads,
+	                              useSimd = args.useSimd,
+	                              singlePrecisionAmps = args.singlePrecisionAmps,
+	                              ampCacheDirectory = args.ampCacheDirectory,
 	                              verbose = args.verbose,
-	                              attempts = args.nAttempts
+	                              attempts = args.nAttempts,
+	                              nmbParallelFits = args.nmbParallelFits
 	                             )
 	if not fitResults:
 		printErr("didn't get valid fit result(s). Aborting...")
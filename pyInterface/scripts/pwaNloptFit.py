@@ -23,6 +23,10 @@ if __name__ == "__main__":
 	parser.add_argument("-w", type=str, metavar="path", dest="waveListFileName", default="", help="path to wavelist file (default: none)")
 	parser.add_argument("-S", type=str, metavar="path", dest="startValFileName", default="", help="path to start value fit result file (default: none)")
 	parser.add_argument("-r", type=int, metavar="#", dest="rank", default=1, help="rank of spin density matrix (default: 1)")
+	parser.add_argument("-t", type=int, metavar="#", dest="nmbThreads", default=1, help="number of threads used to calculate the likelihood; 0 uses all available threads (default: 1)")
+	parser.add_argument("--simd", dest="useSimd", action="store_true", help="use vectorized kernels to calculate the likelihood (default: false)")
+	parser.add_argument("--singlePrecisionAmps", dest="singlePrecisionAmps", action="store_true",
+	                    help="store decay amplitudes in single precision to halve their memory footprint; sums are still calculated in double precision (default: false)")
 	parser.add_argument("-A", type=int, metavar="#", dest="accEventsOverride", default=0,
 	                    help="number of input events to normalize acceptance to (default: use number of events from normalization integral file)")
 	parser.add_argument("--do-not-normalize-amplitudes", dest="useNormalizedAmps", action="store_false", help="do not normalize amlitudes (default: normalize amplitudes)")
@@ -95,6 +99,9 @@ if __name__ == "__main__":
 	                                   checkHessian = args.checkHessian,
 	                                   saveSpace = args.saveSpace,
 	                                   rank = args.rank,
+	                                   nmbThreads = args.nmbThreads,
+	                                   useSimd = args.useSimd,
+	                                   singlePrecisionAmps = args.singlePrecisionAmps,
 	                                   verbose = args.verbose,
 	                                   attempts = args.nAttempts,
 	                                   keepMatricesOnlyOfBest = args.keepMatricesOnlyOfBest
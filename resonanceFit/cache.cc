@@ -28,16 +28,27 @@
 
 #include "cache.h"
 
+#include <algorithm>
+#include <limits>
+
 
 rpwa::resonanceFit::cache::cache(const size_t maxWaves,
                                  const size_t maxComponents,
                                  const size_t maxChannels,
                                  const size_t maxBins,
-                                 const size_t maxMassBins)
-	: _couplings(boost::extents[maxComponents][maxChannels][maxBins][maxMassBins]),
+                                 const size_t maxMassBins,
+                                 const bool cacheWavePairs)
+	: _cacheWavePairs(cacheWavePairs),
+	  _couplings(boost::extents[maxComponents][maxChannels][maxBins][maxMassBins]),
 	  _components(boost::extents[maxComponents][maxBins][maxMassBins]),
-	  _prodAmps(boost::extents[maxWaves][maxBins][maxMassBins])
+	  _componentsValid(boost::extents[maxComponents][maxBins][maxMassBins]),
+	  _prodAmps(boost::extents[maxWaves][maxBins][maxMassBins]),
+	  _chiSquares(boost::extents[maxBins][maxMassBins]),
+	  _chiSquaresWavePairs(boost::extents[cacheWavePairs ? maxBins : 0][cacheWavePairs ? maxMassBins : 0][cacheWavePairs ? maxWaves : 0][cacheWavePairs ? maxWaves : 0])
 {
+	std::fill(_componentsValid.data(), _componentsValid.data()+_componentsValid.num_elements(), false);
+	std::fill(_chiSquares.data(), _chiSquares.data()+_chiSquares.num_elements(), std::numeric_limits<double>::quiet_NaN());
+	std::fill(_chiSquaresWavePairs.data(), _chiSquaresWavePairs.data()+_chiSquaresWavePairs.num_elements(), std::numeric_limits<double>::quiet_NaN());
 }
 
 
@@ -74,22 +85,37 @@ rpwa::resonanceFit::cache::setComponent(const size_t idxComponent,
                                         const size_t idxMassBin,
                                         const std::complex<double> component)
 {
-	if (idxBin == std::numeric_limits<size_t>::max() && idxMassBin == std::numeric_limits<size_t>::max()) {
-		for (size_t idx=0; idx<*(_components.shape()+1) ; ++idx) {
-			for (size_t jdx=0; jdx<*(_components.shape()+2) ; ++jdx) {
-				_components[idxComponent][idx][jdx] = component;
-			}
-		}
-	} else if (idxBin == std::numeric_limits<size_t>::max()) {
-		for (size_t idx=0; idx<*(_components.shape()+1) ; ++idx) {
-			_components[idxComponent][idx][idxMassBin] = component;
+	const size_t idxBinFirst = (idxBin == std::numeric_limits<size_t>::max()) ? 0 : idxBin;
+	const size_t idxBinLast = (idxBin == std::numeric_limits<size_t>::max()) ? *(_components.shape()+1) : idxBin+1;
+	const size_t idxMassBinFirst = (idxMassBin == std::numeric_limits<size_t>::max()) ? 0 : idxMassBin;
+	const size_t idxMassBinLast = (idxMassBin == std::numeric_limits<size_t>::max()) ? *(_components.shape()+2) : idxMassBin+1;
+
+	for (size_t idx=idxBinFirst; idx<idxBinLast; ++idx) {
+		for (size_t jdx=idxMassBinFirst; jdx<idxMassBinLast; ++jdx) {
+			_components[idxComponent][idx][jdx] = component;
+			_componentsValid[idxComponent][idx][jdx] = true;
 		}
-	} else if (idxMassBin == std::numeric_limits<size_t>::max()) {
-		for (size_t idx=0; idx<*(_components.shape()+2) ; ++idx) {
-			_components[idxComponent][idxBin][idx] = component;
+	}
+}
+
+
+// a value of 0 is a valid value of a component, so the validity of the
+// cached values is tracked separately
+void
+rpwa::resonanceFit::cache::invalidateComponent(const size_t idxComponent,
+                                               const size_t idxBin,
+                                               const size_t idxMassBin)
+{
+	const size_t idxBinFirst = (idxBin == std::numeric_limits<size_t>::max()) ? 0 : idxBin;
+	const size_t idxBinLast = (idxBin == std::numeric_limits<size_t>::max()) ? *(_components.shape()+1) : idxBin+1;
+	const size_t idxMassBinFirst = (idxMassBin == std::numeric_limits<size_t>::max()) ? 0 : idxMassBin;
+	const size_t idxMassBinLast = (idxMassBin == std::numeric_limits<size_t>::max()) ? *(_components.shape()+2) : idxMassBin+1;
+
+	for (size_t idx=idxBinFirst; idx<idxBinLast; ++idx) {
+		for (size_t jdx=idxMassBinFirst; jdx<idxMassBinLast; ++jdx) {
+			_components[idxComponent][idx][jdx] = 0.;
+			_componentsValid[idxComponent][idx][jdx] = false;
 		}
-	} else {
-		_components[idxComponent][idxBin][idxMassBin] = component;
 	}
 }
 
@@ -100,6 +126,12 @@ rpwa::resonanceFit::cache::setProdAmp(const size_t idxWave,
                                       const size_t idxMassBin,
                                       const std::complex<double> prodAmp)
 {
+	// invalidating a production amplitude also invalidates the
+	// contributions to chi2 that depend on it
+	if (prodAmp == 0.) {
+		invalidateChiSquare(idxWave, idxBin, idxMassBin);
+	}
+
 	if (idxWave == std::numeric_limits<size_t>::max() && idxBin == std::numeric_limits<size_t>::max() && idxMassBin == std::numeric_limits<size_t>::max()) {
 		for (size_t idx=0; idx<*(_prodAmps.shape()) ; ++idx) {
 			for (size_t jdx=0; jdx<*(_prodAmps.shape()+1) ; ++jdx) {
@@ -144,6 +176,41 @@ rpwa::resonanceFit::cache::setProdAmp(const size_t idxWave,
 }
 
 
+void
+rpwa::resonanceFit::cache::invalidateChiSquare(const size_t idxWave,
+                                               const size_t idxBin,
+                                               const size_t idxMassBin)
+{
+	const size_t idxBinFirst = (idxBin == std::numeric_limits<size_t>::max()) ? 0 : idxBin;
+	const size_t idxBinLast = (idxBin == std::numeric_limits<size_t>::max()) ? *(_chiSquares.shape()) : idxBin+1;
+	const size_t idxMassBinFirst = (idxMassBin == std::numeric_limits<size_t>::max()) ? 0 : idxMassBin;
+	const size_t idxMassBinLast = (idxMassBin == std::numeric_limits<size_t>::max()) ? *(_chiSquares.shape()+1) : idxMassBin+1;
+
+	for (size_t idx=idxBinFirst; idx<idxBinLast; ++idx) {
+		for (size_t jdx=idxMassBinFirst; jdx<idxMassBinLast; ++jdx) {
+			_chiSquares[idx][jdx] = std::numeric_limits<double>::quiet_NaN();
+
+			if (!_cacheWavePairs) {
+				continue;
+			}
+			const size_t nrWaves = *(_chiSquaresWavePairs.shape()+2);
+			if (idxWave == std::numeric_limits<size_t>::max()) {
+				for (size_t kdx=0; kdx<nrWaves; ++kdx) {
+					for (size_t ldx=0; ldx<nrWaves; ++ldx) {
+						_chiSquaresWavePairs[idx][jdx][kdx][ldx] = std::numeric_limits<double>::quiet_NaN();
+					}
+				}
+			} else {
+				for (size_t kdx=0; kdx<nrWaves; ++kdx) {
+					_chiSquaresWavePairs[idx][jdx][idxWave][kdx] = std::numeric_limits<double>::quiet_NaN();
+					_chiSquaresWavePairs[idx][jdx][kdx][idxWave] = std::numeric_limits<double>::quiet_NaN();
+				}
+			}
+		}
+	}
+}
+
+
 std::ostream&
 rpwa::resonanceFit::cache::print(std::ostream& out, const bool newLine) const
 {
@@ -161,7 +228,12 @@ rpwa::resonanceFit::cache::print(std::ostream& out, const bool newLine) const
 	out << "cache for production amplitudes: "
 	    << *(_prodAmps.shape()) << " waves, "
 	    << *(_prodAmps.shape()+1) << " bins, "
-	    << *(_prodAmps.shape()+2) << " mass bins";
+	    << *(_prodAmps.shape()+2) << " mass bins"
+	    << std::endl;
+	out << "cache for contributions to chi2: "
+	    << *(_chiSquares.shape()) << " bins, "
+	    << *(_chiSquares.shape()+1) << " mass bins"
+	    << (_cacheWavePairs ? ", separately for each pair of waves" : "");
 
 	if(newLine) {
 		out << std::endl;
@@ -22,6 +22,9 @@
 //
 // Description:
 //      cache results during the resonance fit
+//      - the contributions to chi2 of each pair of bin and mass bin and,
+//        optionally, of each pair of waves are kept until one of the
+//        production amplitudes they depend on is invalidated
 //
 //-------------------------------------------------------------------------
 
@@ -46,24 +49,42 @@ namespace rpwa {
 			      const size_t maxComponents,
 			      const size_t maxChannels,
 			      const size_t maxBins,
-			      const size_t maxMassBins);
+			      const size_t maxMassBins,
+			      const bool cacheWavePairs = false);
 			~cache() {}
 
 			std::complex<double> getCoupling(const size_t idxComponent, const size_t idxChannel, const size_t idxBin, const size_t idxMassBin) const { return _couplings[idxComponent][idxChannel][idxBin][idxMassBin]; }
 			std::complex<double> getComponent(const size_t idxComponent, const size_t idxBin, const size_t idxMassBin) const { return _components[idxComponent][idxBin][idxMassBin]; }
+			// false if the value of the component has to be recalculated
+			bool isComponentValid(const size_t idxComponent, const size_t idxBin, const size_t idxMassBin) const { return _componentsValid[idxComponent][idxBin][idxMassBin]; }
 			std::complex<double> getProdAmp(const size_t idxWave, const size_t idxBin, const size_t idxMassBin) const { return _prodAmps[idxWave][idxBin][idxMassBin]; }
+			// NaN if the contribution to chi2 has to be recalculated
+			double getChiSquare(const size_t idxBin, const size_t idxMassBin) const { return _chiSquares[idxBin][idxMassBin]; }
+			double getChiSquareWavePair(const size_t idxBin, const size_t idxMassBin, const size_t idxWave, const size_t jdxWave) const { return _chiSquaresWavePairs[idxBin][idxMassBin][idxWave][jdxWave]; }
+
+			bool cachesWavePairs() const { return _cacheWavePairs; }
 
 			void setCoupling(const size_t idxComponent, const size_t idxChannel, const size_t idxBin, const size_t idxMassBin, const std::complex<double> coupling);
 			void setComponent(const size_t idxComponent, const size_t idxBin, const size_t idxMassBin, const std::complex<double> component);
+			void invalidateComponent(const size_t idxComponent, const size_t idxBin, const size_t idxMassBin);
 			void setProdAmp(const size_t idxWave, const size_t idxBin, const size_t idxMassBin, const std::complex<double> prodAmp);
+			void setChiSquare(const size_t idxBin, const size_t idxMassBin, const double chi2) { _chiSquares[idxBin][idxMassBin] = chi2; }
+			void setChiSquareWavePair(const size_t idxBin, const size_t idxMassBin, const size_t idxWave, const size_t jdxWave, const double chi2) { _chiSquaresWavePairs[idxBin][idxMassBin][idxWave][jdxWave] = chi2; }
 
 			std::ostream& print(std::ostream& out = std::cout, const bool newLine = true) const;
 
 		private:
 
+			void invalidateChiSquare(const size_t idxWave, const size_t idxBin, const size_t idxMassBin);
+
+			const bool _cacheWavePairs;
+
 			boost::multi_array<std::complex<double>, 4> _couplings;
 			boost::multi_array<std::complex<double>, 3> _components;
+			boost::multi_array<bool, 3> _componentsValid;
 			boost::multi_array<std::complex<double>, 3> _prodAmps;
+			boost::multi_array<double, 2> _chiSquares;
+			boost::multi_array<double, 4> _chiSquaresWavePairs;
 
 		};
 
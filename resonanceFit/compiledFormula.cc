@@ -0,0 +1,507 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026 Boris Grube (TUM)
+//
+//    This file is part of ROOTPWA
+//
+//    ROOTPWA is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ROOTPWA is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with ROOTPWA.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      compiled form of a one-dimensional TFormula expression
+//
+//-------------------------------------------------------------------------
+
+
+#include "compiledFormula.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+
+#include <TFormula.h>
+
+#include <reportingUtils.hpp>
+
+
+namespace {
+
+	// recursive-descent parser for the subset of the TFormula syntax that
+	// can be compiled
+	//   expression := term {('+' | '-') term}
+	//   term       := unary {('*' | '/') unary}
+	//   unary      := ('+' | '-') unary | power
+	//   power      := primary [('^' | '**') unary]
+	//   primary    := number | 'x' | 'x[0]' | 'pi' | '[' parameter ']'
+	//               | function '(' [expression {',' expression}] ')'
+	//               | '(' expression ')'
+	class formulaParser {
+
+	public:
+
+		formulaParser(const std::string& expression,
+		              const TFormula& formula,
+		              std::vector<rpwa::resonanceFit::compiledFormula::instruction>& program)
+			: _expression(expression),
+			  _formula(formula),
+			  _program(program),
+			  _position(0),
+			  _stackSize(0),
+			  _maxStackSize(0)
+		{
+		}
+
+		bool parse()
+		{
+			_program.clear();
+			_position = 0;
+			_stackSize = 0;
+			_maxStackSize = 0;
+			if(not parseExpression()) {
+				return false;
+			}
+			skipSpaces();
+			return _position == _expression.size() and _stackSize == 1;
+		}
+
+		size_t maxStackSize() const { return _maxStackSize; }
+
+	private:
+
+		void skipSpaces()
+		{
+			while(_position < _expression.size() and std::isspace(_expression[_position])) {
+				++_position;
+			}
+		}
+
+		char peek()
+		{
+			skipSpaces();
+			return (_position < _expression.size()) ? _expression[_position] : '\0';
+		}
+
+		bool accept(const std::string& token)
+		{
+			skipSpaces();
+			if(_expression.compare(_position, token.size(), token) != 0) {
+				return false;
+			}
+			_position += token.size();
+			return true;
+		}
+
+		void emit(const rpwa::resonanceFit::compiledFormula::opCode code,
+		          const double constant = 0.,
+		          const size_t index = 0)
+		{
+			_program.push_back(rpwa::resonanceFit::compiledFormula::instruction(code, constant, index));
+			switch(code) {
+				case rpwa::resonanceFit::compiledFormula::pushConstant:
+				case rpwa::resonanceFit::compiledFormula::pushVariable:
+				case rpwa::resonanceFit::compiledFormula::pushParameter:
+					++_stackSize;
+					_maxStackSize = std::max(_maxStackSize, _stackSize);
+					break;
+				case rpwa::resonanceFit::compiledFormula::add:
+				case rpwa::resonanceFit::compiledFormula::subtract:
+				case rpwa::resonanceFit::compiledFormula::multiply:
+				case rpwa::resonanceFit::compiledFormula::divide:
+				case rpwa::resonanceFit::compiledFormula::power:
+				case rpwa::resonanceFit::compiledFormula::arcTangent2:
+					--_stackSize;
+					break;
+				default:
+					break;
+			}
+		}
+
+		bool parseExpression()
+		{
+			if(not parseTerm()) {
+				return false;
+			}
+			while(true) {
+				if(accept("+")) {
+					if(not parseTerm()) {
+						return false;
+					}
+					emit(rpwa::resonanceFit::compiledFormula::add);
+				} else if(accept("-")) {
+					if(not parseTerm()) {
+						return false;
+					}
+					emit(rpwa::resonanceFit::compiledFormula::subtract);
+				} else {
+					return true;
+				}
+			}
+		}
+
+		bool parseTerm()
+		{
+			if(not parseUnary()) {
+				return false;
+			}
+			while(true) {
+				if(peek() == '*' and _expression.compare(_position, 2, "**") != 0) {
+					accept("*");
+					if(not parseUnary()) {
+						return false;
+					}
+					emit(rpwa::resonanceFit::compiledFormula::multiply);
+				} else if(accept("/")) {
+					if(not parseUnary()) {
+						return false;
+					}
+					emit(rpwa::resonanceFit::compiledFormula::divide);
+				} else {
+					return true;
+				}
+			}
+		}
+
+		bool parseUnary()
+		{
+			if(accept("-")) {
+				if(not parseUnary()) {
+					return false;
+				}
+				emit(rpwa::resonanceFit::compiledFormula::negate);
+				return true;
+			}
+			if(accept("+")) {
+				return parseUnary();
+			}
+			return parsePower();
+		}
+
+		bool parsePower()
+		{
+			if(not parsePrimary()) {
+				return false;
+			}
+			if(accept("^") or accept("**")) {
+				if(not parseUnary()) {
+					return false;
+				}
+				emit(rpwa::resonanceFit::compiledFormula::power);
+			}
+			return true;
+		}
+
+		bool parsePrimary()
+		{
+			const char next = peek();
+			if(std::isdigit(next) or (next == '.' and _position+1 < _expression.size() and std::isdigit(_expression[_position+1]))) {
+				const char* begin = _expression.c_str() + _position;
+				char* end;
+				const double value = std::strtod(begin, &end);
+				_position += end - begin;
+				emit(rpwa::resonanceFit::compiledFormula::pushConstant, value);
+				return true;
+			}
+			if(accept("(")) {
+				return parseExpression() and accept(")");
+			}
+			if(accept("[")) {
+				return parseParameter();
+			}
+			if(std::isalpha(next) or next == '_') {
+				return parseIdentifier();
+			}
+			return false;
+		}
+
+		bool parseParameter()
+		{
+			const size_t end = _expression.find(']', _position);
+			if(end == std::string::npos) {
+				return false;
+			}
+			const std::string name = _expression.substr(_position, end - _position);
+			_position = end + 1;
+			if(name.empty()) {
+				return false;
+			}
+
+			// ROOT 6 names the parameter '[i]' 'pi', ROOT 5 uses the index i
+			int index = -1;
+			if(name.find_first_not_of("0123456789") == std::string::npos) {
+				index = _formula.GetParNumber(("p" + name).c_str());
+				if(index < 0) {
+					index = std::atoi(name.c_str());
+				}
+			} else {
+				index = _formula.GetParNumber(name.c_str());
+			}
+			if(index < 0 or index >= _formula.GetNpar()) {
+				return false;
+			}
+			emit(rpwa::resonanceFit::compiledFormula::pushParameter, 0., index);
+			return true;
+		}
+
+		bool parseIdentifier()
+		{
+			const size_t begin = _position;
+			while(_position < _expression.size() and (std::isalnum(_expression[_position]) or _expression[_position] == '_' or _expression[_position] == ':')) {
+				++_position;
+			}
+			const std::string name = _expression.substr(begin, _position - begin);
+
+			if(not accept("(")) {
+				if(name == "x") {
+					if(accept("[")) {
+						if(not (accept("0") and accept("]"))) {
+							return false;
+						}
+					}
+					emit(rpwa::resonanceFit::compiledFormula::pushVariable);
+					return true;
+				}
+				if(name == "pi") {
+					emit(rpwa::resonanceFit::compiledFormula::pushConstant, M_PI);
+					return true;
+				}
+				return false;
+			}
+
+			size_t nrArguments = 0;
+			if(not accept(")")) {
+				do {
+					if(not parseExpression()) {
+						return false;
+					}
+					++nrArguments;
+				} while(accept(","));
+				if(not accept(")")) {
+					return false;
+				}
+			}
+
+			if(name == "TMath::Pi" and nrArguments == 0) {
+				emit(rpwa::resonanceFit::compiledFormula::pushConstant, M_PI);
+				return true;
+			}
+
+			const std::map<std::string, std::pair<rpwa::resonanceFit::compiledFormula::opCode, size_t> >& functions = knownFunctions();
+			const std::map<std::string, std::pair<rpwa::resonanceFit::compiledFormula::opCode, size_t> >::const_iterator function = functions.find(name);
+			if(function == functions.end() or function->second.second != nrArguments) {
+				return false;
+			}
+			emit(function->second.first);
+			return true;
+		}
+
+		// the map is initialized on first use, which is thread-safe
+		static const std::map<std::string, std::pair<rpwa::resonanceFit::compiledFormula::opCode, size_t> >& knownFunctions()
+		{
+			static const std::map<std::string, std::pair<rpwa::resonanceFit::compiledFormula::opCode, size_t> > functions = createKnownFunctions();
+			return functions;
+		}
+
+		static std::map<std::string, std::pair<rpwa::resonanceFit::compiledFormula::opCode, size_t> > createKnownFunctions()
+		{
+			typedef rpwa::resonanceFit::compiledFormula cf;
+			std::map<std::string, std::pair<cf::opCode, size_t> > functions;
+			functions["sqrt"]         = std::make_pair(cf::squareRoot, 1);
+			functions["TMath::Sqrt"]  = std::make_pair(cf::squareRoot, 1);
+			functions["exp"]          = std::make_pair(cf::exponential, 1);
+			functions["TMath::Exp"]   = std::make_pair(cf::exponential, 1);
+			functions["log"]          = std::make_pair(cf::logarithm, 1);
+			functions["TMath::Log"]   = std::make_pair(cf::logarithm, 1);
+			functions["log10"]        = std::make_pair(cf::logarithm10, 1);
+			functions["TMath::Log10"] = std::make_pair(cf::logarithm10, 1);
+			functions["sin"]          = std::make_pair(cf::sine, 1);
+			functions["TMath::Sin"]   = std::make_pair(cf::sine, 1);
+			functions["cos"]          = std::make_pair(cf::cosine, 1);
+			functions["TMath::Cos"]   = std::make_pair(cf::cosine, 1);
+			functions["tan"]          = std::make_pair(cf::tangent, 1);
+			functions["TMath::Tan"]   = std::make_pair(cf::tangent, 1);
+			functions["asin"]         = std::make_pair(cf::arcSine, 1);
+			functions["TMath::ASin"]  = std::make_pair(cf::arcSine, 1);
+			functions["acos"]         = std::make_pair(cf::arcCosine, 1);
+			functions["TMath::ACos"]  = std::make_pair(cf::arcCosine, 1);
+			functions["atan"]         = std::make_pair(cf::arcTangent, 1);
+			functions["TMath::ATan"]  = std::make_pair(cf::arcTangent, 1);
+			functions["sinh"]         = std::make_pair(cf::sineHyperbolic, 1);
+			functions["TMath::SinH"]  = std::make_pair(cf::sineHyperbolic, 1);
+			functions["cosh"]         = std::make_pair(cf::cosineHyperbolic, 1);
+			functions["TMath::CosH"]  = std::make_pair(cf::cosineHyperbolic, 1);
+			functions["tanh"]         = std::make_pair(cf::tangentHyperbolic, 1);
+			functions["TMath::TanH"]  = std::make_pair(cf::tangentHyperbolic, 1);
+			functions["abs"]          = std::make_pair(cf::absolute, 1);
+			functions["fabs"]         = std::make_pair(cf::absolute, 1);
+			functions["TMath::Abs"]   = std::make_pair(cf::absolute, 1);
+			functions["pow"]          = std::make_pair(cf::power, 2);
+			functions["TMath::Power"] = std::make_pair(cf::power, 2);
+			functions["atan2"]        = std::make_pair(cf::arcTangent2, 2);
+			functions["TMath::ATan2"] = std::make_pair(cf::arcTangent2, 2);
+			return functions;
+		}
+
+		const std::string& _expression;
+		const TFormula& _formula;
+		std::vector<rpwa::resonanceFit::compiledFormula::instruction>& _program;
+
+		size_t _position;
+		size_t _stackSize;
+		size_t _maxStackSize;
+
+	};
+
+}
+
+
+rpwa::resonanceFit::compiledFormula::compiledFormula(const TFormula& formula)
+	: _valid(false),
+	  _maxStackSize(0)
+{
+	const std::string expression = formula.GetTitle();
+	formulaParser parser(expression, formula, _program);
+	_valid = parser.parse();
+	if(_valid) {
+		_maxStackSize = parser.maxStackSize();
+	} else {
+		_program.clear();
+	}
+}
+
+
+void
+rpwa::resonanceFit::compiledFormula::eval(const double* x,
+                                          const size_t nrPoints,
+                                          const double* par,
+                                          double* result) const
+{
+	if(not _valid) {
+		printErr << "trying to evaluate a formula that could not be compiled. Aborting..." << std::endl;
+		throw;
+	}
+	if(nrPoints == 0) {
+		return;
+	}
+
+	// the stack holds one vector of nrPoints values per entry
+	std::vector<double> stack(_maxStackSize * nrPoints);
+	size_t depth = 0;
+	for(std::vector<instruction>::const_iterator it = _program.begin(); it != _program.end(); ++it) {
+		// a and b are the two topmost entries, top is the first free entry
+		double* a = stack.data() + ((depth >= 2) ? (depth-2)*nrPoints : 0);
+		double* b = stack.data() + ((depth >= 1) ? (depth-1)*nrPoints : 0);
+		double* top = stack.data() + depth*nrPoints;
+		switch(it->code) {
+			case pushConstant:
+				for(size_t i = 0; i < nrPoints; ++i) top[i] = it->constant;
+				++depth;
+				break;
+			case pushVariable:
+				for(size_t i = 0; i < nrPoints; ++i) top[i] = x[i];
+				++depth;
+				break;
+			case pushParameter:
+				for(size_t i = 0; i < nrPoints; ++i) top[i] = par[it->index];
+				++depth;
+				break;
+			case add:
+				for(size_t i = 0; i < nrPoints; ++i) a[i] += b[i];
+				--depth;
+				break;
+			case subtract:
+				for(size_t i = 0; i < nrPoints; ++i) a[i] -= b[i];
+				--depth;
+				break;
+			case multiply:
+				for(size_t i = 0; i < nrPoints; ++i) a[i] *= b[i];
+				--depth;
+				break;
+			case divide:
+				for(size_t i = 0; i < nrPoints; ++i) a[i] /= b[i];
+				--depth;
+				break;
+			case power:
+				for(size_t i = 0; i < nrPoints; ++i) a[i] = std::pow(a[i], b[i]);
+				--depth;
+				break;
+			case arcTangent2:
+				for(size_t i = 0; i < nrPoints; ++i) a[i] = std::atan2(a[i], b[i]);
+				--depth;
+				break;
+			case negate:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = -b[i];
+				break;
+			case squareRoot:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::sqrt(b[i]);
+				break;
+			case exponential:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::exp(b[i]);
+				break;
+			case logarithm:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::log(b[i]);
+				break;
+			case logarithm10:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::log10(b[i]);
+				break;
+			case sine:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::sin(b[i]);
+				break;
+			case cosine:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::cos(b[i]);
+				break;
+			case tangent:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::tan(b[i]);
+				break;
+			case arcSine:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::asin(b[i]);
+				break;
+			case arcCosine:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::acos(b[i]);
+				break;
+			case arcTangent:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::atan(b[i]);
+				break;
+			case sineHyperbolic:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::sinh(b[i]);
+				break;
+			case cosineHyperbolic:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::cosh(b[i]);
+				break;
+			case tangentHyperbolic:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::tanh(b[i]);
+				break;
+			case absolute:
+				for(size_t i = 0; i < nrPoints; ++i) b[i] = std::abs(b[i]);
+				break;
+		}
+	}
+
+	for(size_t i = 0; i < nrPoints; ++i) {
+		result[i] = stack[i];
+	}
+}
+
+
+double
+rpwa::resonanceFit::compiledFormula::eval(const double x,
+                                          const double* par) const
+{
+	double result;
+	eval(&x, 1, par, &result);
+	return result;
+}
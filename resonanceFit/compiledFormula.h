@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026 Boris Grube (TUM)
+//
+//    This file is part of ROOTPWA
+//
+//    ROOTPWA is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ROOTPWA is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with ROOTPWA.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      compiled form of a one-dimensional TFormula expression
+//      - the expression is translated once into a program for a small
+//        stack machine, each instruction of which is applied to a whole
+//        vector of values of the variable x
+//      - only the arithmetic operators, the power operator, parameters,
+//        and the most common mathematical functions are supported, for
+//        all other expressions isValid() returns false
+//
+//-------------------------------------------------------------------------
+
+
+#ifndef RESONANCEFIT_COMPILEDFORMULA_HH
+#define RESONANCEFIT_COMPILEDFORMULA_HH
+
+#include <string>
+#include <vector>
+
+class TFormula;
+
+namespace rpwa {
+
+	namespace resonanceFit {
+
+		class compiledFormula {
+
+		public:
+
+			enum opCode {
+				pushConstant,
+				pushVariable,
+				pushParameter,
+				add,
+				subtract,
+				multiply,
+				divide,
+				power,
+				arcTangent2,
+				negate,
+				squareRoot,
+				exponential,
+				logarithm,
+				logarithm10,
+				sine,
+				cosine,
+				tangent,
+				arcSine,
+				arcCosine,
+				arcTangent,
+				sineHyperbolic,
+				cosineHyperbolic,
+				tangentHyperbolic,
+				absolute
+			};
+
+			struct instruction {
+				instruction(const opCode c, const double v = 0., const size_t i = 0) : code(c), constant(v), index(i) {}
+				opCode code;
+				double constant;
+				size_t index;
+			};
+
+			compiledFormula(const TFormula& formula);
+			~compiledFormula() {}
+
+			bool isValid() const { return _valid; }
+
+			// evaluates the formula for nrPoints values of the variable
+			void eval(const double* x,
+			          const size_t nrPoints,
+			          const double* par,
+			          double* result) const;
+			double eval(const double x,
+			            const double* par) const;
+
+		private:
+
+			bool _valid;
+
+			std::vector<instruction> _program;
+			size_t _maxStackSize;
+
+		};
+
+	} // end namespace resonanceFit
+
+} // end namespace rpwa
+
+
+#endif // RESONANCEFIT_COMPILEDFORMULA_HH
@@ -187,7 +187,7 @@ rpwa::resonanceFit::component::channel::channel(const std::string& waveName,
 
 		// set up interpolator for when the requested mass is not a
 		// mass bin center
-		_interpolators[idxBin] = std::make_shared<ROOT::Math::Interpolator>(std::vector<double>(viewM.begin(), viewM.end()), std::vector<double>(viewInt.begin(), viewInt.end()), ROOT::Math::Interpolation::kLINEAR);
+		_interpolators[idxBin] = std::make_shared<rpwa::resonanceFit::linearInterpolator>(std::vector<double>(viewM.begin(), viewM.end()), std::vector<double>(viewInt.begin(), viewInt.end()));
 	}
 }
 
@@ -403,7 +403,7 @@ rpwa::resonanceFit::component::importParameters(const double* par,
 	}
 
 	if(invalidateCache) {
-		cache.setComponent(getId(), std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max(), 0.);
+		cache.invalidateComponent(getId(), std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max());
 		for(size_t idxChannel = 0; idxChannel < _channels.size(); ++idxChannel) {
 			for(std::vector<size_t>::const_iterator idxBin = _channels[idxChannel].getBins().begin(); idxBin != _channels[idxChannel].getBins().end(); ++idxBin) {
 				cache.setProdAmp(_channels[idxChannel].getWaveIndices()[*idxBin], *idxBin, std::numeric_limits<size_t>::max(), 0.);
@@ -422,11 +422,8 @@ rpwa::resonanceFit::component::val(const rpwa::resonanceFit::parameters& fitPara
                                    const double mass,
                                    const size_t idxMass) const
 {
-	if(idxMass != std::numeric_limits<size_t>::max()) {
-		const std::complex<double> component = cache.getComponent(getId(), idxBin, idxMass);
-		if(component != 0.) {
-			return component;
-		}
+	if(idxMass != std::numeric_limits<size_t>::max() and cache.isComponentValid(getId(), idxBin, idxMass)) {
+		return cache.getComponent(getId(), idxBin, idxMass);
 	}
 
 	const std::complex<double> component = val(fitParameters, idxBin, mass);
@@ -446,6 +443,21 @@ rpwa::resonanceFit::component::val(const rpwa::resonanceFit::parameters& fitPara
 }
 
 
+void
+rpwa::resonanceFit::component::valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+                                              const size_t idxBin,
+                                              const double mass,
+                                              std::vector<std::complex<double> >& derivatives) const
+{
+	derivatives.assign(_parameters.size(), 0.);
+	if(_parameters.size() == 0) {
+		return;
+	}
+
+	valDerivatives(fitParameters, idxBin, mass, derivatives.data());
+}
+
+
 std::ostream&
 rpwa::resonanceFit::component::print(std::ostream& out, const bool newLine) const
 {
@@ -549,6 +561,24 @@ rpwa::resonanceFit::fixedWidthBreitWigner::val(const rpwa::resonanceFit::paramet
 }
 
 
+void
+rpwa::resonanceFit::fixedWidthBreitWigner::valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+                                                          const size_t /*idxBin*/,
+                                                          const double mass,
+                                                          std::complex<double>* derivatives) const
+{
+	const double& m0 = fitParameters.getParameter(getId(), 0);
+	const double& gamma0 = fitParameters.getParameter(getId(), 1);
+
+	const std::complex<double> denominator(m0*m0-mass*mass, -gamma0*m0);
+	const std::complex<double> component = gamma0*m0 / denominator;
+
+	// d(A/D) = (dA - A/D * dD) / D
+	derivatives[0] = (gamma0 - component * std::complex<double>(2.*m0, -gamma0)) / denominator;
+	derivatives[1] = (m0 - component * std::complex<double>(0., -m0)) / denominator;
+}
+
+
 std::vector<rpwa::resonanceFit::parameter>
 rpwa::resonanceFit::dynamicWidthBreitWigner::getDefaultParameters()
 {
@@ -652,6 +682,52 @@ rpwa::resonanceFit::dynamicWidthBreitWigner::val(const rpwa::resonanceFit::param
 }
 
 
+void
+rpwa::resonanceFit::dynamicWidthBreitWigner::valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+                                                            const size_t /*idxBin*/,
+                                                            const double mass,
+                                                            std::complex<double>* derivatives) const
+{
+	const double& m0 = fitParameters.getParameter(getId(), 0);
+	const double& gamma0 = fitParameters.getParameter(getId(), 1);
+
+	// the same channels as in val() are taken into account
+	double sum = 0.;
+	double sumDerivative = 0.;
+	for(size_t i = 0; i < _ratio.size(); ++i) {
+		if(_ratio[i] == 0.) {
+			continue;
+		}
+
+		if(mass >= _m1[i] + _m2[i]) {
+			// calculate breakup momenta
+			const double q = rpwa::breakupMomentum(mass, _m1[i], _m2[i]);
+			const double q0 = rpwa::breakupMomentum(m0, _m1[i], _m2[i]);
+			const double dq0 = rpwa::breakupMomentumDerivative(m0, _m1[i], _m2[i]);
+
+			// calculate barrier factors
+			const double f2 = rpwa::barrierFactorSquared(2*_l[i], q);
+			const double f20 = rpwa::barrierFactorSquared(2*_l[i], q0);
+			const double df20 = rpwa::barrierFactorSquaredDerivative(2*_l[i], q0);
+
+			const double term = _ratio[i] * q/q0 * f2/f20;
+			sum += term;
+			sumDerivative -= term * dq0 * (1./q0 + df20/f20);
+		}
+	}
+	const double gamma = gamma0 * m0/mass * sum;
+
+	const std::complex<double> denominator(m0*m0-mass*mass, -gamma*m0);
+	const std::complex<double> component = gamma0*m0 / denominator;
+
+	// d(A/D) = (dA - A/D * dD) / D
+	const std::complex<double> dDenominatorDm0(2.*m0, -gamma0/mass * (2.*m0*sum + m0*m0*sumDerivative));
+	const std::complex<double> dDenominatorDgamma0(0., -m0*m0/mass * sum);
+	derivatives[0] = (gamma0 - component * dDenominatorDm0) / denominator;
+	derivatives[1] = (m0 - component * dDenominatorDgamma0) / denominator;
+}
+
+
 std::ostream&
 rpwa::resonanceFit::dynamicWidthBreitWigner::print(std::ostream& out, const bool newLine) const
 {
@@ -728,7 +804,7 @@ rpwa::resonanceFit::integralWidthBreitWigner::integralWidthBreitWigner(const siz
 	          totalDecayChannels, "total number of decay channels is not correct for values of phase-space integrals.");
 
 	for(size_t idxDecayChannel = 0; idxDecayChannel < totalDecayChannels; ++idxDecayChannel) {
-		_interpolator.push_back(std::make_shared<ROOT::Math::Interpolator>(_masses[idxDecayChannel], _values[idxDecayChannel], ROOT::Math::Interpolation::kLINEAR));
+		_interpolator.push_back(std::make_shared<rpwa::resonanceFit::linearInterpolator>(_masses[idxDecayChannel], _values[idxDecayChannel]));
 	}
 
 	const double sum = std::accumulate(_ratio.begin(), _ratio.end(), 0.0);
@@ -751,8 +827,8 @@ rpwa::resonanceFit::integralWidthBreitWigner::val(const rpwa::resonanceFit::para
 			continue;
 		}
 
-		const double ps = _interpolator[i]->Eval(mass);
-		const double ps0 = _interpolator[i]->Eval(m0);
+		const double ps = _interpolator[i]->eval(mass);
+		const double ps0 = _interpolator[i]->eval(m0);
 
 		gamma += _ratio[i] * ps / ps0;
 	}
@@ -764,6 +840,43 @@ rpwa::resonanceFit::integralWidthBreitWigner::val(const rpwa::resonanceFit::para
 }
 
 
+void
+rpwa::resonanceFit::integralWidthBreitWigner::valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+                                                             const size_t /*idxBin*/,
+                                                             const double mass,
+                                                             std::complex<double>* derivatives) const
+{
+	const double& m0 = fitParameters.getParameter(getId(), 0);
+	const double& gamma0 = fitParameters.getParameter(getId(), 1);
+
+	double sum = 0.;
+	double sumDerivative = 0.;
+	for(size_t i = 0; i < _ratio.size(); ++i) {
+		// save some time not calculating stuff that is ignored
+		if(_ratio[i] == 0.) {
+			continue;
+		}
+
+		const double ps = _interpolator[i]->eval(mass);
+		const double ps0 = _interpolator[i]->eval(m0);
+		const double dps0 = _interpolator[i]->deriv(m0);
+
+		sum += _ratio[i] * ps / ps0;
+		sumDerivative -= _ratio[i] * ps * dps0 / (ps0*ps0);
+	}
+	const double gamma = gamma0 * sum;
+
+	const std::complex<double> denominator(m0*m0-mass*mass, -gamma*m0);
+	const std::complex<double> component = gamma0*m0 / denominator;
+
+	// d(A/D) = (dA - A/D * dD) / D
+	const std::complex<double> dDenominatorDm0(2.*m0, -gamma0 * (sum + m0*sumDerivative));
+	const std::complex<double> dDenominatorDgamma0(0., -sum*m0);
+	derivatives[0] = (gamma0 - component * dDenominatorDm0) / denominator;
+	derivatives[1] = (m0 - component * dDenominatorDgamma0) / denominator;
+}
+
+
 std::vector<rpwa::resonanceFit::parameter>
 rpwa::resonanceFit::constantBackground::getDefaultParameters()
 {
@@ -812,6 +925,16 @@ rpwa::resonanceFit::constantBackground::val(const rpwa::resonanceFit::parameters
 }
 
 
+void
+rpwa::resonanceFit::constantBackground::valDerivatives(const rpwa::resonanceFit::parameters& /*fitParameters*/,
+                                                       const size_t /*idxBin*/,
+                                                       const double /*m*/,
+                                                       std::complex<double>* /*derivatives*/) const
+{
+	// no parameters
+}
+
+
 std::vector<rpwa::resonanceFit::parameter>
 rpwa::resonanceFit::exponentialBackground::getDefaultParameters()
 {
@@ -892,6 +1015,25 @@ rpwa::resonanceFit::exponentialBackground::val(const rpwa::resonanceFit::paramet
 }
 
 
+void
+rpwa::resonanceFit::exponentialBackground::valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+                                                          const size_t /*idxBin*/,
+                                                          const double mass,
+                                                          std::complex<double>* derivatives) const
+{
+	// calculate breakup momentum
+	if(mass < _m1+_m2) {
+		derivatives[0] = 0.;
+		return;
+	}
+	const double q = rpwa::breakupMomentum(mass, _m1, _m2);
+	const double f2 = rpwa::barrierFactorSquared(2*_l, q);
+	const double c = std::pow(q*f2 * _norm, _exponent);
+
+	derivatives[0] = -c * exp(-fitParameters.getParameter(getId(), 0)*c);
+}
+
+
 std::ostream&
 rpwa::resonanceFit::exponentialBackground::print(std::ostream& out, const bool newLine) const
 {
@@ -1004,6 +1146,43 @@ rpwa::resonanceFit::tPrimeDependentBackground::val(const rpwa::resonanceFit::par
 }
 
 
+void
+rpwa::resonanceFit::tPrimeDependentBackground::valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+                                                              const size_t idxBin,
+                                                              const double mass,
+                                                              std::complex<double>* derivatives) const
+{
+	const double mPre = std::pow(mass - fitParameters.getParameter(getId(), 0), fitParameters.getParameter(getId(), 1));
+	const double dmPreDm0 = -fitParameters.getParameter(getId(), 1) * std::pow(mass - fitParameters.getParameter(getId(), 0), fitParameters.getParameter(getId(), 1) - 1.);
+	const double dmPreDc0 = (mPre != 0.) ? mPre * std::log(mass - fitParameters.getParameter(getId(), 0)) : 0.;
+
+	// calculate breakup momentum
+	if(mass < _m1+_m2) {
+		derivatives[0] = dmPreDm0;
+		derivatives[1] = dmPreDc0;
+		derivatives[2] = 0.;
+		derivatives[3] = 0.;
+		derivatives[4] = 0.;
+		return;
+	}
+	const double q = rpwa::breakupMomentum(mass, _m1, _m2);
+	const double f2 = rpwa::barrierFactorSquared(2*_l, q);
+	const double c = std::pow(q*f2 * _norm, _exponent);
+
+	// get mean t' value for current bin
+	const double tPrime = _tPrimeMeans[idxBin];
+	const double tPrimePol = fitParameters.getParameter(getId(), 2) + fitParameters.getParameter(getId(), 3)*tPrime + fitParameters.getParameter(getId(), 4)*tPrime*tPrime;
+
+	const double tPrimeExp = exp(-tPrimePol*c);
+
+	derivatives[0] = dmPreDm0 * tPrimeExp;
+	derivatives[1] = dmPreDc0 * tPrimeExp;
+	derivatives[2] = -c * mPre * tPrimeExp;
+	derivatives[3] = -c * tPrime * mPre * tPrimeExp;
+	derivatives[4] = -c * tPrime*tPrime * mPre * tPrimeExp;
+}
+
+
 std::ostream&
 rpwa::resonanceFit::tPrimeDependentBackground::print(std::ostream& out, const bool newLine) const
 {
@@ -1072,7 +1251,7 @@ rpwa::resonanceFit::exponentialBackgroundIntegral::exponentialBackgroundIntegral
 	checkParameters(*this);
 
 	assert(not _interpolator);
-	_interpolator = std::make_shared<ROOT::Math::Interpolator>(_masses, _values, ROOT::Math::Interpolation::kLINEAR);
+	_interpolator = std::make_shared<rpwa::resonanceFit::linearInterpolator>(_masses, _values);
 
 	// select the maximum of the mass only from the used bins
 	const std::vector<size_t>& bins = getChannel(0).getBins();
@@ -1082,7 +1261,7 @@ rpwa::resonanceFit::exponentialBackgroundIntegral::exponentialBackgroundIntegral
 		maxMasses[i] = massBinCenters[idxBin][nrMassBins[idxBin] - 1];
 	}
 	const double maxMass = *std::max_element(maxMasses.begin(), maxMasses.end());
-	_norm = 1. / (maxMass * _interpolator->Eval(maxMass));
+	_norm = 1. / (maxMass * _interpolator->eval(maxMass));
 }
 
 
@@ -1091,7 +1270,7 @@ rpwa::resonanceFit::exponentialBackgroundIntegral::val(const rpwa::resonanceFit:
                                                        const size_t /*idxBin*/,
                                                        const double mass) const
 {
-	const double ps = _interpolator->Eval(mass);
+	const double ps = _interpolator->eval(mass);
 	const double c = std::pow(mass * ps * _norm, _exponent);
 
 	const std::complex<double> component = exp(-fitParameters.getParameter(getId(), 0)*c);
@@ -1100,6 +1279,19 @@ rpwa::resonanceFit::exponentialBackgroundIntegral::val(const rpwa::resonanceFit:
 }
 
 
+void
+rpwa::resonanceFit::exponentialBackgroundIntegral::valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+                                                                  const size_t /*idxBin*/,
+                                                                  const double mass,
+                                                                  std::complex<double>* derivatives) const
+{
+	const double ps = _interpolator->eval(mass);
+	const double c = std::pow(mass * ps * _norm, _exponent);
+
+	derivatives[0] = -c * exp(-fitParameters.getParameter(getId(), 0)*c);
+}
+
+
 std::ostream&
 rpwa::resonanceFit::exponentialBackgroundIntegral::print(std::ostream& out, const bool newLine) const
 {
@@ -1170,7 +1362,7 @@ rpwa::resonanceFit::tPrimeDependentBackgroundIntegral::tPrimeDependentBackground
 	          nrBins, "number of bins is not correct for mean t' value per bin.");
 
 	assert(not _interpolator);
-	_interpolator = std::make_shared<ROOT::Math::Interpolator>(_masses, _values, ROOT::Math::Interpolation::kLINEAR);
+	_interpolator = std::make_shared<rpwa::resonanceFit::linearInterpolator>(_masses, _values);
 
 	// select the maximum of the mass only from the used bins
 	const std::vector<size_t>& bins = getChannel(0).getBins();
@@ -1180,7 +1372,7 @@ rpwa::resonanceFit::tPrimeDependentBackgroundIntegral::tPrimeDependentBackground
 		maxMasses[i] = massBinCenters[idxBin][nrMassBins[idxBin] - 1];
 	}
 	const double maxMass = *std::max_element(maxMasses.begin(), maxMasses.end());
-	_norm = 1. / (maxMass * _interpolator->Eval(maxMass));
+	_norm = 1. / (maxMass * _interpolator->eval(maxMass));
 }
 
 
@@ -1189,7 +1381,7 @@ rpwa::resonanceFit::tPrimeDependentBackgroundIntegral::val(const rpwa::resonance
                                                            const size_t idxBin,
                                                            const double mass) const
 {
-	const double ps = _interpolator->Eval(mass);
+	const double ps = _interpolator->eval(mass);
 	const double c = std::pow(mass * ps * _norm, _exponent);
 
 	// get mean t' value for current bin
@@ -1204,6 +1396,33 @@ rpwa::resonanceFit::tPrimeDependentBackgroundIntegral::val(const rpwa::resonance
 }
 
 
+void
+rpwa::resonanceFit::tPrimeDependentBackgroundIntegral::valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+                                                                      const size_t idxBin,
+                                                                      const double mass,
+                                                                      std::complex<double>* derivatives) const
+{
+	const double ps = _interpolator->eval(mass);
+	const double c = std::pow(mass * ps * _norm, _exponent);
+
+	// get mean t' value for current bin
+	const double tPrime = _tPrimeMeans[idxBin];
+	const double tPrimePol = fitParameters.getParameter(getId(), 2) + fitParameters.getParameter(getId(), 3)*tPrime + fitParameters.getParameter(getId(), 4)*tPrime*tPrime;
+
+	const double mPre = std::pow(mass - fitParameters.getParameter(getId(), 0), fitParameters.getParameter(getId(), 1));
+	const double dmPreDm0 = -fitParameters.getParameter(getId(), 1) * std::pow(mass - fitParameters.getParameter(getId(), 0), fitParameters.getParameter(getId(), 1) - 1.);
+	const double dmPreDc0 = (mPre != 0.) ? mPre * std::log(mass - fitParameters.getParameter(getId(), 0)) : 0.;
+
+	const double tPrimeExp = exp(-tPrimePol*c);
+
+	derivatives[0] = dmPreDm0 * tPrimeExp;
+	derivatives[1] = dmPreDc0 * tPrimeExp;
+	derivatives[2] = -c * mPre * tPrimeExp;
+	derivatives[3] = -c * tPrime * mPre * tPrimeExp;
+	derivatives[4] = -c * tPrime*tPrime * mPre * tPrimeExp;
+}
+
+
 std::ostream&
 rpwa::resonanceFit::tPrimeDependentBackgroundIntegral::print(std::ostream& out, const bool newLine) const
 {
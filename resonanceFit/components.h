@@ -40,9 +40,8 @@
 
 #include <boost/multi_array.hpp>
 
-#include <Math/Interpolator.h>
-
 #include "cache.h"
+#include "linearInterpolator.h"
 #include "parameter.h"
 #include "parameters.h"
 
@@ -81,7 +80,7 @@ namespace rpwa {
 				std::vector<size_t> _bins;
 
 				boost::multi_array<double, 2> _phaseSpaceIntegrals;
-				std::vector<std::shared_ptr<const ROOT::Math::Interpolator> > _interpolators;
+				std::vector<std::shared_ptr<const rpwa::resonanceFit::linearInterpolator> > _interpolators;
 
 			};
 
@@ -136,6 +135,10 @@ namespace rpwa {
 			                         const size_t idxBin,
 			                         const double mass,
 			                         const size_t idxMass = std::numeric_limits<size_t>::max()) const;
+			void valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+			                    const size_t idxBin,
+			                    const double mass,
+			                    std::vector<std::complex<double> >& derivatives) const;
 
 			std::complex<double> getCouplingPhaseSpace(const rpwa::resonanceFit::parameters& fitParameters,
 			                                           rpwa::resonanceFit::cache& cache,
@@ -151,6 +154,11 @@ namespace rpwa {
 			virtual std::complex<double> val(const rpwa::resonanceFit::parameters& fitParameters,
 			                                 const size_t idxBin,
 			                                 const double mass) const = 0;
+			// derivatives of the value w.r.t. the parameters of the component
+			virtual void valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+			                            const size_t idxBin,
+			                            const double mass,
+			                            std::complex<double>* derivatives) const = 0;
 
 			const size_t _id;
 			const std::string _name;
@@ -197,6 +205,10 @@ namespace rpwa {
 			virtual std::complex<double> val(const rpwa::resonanceFit::parameters& fitParameters,
 			                                 const size_t idxBin,
 			                                 const double mass) const;
+			virtual void valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+			                            const size_t idxBin,
+			                            const double mass,
+			                            std::complex<double>* derivatives) const;
 
 		};
 
@@ -234,6 +246,10 @@ namespace rpwa {
 			virtual std::complex<double> val(const rpwa::resonanceFit::parameters& fitParameters,
 			                                 const size_t idxBin,
 			                                 const double mass) const;
+			virtual void valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+			                            const size_t idxBin,
+			                            const double mass,
+			                            std::complex<double>* derivatives) const;
 
 			std::vector<double> _ratio;
 			const std::vector<int> _l;
@@ -272,11 +288,15 @@ namespace rpwa {
 			virtual std::complex<double> val(const rpwa::resonanceFit::parameters& fitParameters,
 			                                 const size_t idxBin,
 			                                 const double mass) const;
+			virtual void valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+			                            const size_t idxBin,
+			                            const double mass,
+			                            std::complex<double>* derivatives) const;
 
 			std::vector<double> _ratio;
 			const std::vector<std::vector<double> > _masses;
 			const std::vector<std::vector<double> > _values;
-			std::vector<std::shared_ptr<const ROOT::Math::Interpolator> > _interpolator;
+			std::vector<std::shared_ptr<const rpwa::resonanceFit::linearInterpolator> > _interpolator;
 
 		};
 
@@ -301,6 +321,10 @@ namespace rpwa {
 			virtual std::complex<double> val(const rpwa::resonanceFit::parameters& fitParameters,
 			                                 const size_t idxBin,
 			                                 const double mass) const;
+			virtual void valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+			                            const size_t idxBin,
+			                            const double mass,
+			                            std::complex<double>* derivatives) const;
 
 		};
 
@@ -336,6 +360,10 @@ namespace rpwa {
 			virtual std::complex<double> val(const rpwa::resonanceFit::parameters& fitParameters,
 			                                 const size_t idxBin,
 			                                 const double mass) const;
+			virtual void valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+			                            const size_t idxBin,
+			                            const double mass,
+			                            std::complex<double>* derivatives) const;
 
 			const int _l;
 			const double _m1;
@@ -379,6 +407,10 @@ namespace rpwa {
 			virtual std::complex<double> val(const rpwa::resonanceFit::parameters& fitParameters,
 			                                 const size_t idxBin,
 			                                 const double mass) const;
+			virtual void valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+			                            const size_t idxBin,
+			                            const double mass,
+			                            std::complex<double>* derivatives) const;
 
 			const std::vector<double> _tPrimeMeans;
 
@@ -421,10 +453,14 @@ namespace rpwa {
 			virtual std::complex<double> val(const rpwa::resonanceFit::parameters& fitParameters,
 			                                 const size_t idxBin,
 			                                 const double mass) const;
+			virtual void valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+			                            const size_t idxBin,
+			                            const double mass,
+			                            std::complex<double>* derivatives) const;
 
 			const std::vector<double> _masses;
 			const std::vector<double> _values;
-			std::shared_ptr<const ROOT::Math::Interpolator> _interpolator;
+			std::shared_ptr<const rpwa::resonanceFit::linearInterpolator> _interpolator;
 			const double _exponent;
 
 			double _norm;
@@ -462,12 +498,16 @@ namespace rpwa {
 			virtual std::complex<double> val(const rpwa::resonanceFit::parameters& fitParameters,
 			                                 const size_t idxBin,
 			                                 const double mass) const;
+			virtual void valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+			                            const size_t idxBin,
+			                            const double mass,
+			                            std::complex<double>* derivatives) const;
 
 			const std::vector<double> _tPrimeMeans;
 
 			const std::vector<double> _masses;
 			const std::vector<double> _values;
-			std::shared_ptr<const ROOT::Math::Interpolator> _interpolator;
+			std::shared_ptr<const rpwa::resonanceFit::linearInterpolator> _interpolator;
 			const double _exponent;
 
 			double _norm;
@@ -489,7 +529,7 @@ rpwa::resonanceFit::component::channel::getPhaseSpaceIntegral(const size_t idxBi
 		return _phaseSpaceIntegrals[idxBin][idxMass];
 	}
 
-	return _interpolators[idxBin]->Eval(mass);
+	return _interpolators[idxBin]->eval(mass);
 }
 
 
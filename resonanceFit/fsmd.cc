@@ -29,6 +29,7 @@
 
 #include "fsmd.h"
 
+#include <cmath>
 #include <set>
 
 #include <TFormula.h>
@@ -36,6 +37,7 @@
 #include <reportingUtils.hpp>
 
 #include "cache.h"
+#include "compiledFormula.h"
 #include "parameters.h"
 #include "resonanceFitHelper.h"
 
@@ -46,7 +48,9 @@ rpwa::resonanceFit::fsmd::fsmd(const size_t id,
                                const std::shared_ptr<TFormula>& function,
                                const boost::multi_array<rpwa::resonanceFit::parameter, 1>& parameters)
 	: _id(id),
-	  _sameFunctionForAllBins(true)
+	  _sameFunctionForAllBins(true),
+	  _nrMassBins(nrMassBins),
+	  _massBinCenters(massBinCenters)
 {
 	// a single final-state mass-dependence for all bins is used
 	// get dimensions from one array and make sure that all other arrays
@@ -125,6 +129,8 @@ rpwa::resonanceFit::fsmd::fsmd(const size_t id,
 			_binsEqualValues[bins[jdxBin]] = bins;
 		}
 	}
+
+	compileFunctions();
 }
 
 
@@ -136,6 +142,8 @@ rpwa::resonanceFit::fsmd::fsmd(const size_t id,
 	: _id(id),
 	  _sameFunctionForAllBins(false),
 	  _functions(functions),
+	  _nrMassBins(nrMassBins),
+	  _massBinCenters(massBinCenters),
 	  _parameters(parameters)
 {
 	// a different final-state mass-dependence for each bin is used
@@ -202,6 +210,8 @@ rpwa::resonanceFit::fsmd::fsmd(const size_t id,
 	for(size_t idxBin = 0; idxBin < _nrBins; ++idxBin) {
 		_binsEqualValues[idxBin][0] = idxBin;
 	}
+
+	compileFunctions();
 }
 
 
@@ -210,6 +220,70 @@ rpwa::resonanceFit::fsmd::~fsmd()
 }
 
 
+bool
+rpwa::resonanceFit::fsmd::isCompiled() const
+{
+	for(size_t idxBin = 0; idxBin < _nrBins; ++idxBin) {
+		if(_functions[idxBin] and not _compiledFunctions[idxBin]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+void
+rpwa::resonanceFit::fsmd::compileFunctions()
+{
+	_compiledFunctions.assign(_nrBins, std::shared_ptr<const rpwa::resonanceFit::compiledFormula>());
+	for(size_t idxBin = 0; idxBin < _nrBins; ++idxBin) {
+		if(not _functions[idxBin]) {
+			continue;
+		}
+
+		// the same function is only compiled once
+		if(idxBin > 0 and _functions[idxBin] == _functions[idxBin-1]) {
+			_compiledFunctions[idxBin] = _compiledFunctions[idxBin-1];
+			continue;
+		}
+
+		std::shared_ptr<const rpwa::resonanceFit::compiledFormula> compiledFunction(new rpwa::resonanceFit::compiledFormula(*_functions[idxBin]));
+		if(not compiledFunction->isValid()) {
+			printWarn << "formula '" << _functions[idxBin]->GetTitle() << "' of final-state mass-dependence "
+			          << "for bin " << idxBin << " cannot be compiled, TFormula is used to evaluate it." << std::endl;
+			continue;
+		}
+
+		// cross-check the compiled formula against TFormula for all mass
+		// bins using the start values of the parameters
+		std::vector<double> startValues(_nrParameters[idxBin]);
+		for(size_t idxParameter = 0; idxParameter < _nrParameters[idxBin]; ++idxParameter) {
+			startValues[idxParameter] = _parameters[idxBin][idxParameter].startValue();
+		}
+		std::vector<double> values(_nrMassBins[idxBin]);
+		compiledFunction->eval(&_massBinCenters[idxBin][0], _nrMassBins[idxBin], startValues.data(), values.data());
+		bool sameValues = true;
+		for(size_t idxMass = 0; idxMass < _nrMassBins[idxBin]; ++idxMass) {
+			const double value = _functions[idxBin]->EvalPar(&_massBinCenters[idxBin][idxMass], startValues.data());
+			if(std::isnan(value) and std::isnan(values[idxMass])) {
+				continue;
+			}
+			if(not (std::abs(value - values[idxMass]) <= 1e-12 * std::max(std::abs(value), 1.))) {
+				sameValues = false;
+				break;
+			}
+		}
+		if(not sameValues) {
+			printWarn << "compiled formula '" << _functions[idxBin]->GetTitle() << "' of final-state mass-dependence "
+			          << "for bin " << idxBin << " does not reproduce TFormula, TFormula is used to evaluate it." << std::endl;
+			continue;
+		}
+
+		_compiledFunctions[idxBin] = compiledFunction;
+	}
+}
+
+
 size_t
 rpwa::resonanceFit::fsmd::importParameters(const double* par,
                                            rpwa::resonanceFit::parameters& fitParameters,
@@ -231,11 +305,11 @@ rpwa::resonanceFit::fsmd::importParameters(const double* par,
 		if(invalidateCache) {
 			if(_sameFunctionForAllBins or _binsEqualValues[idxBin].size() == _binsEqualValues.size()) {
 				// the value is the same for all bins
-				cache.setComponent(_id, std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max(), 0.);
+				cache.invalidateComponent(_id, std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max());
 				cache.setProdAmp(std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max(), 0.);
 			} else {
 				for(std::vector<size_t>::const_iterator it = _binsEqualValues[idxBin].begin(); it != _binsEqualValues[idxBin].end(); ++it) {
-					cache.setComponent(_id, *it, std::numeric_limits<size_t>::max(), 0.);
+					cache.invalidateComponent(_id, *it, std::numeric_limits<size_t>::max());
 					cache.setProdAmp(std::numeric_limits<size_t>::max(), *it, std::numeric_limits<size_t>::max(), 0.);
 				}
 			}
@@ -257,14 +331,17 @@ rpwa::resonanceFit::fsmd::val(const rpwa::resonanceFit::parameters& fitParameter
 		return 1.;
 	}
 
-	if(idxMass != std::numeric_limits<size_t>::max()) {
-		const std::complex<double> fsmd = cache.getComponent(_id, idxBin, idxMass);
-		if(fsmd != 0.) {
-			return fsmd;
-		}
+	if(idxMass != std::numeric_limits<size_t>::max() and cache.isComponentValid(_id, idxBin, idxMass)) {
+		return cache.getComponent(_id, idxBin, idxMass);
+	}
+
+	if(idxMass != std::numeric_limits<size_t>::max() and _compiledFunctions[idxBin]) {
+		fillCache(fitParameters, cache, idxBin);
+		return cache.getComponent(_id, idxBin, idxMass);
 	}
 
-	const std::complex<double> fsmd = _functions[idxBin]->EvalPar(&mass, fitParameters.getParameters(_id)+_parametersIndex[idxBin]);
+	const double* parameters = fitParameters.getParameters(_id)+_parametersIndex[idxBin];
+	const std::complex<double> fsmd = _compiledFunctions[idxBin] ? _compiledFunctions[idxBin]->eval(mass, parameters) : _functions[idxBin]->EvalPar(&mass, parameters);
 
 	if(idxMass != std::numeric_limits<size_t>::max()) {
 		if(_binsEqualValues[idxBin].size() == _binsEqualValues.size()) {
@@ -281,6 +358,79 @@ rpwa::resonanceFit::fsmd::val(const rpwa::resonanceFit::parameters& fitParameter
 }
 
 
+void
+rpwa::resonanceFit::fsmd::fillCache(const rpwa::resonanceFit::parameters& fitParameters,
+                                    rpwa::resonanceFit::cache& cache,
+                                    const size_t idxBin) const
+{
+	if(not _functions[idxBin]) {
+		return;
+	}
+
+	const size_t nrMassBins = _nrMassBins[idxBin];
+	const double* masses = &_massBinCenters[idxBin][0];
+	const double* parameters = fitParameters.getParameters(_id)+_parametersIndex[idxBin];
+
+	std::vector<double> values(nrMassBins);
+	if(_compiledFunctions[idxBin]) {
+		_compiledFunctions[idxBin]->eval(masses, nrMassBins, parameters, values.data());
+	} else {
+		for(size_t idxMass = 0; idxMass < nrMassBins; ++idxMass) {
+			values[idxMass] = _functions[idxBin]->EvalPar(&masses[idxMass], parameters);
+		}
+	}
+
+	for(size_t idxMass = 0; idxMass < nrMassBins; ++idxMass) {
+		if(_binsEqualValues[idxBin].size() == _binsEqualValues.size()) {
+			// the value is the same for all bins
+			cache.setComponent(_id, std::numeric_limits<size_t>::max(), idxMass, values[idxMass]);
+		} else {
+			for(std::vector<size_t>::const_iterator it = _binsEqualValues[idxBin].begin(); it != _binsEqualValues[idxBin].end(); ++it) {
+				cache.setComponent(_id, *it, idxMass, values[idxMass]);
+			}
+		}
+	}
+}
+
+
+
+// derivatives of the value w.r.t. the parameters of the function in
+// the given bin
+// TFormula does not provide derivatives with respect to the parameters
+// in all supported versions of ROOT, so symmetric difference quotients
+// of the formula are used. In contrast to numerical derivatives of the
+// full chi2 this only requires two evaluations of the formula per
+// parameter.
+void
+rpwa::resonanceFit::fsmd::valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+                                         const size_t idxBin,
+                                         const double mass,
+                                         std::vector<std::complex<double> >& derivatives) const
+{
+	if(not _functions[idxBin]) {
+		derivatives.clear();
+		return;
+	}
+
+	const double* parameters = fitParameters.getParameters(_id)+_parametersIndex[idxBin];
+	std::vector<double> variedParameters(parameters, parameters+_nrParameters[idxBin]);
+
+	derivatives.resize(_nrParameters[idxBin]);
+	for(size_t idxParameter = 0; idxParameter < _nrParameters[idxBin]; ++idxParameter) {
+		const double value = parameters[idxParameter];
+		const double step = std::cbrt(std::numeric_limits<double>::epsilon()) * std::max(std::abs(value), 1.);
+
+		variedParameters[idxParameter] = value + step;
+		const double valueUp = _compiledFunctions[idxBin] ? _compiledFunctions[idxBin]->eval(mass, variedParameters.data()) : _functions[idxBin]->EvalPar(&mass, variedParameters.data());
+		variedParameters[idxParameter] = value - step;
+		const double valueDown = _compiledFunctions[idxBin] ? _compiledFunctions[idxBin]->eval(mass, variedParameters.data()) : _functions[idxBin]->EvalPar(&mass, variedParameters.data());
+		variedParameters[idxParameter] = value;
+
+		derivatives[idxParameter] = (valueUp - valueDown) / (2.*step);
+	}
+}
+
+
 std::ostream&
 rpwa::resonanceFit::fsmd::print(std::ostream& out, const bool newLine) const
 {
@@ -24,6 +24,8 @@
 // Description:
 //      final-state mass-dependence of resonance fit
 //      - use ROOT's TFormula for user-definable functions
+//      - formulas are compiled once if possible and then evaluated for
+//        all mass bins of a bin in one call
 //
 //-------------------------------------------------------------------------
 
@@ -51,6 +53,7 @@ namespace rpwa {
 	namespace resonanceFit {
 
 		class cache;
+		class compiledFormula;
 		class parameters;
 
 		class fsmd {
@@ -75,6 +78,11 @@ namespace rpwa {
 
 			const std::shared_ptr<TFormula>& getFunction(const size_t idxBin) const { return _functions[idxBin]; }
 
+			// true if the functions of all bins have been compiled, in which
+			// case the final-state mass-dependence can be evaluated by
+			// several threads at the same time
+			bool isCompiled() const;
+
 			size_t getNrBins() const { return _nrBins; }
 
 			size_t getNrParameters(const size_t idxBin) const { return _nrParameters[idxBin]; }
@@ -90,11 +98,22 @@ namespace rpwa {
 			                         const size_t idxBin,
 			                         const double mass,
 			                         const size_t idxMass = std::numeric_limits<size_t>::max()) const;
+			// evaluates the final-state mass-dependence for all mass bins of
+			// the given bin at once and stores the values in the cache
+			void fillCache(const rpwa::resonanceFit::parameters& fitParameters,
+			               rpwa::resonanceFit::cache& cache,
+			               const size_t idxBin) const;
+			void valDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+			                    const size_t idxBin,
+			                    const double mass,
+			                    std::vector<std::complex<double> >& derivatives) const;
 
 			std::ostream& print(std::ostream& out = std::cout, const bool newLine = true) const;
 
 		private:
 
+			void compileFunctions();
+
 			const size_t _id;
 
 			bool _sameFunctionForAllBins;
@@ -105,6 +124,10 @@ namespace rpwa {
 			std::vector<std::vector<size_t> > _binsEqualValues;
 
 			std::vector<std::shared_ptr<TFormula> > _functions;
+			std::vector<std::shared_ptr<const rpwa::resonanceFit::compiledFormula> > _compiledFunctions;
+
+			std::vector<size_t> _nrMassBins;
+			boost::multi_array<double, 2> _massBinCenters;
 
 			std::vector<size_t> _nrParameters;
 			std::vector<size_t> _parametersIndex;
@@ -29,27 +29,35 @@
 
 #include "function.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include <TVectorT.h>
 
 #include <reportingUtils.hpp>
+#include <threadUtils.hpp>
 
 #include "cache.h"
 #include "components.h"
 #include "data.h"
+#include "fsmd.h"
 #include "model.h"
 #include "parameters.h"
 
 
 rpwa::resonanceFit::function::function(const rpwa::resonanceFit::dataConstPtr& fitData,
                                        const rpwa::resonanceFit::modelConstPtr& fitModel,
-                                       const bool useProductionAmplitudes)
+                                       const bool useProductionAmplitudes,
+                                       const unsigned int nrThreads)
 	: _fitData(fitData),
 	  _fitModel(fitModel),
 	  _nrBins(fitData->nrBins()),
 	  _maxNrWaves(_fitData->maxNrWaves()),
 	  _maxNrMassBins(_fitData->maxNrMassBins()),
 	  _useProductionAmplitudes(useProductionAmplitudes),
-	  _useCovariance(_fitData->useCovariance())
+	  _useCovariance(_fitData->useCovariance()),
+	  _nrThreads(nrThreads),
+	  _nrChunks(0)
 {
 	if(not _useProductionAmplitudes and _useCovariance == useFullCovarianceMatrix) {
 		printErr << "cannot use full covariance matrix while fitting to spin-density matrix." << std::endl;
@@ -65,6 +73,29 @@ rpwa::resonanceFit::function::function(const rpwa::resonanceFit::dataConstPtr& f
 			_idxMassMin[idxBin] = std::min(_idxMassMin[idxBin], _fitData->wavePairMassBinLimits()[idxBin][idxWave][idxWave].first);
 			_idxMassMax[idxBin] = std::max(_idxMassMax[idxBin], _fitData->wavePairMassBinLimits()[idxBin][idxWave][idxWave].second);
 		}
+		for(size_t idxMass = _idxMassMin[idxBin]; idxMass <= _idxMassMax[idxBin]; ++idxMass) {
+			_binMassPairs.push_back(std::make_pair(idxBin, idxMass));
+		}
+	}
+
+	// TFormula cannot be evaluated by several threads at the same time
+	if(_nrThreads != 1 and _fitModel->getFsmd() and not _fitModel->getFsmd()->isCompiled()) {
+		printWarn << "final-state mass-dependence could not be compiled, calculating chi2 in a single thread." << std::endl;
+		_nrThreads = 1;
+	}
+
+	_nrChunks = rpwa::nmbChunks(_binMassPairs.size(), rpwa::nmbThreadsToUse(_nrThreads));
+	for(unsigned int idxChunk = 0; idxChunk < std::max(_nrChunks, 1u); ++idxChunk) {
+		_chunkFitParameters.push_back(std::make_shared<rpwa::resonanceFit::parameters>(_fitModel->getNrComponents()+1,            // nr components + final-state mass-dependence
+		                                                                                _fitModel->getMaxChannelsInComponent(),
+		                                                                                _fitModel->getMaxParametersInComponent(),
+		                                                                                _nrBins));
+		_chunkCaches.push_back(std::make_shared<rpwa::resonanceFit::cache>(_maxNrWaves,
+		                                                                   _fitModel->getNrComponents()+1,          // nr components + final-state mass-dependence
+		                                                                   _fitModel->getMaxChannelsInComponent(),
+		                                                                   _nrBins,
+		                                                                   _maxNrMassBins,
+		                                                                   not _useProductionAmplitudes));   // cache contributions to chi2 of pairs of waves for fits to the spin-density matrix
 	}
 
 	std::ostringstream output;
@@ -144,34 +175,114 @@ rpwa::resonanceFit::function::chiSquare(const std::vector<double>& par) const
 double
 rpwa::resonanceFit::function::chiSquare(const double* par) const
 {
-	// in C++11 we can use a static variable per thread so that the
-	// parameters are kept over function calls and we can implement some
-	// caching
-	thread_local rpwa::resonanceFit::parameters fitParameters(_fitModel->getNrComponents()+1,            // nr components + final-state mass-dependence
-	                                                          _fitModel->getMaxChannelsInComponent(),
-	                                                          _fitModel->getMaxParametersInComponent(),
-	                                                          _nrBins);
-	thread_local rpwa::resonanceFit::cache cache(_maxNrWaves,
-	                                             _fitModel->getNrComponents()+1,          // nr components + final-state mass-dependence
-	                                             _fitModel->getMaxChannelsInComponent(),
-	                                             _nrBins,
-	                                             _maxNrMassBins);
+	return chiSquare(par, nullptr);
+}
+
+
+double
+rpwa::resonanceFit::function::chiSquare(const rpwa::resonanceFit::parameters& fitParameters,
+                                        rpwa::resonanceFit::cache& cache) const
+{
+	return chiSquare(fitParameters, cache, nullptr);
+}
+
+
+double
+rpwa::resonanceFit::function::chiSquare(const std::vector<double>& par,
+                                        std::vector<double>& gradient) const
+{
+	gradient.resize(getNrParameters());
+	return chiSquare(par.data(), gradient.data());
+}
+
+
+double
+rpwa::resonanceFit::function::chiSquare(const double* par,
+                                        double* gradient) const
+{
+	const unsigned int nrChunks = _nrChunks;
+	if(nrChunks <= 1) {
+		rpwa::resonanceFit::parameters* fitParameters;
+		rpwa::resonanceFit::cache* cache;
+		importParameters(par, 0, fitParameters, cache);
+		return chiSquare(*fitParameters, *cache, gradient);
+	}
+
+	// the pairs of bins and mass-bins are split into contiguous chunks,
+	// each of which is processed by its own thread using its own copy
+	// of the parameters and the cache; the contributions to chi2 and to
+	// the gradient are summed in chunk order
+	const size_t nrParameters = getNrParameters();
+	std::vector<double> chunkChiSquares(nrChunks, 0.);
+	std::vector<std::vector<double> > chunkGradients((gradient != nullptr) ? nrChunks : 0, std::vector<double>(nrParameters, 0.));
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nrChunks) schedule(static, 1)
+#endif
+	for(unsigned int idxChunk = 0; idxChunk < nrChunks; ++idxChunk) {
+		rpwa::resonanceFit::parameters* fitParameters;
+		rpwa::resonanceFit::cache* cache;
+		importParameters(par, idxChunk, fitParameters, cache);
+
+		size_t idxPairBegin, idxPairEnd;
+		rpwa::chunkRange(_binMassPairs.size(), nrChunks, idxChunk, idxPairBegin, idxPairEnd);
+		chunkChiSquares[idxChunk] = chiSquare(*fitParameters, *cache, idxPairBegin, idxPairEnd, (gradient != nullptr) ? chunkGradients[idxChunk].data() : nullptr);
+	}
+
+	double chi2 = 0.;
+	for(unsigned int idxChunk = 0; idxChunk < nrChunks; ++idxChunk) {
+		chi2 += chunkChiSquares[idxChunk];
+	}
+	if(gradient != nullptr) {
+		for(size_t idxParameter = 0; idxParameter < nrParameters; ++idxParameter) {
+			gradient[idxParameter] = 0.;
+			for(unsigned int idxChunk = 0; idxChunk < nrChunks; ++idxChunk) {
+				gradient[idxParameter] += chunkGradients[idxChunk][idxParameter];
+			}
+		}
+	}
+
+	return chi2;
+}
+
+
+void
+rpwa::resonanceFit::function::importParameters(const double* par,
+                                               const unsigned int idxChunk,
+                                               rpwa::resonanceFit::parameters*& fitParameters,
+                                               rpwa::resonanceFit::cache*& cache) const
+{
+	fitParameters = _chunkFitParameters[idxChunk].get();
+	cache = _chunkCaches[idxChunk].get();
 
 	// import parameters (couplings, branchings, resonance parameters, ...)
-	_fitModel->importParameters(par, fitParameters, cache);
+	_fitModel->importParameters(par, *fitParameters, *cache);
+}
+
+
+double
+rpwa::resonanceFit::function::chiSquare(const rpwa::resonanceFit::parameters& fitParameters,
+                                        rpwa::resonanceFit::cache& cache,
+                                        double* gradient) const
+{
+	if(gradient != nullptr) {
+		std::fill(gradient, gradient+getNrParameters(), 0.);
+	}
 
-	return chiSquare(fitParameters, cache);
+	return chiSquare(fitParameters, cache, 0, _binMassPairs.size(), gradient);
 }
 
 
 double
 rpwa::resonanceFit::function::chiSquare(const rpwa::resonanceFit::parameters& fitParameters,
-                                        rpwa::resonanceFit::cache& cache) const
+                                        rpwa::resonanceFit::cache& cache,
+                                        const size_t idxPairBegin,
+                                        const size_t idxPairEnd,
+                                        double* gradient) const
 {
 	if(_useProductionAmplitudes) {
-		return chiSquareProductionAmplitudes(fitParameters, cache);
+		return chiSquareProductionAmplitudes(fitParameters, cache, idxPairBegin, idxPairEnd, gradient);
 	} else {
-		return chiSquareSpinDensityMatrix(fitParameters, cache);
+		return chiSquareSpinDensityMatrix(fitParameters, cache, idxPairBegin, idxPairEnd, gradient);
 	}
 }
 
@@ -198,6 +309,42 @@ rpwa::resonanceFit::function::logLikelihood(const rpwa::resonanceFit::parameters
 }
 
 
+double
+rpwa::resonanceFit::function::logLikelihood(const std::vector<double>& par,
+                                            std::vector<double>& gradient) const
+{
+	gradient.resize(getNrParameters());
+	return logLikelihood(par.data(), gradient.data());
+}
+
+
+double
+rpwa::resonanceFit::function::logLikelihood(const double* par,
+                                            double* gradient) const
+{
+	const double chi2 = chiSquare(par, gradient);
+	if(gradient != nullptr) {
+		std::transform(gradient, gradient+getNrParameters(), gradient, [](const double v){ return -0.5 * v; });
+	}
+
+	return -0.5 * chi2;
+}
+
+
+double
+rpwa::resonanceFit::function::logLikelihood(const rpwa::resonanceFit::parameters& fitParameters,
+                                            rpwa::resonanceFit::cache& cache,
+                                            double* gradient) const
+{
+	const double chi2 = chiSquare(fitParameters, cache, gradient);
+	if(gradient != nullptr) {
+		std::transform(gradient, gradient+getNrParameters(), gradient, [](const double v){ return -0.5 * v; });
+	}
+
+	return -0.5 * chi2;
+}
+
+
 double
 rpwa::resonanceFit::function::logPriorLikelihood(const std::vector<double>& par) const
 {
@@ -254,45 +401,98 @@ rpwa::resonanceFit::function::logPriorLikelihood(const rpwa::resonanceFit::param
 
 double
 rpwa::resonanceFit::function::chiSquareProductionAmplitudes(const rpwa::resonanceFit::parameters& fitParameters,
-                                                            rpwa::resonanceFit::cache& cache) const
+                                                            rpwa::resonanceFit::cache& cache,
+                                                            const size_t idxPairBegin,
+                                                            const size_t idxPairEnd,
+                                                            double* gradient) const
 {
 	double chi2=0;
 
-	// loop over bins
-	for(unsigned idxBin=0; idxBin<_nrBins; ++idxBin) {
-		// loop over mass-bins
-		for(unsigned idxMass = _idxMassMin[idxBin]; idxMass <= _idxMassMax[idxBin]; ++idxMass) {
-			const double mass = _fitData->massBinCenters()[idxBin][idxMass];
+	std::vector<std::pair<size_t, std::complex<double> > > anchorDerivatives;
+	std::vector<std::pair<size_t, std::complex<double> > > prodAmpDerivatives;
+
+	// loop over pairs of bins and mass-bins
+	for(size_t idxPair = idxPairBegin; idxPair < idxPairEnd; ++idxPair) {
+		const size_t idxBin = _binMassPairs[idxPair].first;
+		const size_t idxMass = _binMassPairs[idxPair].second;
+		const double mass = _fitData->massBinCenters()[idxBin][idxMass];
+
+		// the contribution to chi2 of this pair can be taken from the
+		// cache if none of the production amplitudes in it changed since
+		// the last calculation
+		if(gradient == nullptr) {
+			const double pairChi2 = cache.getChiSquare(idxBin, idxMass);
+			if(not std::isnan(pairChi2)) {
+				chi2 += pairChi2;
+				continue;
+			}
+		}
+
+		// phase of fit in anchor wave
+		const std::complex<double> anchorFit = _fitModel->productionAmplitude(fitParameters, cache, _fitModel->anchorWaveIndex(idxBin), idxBin, mass, idxMass);
+		const std::complex<double> anchorFitPhase = anchorFit / abs(anchorFit);
+
+		TVectorT<double> prodAmpDiffVect(2*_fitData->nrWaves(idxBin));
+
+		// sum over the contributions to chi2
+		for(size_t idxWave = 0; idxWave < _fitData->nrWaves(idxBin); ++idxWave) {
+			// check that this mass bin should be taken into account for this
+			// combination of waves
+			if(idxMass < _fitData->wavePairMassBinLimits()[idxBin][idxWave][idxWave].first or idxMass > _fitData->wavePairMassBinLimits()[idxBin][idxWave][idxWave].second) {
+				continue;
+			}
+
+			// calculate target spin density matrix element
+			const std::complex<double> prodAmpFit = _fitModel->productionAmplitude(fitParameters, cache, idxWave, idxBin, mass, idxMass) / anchorFitPhase;
 
-			// phase of fit in anchor wave
-			const std::complex<double> anchorFit = _fitModel->productionAmplitude(fitParameters, cache, _fitModel->anchorWaveIndex(idxBin), idxBin, mass, idxMass);
-			const std::complex<double> anchorFitPhase = anchorFit / abs(anchorFit);
+			const std::complex<double> prodAmpDiff = prodAmpFit - _fitData->productionAmplitudes()[idxBin][idxMass][idxWave];
 
-			TVectorT<double> prodAmpDiffVect(2*_fitData->nrWaves(idxBin));
+			const Int_t row = 2*idxWave;
+			prodAmpDiffVect(row) = prodAmpDiff.real();
+			if(idxWave != _fitModel->anchorWaveIndex(idxBin)) {
+				prodAmpDiffVect(row+1) = prodAmpDiff.imag();
+			}
+		} // end loop over idxWave
+
+		const double pairChi2 = _fitData->productionAmplitudesCovMatInv()[idxBin][idxMass].Similarity(prodAmpDiffVect);
+		cache.setChiSquare(idxBin, idxMass, pairChi2);
+		chi2 += pairChi2;
 
-			// sum over the contributions to chi2
+		if(gradient != nullptr) {
+			// chi2 = r^T C r, so that d(chi2) = 2 (C r)^T dr
+			const TVectorT<double> weightedDiffVect = _fitData->productionAmplitudesCovMatInv()[idxBin][idxMass] * prodAmpDiffVect;
+
+			// derivatives of the production amplitudes rotated by the
+			// phase of the anchor wave
+			std::complex<double> sumWeightedProdAmps(0., 0.);
 			for(size_t idxWave = 0; idxWave < _fitData->nrWaves(idxBin); ++idxWave) {
-				// check that this mass bin should be taken into account for this
-				// combination of waves
 				if(idxMass < _fitData->wavePairMassBinLimits()[idxBin][idxWave][idxWave].first or idxMass > _fitData->wavePairMassBinLimits()[idxBin][idxWave][idxWave].second) {
 					continue;
 				}
 
-				// calculate target spin density matrix element
-				const std::complex<double> prodAmpFit = _fitModel->productionAmplitude(fitParameters, cache, idxWave, idxBin, mass, idxMass) / anchorFitPhase;
+				// the imaginary part of the anchor wave does not contribute
+				const Int_t row = 2*idxWave;
+				const std::complex<double> weightedDiff(weightedDiffVect(row), (idxWave != _fitModel->anchorWaveIndex(idxBin)) ? weightedDiffVect(row+1) : 0.);
 
-				const std::complex<double> prodAmpDiff = prodAmpFit - _fitData->productionAmplitudes()[idxBin][idxMass][idxWave];
+				const std::complex<double> prodAmp = _fitModel->productionAmplitude(fitParameters, cache, idxWave, idxBin, mass, idxMass);
+				sumWeightedProdAmps += prodAmp * conj(weightedDiff);
 
-				const Int_t row = 2*idxWave;
-				prodAmpDiffVect(row) = prodAmpDiff.real();
-				if(idxWave != _fitModel->anchorWaveIndex(idxBin)) {
-					prodAmpDiffVect(row+1) = prodAmpDiff.imag();
+				_fitModel->productionAmplitudeDerivatives(fitParameters, cache, idxWave, idxBin, mass, idxMass, prodAmpDerivatives);
+				for(size_t i = 0; i < prodAmpDerivatives.size(); ++i) {
+					gradient[prodAmpDerivatives[i].first] += 2. * (prodAmpDerivatives[i].second / anchorFitPhase * conj(weightedDiff)).real();
 				}
-			} // end loop over idxWave
+			}
 
-			chi2 += _fitData->productionAmplitudesCovMatInv()[idxBin][idxMass].Similarity(prodAmpDiffVect);
-		} // end loop over mass-bins
-	} // end loop over bins
+			// derivatives of the phase of the anchor wave:
+			// d(1/phase) = d(conj(A)/|A|) = (conj(dA) - conj(A)/|A| * Re(conj(A)/|A| * dA)) / |A|
+			_fitModel->productionAmplitudeDerivatives(fitParameters, cache, _fitModel->anchorWaveIndex(idxBin), idxBin, mass, idxMass, anchorDerivatives);
+			for(size_t i = 0; i < anchorDerivatives.size(); ++i) {
+				const std::complex<double>& anchorDerivative = anchorDerivatives[i].second;
+				const std::complex<double> phaseDerivative = (conj(anchorDerivative) - conj(anchorFitPhase) * (conj(anchorFitPhase) * anchorDerivative).real()) / abs(anchorFit);
+				gradient[anchorDerivatives[i].first] += 2. * (phaseDerivative * sumWeightedProdAmps).real();
+			}
+		}
+	} // end loop over pairs of bins and mass-bins
 
 	return chi2;
 }
@@ -300,50 +500,123 @@ rpwa::resonanceFit::function::chiSquareProductionAmplitudes(const rpwa::resonanc
 
 double
 rpwa::resonanceFit::function::chiSquareSpinDensityMatrix(const rpwa::resonanceFit::parameters& fitParameters,
-                                                         rpwa::resonanceFit::cache& cache) const
+                                                         rpwa::resonanceFit::cache& cache,
+                                                         const size_t idxPairBegin,
+                                                         const size_t idxPairEnd,
+                                                         double* gradient) const
 {
 	double chi2=0;
 
-	// loop over bins
-	for(unsigned idxBin=0; idxBin<_nrBins; ++idxBin) {
-		// loop over mass-bins
-		for(unsigned idxMass = _idxMassMin[idxBin]; idxMass <= _idxMassMax[idxBin]; ++idxMass) {
-			const double mass = _fitData->massBinCenters()[idxBin][idxMass];
+	std::vector<std::vector<std::pair<size_t, std::complex<double> > > > prodAmpDerivatives(_maxNrWaves);
+
+	// loop over pairs of bins and mass-bins
+	for(size_t idxPair = idxPairBegin; idxPair < idxPairEnd; ++idxPair) {
+		const size_t idxBin = _binMassPairs[idxPair].first;
+		const size_t idxMass = _binMassPairs[idxPair].second;
+		const double mass = _fitData->massBinCenters()[idxBin][idxMass];
+
+		// the contribution to chi2 of this pair can be taken from the
+		// cache if none of the production amplitudes in it changed since
+		// the last calculation
+		if(gradient == nullptr) {
+			const double pairChi2 = cache.getChiSquare(idxBin, idxMass);
+			if(not std::isnan(pairChi2)) {
+				chi2 += pairChi2;
+				continue;
+			}
+		}
+		double pairChi2 = 0.;
 
-			// sum over the contributions to chi2 -> rho_ij
+		// the derivatives of the spin-density matrix elements are
+		// calculated from the derivatives of the production amplitudes
+		if(gradient != nullptr) {
 			for(size_t idxWave = 0; idxWave < _fitData->nrWaves(idxBin); ++idxWave) {
-				for(size_t jdxWave = idxWave; jdxWave < _fitData->nrWaves(idxBin); ++jdxWave) {
-					// check that this mass bin should be taken into account for this
-					// combination of waves
-					if(idxMass < _fitData->wavePairMassBinLimits()[idxBin][idxWave][jdxWave].first or idxMass > _fitData->wavePairMassBinLimits()[idxBin][idxWave][jdxWave].second) {
-						continue;
-					}
+				_fitModel->productionAmplitudeDerivatives(fitParameters, cache, idxWave, idxBin, mass, idxMass, prodAmpDerivatives[idxWave]);
+			}
+		}
 
-					// calculate target spin density matrix element
-					const std::complex<double> rhoFit = _fitModel->spinDensityMatrix(fitParameters, cache, idxWave, jdxWave, idxBin, mass, idxMass);
+		// sum over the contributions to chi2 -> rho_ij
+		for(size_t idxWave = 0; idxWave < _fitData->nrWaves(idxBin); ++idxWave) {
+			for(size_t jdxWave = idxWave; jdxWave < _fitData->nrWaves(idxBin); ++jdxWave) {
+				// check that this mass bin should be taken into account for this
+				// combination of waves
+				if(idxMass < _fitData->wavePairMassBinLimits()[idxBin][idxWave][jdxWave].first or idxMass > _fitData->wavePairMassBinLimits()[idxBin][idxWave][jdxWave].second) {
+					continue;
+				}
 
-					const std::complex<double> rhoDiff = rhoFit - _fitData->spinDensityMatrixElements()[idxBin][idxMass][idxWave][jdxWave];
+				// if only some production amplitudes changed, only the
+				// contributions of the pairs of waves involving them have
+				// to be recalculated
+				if(gradient == nullptr and cache.cachesWavePairs()) {
+					const double wavePairChi2 = cache.getChiSquareWavePair(idxBin, idxMass, idxWave, jdxWave);
+					if(not std::isnan(wavePairChi2)) {
+						pairChi2 += wavePairChi2;
+						continue;
+					}
+				}
 
-					if(idxWave==jdxWave) {
-						chi2 += rhoDiff.real() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][0][0] * rhoDiff.real();
+				// calculate target spin density matrix element
+				const std::complex<double> rhoFit = _fitModel->spinDensityMatrix(fitParameters, cache, idxWave, jdxWave, idxBin, mass, idxMass);
+
+				const std::complex<double> rhoDiff = rhoFit - _fitData->spinDensityMatrixElements()[idxBin][idxMass][idxWave][jdxWave];
+
+				// derivatives of the contribution to chi2 w.r.t. the real
+				// and imaginary part of the spin-density matrix element
+				double chi2DerivativeReal = 0.;
+				double chi2DerivativeImag = 0.;
+
+				double wavePairChi2 = 0.;
+
+				if(idxWave==jdxWave) {
+					wavePairChi2 += rhoDiff.real() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][0][0] * rhoDiff.real();
+					chi2DerivativeReal = 2. * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][0][0] * rhoDiff.real();
+				} else {
+					if (_useCovariance == useDiagnalElementsOnly) {
+						wavePairChi2 += rhoDiff.real() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][0][0] * rhoDiff.real();
+						wavePairChi2 += rhoDiff.imag() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][1][1] * rhoDiff.imag();
+						chi2DerivativeReal = 2. * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][0][0] * rhoDiff.real();
+						chi2DerivativeImag = 2. * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][1][1] * rhoDiff.imag();
+					} else if(_useCovariance == useComplexDiagnalElementsOnly) {
+						wavePairChi2 += rhoDiff.real() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][0][0] * rhoDiff.real();
+						wavePairChi2 += rhoDiff.real() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][0][1] * rhoDiff.imag();
+						wavePairChi2 += rhoDiff.imag() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][1][0] * rhoDiff.real();
+						wavePairChi2 += rhoDiff.imag() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][1][1] * rhoDiff.imag();
+						const double covMatInvOffDiagonal = _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][0][1] + _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][1][0];
+						chi2DerivativeReal = 2. * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][0][0] * rhoDiff.real() + covMatInvOffDiagonal * rhoDiff.imag();
+						chi2DerivativeImag = 2. * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][1][1] * rhoDiff.imag() + covMatInvOffDiagonal * rhoDiff.real();
 					} else {
-						if (_useCovariance == useDiagnalElementsOnly) {
-							chi2 += rhoDiff.real() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][0][0] * rhoDiff.real();
-							chi2 += rhoDiff.imag() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][1][1] * rhoDiff.imag();
-						} else if(_useCovariance == useComplexDiagnalElementsOnly) {
-							chi2 += rhoDiff.real() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][0][0] * rhoDiff.real();
-							chi2 += rhoDiff.real() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][0][1] * rhoDiff.imag();
-							chi2 += rhoDiff.imag() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][1][0] * rhoDiff.real();
-							chi2 += rhoDiff.imag() * _fitData->spinDensityMatrixElementsCovMatInvArray()[idxBin][idxMass][idxWave][jdxWave][1][1] * rhoDiff.imag();
-						} else {
-							// this should have returned an error during the call to init()
-							assert(false);
-						}
+						// this should have returned an error during the call to init()
+						assert(false);
 					}
-				} // end loop over jdxWave
-			} // end loop over idxWave
-		} // end loop over mass-bins
-	} // end loop over bins
+				}
+
+				if(cache.cachesWavePairs()) {
+					cache.setChiSquareWavePair(idxBin, idxMass, idxWave, jdxWave, wavePairChi2);
+				}
+				pairChi2 += wavePairChi2;
+
+				if(gradient != nullptr) {
+					// d(rho_ij) = dP_i * conj(P_j) + P_i * conj(dP_j), and
+					// d(chi2) = Re(d(rho_ij) * conj(chi2Derivative))
+					const std::complex<double> chi2Derivative(chi2DerivativeReal, chi2DerivativeImag);
+					const std::complex<double> prodAmpI = _fitModel->productionAmplitude(fitParameters, cache, idxWave, idxBin, mass, idxMass);
+					const std::complex<double> prodAmpJ = _fitModel->productionAmplitude(fitParameters, cache, jdxWave, idxBin, mass, idxMass);
+
+					const std::complex<double> factorI = conj(prodAmpJ * chi2Derivative);
+					for(size_t i = 0; i < prodAmpDerivatives[idxWave].size(); ++i) {
+						gradient[prodAmpDerivatives[idxWave][i].first] += (prodAmpDerivatives[idxWave][i].second * factorI).real();
+					}
+					const std::complex<double> factorJ = conj(prodAmpI) * chi2Derivative;
+					for(size_t i = 0; i < prodAmpDerivatives[jdxWave].size(); ++i) {
+						gradient[prodAmpDerivatives[jdxWave][i].first] += (prodAmpDerivatives[jdxWave][i].second * factorJ).real();
+					}
+				}
+			} // end loop over jdxWave
+		} // end loop over idxWave
+
+		cache.setChiSquare(idxBin, idxMass, pairChi2);
+		chi2 += pairChi2;
+	} // end loop over pairs of bins and mass-bins
 
 	return chi2;
 }
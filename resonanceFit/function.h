@@ -62,7 +62,8 @@ namespace rpwa {
 
 			function(const rpwa::resonanceFit::dataConstPtr& fitData,
 			         const rpwa::resonanceFit::modelConstPtr& fitModel,
-			         const bool useProductionAmplitudes);
+			         const bool useProductionAmplitudes,
+			         const unsigned int nrThreads = 1);
 			~function() {}
 
 			size_t getNrParameters() const;
@@ -73,21 +74,61 @@ namespace rpwa {
 			double chiSquare(const rpwa::resonanceFit::parameters& fitParameters,
 			                 rpwa::resonanceFit::cache& cache) const;
 
+			// chi2 and its derivatives w.r.t. the parameters
+			double chiSquare(const std::vector<double>& par,
+			                 std::vector<double>& gradient) const;
+			double chiSquare(const double* par,
+			                 double* gradient) const;
+			double chiSquare(const rpwa::resonanceFit::parameters& fitParameters,
+			                 rpwa::resonanceFit::cache& cache,
+			                 double* gradient) const;
+
 			double logLikelihood(const std::vector<double>& par) const;
 			double logLikelihood(const double* par) const;
 			double logLikelihood(const rpwa::resonanceFit::parameters& fitParameters,
 			                     rpwa::resonanceFit::cache& cache) const;
 
+			// log-likelihood and its derivatives w.r.t. the parameters
+			double logLikelihood(const std::vector<double>& par,
+			                     std::vector<double>& gradient) const;
+			double logLikelihood(const double* par,
+			                     double* gradient) const;
+			double logLikelihood(const rpwa::resonanceFit::parameters& fitParameters,
+			                     rpwa::resonanceFit::cache& cache,
+			                     double* gradient) const;
+
 			double logPriorLikelihood(const std::vector<double>& par) const;
 			double logPriorLikelihood(const double* par) const;
 			double logPriorLikelihood(const rpwa::resonanceFit::parameters& fitParameters) const;
 
+			unsigned int getNrThreads() const { return _nrThreads; }
+
 		private:
 
+			// imports the parameters into the parameters and cache of the
+			// given chunk, which are kept between function calls
+			void importParameters(const double* par,
+			                      const unsigned int idxChunk,
+			                      rpwa::resonanceFit::parameters*& fitParameters,
+			                      rpwa::resonanceFit::cache*& cache) const;
+
+			// contributions of the pairs of bins and mass-bins in the range
+			// [idxPairBegin, idxPairEnd) to chi2 and its derivatives
+			double chiSquare(const rpwa::resonanceFit::parameters& fitParameters,
+			                 rpwa::resonanceFit::cache& cache,
+			                 const size_t idxPairBegin,
+			                 const size_t idxPairEnd,
+			                 double* gradient) const;
 			double chiSquareProductionAmplitudes(const rpwa::resonanceFit::parameters& fitParameters,
-			                                     rpwa::resonanceFit::cache& cache) const;
+			                                     rpwa::resonanceFit::cache& cache,
+			                                     const size_t idxPairBegin,
+			                                     const size_t idxPairEnd,
+			                                     double* gradient) const;
 			double chiSquareSpinDensityMatrix(const rpwa::resonanceFit::parameters& fitParameters,
-			                                  rpwa::resonanceFit::cache& cache) const;
+			                                  rpwa::resonanceFit::cache& cache,
+			                                  const size_t idxPairBegin,
+			                                  const size_t idxPairEnd,
+			                                  double* gradient) const;
 
 			const rpwa::resonanceFit::dataConstPtr _fitData;
 			const rpwa::resonanceFit::modelConstPtr _fitModel;
@@ -99,9 +140,27 @@ namespace rpwa {
 			std::vector<size_t> _idxMassMin;
 			std::vector<size_t> _idxMassMax;
 
+			// pairs of bin and mass-bin that contribute to chi2
+			std::vector<std::pair<size_t, size_t> > _binMassPairs;
+
 			const bool _useProductionAmplitudes;
 			const rpwa::resonanceFit::function::useCovarianceMatrix _useCovariance;
 
+			// number of threads used to calculate chi2, 0 uses all
+			// available threads
+			unsigned int _nrThreads;
+
+			// number of chunks the pairs of bins and mass-bins are split
+			// into, each of which is processed by its own thread
+			unsigned int _nrChunks;
+
+			// parameters and cache of each chunk, which are kept between
+			// function calls so that we can implement some caching; as
+			// they belong to this object, a function object must not be
+			// evaluated by several threads at the same time
+			mutable std::vector<std::shared_ptr<rpwa::resonanceFit::parameters> > _chunkFitParameters;
+			mutable std::vector<std::shared_ptr<rpwa::resonanceFit::cache> > _chunkCaches;
+
 		};
 
 	} // end namespace resonanceFit
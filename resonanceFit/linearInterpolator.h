@@ -0,0 +1,128 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026 Boris Grube (TUM)
+//
+//    This file is part of ROOTPWA
+//
+//    ROOTPWA is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ROOTPWA is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with ROOTPWA.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      linear interpolation between tabulated points
+//      - gives the same values as ROOT::Math::Interpolator with
+//        ROOT::Math::Interpolation::kLINEAR, but does not use an
+//        accelerator for the lookup of the interval, so that one
+//        instance can be evaluated by several threads at the same time
+//
+//-------------------------------------------------------------------------
+
+
+#ifndef RESONANCEFIT_LINEARINTERPOLATOR_HH
+#define RESONANCEFIT_LINEARINTERPOLATOR_HH
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <reportingUtils.hpp>
+
+namespace rpwa {
+
+	namespace resonanceFit {
+
+		class linearInterpolator {
+
+		public:
+
+			linearInterpolator(const std::vector<double>& x,
+			                   const std::vector<double>& y);
+
+			// NaN outside of the range of the tabulated points or if there
+			// are less than two points
+			double eval(const double x) const;
+			double deriv(const double x) const;
+
+		private:
+
+			size_t findInterval(const double x) const;
+
+			const std::vector<double> _x;
+			const std::vector<double> _y;
+
+		};
+
+	} // end namespace resonanceFit
+
+} // end namespace rpwa
+
+
+inline
+rpwa::resonanceFit::linearInterpolator::linearInterpolator(const std::vector<double>& x,
+                                                           const std::vector<double>& y)
+	: _x(x),
+	  _y(y)
+{
+	if(_x.size() != _y.size()) {
+		printErr << "number of x values (" << _x.size() << ") and y values (" << _y.size() << ") for interpolation differ. Aborting..." << std::endl;
+		throw;
+	}
+	for(size_t i = 1; i < _x.size(); ++i) {
+		if(not (_x[i-1] < _x[i])) {
+			printErr << "x values for interpolation are not strictly increasing. Aborting..." << std::endl;
+			throw;
+		}
+	}
+}
+
+
+inline
+size_t
+rpwa::resonanceFit::linearInterpolator::findInterval(const double x) const
+{
+	// index of the last point not above x, the last interval also
+	// contains its upper end
+	const size_t idx = std::upper_bound(_x.begin(), _x.end(), x) - _x.begin();
+	return std::min(std::max(idx, (size_t)1), _x.size()-1) - 1;
+}
+
+
+inline
+double
+rpwa::resonanceFit::linearInterpolator::eval(const double x) const
+{
+	if(_x.size() < 2 or not (x >= _x.front() and x <= _x.back())) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	const size_t idx = findInterval(x);
+	return _y[idx] + (x - _x[idx]) * (_y[idx+1] - _y[idx]) / (_x[idx+1] - _x[idx]);
+}
+
+
+inline
+double
+rpwa::resonanceFit::linearInterpolator::deriv(const double x) const
+{
+	if(_x.size() < 2 or not (x >= _x.front() and x <= _x.back())) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	const size_t idx = findInterval(x);
+	return (_y[idx+1] - _y[idx]) / (_x[idx+1] - _x[idx]);
+}
+
+
+#endif // RESONANCEFIT_LINEARINTERPOLATOR_HH
@@ -29,6 +29,11 @@
 
 #include "minimizerRoot.h"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+
 #include <boost/tokenizer.hpp>
 
 #include <Math/Minimizer.h>
@@ -73,6 +78,23 @@ rpwa::resonanceFit::minimizerRoot::functionAdaptor::NPoint() const
 }
 
 
+void
+rpwa::resonanceFit::minimizerRoot::functionAdaptor::Gradient(const double* par,
+                                                            double* gradient) const
+{
+	_fitFunction->chiSquare(par, gradient);
+}
+
+
+void
+rpwa::resonanceFit::minimizerRoot::functionAdaptor::FdF(const double* par,
+                                                       double& chi2,
+                                                       double* gradient) const
+{
+	chi2 = _fitFunction->chiSquare(par, gradient);
+}
+
+
 double
 rpwa::resonanceFit::minimizerRoot::functionAdaptor::DoEval(const double* par) const
 {
@@ -80,15 +102,68 @@ rpwa::resonanceFit::minimizerRoot::functionAdaptor::DoEval(const double* par) co
 }
 
 
+double
+rpwa::resonanceFit::minimizerRoot::functionAdaptor::DoDerivative(const double* par,
+                                                                unsigned int derivativeIndex) const
+{
+	const size_t nrParameters = _fitFunction->getNrParameters();
+	if(_parCache.size() != nrParameters or not std::equal(_parCache.begin(), _parCache.end(), par)) {
+		_parCache.assign(par, par+nrParameters);
+		_gradientCache.resize(nrParameters);
+		_fitFunction->chiSquare(par, _gradientCache.data());
+	}
+
+	return _gradientCache[derivativeIndex];
+}
+
+
+rpwa::resonanceFit::minimizerRoot::numericalFunctionAdaptor::numericalFunctionAdaptor(const rpwa::resonanceFit::functionConstPtr& fitFunction)
+	: _fitFunction(fitFunction)
+{
+}
+
+
+rpwa::resonanceFit::minimizerRoot::numericalFunctionAdaptor*
+rpwa::resonanceFit::minimizerRoot::numericalFunctionAdaptor::Clone() const
+{
+	return new rpwa::resonanceFit::minimizerRoot::numericalFunctionAdaptor(*this);
+}
+
+
+unsigned int
+rpwa::resonanceFit::minimizerRoot::numericalFunctionAdaptor::NDim() const
+{
+	return _fitFunction->getNrParameters();
+}
+
+
+unsigned int
+rpwa::resonanceFit::minimizerRoot::numericalFunctionAdaptor::NPoint() const
+{
+	return _fitFunction->getNrDataPoints();
+}
+
+
+double
+rpwa::resonanceFit::minimizerRoot::numericalFunctionAdaptor::DoEval(const double* par) const
+{
+	return _fitFunction->chiSquare(par);
+}
+
+
 rpwa::resonanceFit::minimizerRoot::minimizerRoot(const rpwa::resonanceFit::modelConstPtr& fitModel,
                                                  const rpwa::resonanceFit::functionConstPtr& fitFunction,
                                                  const unsigned int maxNmbOfFunctionCalls,
                                                  const std::string minimizerType[],
                                                  const int minimizerStrategy,
                                                  const double minimizerTolerance,
+                                                 const bool analyticGradient,
+                                                 const bool checkGradient,
                                                  const bool quiet)
 	: _fitModel(fitModel),
 	  _functionAdaptor(fitFunction),
+	  _numericalFunctionAdaptor(fitFunction),
+	  _checkGradient(checkGradient),
 	  _maxNmbOfIterations(20000),
 	  _maxNmbOfFunctionCalls((maxNmbOfFunctionCalls > 0) ? maxNmbOfFunctionCalls : (5 * _maxNmbOfIterations * fitFunction->getNrParameters()))
 {
@@ -100,7 +175,12 @@ rpwa::resonanceFit::minimizerRoot::minimizerRoot(const rpwa::resonanceFit::model
 		printErr << "could not create minimizer. exiting." << std::endl;
 		throw;
 	}
-	_minimizer->SetFunction        (_functionAdaptor);
+	if(analyticGradient) {
+		_minimizer->SetFunction(_functionAdaptor);
+	} else {
+		printInfo << "using numerical derivatives of chi2." << std::endl;
+		_minimizer->SetFunction(_numericalFunctionAdaptor);
+	}
 	_minimizer->SetStrategy        (minimizerStrategy);
 	_minimizer->SetTolerance       (minimizerTolerance);
 	_minimizer->SetPrintLevel      ((quiet) ? 0 : 3);
@@ -168,6 +248,10 @@ rpwa::resonanceFit::minimizerRoot::minimize(std::vector<std::string>& freeParame
 				return std::map<std::string, double>();
 			}
 
+			if(_checkGradient and not checkGradient()) {
+				printWarn << "analytic gradient deviates from difference quotients before step " << step << "." << std::endl;
+			}
+
 			printInfo << "performing minimization step " << step << ": '" << freeParameters[step-removedSteps] << "' (" << _minimizer->NFree() << " free parameters)." << std::endl;
 			success &= _minimizer->Minimize();
 
@@ -552,3 +636,80 @@ rpwa::resonanceFit::minimizerRoot::initParameters(const rpwa::resonanceFit::para
 
 	return true;
 }
+
+
+bool
+rpwa::resonanceFit::minimizerRoot::checkGradient() const
+{
+	const unsigned int nmbPar = _functionAdaptor.NDim();
+	if(_minimizer->X() == nullptr) {
+		printWarn << "minimizer does not provide current parameters, cannot check gradient." << std::endl;
+		return false;
+	}
+	const std::vector<double> par(_minimizer->X(), _minimizer->X() + nmbPar);
+
+	double chi2;
+	std::vector<double> gradient(nmbPar);
+	_functionAdaptor.FdF(par.data(), chi2, gradient.data());
+
+	// the step size is chosen such that the truncation error of the
+	// difference quotient, O(h^2), and the rounding error,
+	// O(epsilon * chi2 / h), are both small compared to the tolerance
+	const double relativeStep = 1e-5;
+	const double tolerance = 1e-4;
+
+	// maximal deviation and number of parameters for each component
+	// type, parameters not belonging to a component are listed as
+	// 'other'
+	std::map<std::string, std::pair<double, size_t> > deviations;
+
+	bool success = true;
+	std::vector<double> parShifted(par);
+	for(unsigned int idxPar = 0; idxPar < nmbPar; ++idxPar) {
+		const double step = relativeStep * std::max(1., std::abs(par[idxPar]));
+		parShifted[idxPar] = par[idxPar] + step;
+		const double chi2Up = _functionAdaptor(parShifted.data());
+		parShifted[idxPar] = par[idxPar] - step;
+		const double chi2Down = _functionAdaptor(parShifted.data());
+		parShifted[idxPar] = par[idxPar];
+
+		const double numerical = (chi2Up - chi2Down) / (2. * step);
+		const double scale = std::max(std::max(std::abs(gradient[idxPar]), std::abs(numerical)), 1e-6 * std::max(1., std::abs(chi2)));
+		const double deviation = std::abs(gradient[idxPar] - numerical) / scale;
+
+		// parameter names consist of tokens separated by '__', one of
+		// which is the name of the component for couplings, branchings
+		// and component parameters
+		const std::string name = _minimizer->VariableName(idxPar);
+		std::string type = "other";
+		for(size_t idxComponent = 0; idxComponent < _fitModel->getNrComponents(); ++idxComponent) {
+			const rpwa::resonanceFit::componentConstPtr& comp = _fitModel->getComponent(idxComponent);
+			if(("__" + name + "__").find("__" + comp->getName() + "__") != std::string::npos) {
+				type = comp->getType();
+				break;
+			}
+		}
+		std::pair<double, size_t>& typeDeviation = deviations[type];
+		typeDeviation.first = std::max(typeDeviation.first, deviation);
+		++typeDeviation.second;
+
+		if(deviation > tolerance) {
+			printWarn << "derivative w.r.t. parameter " << idxPar << " ('" << name << "', " << type << "): "
+			          << "analytic = " << rpwa::maxPrecisionAlign(gradient[idxPar]) << ", "
+			          << "difference quotient = " << rpwa::maxPrecisionAlign(numerical) << ", "
+			          << "relative deviation = " << deviation << std::endl;
+			success = false;
+		}
+	}
+
+	std::ostringstream output;
+	for(std::map<std::string, std::pair<double, size_t> >::const_iterator it = deviations.begin(); it != deviations.end(); ++it) {
+		output << "    " << it->first << ": " << it->second.second << " parameter" << ((it->second.second == 1) ? "" : "s")
+		       << ", maximal relative deviation = " << it->second.first << std::endl;
+	}
+	printInfo << "comparison of analytic gradient with difference quotients at chi2 = " << rpwa::maxPrecisionAlign(chi2)
+	          << " (tolerance " << tolerance << "):" << std::endl
+	          << output.str();
+
+	return success;
+}
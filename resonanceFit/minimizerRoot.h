@@ -52,7 +52,7 @@ namespace rpwa {
 
 		private:
 
-			class functionAdaptor : public ROOT::Math::IBaseFunctionMultiDim {
+			class functionAdaptor : public ROOT::Math::IGradientFunctionMultiDim {
 
 			public:
 
@@ -65,6 +65,44 @@ namespace rpwa {
 
 				virtual unsigned int NPoint() const;
 
+				virtual void Gradient(const double* par,
+				                      double* gradient) const;
+
+				virtual void FdF(const double* par,
+				                 double& chi2,
+				                 double* gradient) const;
+
+			private:
+
+				virtual double DoEval(const double* par) const;
+
+				virtual double DoDerivative(const double* par,
+				                            unsigned int derivativeIndex) const;
+
+				const rpwa::resonanceFit::functionConstPtr _fitFunction;
+
+				// the derivatives are always calculated for all parameters,
+				// keep them for calls to DoDerivative with the same parameters
+				mutable std::vector<double> _parCache;
+				mutable std::vector<double> _gradientCache;
+
+			};
+
+			// adaptor without gradient, the minimizer then calculates the
+			// derivatives numerically
+			class numericalFunctionAdaptor : public ROOT::Math::IBaseFunctionMultiDim {
+
+			public:
+
+				numericalFunctionAdaptor(const rpwa::resonanceFit::functionConstPtr& fitFunction);
+				virtual ~numericalFunctionAdaptor() {}
+
+				virtual rpwa::resonanceFit::minimizerRoot::numericalFunctionAdaptor* Clone() const;
+
+				virtual unsigned int NDim() const;
+
+				virtual unsigned int NPoint() const;
+
 			private:
 
 				virtual double DoEval(const double* par) const;
@@ -81,6 +119,8 @@ namespace rpwa {
 			              const std::string minimizerType[],
 			              const int minimizerStrategy,
 			              const double minimizerTolerance,
+			              const bool analyticGradient,
+			              const bool checkGradient,
 			              const bool quiet);
 			virtual ~minimizerRoot();
 
@@ -95,11 +135,18 @@ namespace rpwa {
 			bool initParameters(const rpwa::resonanceFit::parameters& fitParameters,
 			                    const std::string& freeParameters) const;
 
+			// compares the analytic gradient at the current parameters with
+			// symmetric difference quotients, returns false if they deviate
+			bool checkGradient() const;
+
 			std::unique_ptr<ROOT::Math::Minimizer> _minimizer;
 
 			const rpwa::resonanceFit::modelConstPtr _fitModel;
 
 			rpwa::resonanceFit::minimizerRoot::functionAdaptor _functionAdaptor;
+			rpwa::resonanceFit::minimizerRoot::numericalFunctionAdaptor _numericalFunctionAdaptor;
+
+			const bool _checkGradient;
 
 			unsigned int _maxNmbOfIterations;
 			unsigned int _maxNmbOfFunctionCalls;
@@ -29,6 +29,7 @@
 
 #include "model.h"
 
+#include <algorithm>
 #include <set>
 
 #include <reportingUtils.hpp>
@@ -49,6 +50,7 @@ rpwa::resonanceFit::model::model(const rpwa::resonanceFit::inputConstPtr& fitInp
 	  _components(components),
 	  _fsmd(fsmd),
 	  _nrParameters(0),
+	  _parameterIndexFsmd(std::numeric_limits<size_t>::max()),
 	  _maxChannelsInComponent(0),
 	  _maxParametersInComponent(0),
 	  _anchorWaveNames(anchorWaveNames),
@@ -106,6 +108,8 @@ rpwa::resonanceFit::model::model(const rpwa::resonanceFit::inputConstPtr& fitInp
 		printErr << "error while mapping the waves to the decay channels and components." << std::endl;
 		throw;
 	}
+
+	initParameterIndices(nrBins);
 }
 
 
@@ -283,6 +287,70 @@ rpwa::resonanceFit::model::initMapping(const rpwa::resonanceFit::inputConstPtr&
 }
 
 
+// determines the positions of the parameters in the array of parameters
+// passed to importParameters, the order has to be kept in sync with the
+// import functions of the components and the final-state mass-dependence
+void
+rpwa::resonanceFit::model::initParameterIndices(const size_t nrBins)
+{
+	size_t maxNrCouplings = 0;
+	size_t maxNrBranchings = 0;
+	for(size_t idxComponent = 0; idxComponent < _components.size(); ++idxComponent) {
+		maxNrCouplings = std::max(maxNrCouplings, _components[idxComponent]->getNrCouplings());
+		maxNrBranchings = std::max(maxNrBranchings, _components[idxComponent]->getNrBranchings());
+	}
+
+	_parameterIndicesComponents.assign(_components.size(), std::numeric_limits<size_t>::max());
+	_parameterIndicesCouplings.resize(boost::extents[_components.size()][maxNrCouplings][nrBins]);
+	std::fill(_parameterIndicesCouplings.data(), _parameterIndicesCouplings.data()+_parameterIndicesCouplings.num_elements(), std::numeric_limits<size_t>::max());
+	_parameterIndicesBranchings.resize(boost::extents[_components.size()][maxNrBranchings]);
+	std::fill(_parameterIndicesBranchings.data(), _parameterIndicesBranchings.data()+_parameterIndicesBranchings.num_elements(), std::numeric_limits<size_t>::max());
+	_parameterIndexFsmd = std::numeric_limits<size_t>::max();
+
+	size_t parcount=0;
+
+	// couplings
+	for(size_t idxComponent = 0; idxComponent < _components.size(); ++idxComponent) {
+		const componentConstPtr& component = _components[idxComponent];
+		for(size_t idxCoupling = 0; idxCoupling < component->getNrCouplings(); ++idxCoupling) {
+			const std::vector<size_t>& bins = component->getChannelFromCouplingIdx(idxCoupling).getBins();
+			for(size_t i = 0; i < bins.size(); ++i) {
+				_parameterIndicesCouplings[idxComponent][idxCoupling][bins[i]] = parcount;
+				parcount += 2;
+			}
+		}
+	}
+
+	// branchings
+	for(size_t idxComponent = 0; idxComponent < _components.size(); ++idxComponent) {
+		const componentConstPtr& component = _components[idxComponent];
+		for(size_t idxBranching = 0; idxBranching < component->getNrBranchings(); ++idxBranching) {
+			if(not component->isBranchingFixed(idxBranching)) {
+				_parameterIndicesBranchings[idxComponent][idxBranching] = parcount;
+				parcount += 2;
+			}
+		}
+	}
+
+	// parameters
+	for(size_t idxComponent = 0; idxComponent < _components.size(); ++idxComponent) {
+		_parameterIndicesComponents[idxComponent] = parcount;
+		parcount += _components[idxComponent]->getNrParameters();
+	}
+
+	// final-state mass-dependence
+	if(_fsmd) {
+		_parameterIndexFsmd = parcount;
+		const size_t maxNrBins = _fsmd->isSameFunctionForAllBins() ? 1 : _fsmd->getNrBins();
+		for(size_t idxBin = 0; idxBin < maxNrBins; ++idxBin) {
+			parcount += _fsmd->getNrParameters(idxBin);
+		}
+	}
+
+	assert(_nrParameters == parcount);
+}
+
+
 void
 rpwa::resonanceFit::model::importParameters(const double* par,
                                             rpwa::resonanceFit::parameters& parameters,
@@ -354,6 +422,77 @@ rpwa::resonanceFit::model::productionAmplitude(const rpwa::resonanceFit::paramet
 }
 
 
+// calculates the derivatives of the production amplitude w.r.t. all
+// parameters the production amplitude depends on, each entry contains
+// the index of the parameter in the array of parameters passed to
+// importParameters and the derivative w.r.t. this (real) parameter
+void
+rpwa::resonanceFit::model::productionAmplitudeDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+                                                          rpwa::resonanceFit::cache& cache,
+                                                          const size_t idxWave,
+                                                          const size_t idxBin,
+                                                          const double mass,
+                                                          const size_t idxMass,
+                                                          std::vector<std::pair<size_t, std::complex<double> > >& derivatives) const
+{
+	derivatives.clear();
+
+	const std::complex<double> fsmd = _fsmd ? _fsmd->val(fitParameters, cache, idxBin, mass, idxMass) : 1.;
+	const std::complex<double> imag(0., 1.);
+
+	// get entry from mapping
+	const std::vector<std::pair<size_t, size_t> >& components = _waveComponentChannel[idxBin][idxWave];
+	const size_t nrComponents = components.size();
+
+	std::complex<double> sum(0., 0.);
+	std::vector<std::complex<double> > componentDerivatives;
+	for(size_t idxComponents = 0; idxComponents < nrComponents; ++idxComponents) {
+		const size_t idxComponent = components[idxComponents].first;
+		const size_t idxChannel = components[idxComponents].second;
+		const componentConstPtr& component = _components[idxComponent];
+
+		const std::complex<double> componentVal = component->val(fitParameters, cache, idxBin, mass, idxMass);
+		const std::complex<double> couplingPhaseSpace = component->getCouplingPhaseSpace(fitParameters, cache, idxChannel, idxBin, mass, idxMass);
+		sum += componentVal * couplingPhaseSpace;
+
+		const size_t idxCoupling = component->mapChannelToCoupling(idxChannel);
+		const size_t idxBranching = component->mapChannelToBranching(idxChannel);
+		const std::complex<double> coupling = fitParameters.getCoupling(component->getId(), idxCoupling, idxBin);
+		const std::complex<double> branching = fitParameters.getBranching(component->getId(), idxBranching);
+		const double phaseSpaceIntegral = component->getChannel(idxChannel).getPhaseSpaceIntegral(idxBin, mass, idxMass);
+
+		// couplings (real and imaginary part)
+		const std::complex<double> derivativeCoupling = fsmd * componentVal * branching * phaseSpaceIntegral;
+		const size_t idxParCoupling = _parameterIndicesCouplings[idxComponent][idxCoupling][idxBin];
+		derivatives.push_back(std::make_pair(idxParCoupling, derivativeCoupling));
+		derivatives.push_back(std::make_pair(idxParCoupling+1, imag * derivativeCoupling));
+
+		// branchings (real and imaginary part)
+		if(not component->isBranchingFixed(idxBranching)) {
+			const std::complex<double> derivativeBranching = fsmd * componentVal * coupling * phaseSpaceIntegral;
+			const size_t idxParBranching = _parameterIndicesBranchings[idxComponent][idxBranching];
+			derivatives.push_back(std::make_pair(idxParBranching, derivativeBranching));
+			derivatives.push_back(std::make_pair(idxParBranching+1, imag * derivativeBranching));
+		}
+
+		// parameters of the component
+		component->valDerivatives(fitParameters, idxBin, mass, componentDerivatives);
+		for(size_t idxParameter = 0; idxParameter < componentDerivatives.size(); ++idxParameter) {
+			derivatives.push_back(std::make_pair(_parameterIndicesComponents[idxComponent]+idxParameter, fsmd * componentDerivatives[idxParameter] * couplingPhaseSpace));
+		}
+	}
+
+	// parameters of the final-state mass-dependence
+	if(_fsmd) {
+		std::vector<std::complex<double> > fsmdDerivatives;
+		_fsmd->valDerivatives(fitParameters, idxBin, mass, fsmdDerivatives);
+		for(size_t idxParameter = 0; idxParameter < fsmdDerivatives.size(); ++idxParameter) {
+			derivatives.push_back(std::make_pair(_parameterIndexFsmd+_fsmd->getParameterIndex(idxBin)+idxParameter, fsmdDerivatives[idxParameter] * sum));
+		}
+	}
+}
+
+
 double
 rpwa::resonanceFit::model::intensity(const rpwa::resonanceFit::parameters& fitParameters,
                                      rpwa::resonanceFit::cache& cache,
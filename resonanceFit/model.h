@@ -87,6 +87,13 @@ namespace rpwa {
 			                                         const size_t idxBin,
 			                                         const double mass,
 			                                         const size_t idxMass = std::numeric_limits<size_t>::max()) const;
+			void productionAmplitudeDerivatives(const rpwa::resonanceFit::parameters& fitParameters,
+			                                    rpwa::resonanceFit::cache& cache,
+			                                    const size_t idxWave,
+			                                    const size_t idxBin,
+			                                    const double mass,
+			                                    const size_t idxMass,
+			                                    std::vector<std::pair<size_t, std::complex<double> > >& derivatives) const;
 			double intensity(const rpwa::resonanceFit::parameters& fitParameters,
 			                 rpwa::resonanceFit::cache& cache,
 			                 const size_t idxWave,
@@ -119,6 +126,7 @@ namespace rpwa {
 		private:
 
 			bool initMapping(const rpwa::resonanceFit::inputConstPtr& fitInput);
+			void initParameterIndices(const size_t nrBins);
 
 			bool _mappingEqualInAllBins;
 
@@ -127,6 +135,10 @@ namespace rpwa {
 			const rpwa::resonanceFit::fsmdConstPtr _fsmd;
 
 			size_t _nrParameters;
+			std::vector<size_t> _parameterIndicesComponents;
+			boost::multi_array<size_t, 3> _parameterIndicesCouplings;
+			boost::multi_array<size_t, 2> _parameterIndicesBranchings;
+			size_t _parameterIndexFsmd;
 			size_t _maxChannelsInComponent;
 			size_t _maxParametersInComponent;
 
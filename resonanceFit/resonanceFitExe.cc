@@ -60,7 +60,7 @@ usage(const std::string& progName,
 	          << std::endl
 	          << "usage:" << std::endl
 	          << progName
-	          << " [-o outfile -c # -M minimizer -m algorithm -g # -t # -P -R -F # -A -B -C # -d -q -h] config file" << std::endl
+	          << " [-o outfile -c # -M minimizer -m algorithm -g # -t # -N -G -T # -P -R -F # -A -B -C # -d -q -h] config file" << std::endl
 	          << "    where:" << std::endl
 	          << "        -o file    path to output file (default: 'resonanceFit.result.root')" << std::endl
 	          << "        -c #       maximal number of function calls (default: depends on number of parameters)" << std::endl
@@ -75,6 +75,9 @@ usage(const std::string& progName,
 	          << "                                         Fumili:      -" << std::endl
 	          << "        -g #       minimizer strategy: 0 = low, 1 = medium, 2 = high effort  (default: 1)" << std::endl
 	          << "        -t #       minimizer tolerance (default: 1e-10)" << std::endl
+	          << "        -N         use numerical derivatives of chi2 in the minimizer instead of the analytic gradient" << std::endl
+	          << "        -G         compare analytic gradient with difference quotients before each minimization step" << std::endl
+	          << "        -T #       number of threads used to calculate chi2; 0 uses all available threads (default: 1)" << std::endl
 	          << "        -P         plotting only - no fit" << std::endl
 	          << "        -R         plot in fit range only" << std::endl
 	          << "        -F #       finer binning for plotting (default: 1)" << std::endl
@@ -120,6 +123,9 @@ main(int    argc,
 	std::string       minimizerType[2]         = {"Minuit2", "Migrad"};       // minimizer, minimization algorithm
 	int               minimizerStrategy        = 1;                           // minimizer strategy
 	double            minimizerTolerance       = 1e-10;                       // minimizer tolerance
+	bool              analyticGradient         = true;                        // pass analytic gradient to minimizer
+	bool              checkGradient            = false;                       // compare analytic gradient with difference quotients
+	unsigned int      nrThreads                = 1;                           // number of threads used to calculate chi2
 	bool              onlyPlotting             = false;
 	bool              rangePlotting            = false;
 	size_t            extraBinning             = 1;
@@ -133,7 +139,7 @@ main(int    argc,
 	extern char* optarg;
 	extern int   optind;
 	int c;
-	while ((c = getopt(argc, argv, "o:c:M:m:g:t:PRF:ABC:dqh")) != -1) {
+	while ((c = getopt(argc, argv, "o:c:M:m:g:t:NGT:PRF:ABC:dqh")) != -1) {
 		switch (c) {
 		case 'o':
 			outRootFileName = optarg;
@@ -153,6 +159,15 @@ main(int    argc,
 		case 't':
 			minimizerTolerance = atof(optarg);
 			break;
+		case 'N':
+			analyticGradient = false;
+			break;
+		case 'G':
+			checkGradient = true;
+			break;
+		case 'T':
+			nrThreads = atoi(optarg);
+			break;
 		case 'P':
 			onlyPlotting = true;
 			break;
@@ -217,6 +232,9 @@ main(int    argc,
 	          << "    minimizer ...................................... "  << minimizerType[0] << ", " << minimizerType[1] << std::endl
 	          << "    minimizer strategy ............................. "  << minimizerStrategy  << std::endl
 	          << "    minimizer tolerance ............................ "  << minimizerTolerance << std::endl
+	          << "    analytic gradient .............................. "  << rpwa::yesNo(analyticGradient) << std::endl
+	          << "    check gradient ................................. "  << rpwa::yesNo(checkGradient) << std::endl
+	          << "    number of threads .............................. "  << nrThreads << std::endl
 	          << "    only plotting .................................. "  << rpwa::yesNo(onlyPlotting) << std::endl
 	          << "    plot in fit range only ......................... "  << rpwa::yesNo(rangePlotting) << std::endl
 	          << "    fit to production amplitudes ................... "  << rpwa::yesNo(doProdAmp) << std::endl
@@ -300,7 +318,8 @@ main(int    argc,
 	// set-up fit model and fit function
 	rpwa::resonanceFit::functionConstPtr fitFunction(new rpwa::resonanceFit::function(fitData,
 	                                                                                  fitModel,
-	                                                                                  doProdAmp));
+	                                                                                  doProdAmp,
+	                                                                                  nrThreads));
 	if(not fitFunction) {
 		printErr << "error while initializing the function to minimize." << std::endl;
 		return 1;
@@ -324,6 +343,8 @@ main(int    argc,
 		                                            minimizerType,
 		                                            minimizerStrategy,
 		                                            minimizerTolerance,
+		                                            analyticGradient,
+		                                            checkGradient,
 		                                            quiet);
 
 		TStopwatch stopwatch;
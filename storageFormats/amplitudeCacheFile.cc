@@ -0,0 +1,201 @@
+#include "amplitudeCacheFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <TTree.h>
+
+#include "amplitudeMetadata.h"
+#include "amplitudeTreeLeaf.h"
+#include "reportingUtils.hpp"
+
+
+using namespace rpwa;
+using namespace std;
+
+
+namespace {
+
+	// header of the cache file; the amplitude values follow directly after
+	// the header, which has a size of 128 bytes, so that the values are
+	// aligned to cache lines in the mapped file
+	struct cacheFileHeader {
+		char     magic[8];          // identifies amplitude cache files
+		uint32_t version;           // version of file format
+		uint32_t byteOrderMark;     // cacheFileByteOrderMark in byte order of the machine that wrote the file
+		uint64_t nmbEvents;         // number of amplitude values
+		char     contentHash[104];  // null-terminated content hash of the amplitude metadata
+	};
+	static_assert(sizeof(cacheFileHeader) == 128, "size of amplitude cache file header is part of the file format");
+
+	const char     cacheFileMagic[8]      = {'R', 'P', 'W', 'A', 'A', 'M', 'P', 'C'};
+	const uint32_t cacheFileVersion       = 1;
+	const uint32_t cacheFileByteOrderMark = 0x01020304;
+
+}
+
+
+rpwa::amplitudeCacheFile::amplitudeCacheFile()
+	: _mappedData(0),
+	  _mappedSize(0),
+	  _nmbEvents(0),
+	  _amplitudes(0)
+{
+
+}
+
+
+rpwa::amplitudeCacheFile::~amplitudeCacheFile()
+{
+	close();
+}
+
+
+bool rpwa::amplitudeCacheFile::open(const string& fileName,
+                                    const string& contentHash)
+{
+	close();
+
+	// a missing cache file is not an error
+	const int fileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+	if(fileDescriptor < 0) {
+		return false;
+	}
+	struct stat fileStat;
+	if(fstat(fileDescriptor, &fileStat) != 0 or (size_t)fileStat.st_size < sizeof(cacheFileHeader)) {
+		printWarn << "'" << fileName << "' is not a valid amplitude cache file. ignoring it." << endl;
+		::close(fileDescriptor);
+		return false;
+	}
+	const size_t fileSize   = fileStat.st_size;
+	void*        mappedData = mmap(0, fileSize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+	// the mapping stays valid after the file descriptor is closed
+	::close(fileDescriptor);
+	if(mappedData == MAP_FAILED) {
+		printWarn << "could not map amplitude cache file '" << fileName << "' into memory. ignoring it." << endl;
+		return false;
+	}
+
+	const cacheFileHeader* header = static_cast<const cacheFileHeader*>(mappedData);
+	if(memcmp(header->magic, cacheFileMagic, sizeof(cacheFileMagic)) != 0
+	   or header->version != cacheFileVersion
+	   or header->byteOrderMark != cacheFileByteOrderMark
+	   or fileSize != sizeof(cacheFileHeader) + header->nmbEvents * sizeof(complex<double>))
+	{
+		printWarn << "'" << fileName << "' is not a valid amplitude cache file. ignoring it." << endl;
+		munmap(mappedData, fileSize);
+		return false;
+	}
+	const string fileContentHash(header->contentHash, strnlen(header->contentHash, sizeof(header->contentHash)));
+	if(fileContentHash != contentHash) {
+		printWarn << "content hash in amplitude cache file '" << fileName << "' ('" << fileContentHash << "') "
+		          << "does not match the requested one ('" << contentHash << "'). ignoring it." << endl;
+		munmap(mappedData, fileSize);
+		return false;
+	}
+
+	_mappedData = mappedData;
+	_mappedSize = fileSize;
+	_nmbEvents  = header->nmbEvents;
+	_amplitudes = reinterpret_cast<const complex<double>*>(static_cast<const char*>(mappedData) + sizeof(cacheFileHeader));
+	return true;
+}
+
+
+void rpwa::amplitudeCacheFile::close()
+{
+	if(_mappedData) {
+		munmap(_mappedData, _mappedSize);
+	}
+	_mappedData = 0;
+	_mappedSize = 0;
+	_nmbEvents  = 0;
+	_amplitudes = 0;
+}
+
+
+bool rpwa::amplitudeCacheFile::writeCacheFile(const amplitudeMetadata& ampMeta,
+                                              const string&            fileName)
+{
+	TTree* ampTree = ampMeta.amplitudeTree();
+	if(not ampTree) {
+		printWarn << "amplitude tree not found in metadata." << endl;
+		return false;
+	}
+	cacheFileHeader header;
+	memset(&header, 0, sizeof(header));
+	if(ampMeta.contentHash().empty() or ampMeta.contentHash().size() >= sizeof(header.contentHash)) {
+		printWarn << "invalid content hash '" << ampMeta.contentHash() << "' in amplitude metadata." << endl;
+		return false;
+	}
+	amplitudeTreeLeaf* ampTreeLeaf = 0;
+	if(ampTree->SetBranchAddress(amplitudeMetadata::amplitudeLeafName.c_str(), &ampTreeLeaf) < 0) {
+		printWarn << "could not set address for branch '" << amplitudeMetadata::amplitudeLeafName << "'." << endl;
+		return false;
+	}
+
+	// several processes might write the same cache file at the same time
+	stringstream tmpFileName;
+	tmpFileName << fileName << ".tmp" << getpid();
+	FILE* outFile = fopen(tmpFileName.str().c_str(), "wb");
+	bool  success = (outFile != 0);
+	if(not success) {
+		printWarn << "could not open amplitude cache file '" << tmpFileName.str() << "' for writing." << endl;
+	} else {
+		const long nmbEvents = ampTree->GetEntries();
+		memcpy(header.magic, cacheFileMagic, sizeof(cacheFileMagic));
+		header.version       = cacheFileVersion;
+		header.byteOrderMark = cacheFileByteOrderMark;
+		header.nmbEvents     = nmbEvents;
+		strncpy(header.contentHash, ampMeta.contentHash().c_str(), sizeof(header.contentHash) - 1);
+		success = (fwrite(&header, sizeof(header), 1, outFile) == 1);
+
+		// write amplitudes in blocks
+		const size_t             nmbAmpsBuffer = 65536;
+		vector<complex<double> > ampsBuffer;
+		ampsBuffer.reserve(nmbAmpsBuffer);
+		for(long iEvent = 0; success and iEvent < nmbEvents; ++iEvent) {
+			ampTree->GetEntry(iEvent);
+			if(ampTreeLeaf->nmbIncohSubAmps() != 1) {
+				printWarn << "amplitude cache files can only hold amplitudes without incoherent sub-amplitudes." << endl;
+				success = false;
+				break;
+			}
+			ampsBuffer.push_back(ampTreeLeaf->incohSubAmp(0));
+			if(ampsBuffer.size() == nmbAmpsBuffer or iEvent == nmbEvents - 1) {
+				success = (fwrite(&ampsBuffer[0], sizeof(complex<double>), ampsBuffer.size(), outFile) == ampsBuffer.size());
+				ampsBuffer.clear();
+			}
+		}
+		success = (fclose(outFile) == 0) and success;
+		if(success and rename(tmpFileName.str().c_str(), fileName.c_str()) != 0) {
+			printWarn << "could not rename '" << tmpFileName.str() << "' to '" << fileName << "'." << endl;
+			success = false;
+		}
+		if(not success) {
+			printWarn << "could not write amplitude cache file '" << fileName << "'." << endl;
+			remove(tmpFileName.str().c_str());
+		}
+	}
+
+	// the branch must not keep the address of the local pointer; the
+	// leaf object was allocated by ROOT
+	ampTree->ResetBranchAddresses();
+	delete ampTreeLeaf;
+	return success;
+}
+
+
+string rpwa::amplitudeCacheFile::cacheFileName(const string& cacheDirectory,
+                                               const string& contentHash)
+{
+	return cacheDirectory + "/" + contentHash + ".ampcache";
+}
@@ -0,0 +1,65 @@
+#ifndef AMPLITUDECACHEFILE_H
+#define AMPLITUDECACHEFILE_H
+
+#include <complex>
+#include <string>
+
+
+namespace rpwa {
+
+	class amplitudeMetadata;
+
+	/***
+	 * Binary cache of the amplitude values of one amplitude file. The values are
+	 * stored as one contiguous column of std::complex<double> in native byte order
+	 * after a fixed-size header, so that the file can be memory-mapped and used
+	 * without deserialization. The cache file of an amplitude file is identified
+	 * by the content hash of its amplitude metadata.
+	 */
+	class amplitudeCacheFile {
+
+	  public:
+
+		amplitudeCacheFile();
+		~amplitudeCacheFile();
+
+		/***
+		 * maps the given cache file into memory
+		 * \return false if the file does not exist, is not a valid cache file or
+		 *         was not written for an amplitude file with the given content hash
+		 */
+		bool open(const std::string& fileName,
+		          const std::string& contentHash);
+		void close();
+
+		bool isOpen() const { return _amplitudes != 0; }
+
+		size_t nmbEvents() const { return _nmbEvents; }
+		const std::complex<double>* amplitudes() const { return _amplitudes; }  // valid as long as the file is open
+
+		/***
+		 * writes the amplitude values of the tree in the given metadata to a cache
+		 * file; the file is first written under a temporary name and then renamed,
+		 * so that concurrent readers never see an incomplete file
+		 */
+		static bool writeCacheFile(const rpwa::amplitudeMetadata& ampMeta,
+		                           const std::string&             fileName);
+
+		static std::string cacheFileName(const std::string& cacheDirectory,
+		                                 const std::string& contentHash);
+
+	  private:
+
+		amplitudeCacheFile(const amplitudeCacheFile&);
+		amplitudeCacheFile& operator =(const amplitudeCacheFile&);
+
+		void*                       _mappedData;
+		size_t                      _mappedSize;
+		size_t                      _nmbEvents;
+		const std::complex<double>* _amplitudes;
+
+	}; // class amplitudeCacheFile
+
+} // namespace rpwa
+
+#endif
@@ -79,8 +79,17 @@ void rpwa::amplitudeFileWriter::addAmplitude(const complex<double>& amplitude)
 
 void rpwa::amplitudeFileWriter::addAmplitudes(const vector<complex<double> >& amplitudes)
 {
+	if(not _initialized) {
+		printWarn << "trying to add amplitudes when not initialized." << endl;
+		return;
+	}
+	if(amplitudes.empty()) {
+		return;
+	}
+	_hashCalculator.Update(amplitudes.data(), amplitudes.size());
 	for(unsigned int i = 0; i < amplitudes.size(); ++i) {
-		addAmplitude(amplitudes[i]);
+		_ampTreeLeaf->setAmp(amplitudes[i]);
+		_metadata._amplitudeTree->Fill();
 	}
 }
 
@@ -43,12 +43,24 @@ string rpwa::amplitudeMetadata::recalculateHash(const bool& printProgress) const
 		return "";
 	}
 	progress_display* progressIndicator = printProgress ? new progress_display(_amplitudeTree->GetEntries(), cout, "") : 0;
+	// the amplitudes are collected in blocks, which give the same hash as
+	// the single amplitudes
+	const size_t             nmbAmpsBuffer = 65536;
+	vector<complex<double> > ampsBuffer;
+	ampsBuffer.reserve(nmbAmpsBuffer);
 	for(long eventNumber = 0; eventNumber < _amplitudeTree->GetEntries(); ++eventNumber) {
 		_amplitudeTree->GetEntry(eventNumber);
 		if(progressIndicator) {
 			++(*progressIndicator);
 		}
-		hashor.Update(ampTreeLeaf->amp());
+		ampsBuffer.push_back(ampTreeLeaf->amp());
+		if(ampsBuffer.size() == nmbAmpsBuffer) {
+			hashor.Update(ampsBuffer.data(), ampsBuffer.size());
+			ampsBuffer.clear();
+		}
+	}
+	if(not ampsBuffer.empty()) {
+		hashor.Update(ampsBuffer.data(), ampsBuffer.size());
 	}
 	return hashor.hash();
 }
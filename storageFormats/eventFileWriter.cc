@@ -137,6 +137,7 @@ void rpwa::eventFileWriter::addEvent(const TClonesArray&   productionKinematicsM
 		_hashCalculator.Update(additionalVariablesToSave[i]);
 		_additionalVariablesToSave[i] = additionalVariablesToSave[i];
 	}
+	_hashCalculator.finishEvent();
 	_metadata._eventTree->Fill();
 }
 
@@ -146,7 +147,7 @@ bool rpwa::eventFileWriter::finalize() {
 		printWarn << "trying to finalize when not initialized." << endl;
 		return false;
 	}
-	_metadata.setContentHash(_hashCalculator.hash());
+	_metadata.setContentHash(_hashCalculator);
 	_outputFile->cd();
 	_metadata.Write(eventMetadata::objectNameInFile.c_str());
 	_outputFile->Close();
@@ -165,6 +166,6 @@ void rpwa::eventFileWriter::reset() {
 		_decayKinematicsMomenta = 0;
 	}
 	_outputFile = 0;
-	_hashCalculator = hashCalculator();
+	_hashCalculator = blockHashCalculator();
 	_initialized = false;
 }
@@ -55,7 +55,7 @@ namespace rpwa {
 		std::vector<double> _additionalVariablesToSave;
 		unsigned int _nmbProductionKinematicsParticles;
 		unsigned int _nmbDecayKinematicsParticles;
-		hashCalculator _hashCalculator;
+		blockHashCalculator _hashCalculator;
 
 	}; // rootpwaDataFileWriter
 
@@ -21,6 +21,8 @@ const std::string rpwa::eventMetadata::decayKinematicsMomentaBranchName = "decay
 rpwa::eventMetadata::eventMetadata()
 	: _auxString(""),
 	  _contentHash(""),
+	  _contentHashBlockNmbEvents(),
+	  _contentHashBlockHashes(),
 	  _eventsType(eventMetadata::OTHER),
 	  _productionKinematicsParticleNames(),
 	  _decayKinematicsParticleNames(),
@@ -37,6 +39,7 @@ ostream& rpwa::eventMetadata::print(ostream& out) const
 	out << "eventMetadata: " << endl
 	    << "    auxString ....................... '" << _auxString << "'"                   << endl
 	    << "    contentHash ..................... '" << _contentHash << "'"                 << endl
+	    << "    blocks in contentHash ........... " << _contentHashBlockNmbEvents.size()       << endl
 	    << "    eventsType ...................... '" << getStringForEventsType(_eventsType) << "'" << endl
 	    << "    initial state particle names: ... "  << _productionKinematicsParticleNames  << endl
 	    << "    final state particle names: ..... "  << _decayKinematicsParticleNames       << endl
@@ -112,52 +115,88 @@ void rpwa::eventMetadata::setBinningVariableLabels(const vector<string>& labels)
 }
 
 
-bool rpwa::eventMetadata::updateHashor(hashCalculator& hashor, const bool& printProgress) const
-{
-	TClonesArray* productionKinematicsMomenta = 0;
-	TClonesArray* decayKinematicsMomenta = 0;
-	if(not _eventTree) {
-		printWarn << "input tree not found in metadata." << endl;
-		return false;
-	}
-	if(_eventTree->SetBranchAddress(productionKinematicsMomentaBranchName.c_str(), &productionKinematicsMomenta) < 0)
+namespace {
+
+	// hashCalculator hashes the whole content at once, blockHashCalculator
+	// needs to know where an event ends
+	void finishEvent(hashCalculator& /*hashor*/) { }
+	void finishEvent(blockHashCalculator& hashor) { hashor.finishEvent(); }
+
+
+	template<typename hashorT>
+	bool
+	updateHashorWithEvents(TTree* eventTree, const vector<string>& additionalTreeVariableNames, hashorT& hashor, const bool& printProgress)
 	{
-		printWarn << "could not set address for branch '" << productionKinematicsMomentaBranchName << "'." << endl;
-		return false;
-	}
-	if(_eventTree->SetBranchAddress(decayKinematicsMomentaBranchName.c_str(), &decayKinematicsMomenta)) {
-		printWarn << "could not set address for branch '" << decayKinematicsMomentaBranchName << "'." << endl;
-		return false;
-	}
-	vector<double> additionalVariables(additionalTreeVariableNames().size(), 0.);
-	for(unsigned int i = 0; i < additionalVariables.size(); ++i) {
-		if(_eventTree->SetBranchAddress(additionalTreeVariableNames()[i].c_str(), &additionalVariables[i]) < 0) {
-			printWarn << "could not set address for branch '" << additionalTreeVariableNames()[i].c_str() << "'." << endl;
+		TClonesArray* productionKinematicsMomenta = 0;
+		TClonesArray* decayKinematicsMomenta = 0;
+		if(not eventTree) {
+			printWarn << "input tree not found in metadata." << endl;
 			return false;
 		}
-	}
-	progress_display* progressIndicator = printProgress ? new progress_display(_eventTree->GetEntries(), cout, "") : 0;
-	for(long eventNumber = 0; eventNumber < _eventTree->GetEntries(); ++eventNumber) {
-		_eventTree->GetEntry(eventNumber);
-		if(progressIndicator) {
-			++(*progressIndicator);
-		}
-		for(int i = 0; i < productionKinematicsMomenta->GetEntries(); ++i) {
-			hashor.Update(*((TVector3*)(*productionKinematicsMomenta)[i]));
+		if(eventTree->SetBranchAddress(eventMetadata::productionKinematicsMomentaBranchName.c_str(), &productionKinematicsMomenta) < 0)
+		{
+			printWarn << "could not set address for branch '" << eventMetadata::productionKinematicsMomentaBranchName << "'." << endl;
+			return false;
 		}
-		for(int i = 0; i < decayKinematicsMomenta->GetEntries(); ++i) {
-			hashor.Update(*((TVector3*)(*decayKinematicsMomenta)[i]));
+		if(eventTree->SetBranchAddress(eventMetadata::decayKinematicsMomentaBranchName.c_str(), &decayKinematicsMomenta)) {
+			printWarn << "could not set address for branch '" << eventMetadata::decayKinematicsMomentaBranchName << "'." << endl;
+			return false;
 		}
+		vector<double> additionalVariables(additionalTreeVariableNames.size(), 0.);
 		for(unsigned int i = 0; i < additionalVariables.size(); ++i) {
-			hashor.Update(additionalVariables[i]);
+			if(eventTree->SetBranchAddress(additionalTreeVariableNames[i].c_str(), &additionalVariables[i]) < 0) {
+				printWarn << "could not set address for branch '" << additionalTreeVariableNames[i].c_str() << "'." << endl;
+				return false;
+			}
+		}
+		progress_display* progressIndicator = printProgress ? new progress_display(eventTree->GetEntries(), cout, "") : 0;
+		for(long eventNumber = 0; eventNumber < eventTree->GetEntries(); ++eventNumber) {
+			eventTree->GetEntry(eventNumber);
+			if(progressIndicator) {
+				++(*progressIndicator);
+			}
+			for(int i = 0; i < productionKinematicsMomenta->GetEntries(); ++i) {
+				hashor.Update(*((TVector3*)(*productionKinematicsMomenta)[i]));
+			}
+			for(int i = 0; i < decayKinematicsMomenta->GetEntries(); ++i) {
+				hashor.Update(*((TVector3*)(*decayKinematicsMomenta)[i]));
+			}
+			for(unsigned int i = 0; i < additionalVariables.size(); ++i) {
+				hashor.Update(additionalVariables[i]);
+			}
+			finishEvent(hashor);
 		}
+		return true;
 	}
-	return true;
+
+}
+
+
+bool rpwa::eventMetadata::updateHashor(hashCalculator& hashor, const bool& printProgress) const
+{
+	return updateHashorWithEvents(_eventTree, additionalTreeVariableNames(), hashor, printProgress);
+}
+
+
+bool rpwa::eventMetadata::updateHashor(blockHashCalculator& hashor, const bool& printProgress) const
+{
+	return updateHashorWithEvents(_eventTree, additionalTreeVariableNames(), hashor, printProgress);
 }
 
 
 string rpwa::eventMetadata::recalculateHash(const bool& printProgress) const {
-	hashCalculator hashor;
+	// files written before the content hash was calculated from blocks
+	// of events have a single MD5 hash over all events
+	if(_contentHashBlockNmbEvents.empty()) {
+		hashCalculator hashor;
+		if (updateHashor(hashor, printProgress)) {
+			return hashor.hash();
+		} else {
+			return "";
+		}
+	}
+	blockHashCalculator hashor;
+	hashor.setBlockLayout(_contentHashBlockNmbEvents);
 	if (updateHashor(hashor, printProgress)) {
 		return hashor.hash();
 	} else {
@@ -166,6 +205,14 @@ string rpwa::eventMetadata::recalculateHash(const bool& printProgress) const {
 }
 
 
+void rpwa::eventMetadata::setContentHash(blockHashCalculator& hashor)
+{
+	_contentHash = hashor.hash();
+	_contentHashBlockNmbEvents = hashor.blockNmbEvents();
+	_contentHashBlockHashes = hashor.blockHashes();
+}
+
+
 Long64_t rpwa::eventMetadata::Merge(TCollection* /*list*/, Option_t* /*option*/) {
 	printErr << "data files cannot be merged with hadd. Please use $ROOTPWA/build/bin/mergeDatafiles." << endl;
 	throw;
@@ -184,7 +231,7 @@ eventMetadata* rpwa::eventMetadata::merge(const vector<const eventMetadata*>& in
 		printWarn << "trying to merge without input data." << endl;
 		return 0;
 	}
-	hashCalculator hashor;
+	blockHashCalculator hashor;
 	const unsigned int nmbProductionKinematicsParticles = inputData[0]->productionKinematicsParticleNames().size();
 	const unsigned int nmbDecayKinematicsParticles = inputData[0]->decayKinematicsParticleNames().size();
 	TClonesArray* productionKinematicsMomenta = new TClonesArray("TVector3", nmbProductionKinematicsParticles);
@@ -267,19 +314,41 @@ eventMetadata* rpwa::eventMetadata::merge(const vector<const eventMetadata*>& in
 				goto mergeFailed;
 			}
 		}
+		// the hashes of the blocks of input files that were already hashed
+		// in blocks are taken over, if they cover all events and reproduce
+		// the content hash of the input file; the events of other input
+		// files are hashed
+		Long64_t nmbEventsInBlocks = 0;
+		for(unsigned int i = 0; i < metadata->contentHashBlockNmbEvents().size(); ++i) {
+			nmbEventsInBlocks += metadata->contentHashBlockNmbEvents()[i];
+		}
+		bool reuseBlockHashes = not metadata->contentHashBlockNmbEvents().empty()
+		                        and nmbEventsInBlocks == inputTree->GetEntries()
+		                        and metadata->contentHashBlockNmbEvents().size() == metadata->contentHashBlockHashes().size();
+		if(reuseBlockHashes and blockHashCalculator::combineBlockHashes(metadata->contentHashBlockNmbEvents(), metadata->contentHashBlockHashes())
+		                        != metadata->contentHash()) {
+			printWarn << "block hashes of input file do not reproduce its content hash. hashing its events again." << endl;
+			reuseBlockHashes = false;
+		}
 		for(long eventNumber = 0; eventNumber < inputTree->GetEntries(); ++eventNumber) {
 			inputTree->GetEntry(eventNumber);
-			for(int i = 0; i < productionKinematicsMomenta->GetEntries(); ++i) {
-				hashor.Update(*((TVector3*)(*productionKinematicsMomenta)[i]));
-			}
-			for(int i = 0; i < decayKinematicsMomenta->GetEntries(); ++i) {
-				hashor.Update(*((TVector3*)(*decayKinematicsMomenta)[i]));
-			}
-			for(unsigned int i = 0; i < additionalTreeVariables.size(); ++i) {
-				hashor.Update(additionalTreeVariables[i]);
+			if(not reuseBlockHashes) {
+				for(int i = 0; i < productionKinematicsMomenta->GetEntries(); ++i) {
+					hashor.Update(*((TVector3*)(*productionKinematicsMomenta)[i]));
+				}
+				for(int i = 0; i < decayKinematicsMomenta->GetEntries(); ++i) {
+					hashor.Update(*((TVector3*)(*decayKinematicsMomenta)[i]));
+				}
+				for(unsigned int i = 0; i < additionalTreeVariables.size(); ++i) {
+					hashor.Update(additionalTreeVariables[i]);
+				}
+				hashor.finishEvent();
 			}
 			mergee->_eventTree->Fill();
 		}
+		if(reuseBlockHashes) {
+			hashor.appendBlocks(metadata->contentHashBlockNmbEvents(), metadata->contentHashBlockHashes());
+		}
 
 		if (mergeAuxValues) {
 			for (const auto& nameValue : metadata->auxValues()) {
@@ -299,7 +368,7 @@ eventMetadata* rpwa::eventMetadata::merge(const vector<const eventMetadata*>& in
 		mergee->setMultibinBoundaries(mergedMultibinBoundaries);
 	}
 
-	mergee->setContentHash(hashor.hash());
+	mergee->setContentHash(hashor);
 	return mergee;
 mergeFailed:
 	delete mergee->_eventTree;
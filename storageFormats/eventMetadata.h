@@ -13,6 +13,7 @@ class TTree;
 namespace rpwa {
 
 	class additionalTreeVariables;
+	class blockHashCalculator;
 	class hashCalculator;
 
 	class eventMetadata : public TObject {
@@ -37,6 +38,12 @@ namespace rpwa {
 
 		const std::string& auxString() const { return _auxString; }
 		const std::string& contentHash() const { return _contentHash; }
+		/***
+		 * Number of events and hashes of the blocks the content hash is calculated from.
+		 * Both are empty for files, of which the content hash is a single MD5 hash over all events.
+		 */
+		const std::vector<Long64_t>& contentHashBlockNmbEvents() const { return _contentHashBlockNmbEvents; }
+		const std::vector<std::string>& contentHashBlockHashes() const { return _contentHashBlockHashes; }
 		const eventsTypeEnum& eventsType() const { return _eventsType; }
 		const rpwa::multibinBoundariesType& multibinBoundaries() const { return _multibinBoundaries; }
 		const std::vector<std::string>& productionKinematicsParticleNames() const { return _productionKinematicsParticleNames; }
@@ -52,8 +59,10 @@ namespace rpwa {
 		 * \return true if update was successful
 		 */
 		bool updateHashor(hashCalculator& hashor, const bool& printProgress = false) const;
+		bool updateHashor(blockHashCalculator& hashor, const bool& printProgress = false) const;
 		/***
 		 * Recalculate the hash for this object. Auxiliary information (auxString, auxValues) are not considered.
+		 * The hash is calculated in the same way (single MD5 hash or blocks of events) as the stored content hash.
 		 */
 		std::string recalculateHash(const bool& printProgress = false) const;
 
@@ -100,6 +109,7 @@ namespace rpwa {
 		                       const std::string& delimiter = ", ");
 
 		void setContentHash(const std::string& contentHash) { _contentHash = contentHash; }
+		void setContentHash(blockHashCalculator& hashor);
 		void setEventsType(const eventsTypeEnum& eventsType) { _eventsType = eventsType; }
 		void setProductionKinematicsParticleNames(const std::vector<std::string>& productionKinematicsParticleNames) { _productionKinematicsParticleNames = productionKinematicsParticleNames; }
 		void setDecayKinematicsParticleNames(const std::vector<std::string>& decayKinematicsParticleNames) { _decayKinematicsParticleNames = decayKinematicsParticleNames; }
@@ -113,6 +123,8 @@ namespace rpwa {
 
 		std::string _auxString; // the content of this variable is by default not included in the '==' comparison, hash calculation, or merging
 		std::string _contentHash;
+		std::vector<Long64_t> _contentHashBlockNmbEvents;
+		std::vector<std::string> _contentHashBlockHashes;
 		eventsTypeEnum _eventsType;
 
 		std::vector<std::string> _productionKinematicsParticleNames;
@@ -126,7 +138,7 @@ namespace rpwa {
 
 		mutable TTree* _eventTree; //!
 
-		ClassDef(eventMetadata, 4);
+		ClassDef(eventMetadata, 5);
 
 	}; // class eventMetadata
 
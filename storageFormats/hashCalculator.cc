@@ -4,6 +4,7 @@
 #include <TVector3.h>
 
 #include "reportingUtils.hpp"
+#include "threadUtils.hpp"
 
 
 using namespace std;
@@ -36,3 +37,156 @@ void rpwa::hashCalculator::Update(const TVector3& vector) {
 	Update(vector.Y());
 	Update(vector.Z());
 }
+
+
+void rpwa::hashCalculator::Update(const double* values, const size_t nmbValues)
+{
+	if(_debug) {
+		printDebug << "updating with " << nmbValues << " values." << endl;
+	}
+	// MD5 works on a stream of bytes, so that feeding all values at once
+	// gives the same hash as feeding them one by one
+	TMD5::Update((const UChar_t*)values, nmbValues * sizeof(double));
+}
+
+
+void rpwa::hashCalculator::Update(const complex<double>* values, const size_t nmbValues)
+{
+	// std::complex<double> is stored as real and imaginary part
+	Update((const double*)values, 2 * nmbValues);
+}
+
+
+rpwa::blockHashCalculator::blockHashCalculator(const unsigned int nmbThreads,
+                                               const Long64_t     nmbEventsPerBlock)
+	: _nmbThreads(nmbThreads),
+	  _nmbEventsPerBlock(nmbEventsPerBlock),
+	  _blockLayout(),
+	  _blockLayoutIndex(0),
+	  _currentBlock(),
+	  _currentBlockNmbEvents(0),
+	  _pendingBlocks(),
+	  _pendingBlockNmbEvents(),
+	  _blockNmbEvents(),
+	  _blockHashes()
+{
+	if(_nmbEventsPerBlock <= 0) {
+		printErr << "number of events per block must be positive (got " << _nmbEventsPerBlock << "). Aborting..." << endl;
+		throw;
+	}
+}
+
+
+void rpwa::blockHashCalculator::Update(const complex<double>& value)
+{
+	Update(value.real());
+	Update(value.imag());
+}
+
+
+void rpwa::blockHashCalculator::Update(const TVector3& vector)
+{
+	Update(vector.X());
+	Update(vector.Y());
+	Update(vector.Z());
+}
+
+
+void rpwa::blockHashCalculator::finishEvent()
+{
+	++_currentBlockNmbEvents;
+	const Long64_t nmbEventsInBlock = (_blockLayoutIndex < _blockLayout.size()) ? _blockLayout[_blockLayoutIndex] : _nmbEventsPerBlock;
+	if(_currentBlockNmbEvents >= nmbEventsInBlock) {
+		finishBlock();
+	}
+}
+
+
+void rpwa::blockHashCalculator::setBlockLayout(const vector<Long64_t>& blockNmbEvents)
+{
+	_blockLayout = blockNmbEvents;
+	_blockLayoutIndex = 0;
+}
+
+
+bool rpwa::blockHashCalculator::appendBlocks(const vector<Long64_t>& blockNmbEvents,
+                                             const vector<string>&   blockHashes)
+{
+	if(blockNmbEvents.size() != blockHashes.size()) {
+		printWarn << "number of blocks (" << blockNmbEvents.size() << ") does not match number of hashes (" << blockHashes.size() << ")." << endl;
+		return false;
+	}
+	if(_currentBlockNmbEvents > 0) {
+		finishBlock();
+	}
+	hashPendingBlocks();
+	_blockNmbEvents.insert(_blockNmbEvents.end(), blockNmbEvents.begin(), blockNmbEvents.end());
+	_blockHashes.insert(_blockHashes.end(), blockHashes.begin(), blockHashes.end());
+	return true;
+}
+
+
+string rpwa::blockHashCalculator::hash()
+{
+	if(_currentBlockNmbEvents > 0) {
+		finishBlock();
+	}
+	hashPendingBlocks();
+	return combineBlockHashes(_blockNmbEvents, _blockHashes);
+}
+
+
+string rpwa::blockHashCalculator::combineBlockHashes(const vector<Long64_t>& blockNmbEvents,
+                                                     const vector<string>&   blockHashes)
+{
+	// without any block this is the same as the MD5 hash of an empty file
+	TMD5 hashor;
+	for(size_t i = 0; i < blockNmbEvents.size(); ++i) {
+		hashor.Update((const UChar_t*)&blockNmbEvents[i], sizeof(Long64_t));
+		hashor.Update((const UChar_t*)blockHashes[i].c_str(), blockHashes[i].size());
+	}
+	hashor.Final();
+	return hashor.AsString();
+}
+
+
+void rpwa::blockHashCalculator::finishBlock()
+{
+	_pendingBlocks.push_back(vector<double>());
+	_pendingBlocks.back().swap(_currentBlock);
+	_pendingBlockNmbEvents.push_back(_currentBlockNmbEvents);
+	_currentBlockNmbEvents = 0;
+	if(_blockLayoutIndex < _blockLayout.size()) {
+		++_blockLayoutIndex;
+	}
+	if(_pendingBlocks.size() >= rpwa::nmbThreadsToUse(_nmbThreads)) {
+		hashPendingBlocks();
+	}
+}
+
+
+void rpwa::blockHashCalculator::hashPendingBlocks()
+{
+	const size_t nmbPendingBlocks = _pendingBlocks.size();
+	if(nmbPendingBlocks == 0) {
+		return;
+	}
+
+	// the blocks are independent of each other, the order of the blocks
+	// is kept by storing their hashes by index
+	vector<string> pendingBlockHashes(nmbPendingBlocks);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nmbPendingBlocks) schedule(static, 1)
+#endif
+	for(size_t i = 0; i < nmbPendingBlocks; ++i) {
+		TMD5 hashor;
+		hashor.Update((const UChar_t*)_pendingBlocks[i].data(), _pendingBlocks[i].size() * sizeof(double));
+		hashor.Final();
+		pendingBlockHashes[i] = hashor.AsString();
+	}
+
+	_blockNmbEvents.insert(_blockNmbEvents.end(), _pendingBlockNmbEvents.begin(), _pendingBlockNmbEvents.end());
+	_blockHashes.insert(_blockHashes.end(), pendingBlockHashes.begin(), pendingBlockHashes.end());
+	_pendingBlocks.clear();
+	_pendingBlockNmbEvents.clear();
+}
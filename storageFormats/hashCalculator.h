@@ -1,8 +1,9 @@
-
 #ifndef HASHCALCULATOR_H
 #define HASHCALCULATOR_H
 
 #include <complex>
+#include <string>
+#include <vector>
 
 #include <TMD5.h>
 
@@ -22,6 +23,10 @@ namespace rpwa {
 		void Update(const std::complex<double>& value);
 		void Update(const TVector3& vector);
 
+		// same result as updating with each value separately
+		void Update(const double* values, const size_t nmbValues);
+		void Update(const std::complex<double>* values, const size_t nmbValues);
+
 		std::string hash() {
 			TMD5::Final();
 			return TMD5::AsString();
@@ -36,6 +41,75 @@ namespace rpwa {
 
 	}; // class hashCalculator
 
+
+	/***
+	 * Content hash of a sequence of events split into blocks. Each block is
+	 * hashed on its own with MD5, the content hash is the MD5 of the list
+	 * of the numbers of events and the hashes of all blocks. Full blocks
+	 * are hashed in parallel, and the hashes of blocks taken over from
+	 * another file (e.g. when merging files) are not recalculated.
+	 */
+	class blockHashCalculator {
+
+	  public:
+
+		blockHashCalculator(const unsigned int nmbThreads = 0,                          // 0 uses all available threads
+		                    const Long64_t     nmbEventsPerBlock = defaultNmbEventsPerBlock);
+
+		void Update(const double& value) { _currentBlock.push_back(value); }
+		void Update(const std::complex<double>& value);
+		void Update(const TVector3& vector);
+
+		/***
+		 * Mark the end of the current event.
+		 */
+		void finishEvent();
+
+		/***
+		 * Use the given numbers of events per block for the next blocks,
+		 * e.g. to recalculate the hash of a file with its original blocks.
+		 */
+		void setBlockLayout(const std::vector<Long64_t>& blockNmbEvents);
+
+		/***
+		 * Append blocks of which the hashes are already known.
+		 * \return false if the lists of numbers of events and hashes are inconsistent
+		 */
+		bool appendBlocks(const std::vector<Long64_t>&    blockNmbEvents,
+		                  const std::vector<std::string>& blockHashes);
+
+		std::string hash();
+
+		const std::vector<Long64_t>& blockNmbEvents() const { return _blockNmbEvents; }
+		const std::vector<std::string>& blockHashes() const { return _blockHashes; }
+
+		static std::string combineBlockHashes(const std::vector<Long64_t>&    blockNmbEvents,
+		                                      const std::vector<std::string>& blockHashes);
+
+		static const Long64_t defaultNmbEventsPerBlock = 10000;
+
+	  private:
+
+		void finishBlock();
+		void hashPendingBlocks();
+
+		unsigned int _nmbThreads;
+		Long64_t _nmbEventsPerBlock;
+
+		std::vector<Long64_t> _blockLayout;
+		size_t _blockLayoutIndex;
+
+		std::vector<double> _currentBlock;
+		Long64_t _currentBlockNmbEvents;
+
+		std::vector<std::vector<double> > _pendingBlocks;  // full blocks that are not yet hashed
+		std::vector<Long64_t> _pendingBlockNmbEvents;
+
+		std::vector<Long64_t> _blockNmbEvents;
+		std::vector<std::string> _blockHashes;
+
+	}; // class blockHashCalculator
+
 } // namespace rpwa
 
 #endif
@@ -72,6 +72,7 @@
 
 #pragma link C++ class std::vector<std::complex<double> >+;
 #pragma link C++ class std::vector<std::string>+;
+#pragma link C++ class std::vector<Long64_t>+;
 #pragma link C++ class rpwa::amplitudeTreeLeaf+;
 #pragma read sourceClass="rpwa::amplitudeTreeLeaf" version="[1-]" \
 	targetClass="rpwa::amplitudeTreeLeaf" \
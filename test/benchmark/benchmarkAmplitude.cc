@@ -0,0 +1,367 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      benchmark of decay amplitude calculation for given key files
+//
+//      the amplitudes are calculated for phase-space events, which are
+//      generated for the final state of each key file with a beam
+//      along the z-axis and a small random transverse momentum of X
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include <complex>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "TClonesArray.h"
+#include "TLorentzVector.h"
+#include "TObjString.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TVector3.h"
+
+#include "reportingUtilsEnvironment.h"
+#include "particleDataTable.h"
+#include "waveDescription.h"
+#include "isobarAmplitude.h"
+#include "nBodyPhaseSpaceGenerator.h"
+#include "benchmarkUtils.hpp"
+
+
+using namespace std;
+using namespace rpwa;
+using namespace rpwa::benchmark;
+
+
+void
+usage(const string& progName,
+      const int     errCode = 0)
+{
+	cerr << "benchmark calculation of decay amplitudes for phase-space events" << endl
+	     << endl
+	     << "usage:" << endl
+	     << progName
+	     << " [-n # -R # -t # -s # -b # -m # -M # -p PDG file -o file -T -v -h] key file(s)" << endl
+	     << "    where:" << endl
+	     << "        -n #       number of events (default: 10000)" << endl
+	     << "        -R #       number of repetitions (default: 5)" << endl
+	     << "        -t #       number of threads for block calculation; 0 uses all available threads (default: 1)" << endl
+	     << "        -s #       seed for random numbers (default: 123456)" << endl
+	     << "        -b #       beam momentum in GeV/c (default: 190)" << endl
+	     << "        -m #       minimum mass of X in GeV/c^2; 0 sets it 0.1 GeV/c^2 above threshold (default: 0)" << endl
+	     << "        -M #       maximum mass of X in GeV/c^2; 0 sets it 1.5 GeV/c^2 above threshold (default: 0)" << endl
+	     << "        -p file    path to particle data table file (default: ./particleDataTable.txt)" << endl
+	     << "        -o file    path to JSON output file; '-' writes to stdout (default: benchmarkAmplitude.json)" << endl
+	     << "        -T         interpolate mass-dependent amplitudes from tables (default: false)" << endl
+	     << "        -v         verbose; print debug output (default: false)" << endl
+	     << "        -h         print help" << endl
+	     << endl;
+	exit(errCode);
+}
+
+
+// phase-space events in the format expected by the decay topology
+struct eventSample {
+
+	eventSample()
+		: prodKinPartNames (0),
+		  decayKinPartNames(0)
+	{ }
+
+	~eventSample()
+	{
+		delete prodKinPartNames;
+		delete decayKinPartNames;
+		for (size_t i = 0; i < prodKinMomenta.size(); ++i) {
+			delete prodKinMomenta [i];
+			delete decayKinMomenta[i];
+		}
+	}
+
+	TClonesArray*               prodKinPartNames;
+	TClonesArray*               decayKinPartNames;
+	vector<const TClonesArray*> prodKinMomenta;
+	vector<const TClonesArray*> decayKinMomenta;
+
+};
+
+
+// generates phase-space events for the final state of the given decay
+// topology; the beam particle is taken from the production vertex,
+// which has to exist
+bool
+generateEvents(const isobarDecayTopologyPtr& decayTopo,
+               eventSample&                  events,
+               const unsigned long           nmbEvents,
+               const double                  beamMomentum,
+               double                        massMin,
+               double                        massMax,
+               const unsigned int            seed)
+{
+	const particlePtr& beam = decayTopo->productionVertex()->inParticles()[0];
+
+	const unsigned int nmbFsParticles = decayTopo->nmbFsParticles();
+	vector<double>     fsMasses(nmbFsParticles);
+	double             fsMassSum = 0;
+	events.prodKinPartNames  = new TClonesArray("TObjString", 1);
+	events.decayKinPartNames = new TClonesArray("TObjString", nmbFsParticles);
+	new ((*events.prodKinPartNames)[0]) TObjString(beam->name().c_str());
+	for (unsigned int i = 0; i < nmbFsParticles; ++i) {
+		const particlePtr& fsPart = decayTopo->fsParticles()[i];
+		new ((*events.decayKinPartNames)[i]) TObjString(fsPart->name().c_str());
+		fsMasses[i]  = fsPart->mass();
+		fsMassSum   += fsMasses[i];
+	}
+	if (massMin <= 0)
+		massMin = fsMassSum + 0.1;
+	if (massMax <= 0)
+		massMax = fsMassSum + 1.5;
+	if ((massMin <= fsMassSum) or (massMax < massMin)) {
+		printWarn << "invalid mass range [" << massMin << ", " << massMax << "] GeV/c^2 "
+		          << "for final-state mass sum of " << fsMassSum << " GeV/c^2. cannot generate events." << endl;
+		return false;
+	}
+
+	nBodyPhaseSpaceGenerator psGen;
+	if (not psGen.setDecay(fsMasses))
+		return false;
+	TRandom3                  random(seed);
+	nBodyPhaseSpaceEventBlock block;
+	const TVector3            beamMom(0, 0, beamMomentum);
+	for (unsigned long iEvent = 0; iEvent < nmbEvents; ++iEvent) {
+		// X has a transverse momentum distributed according to an
+		// exponential t' distribution with a slope of 8 (GeV/c)^-2
+		const double mass   = random.Uniform(massMin, massMax);
+		const double pT     = sqrt(random.Exp(1. / 8));
+		const double phi    = random.Uniform(0, 2 * M_PI);
+		const TVector3 XMom(pT * cos(phi), pT * sin(phi), beamMomentum);
+		const TLorentzVector X(XMom, sqrt(XMom.Mag2() + mass * mass));
+		if (not psGen.generateDecays(X, 1, block, seed, iEvent))
+			return false;
+		TClonesArray* prodKinMomenta  = new TClonesArray("TVector3", 1);
+		TClonesArray* decayKinMomenta = new TClonesArray("TVector3", nmbFsParticles);
+		new ((*prodKinMomenta)[0]) TVector3(beamMom);
+		for (unsigned int i = 0; i < nmbFsParticles; ++i)
+			new ((*decayKinMomenta)[i]) TVector3(block.daughter(i, 0).Vect());
+		events.prodKinMomenta.push_back (prodKinMomenta);
+		events.decayKinMomenta.push_back(decayKinMomenta);
+	}
+	return true;
+}
+
+
+int
+main(int    argc,
+     char** argv)
+{
+	printCompilerInfo();
+	printLibraryInfo ();
+	printGitHash     ();
+	cout << endl;
+
+	// parse command line options
+	const string  progName       = argv[0];
+	unsigned long nmbEvents      = 10000;
+	unsigned int  nmbRepetitions = 5;
+	unsigned int  nmbThreads     = 1;
+	unsigned int  seed           = 123456;
+	double        beamMomentum   = 190;
+	double        massMin        = 0;
+	double        massMax        = 0;
+	string        pdgFileName    = "./particleDataTable.txt";
+	string        jsonFileName   = "benchmarkAmplitude.json";
+	bool          tabulate       = false;
+	bool          debug          = false;
+	extern char*  optarg;
+	extern int    optind;
+	int           c;
+	while ((c = getopt(argc, argv, "n:R:t:s:b:m:M:p:o:Tvh")) != -1)
+		switch (c) {
+		case 'n':
+			nmbEvents = atol(optarg);
+			break;
+		case 'R':
+			nmbRepetitions = atoi(optarg);
+			break;
+		case 't':
+			nmbThreads = atoi(optarg);
+			break;
+		case 's':
+			seed = atoi(optarg);
+			break;
+		case 'b':
+			beamMomentum = atof(optarg);
+			break;
+		case 'm':
+			massMin = atof(optarg);
+			break;
+		case 'M':
+			massMax = atof(optarg);
+			break;
+		case 'p':
+			pdgFileName = optarg;
+			break;
+		case 'o':
+			jsonFileName = optarg;
+			break;
+		case 'T':
+			tabulate = true;
+			break;
+		case 'v':
+			debug = true;
+			break;
+		case 'h':
+		default:
+			usage(progName);
+		}
+	if (optind >= argc) {
+		printErr << "you need to specify at least one key file to process. Aborting..." << endl;
+		usage(progName, 1);
+	}
+	vector<string> keyFileNames;
+	while (optind < argc)
+		keyFileNames.push_back(argv[optind++]);
+	isobarAmplitude::setDebug(debug);
+	massDependence::enableTabulation(tabulate);
+
+	// initialize particle data table
+	particleDataTable::readFile(pdgFileName);
+
+	benchmarkReport report("amplitude");
+	report.setParameter("nmbEvents",    nmbEvents);
+	report.setParameter("nmbThreads",   nmbThreadsToUse(nmbThreads));
+	report.setParameter("seed",         seed);
+	report.setParameter("beamMomentum", beamMomentum);
+	report.setParameter("tabulation",   tabulate);
+
+	// the events are generated once per final state and shared by all
+	// amplitudes with this final state
+	map<string, eventSample>   eventSamples;
+	vector<isobarAmplitudePtr> amplitudes;
+	TStopwatch                 timer;
+	for (size_t iKeyFile = 0; iKeyFile < keyFileNames.size(); ++iKeyFile) {
+		const vector<waveDescriptionPtr> waveDescs = waveDescription::parseKeyFile(keyFileNames[iKeyFile]);
+		if (waveDescs.empty()) {
+			printWarn << "problems parsing key file '" << keyFileNames[iKeyFile] << "'. skipping." << endl;
+			continue;
+		}
+		for (size_t iWaveDesc = 0; iWaveDesc < waveDescs.size(); ++iWaveDesc) {
+			isobarAmplitudePtr amplitude;
+			if (not waveDescs[iWaveDesc]->constructAmplitude(amplitude)) {
+				printWarn << "problems constructing amplitude from key file '" << keyFileNames[iKeyFile] << "'. skipping." << endl;
+				continue;
+			}
+			amplitude->init();
+			const isobarDecayTopologyPtr& decayTopo = amplitude->decayTopology();
+			const string                  waveName  = waveDescription::waveNameFromTopology(*decayTopo);
+
+			// get events
+			if (not decayTopo->productionVertex() or (decayTopo->productionVertex()->nmbInParticles() < 1)) {
+				printWarn << "production vertex of wave '" << waveName << "' has no beam particle. skipping." << endl;
+				continue;
+			}
+			string finalState = decayTopo->productionVertex()->inParticles()[0]->name() + " ->";
+			for (unsigned int i = 0; i < decayTopo->nmbFsParticles(); ++i)
+				finalState += " " + decayTopo->fsParticles()[i]->name();
+			if (eventSamples.count(finalState) == 0) {
+				printInfo << "generating " << nmbEvents << " events for '" << finalState << "'" << endl;
+				if (not generateEvents(decayTopo, eventSamples[finalState], nmbEvents, beamMomentum, massMin, massMax, seed)) {
+					printErr << "could not generate events for '" << finalState << "'. Aborting..." << endl;
+					return 1;
+				}
+			}
+			const eventSample& events = eventSamples[finalState];
+			if (not decayTopo->initKinematicsData(*events.prodKinPartNames, *events.decayKinPartNames)) {
+				printWarn << "problems initializing kinematics data for wave '" << waveName << "'. skipping." << endl;
+				continue;
+			}
+
+			// time calculation of one event after the other
+			printInfo << "timing amplitude '" << waveName << "'" << endl;
+			benchmarkResult& resultEvt = report.addResult("isobarAmplitude::amplitude " + waveName);
+			resultEvt.parameters["keyFile"]     = benchmarkReport::jsonString(keyFileNames[iKeyFile]);
+			resultEvt.parameters["nmbSymTerms"] = benchmarkReport::jsonNumber(amplitude->nmbSymTerms());
+			complex<double>  ampSum    = 0;
+			for (unsigned int iRep = 0; iRep < nmbRepetitions; ++iRep) {
+				timer.Start(true);
+				for (unsigned long iEvent = 0; iEvent < nmbEvents; ++iEvent) {
+					decayTopo->readKinematicsData(*events.prodKinMomenta[iEvent], *events.decayKinMomenta[iEvent]);
+					ampSum += amplitude->amplitude();
+				}
+				timer.Stop();
+				resultEvt.addTime(timer.RealTime(), timer.CpuTime());
+			}
+
+			// time calculation of block of events
+			benchmarkResult&         resultBlock = report.addResult("isobarAmplitude::amplitudes " + waveName);
+			resultBlock.parameters["keyFile"] = benchmarkReport::jsonString(keyFileNames[iKeyFile]);
+			vector<complex<double> > amps;
+			for (unsigned int iRep = 0; iRep < nmbRepetitions; ++iRep) {
+				timer.Start(true);
+				if (not amplitude->amplitudes(events.prodKinMomenta, events.decayKinMomenta, amps, nmbThreads)) {
+					printErr << "problems calculating amplitudes for wave '" << waveName << "'. Aborting..." << endl;
+					return 1;
+				}
+				timer.Stop();
+				resultBlock.addTime(timer.RealTime(), timer.CpuTime());
+			}
+			if (debug)
+				printDebug << "sum of amplitudes of wave '" << waveName << "' = " << ampSum / (double)nmbRepetitions << endl;
+
+			amplitudes.push_back(amplitude);
+		}
+	}
+
+	// time calculation of all waves in a single pass, if they have the
+	// same final state
+	if ((amplitudes.size() > 1) and (eventSamples.size() == 1)) {
+		printInfo << "timing " << amplitudes.size() << " amplitudes in a single pass" << endl;
+		const eventSample& events = eventSamples.begin()->second;
+		benchmarkResult&   result = report.addResult("isobarAmplitude::amplitudes all waves");
+		result.parameters["nmbWaves"] = benchmarkReport::jsonNumber(amplitudes.size());
+		vector<vector<complex<double> > > amps;
+		for (unsigned int iRep = 0; iRep < nmbRepetitions; ++iRep) {
+			timer.Start(true);
+			if (not isobarAmplitude::amplitudes(amplitudes, events.prodKinMomenta, events.decayKinMomenta, amps, nmbThreads)) {
+				printErr << "problems calculating amplitudes in a single pass. Aborting..." << endl;
+				return 1;
+			}
+			timer.Stop();
+			result.addTime(timer.RealTime(), timer.CpuTime());
+		}
+	}
+
+	report.print();
+	if (not report.writeJson(jsonFileName))
+		return 1;
+	return 0;
+}
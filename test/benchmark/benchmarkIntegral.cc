@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      benchmark of integral matrix calculation from amplitude trees
+//
+//      the amplitude trees are filled with random decay amplitudes and
+//      are kept in memory, so that the benchmark does not depend on
+//      the speed of the disk
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include <complex>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "TMemFile.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+
+#include "reportingUtilsEnvironment.h"
+#include "ampIntegralMatrix.h"
+#include "benchmarkUtils.hpp"
+
+
+using namespace std;
+using namespace rpwa;
+using namespace rpwa::benchmark;
+
+
+void
+usage(const string& progName,
+      const int     errCode = 0)
+{
+	cerr << "benchmark calculation of integral matrix from amplitude trees with random decay amplitudes" << endl
+	     << endl
+	     << "usage:" << endl
+	     << progName
+	     << " [-w # -n # -B # -R # -t # -s # -o file -h]" << endl
+	     << "    where:" << endl
+	     << "        -w #       number of waves (default: 50)" << endl
+	     << "        -n #       number of events (default: 100000)" << endl
+	     << "        -B #       number of events per block (default: 10000)" << endl
+	     << "        -R #       number of repetitions (default: 5)" << endl
+	     << "        -t #       number of threads; 0 uses all available threads (default: 1)" << endl
+	     << "        -s #       seed for random numbers (default: 123456)" << endl
+	     << "        -o file    path to JSON output file; '-' writes to stdout (default: benchmarkIntegral.json)" << endl
+	     << "        -h         print help" << endl
+	     << endl;
+	exit(errCode);
+}
+
+
+int
+main(int    argc,
+     char** argv)
+{
+	printCompilerInfo();
+	printLibraryInfo ();
+	printGitHash     ();
+	cout << endl;
+
+	// parse command line options
+	const string  progName          = argv[0];
+	unsigned int  nmbWaves          = 50;
+	unsigned long nmbEvents         = 100000;
+	long          nmbEventsPerBlock = 10000;
+	unsigned int  nmbRepetitions    = 5;
+	unsigned int  nmbThreads        = 1;
+	unsigned int  seed              = 123456;
+	string        jsonFileName      = "benchmarkIntegral.json";
+	extern char*  optarg;
+	int           c;
+	while ((c = getopt(argc, argv, "w:n:B:R:t:s:o:h")) != -1)
+		switch (c) {
+		case 'w':
+			nmbWaves = atoi(optarg);
+			break;
+		case 'n':
+			nmbEvents = atol(optarg);
+			break;
+		case 'B':
+			nmbEventsPerBlock = atol(optarg);
+			break;
+		case 'R':
+			nmbRepetitions = atoi(optarg);
+			break;
+		case 't':
+			nmbThreads = atoi(optarg);
+			break;
+		case 's':
+			seed = atoi(optarg);
+			break;
+		case 'o':
+			jsonFileName = optarg;
+			break;
+		case 'h':
+		default:
+			usage(progName);
+		}
+	if ((nmbWaves == 0) or (nmbEvents == 0) or (nmbEventsPerBlock <= 0)) {
+		printErr << "invalid number of waves or events. Aborting..." << endl;
+		usage(progName, 1);
+	}
+
+	// generate random decay amplitudes
+	vector<string> waveNames;
+	for (unsigned int iWave = 0; iWave < nmbWaves; ++iWave) {
+		ostringstream waveName;
+		waveName << "synthWave" << setw(4) << setfill('0') << iWave;
+		waveNames.push_back(waveName.str());
+	}
+	TRandom3                         random(seed);
+	TMemFile                         ampFile("benchmarkIntegralAmplitudes.root", "RECREATE");
+	vector<const amplitudeMetadata*> ampMetas;
+	if (not writeRandomAmplitudes(ampFile, waveNames, nmbEvents, random, ampMetas)) {
+		printErr << "could not generate decay amplitudes. Aborting..." << endl;
+		return 1;
+	}
+
+	benchmarkReport report("integral");
+	report.setParameter("nmbWaves",          nmbWaves);
+	report.setParameter("nmbEvents",         nmbEvents);
+	report.setParameter("nmbEventsPerBlock", nmbEventsPerBlock);
+	report.setParameter("nmbThreads",        nmbThreadsToUse(nmbThreads));
+	report.setParameter("seed",              seed);
+
+	// each repetition starts with an empty integral matrix
+	printInfo << "timing integral matrix calculation for " << nmbWaves << " waves and " << nmbEvents << " events" << endl;
+	benchmarkResult& result = report.addResult("ampIntegralMatrix::integrate");
+	TStopwatch       timer;
+	for (unsigned int iRep = 0; iRep < nmbRepetitions; ++iRep) {
+		ampIntegralMatrix integral;
+		timer.Start(true);
+		if (not integral.integrate(ampMetas, 0, "", 0, multibinBoundariesType(), nmbThreads, nmbEventsPerBlock)) {
+			printErr << "problems calculating integral matrix. Aborting..." << endl;
+			return 1;
+		}
+		timer.Stop();
+		result.addTime(timer.RealTime(), timer.CpuTime());
+	}
+	ampFile.Close();
+
+	report.print();
+	if (not report.writeJson(jsonFileName))
+		return 1;
+	return 0;
+}
@@ -0,0 +1,392 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      benchmark of likelihood, gradient, and Hessian calculation
+//
+//      the likelihood is set up with random decay amplitudes and
+//      integral matrices, so that wave set, rank, and number of events
+//      can be chosen freely; all waves share the same simple decay and
+//      differ only in name and reflectivity
+//
+//      with -c the analytic Hessian is compared to central finite
+//      differences of the analytic gradient before the timing; the
+//      program fails if the deviation exceeds the tolerance
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "TMatrixT.h"
+#include "TMemFile.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+
+#include "reportingUtilsEnvironment.h"
+#include "particleDataTable.h"
+#include "waveDescription.h"
+#include "ampIntegralMatrix.h"
+#include "pwaLikelihood.h"
+#include "benchmarkUtils.hpp"
+
+
+using namespace std;
+using namespace rpwa;
+using namespace rpwa::benchmark;
+
+
+void
+usage(const string& progName,
+      const int     errCode = 0)
+{
+	cerr << "benchmark likelihood, gradient, and Hessian calculation with random decay amplitudes" << endl
+	     << endl
+	     << "usage:" << endl
+	     << progName
+	     << " [-w # -m # -r # -n # -a # -R # -H # -t # -s # -S -f -C -c -p PDG file -o file -v -h]" << endl
+	     << "    where:" << endl
+	     << "        -w #       number of waves (default: 20)" << endl
+	     << "        -m #       number of waves with negative reflectivity (default: 0)" << endl
+	     << "        -r #       rank of spin-density matrix (default: 1)" << endl
+	     << "        -n #       number of data events (default: 100000)" << endl
+	     << "        -a #       number of Monte Carlo events in integral matrices (default: 100000)" << endl
+	     << "        -R #       number of repetitions of likelihood and gradient calculation (default: 10)" << endl
+	     << "        -H #       number of repetitions of Hessian calculation (default: 1)" << endl
+	     << "        -t #       number of threads; 0 uses all available threads (default: 1)" << endl
+	     << "        -s #       seed for random numbers (default: 123456)" << endl
+	     << "        -S         use vectorized CPU kernels" << endl
+	     << "        -f         store decay amplitudes in single precision" << endl
+	     << "        -C         use CUDA kernels (if compiled with CUDA support)" << endl
+	     << "        -c         check Hessian against finite differences of gradient (default: false)" << endl
+	     << "        -p file    path to particle data table file (default: ./particleDataTable.txt)" << endl
+	     << "        -o file    path to JSON output file; '-' writes to stdout (default: benchmarkLikelihood.json)" << endl
+	     << "        -v         verbose; print debug output (default: false)" << endl
+	     << "        -h         print help" << endl
+	     << endl;
+	exit(errCode);
+}
+
+
+// compares the analytic Hessian at the given parameters to central
+// finite differences of the analytic gradient; returns the maximum
+// deviation relative to the largest element of the Hessian
+double
+hessianDeviation(const pwaLikelihood<complex<double> >& L,
+                 const vector<double>&                   par,
+                 const bool                              debug)
+{
+	const unsigned int     nmbPars = par.size();
+	const TMatrixT<double> hessian = L.Hessian(par.data());
+	double maxAbsHessian = 0;
+	for (unsigned int i = 0; i < nmbPars; ++i)
+		for (unsigned int j = 0; j < nmbPars; ++j)
+			maxAbsHessian = max(maxAbsHessian, fabs(hessian[i][j]));
+	if (maxAbsHessian == 0)
+		return 0;
+
+	vector<double> parShifted(par);
+	vector<double> gradPlus  (nmbPars);
+	vector<double> gradMinus (nmbPars);
+	double         maxDeviation = 0;
+	for (unsigned int j = 0; j < nmbPars; ++j) {
+		const double step = 1e-4 * max(1., fabs(par[j]));
+		parShifted[j] = par[j] + step;
+		L.Gradient(parShifted.data(), gradPlus.data());
+		parShifted[j] = par[j] - step;
+		L.Gradient(parShifted.data(), gradMinus.data());
+		parShifted[j] = par[j];
+		for (unsigned int i = 0; i < nmbPars; ++i) {
+			const double finiteDiff = (gradPlus[i] - gradMinus[i]) / (2 * step);
+			const double deviation  = fabs(hessian[i][j] - finiteDiff) / maxAbsHessian;
+			if (debug and (deviation > maxDeviation))
+				printDebug << "Hessian[" << i << "][" << j << "] = " << maxPrecision(hessian[i][j]) << ", "
+				           << "finite difference = " << maxPrecision(finiteDiff) << endl;
+			maxDeviation = max(maxDeviation, deviation);
+		}
+	}
+	return maxDeviation;
+}
+
+
+// key file content of a 1++ wave decaying into rho(770) pi- with the
+// given reflectivity
+string
+keyFileContent(const int refl)
+{
+	ostringstream key;
+	key << "productionVertex : { type = \"diffractiveDissVertex\"; "
+	    <<   "beam : { name = \"pi-\"; }; target : { name = \"p+\"; }; };" << endl
+	    << "decayVertex : {" << endl
+	    << "  XQuantumNumbers : { isospin = 2; G = -1; J = 2; P = 1; M = 2; refl = " << refl << "; };" << endl
+	    << "  XDecay : {" << endl
+	    << "    isobars = ( { name = \"rho(770)0\"; "
+	    <<                   "fsParticles = ( { name = \"pi+\"; }, { name = \"pi-\"; } ); L = 2; S = 0; } );" << endl
+	    << "    L = 0; S = 2;" << endl
+	    << "    fsParticles = ( { name = \"pi-\"; } );" << endl
+	    << "  };" << endl
+	    << "};" << endl;
+	return key.str();
+}
+
+
+int
+main(int    argc,
+     char** argv)
+{
+	printCompilerInfo();
+	printLibraryInfo ();
+	printGitHash     ();
+	cout << endl;
+
+	// parse command line options
+	const string  progName          = argv[0];
+	unsigned int  nmbWaves          = 20;
+	unsigned int  nmbWavesNeg       = 0;
+	unsigned int  rank              = 1;
+	unsigned long nmbEvents         = 100000;
+	unsigned long nmbAccEvents      = 100000;
+	unsigned int  nmbRepetitions    = 10;
+	unsigned int  nmbRepetitionsHes = 1;
+	unsigned int  nmbThreads        = 1;
+	unsigned int  seed              = 123456;
+	bool          useSimd           = false;
+	bool          singlePrecision   = false;
+	bool          useCuda           = false;
+	bool          checkHessian      = false;
+	const double  hessianTolerance  = 1e-5;
+	string        pdgFileName       = "./particleDataTable.txt";
+	string        jsonFileName      = "benchmarkLikelihood.json";
+	bool          debug             = false;
+	extern char*  optarg;
+	int           c;
+	while ((c = getopt(argc, argv, "w:m:r:n:a:R:H:t:s:SfCcp:o:vh")) != -1)
+		switch (c) {
+		case 'w':
+			nmbWaves = atoi(optarg);
+			break;
+		case 'm':
+			nmbWavesNeg = atoi(optarg);
+			break;
+		case 'r':
+			rank = atoi(optarg);
+			break;
+		case 'n':
+			nmbEvents = atol(optarg);
+			break;
+		case 'a':
+			nmbAccEvents = atol(optarg);
+			break;
+		case 'R':
+			nmbRepetitions = atoi(optarg);
+			break;
+		case 'H':
+			nmbRepetitionsHes = atoi(optarg);
+			break;
+		case 't':
+			nmbThreads = atoi(optarg);
+			break;
+		case 's':
+			seed = atoi(optarg);
+			break;
+		case 'S':
+			useSimd = true;
+			break;
+		case 'f':
+			singlePrecision = true;
+			break;
+		case 'C':
+			useCuda = true;
+			break;
+		case 'c':
+			checkHessian = true;
+			break;
+		case 'p':
+			pdgFileName = optarg;
+			break;
+		case 'o':
+			jsonFileName = optarg;
+			break;
+		case 'v':
+			debug = true;
+			break;
+		case 'h':
+		default:
+			usage(progName);
+		}
+	if ((nmbWaves == 0) or (nmbWavesNeg > nmbWaves) or (rank == 0) or (nmbEvents == 0) or (nmbAccEvents == 0)) {
+		printErr << "invalid wave set, rank, or number of events. Aborting..." << endl;
+		usage(progName, 1);
+	}
+
+	// initialize particle data table
+	particleDataTable::readFile(pdgFileName);
+
+	// create wave set
+	vector<waveDescriptionPtr> waveDescs[2];
+	waveDescs[0] = waveDescription::parseKeyFileContent(keyFileContent(-1));
+	waveDescs[1] = waveDescription::parseKeyFileContent(keyFileContent(+1));
+	if ((waveDescs[0].size() != 1) or (waveDescs[1].size() != 1)) {
+		printErr << "problems parsing key file content of synthetic waves. Aborting..." << endl;
+		return 1;
+	}
+	vector<string> waveNames;
+	vector<pwaLikelihood<complex<double> >::waveDescThresType> waveDescThres;
+	for (unsigned int iWave = 0; iWave < nmbWaves; ++iWave) {
+		const bool    negRefl = (iWave < nmbWavesNeg);
+		ostringstream waveName;
+		waveName << "synthWave" << setw(4) << setfill('0') << iWave << (negRefl ? "-" : "+");
+		waveNames.push_back(waveName.str());
+		waveDescThres.push_back(pwaLikelihood<complex<double> >::waveDescThresType(waveName.str(), *waveDescs[negRefl ? 0 : 1][0], 0.));
+	}
+
+	// generate random integral matrices and decay amplitudes
+	TRandom3          random(seed);
+	ampIntegralMatrix normMatrix;
+	ampIntegralMatrix accMatrix;
+	if (   not fillRandomIntegralMatrix(normMatrix, waveNames, nmbAccEvents, random, nmbThreads)
+	    or not fillRandomIntegralMatrix(accMatrix,  waveNames, nmbAccEvents, random, nmbThreads)) {
+		printErr << "could not generate integral matrices. Aborting..." << endl;
+		return 1;
+	}
+	TMemFile                          ampFile("benchmarkLikelihoodAmplitudes.root", "RECREATE");
+	vector<const amplitudeMetadata*>  ampMetas;
+	if (not writeRandomAmplitudes(ampFile, waveNames, nmbEvents, random, ampMetas)) {
+		printErr << "could not generate decay amplitudes. Aborting..." << endl;
+		return 1;
+	}
+
+	// set up likelihood
+	pwaLikelihood<complex<double> >::setQuiet(not debug);
+	pwaLikelihood<complex<double> > L;
+	L.setNmbThreads          (nmbThreads);
+	L.enableSimd             (useSimd);
+	L.useSinglePrecisionAmps (singlePrecision);
+	L.enableCuda             (useCuda);
+	if (   not L.init(waveDescThres, rank)
+	    or not L.addNormIntegral(normMatrix)
+	    or not L.addAccIntegral (accMatrix)) {
+		printErr << "could not initialize likelihood. Aborting..." << endl;
+		return 1;
+	}
+	for (size_t iWave = 0; iWave < ampMetas.size(); ++iWave)
+		if (not L.addAmplitude(vector<const amplitudeMetadata*>(1, ampMetas[iWave]))) {
+			printErr << "could not add decay amplitudes of wave '" << waveNames[iWave] << "'. Aborting..." << endl;
+			return 1;
+		}
+	if (not L.finishInit()) {
+		printErr << "could not finish initialization of likelihood. Aborting..." << endl;
+		return 1;
+	}
+	const unsigned int nmbPars = L.NDim();
+	ampFile.Close();
+
+	benchmarkReport report("likelihood");
+	report.setParameter("nmbWaves",        nmbWaves);
+	report.setParameter("nmbWavesNeg",     nmbWavesNeg);
+	report.setParameter("rank",            rank);
+	report.setParameter("nmbEvents",       nmbEvents);
+	report.setParameter("nmbAccEvents",    nmbAccEvents);
+	report.setParameter("nmbPars",         nmbPars);
+	report.setParameter("nmbThreads",      nmbThreadsToUse(nmbThreads));
+	report.setParameter("simd",            L.simdEnabled());
+	report.setParameter("singlePrecision", L.singlePrecisionAmpsUsed());
+	report.setParameter("cuda",            L.cudaEnabled());
+	report.setParameter("seed",            seed);
+
+	vector<double> par (nmbPars);
+	vector<double> grad(nmbPars);
+	if (checkHessian) {
+		for (unsigned int iPar = 0; iPar < nmbPars; ++iPar)
+			par[iPar] = random.Uniform(-1, 1) * sqrt((double)nmbEvents / nmbWaves);
+		const double deviation = hessianDeviation(L, par, debug);
+		report.setParameter("hessianDeviation", deviation);
+		if (deviation > hessianTolerance) {
+			printErr << "analytic Hessian deviates from finite differences of gradient by "
+			         << deviation << " relative to its largest element, which is more than "
+			         << hessianTolerance << ". Aborting..." << endl;
+			return 1;
+		}
+		printInfo << "analytic Hessian agrees with finite differences of gradient within "
+		          << deviation << " relative to its largest element" << endl;
+	}
+
+	// each call gets new random parameters, so that no call can take
+	// its result from the derivative cache; the first call of each
+	// function is not timed
+	TStopwatch     timer;
+	printInfo << "timing likelihood and derivatives for " << nmbPars << " parameters" << endl;
+	for (unsigned int iFunc = 0; iFunc < 4; ++iFunc) {
+		const char*        funcNames[4]   = {"DoEval", "Gradient", "FdF", "Hessian"};
+		const unsigned int nmbCalls       = ((iFunc == 3) ? nmbRepetitionsHes : nmbRepetitions) + 1;
+		benchmarkResult&   result         = report.addResult(string("pwaLikelihood::") + funcNames[iFunc]);
+		double             funcValSum     = 0;
+		for (unsigned int iCall = 0; iCall < nmbCalls; ++iCall) {
+			for (unsigned int iPar = 0; iPar < nmbPars; ++iPar)
+				par[iPar] = random.Uniform(-1, 1) * sqrt((double)nmbEvents / nmbWaves);
+			timer.Start(true);
+			switch (iFunc) {
+			case 0:
+				funcValSum += L.DoEval(par.data());
+				break;
+			case 1:
+				L.Gradient(par.data(), grad.data());
+				funcValSum += grad[0];
+				break;
+			case 2:
+				{
+					double funcVal;
+					L.FdF(par.data(), funcVal, grad.data());
+					funcValSum += funcVal;
+				}
+				break;
+			case 3:
+				funcValSum += L.Hessian(par.data())[0][0];
+				break;
+			}
+			timer.Stop();
+			if (iCall > 0)
+				result.addTime(timer.RealTime(), timer.CpuTime());
+		}
+		if (debug)
+			printDebug << "sum of function values of " << funcNames[iFunc] << " = " << funcValSum << endl;
+	}
+
+	report.print();
+	if (debug)
+		L.printFuncInfo(cout);
+	if (not report.writeJson(jsonFileName))
+		return 1;
+	return 0;
+}
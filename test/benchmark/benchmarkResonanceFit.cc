@@ -0,0 +1,212 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026 Boris Grube (TUM)
+//
+//    This file is part of ROOTPWA
+//
+//    ROOTPWA is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ROOTPWA is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with ROOTPWA.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      benchmark of the chi2 calculation of the resonance fit
+//
+//      the fit model, the data, and the parameters are read from a
+//      resonance-fit configuration file; chi2 and its gradient are
+//      calculated at the parameter values given there
+//
+//-------------------------------------------------------------------------
+
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <TStopwatch.h>
+
+#include <reportingUtils.hpp>
+#include <reportingUtilsEnvironment.h>
+
+#include "cache.h"
+#include "data.h"
+#include "function.h"
+#include "input.h"
+#include "model.h"
+#include "parameters.h"
+#include "resonanceFit.h"
+#include "benchmarkUtils.hpp"
+
+
+void
+usage(const std::string& progName,
+      const int     errCode = 0)
+{
+	std::cerr << "benchmark chi2 calculation of the resonance fit" << std::endl
+	          << std::endl
+	          << "usage:" << std::endl
+	          << progName
+	          << " [-R # -o file -A -B -C # -h] config file" << std::endl
+	          << "    where:" << std::endl
+	          << "        -R #       number of repetitions (default: 100)" << std::endl
+	          << "        -o file    path to JSON output file; '-' writes to stdout (default: benchmarkResonanceFit.json)" << std::endl
+	          << "        -A         fit to the production amplitudes (default: spin-density matrix)" << std::endl
+	          << "        -B         use branchings (reducing number of couplings)" << std::endl
+	          << "        -C #       part of the covariance matrix to use:" << std::endl
+	          << "                       1 = only diagonal elements" << std::endl
+	          << "                       2 = take covariance between real and imaginary part of the same complex number into account" << std::endl
+	          << "                       3 = full covariance matrix (not available while fitting to the spin-density matrix)" << std::endl
+	          << "        -h         print help" << std::endl
+	          << std::endl;
+	exit(errCode);
+}
+
+
+int
+main(int    argc,
+     char** argv)
+{
+	rpwa::printCompilerInfo();
+	rpwa::printLibraryInfo ();
+	rpwa::printGitHash     ();
+	std::cout << std::endl;
+
+	// ---------------------------------------------------------------------------
+	// parse command line options
+	const std::string progName       = argv[0];
+	unsigned int      nrRepetitions  = 100;
+	std::string       jsonFileName   = "benchmarkResonanceFit.json";
+	bool              doProdAmp      = false;
+	bool              doBranching    = false;
+
+	rpwa::resonanceFit::function::useCovarianceMatrix doCov = rpwa::resonanceFit::function::useCovarianceMatrixDefault;
+
+	extern char* optarg;
+	extern int   optind;
+	int c;
+	while((c = getopt(argc, argv, "R:o:ABC:h")) != -1) {
+		switch(c) {
+		case 'R':
+			nrRepetitions = atoi(optarg);
+			break;
+		case 'o':
+			jsonFileName = optarg;
+			break;
+		case 'A':
+			doProdAmp = true;
+			break;
+		case 'B':
+			doBranching = true;
+			break;
+		case 'C':
+			{
+				int cov = atoi(optarg);
+				if     (cov == 1) { doCov = rpwa::resonanceFit::function::useDiagnalElementsOnly;        }
+				else if(cov == 2) { doCov = rpwa::resonanceFit::function::useComplexDiagnalElementsOnly; }
+				else if(cov == 3) { doCov = rpwa::resonanceFit::function::useFullCovarianceMatrix;       }
+				else              { usage(progName, 1); }
+			}
+			break;
+		case '?':
+		case 'h':
+			usage(progName, 1);
+			break;
+		}
+	}
+
+	// if useCovariance has not been overwritten from the command line set
+	// the same defaults as the resonance fit
+	if(doCov == rpwa::resonanceFit::function::useCovarianceMatrixDefault) {
+		if(doProdAmp) {
+			doCov = rpwa::resonanceFit::function::useFullCovarianceMatrix;
+		} else {
+			doCov = rpwa::resonanceFit::function::useComplexDiagnalElementsOnly;
+		}
+	}
+
+	if(optind+1 != argc) {
+		printErr << "you need to specify exactly one configuration file." << std::endl;
+		usage(progName, 1);
+	}
+	const std::string configFileName = argv[optind];
+
+	// read configuration file
+	rpwa::resonanceFit::inputConstPtr fitInput;
+	rpwa::resonanceFit::dataConstPtr fitData;
+	rpwa::resonanceFit::modelConstPtr fitModel;
+	rpwa::resonanceFit::parameters fitParameters;
+	rpwa::resonanceFit::parameters fitParametersError;
+	std::map<std::string, double> fitQuality;
+	std::vector<std::string> freeParameters;
+	rpwa::resonanceFit::read(configFileName,
+	                         fitInput,
+	                         fitData,
+	                         fitModel,
+	                         fitParameters,
+	                         fitParametersError,
+	                         fitQuality,
+	                         freeParameters,
+	                         doBranching,
+	                         doCov);
+	if(not fitInput or not fitData or not fitModel) {
+		printErr << "error while reading configuration file '" << configFileName << "'." << std::endl;
+		return 1;
+	}
+
+	const rpwa::resonanceFit::function fitFunction(fitData,
+	                                               fitModel,
+	                                               doProdAmp);
+
+	rpwa::benchmark::benchmarkReport report("resonanceFit");
+	report.setParameter("configFile", configFileName);
+	report.setParameter("nrParameters", fitFunction.getNrParameters());
+	report.setParameter("nrDataPoints", fitFunction.getNrDataPoints());
+	report.setParameter("nrBins", fitData->nrBins());
+	report.setParameter("nrComponents", fitModel->getNrComponents());
+	report.setParameter("productionAmplitudes", doProdAmp);
+	report.setParameter("branchings", doBranching);
+	report.setParameter("covariance", (int)doCov);
+
+	// the cache keeps the contributions to chi2 between calls, so every
+	// repetition starts with an empty cache to time the full calculation
+	printInfo << "timing chi2 for " << fitFunction.getNrParameters() << " parameters and " << fitFunction.getNrDataPoints() << " data points." << std::endl;
+	std::vector<double> gradient(fitFunction.getNrParameters());
+	TStopwatch timer;
+	for(size_t idxFunc = 0; idxFunc < 2; ++idxFunc) {
+		const bool withGradient = (idxFunc == 1);
+		rpwa::benchmark::benchmarkResult& result = report.addResult(withGradient ? "function::chiSquare with gradient" : "function::chiSquare");
+		double chi2 = 0.;
+		for(size_t idxRepetition = 0; idxRepetition < nrRepetitions; ++idxRepetition) {
+			rpwa::resonanceFit::cache cache(fitData->maxNrWaves(),
+			                                fitModel->getNrComponents()+1,           // nr components + final-state mass-dependence
+			                                fitModel->getMaxChannelsInComponent(),
+			                                fitData->nrBins(),
+			                                fitData->maxNrMassBins(),
+			                                not doProdAmp);
+			timer.Start(true);
+			chi2 = fitFunction.chiSquare(fitParameters, cache, withGradient ? gradient.data() : nullptr);
+			timer.Stop();
+			result.addTime(timer.RealTime(), timer.CpuTime());
+		}
+		printInfo << "chi2 = " << rpwa::maxPrecisionAlign(chi2) << std::endl;
+	}
+
+	report.print();
+	if(not report.writeJson(jsonFileName)) {
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,393 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      helpers shared by the benchmark programs
+//
+//      - benchmarkReport collects the run parameters and the measured
+//        times of all timed functions and writes them in JSON format,
+//        so that results can be compared between commits, machines,
+//        and backends
+//      - generators for synthetic decay amplitudes and integral
+//        matrices, so that the benchmarks do not depend on data files
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#ifndef BENCHMARKUTILS_HPP
+#define BENCHMARKUTILS_HPP
+
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TFile.h"
+#include "TRandom3.h"
+
+#include "reportingUtils.hpp"
+#include "reportingUtilsEnvironment.h"
+#include "threadUtils.hpp"
+#include "amplitudeFileWriter.h"
+#include "amplitudeMetadata.h"
+#include "ampIntegralMatrix.h"
+
+
+namespace rpwa {
+
+	namespace benchmark {
+
+
+		/// measured times of one timed function
+		struct benchmarkResult {
+
+			benchmarkResult(const std::string& resultName = "")
+				: name(resultName)
+			{ }
+
+			void addTime(const double realTime,
+			             const double cpuTime)
+			{
+				realTimes.push_back(realTime);
+				cpuTimes.push_back (cpuTime );
+			}
+
+			std::string                        name;
+			std::map<std::string, std::string> parameters;  ///< parameters specific to this result; values are JSON-encoded
+			std::vector<double>                realTimes;   ///< wall-clock time of each repetition in seconds
+			std::vector<double>                cpuTimes;    ///< CPU time of each repetition in seconds
+
+		};
+
+
+		/// collects parameters and results of a benchmark program and writes them as JSON
+		class benchmarkReport {
+
+		public:
+
+			benchmarkReport(const std::string& benchmarkName)
+				: _name(benchmarkName)
+			{ }
+
+			void setParameter(const std::string& name, const std::string& value) { _parameters[name] = jsonString(value);        }
+			void setParameter(const std::string& name, const char*        value) { _parameters[name] = jsonString(value);        }
+			void setParameter(const std::string& name, const bool         value) { _parameters[name] = value ? "true" : "false"; }
+			template<typename T>
+			void setParameter(const std::string& name, const T&           value) { _parameters[name] = jsonNumber(value);        }
+
+			benchmarkResult& addResult(const std::string& name)  ///< adds result; the reference stays valid until the next call
+			{
+				_results.push_back(benchmarkResult(name));
+				return _results.back();
+			}
+
+			std::ostream& print    (std::ostream& out = std::cout) const;  ///< prints summary of results in human-readable form
+			std::ostream& writeJson(std::ostream& out) const;
+			bool          writeJson(const std::string& fileName) const;  ///< "-" writes to stdout
+
+			static std::string jsonString(const std::string& value);  ///< returns quoted and escaped string
+			template<typename T>
+			static std::string jsonNumber(const T& value);  ///< returns number; null for infinite and NaN values, which JSON cannot represent
+
+		private:
+
+			static void statistics(const std::vector<double>& times,
+			                       double&                    min,
+			                       double&                    median,
+			                       double&                    mean,
+			                       double&                    max);
+
+			static std::ostream& writeJson(std::ostream&              out,
+			                               const std::string&         name,
+			                               const std::vector<double>& times,
+			                               const std::string&         indent);
+
+			std::string                        _name;
+			std::map<std::string, std::string> _parameters;  ///< values are JSON-encoded
+			std::vector<benchmarkResult>       _results;
+
+		};
+
+
+		inline
+		std::string
+		benchmarkReport::jsonString(const std::string& value)
+		{
+			std::ostringstream out;
+			out << '"';
+			for (size_t i = 0; i < value.size(); ++i) {
+				const char c = value[i];
+				switch (c) {
+				case '"':
+					out << "\\\"";
+					break;
+				case '\\':
+					out << "\\\\";
+					break;
+				case '\n':
+					out << "\\n";
+					break;
+				case '\t':
+					out << "\\t";
+					break;
+				default:
+					if ((unsigned char)c < 0x20)
+						out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec << std::setfill(' ');
+					else
+						out << c;
+				}
+			}
+			out << '"';
+			return out.str();
+		}
+
+
+		template<typename T>
+		inline
+		std::string
+		benchmarkReport::jsonNumber(const T& value)
+		{
+			if (not std::isfinite(static_cast<double>(value)))
+				return "null";
+			std::ostringstream out;
+			out << std::setprecision(std::numeric_limits<double>::digits10 + 2) << value;
+			return out.str();
+		}
+
+
+		inline
+		void
+		benchmarkReport::statistics(const std::vector<double>& times,
+		                            double&                    min,
+		                            double&                    median,
+		                            double&                    mean,
+		                            double&                    max)
+		{
+			min = median = mean = max = 0;
+			if (times.empty())
+				return;
+			std::vector<double> sorted(times);
+			std::sort(sorted.begin(), sorted.end());
+			min    = sorted.front();
+			max    = sorted.back();
+			median = (sorted.size() % 2 == 1) ? sorted[sorted.size() / 2]
+			                                  : 0.5 * (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]);
+			for (size_t i = 0; i < sorted.size(); ++i)
+				mean += sorted[i];
+			mean /= sorted.size();
+		}
+
+
+		inline
+		std::ostream&
+		benchmarkReport::print(std::ostream& out) const
+		{
+			out << "results of benchmark '" << _name << "':" << std::endl;
+			for (size_t i = 0; i < _results.size(); ++i) {
+				double min, median, mean, max;
+				statistics(_results[i].realTimes, min, median, mean, max);
+				out << "    " << std::setw(40) << std::left << _results[i].name << std::right
+				    << " median = " << std::setw(12) << median << " s"
+				    << " (min = " << min << " s, max = " << max << " s, "
+				    << _results[i].realTimes.size() << " repetitions)" << std::endl;
+			}
+			return out;
+		}
+
+
+		inline
+		std::ostream&
+		benchmarkReport::writeJson(std::ostream&              out,
+		                           const std::string&         name,
+		                           const std::vector<double>& times,
+		                           const std::string&         indent)
+		{
+			double min, median, mean, max;
+			statistics(times, min, median, mean, max);
+			out << indent << jsonString(name) << ": {" << std::endl
+			    << indent << "\t\"min\": "    << jsonNumber(min)    << "," << std::endl
+			    << indent << "\t\"median\": " << jsonNumber(median) << "," << std::endl
+			    << indent << "\t\"mean\": "   << jsonNumber(mean)   << "," << std::endl
+			    << indent << "\t\"max\": "    << jsonNumber(max)    << "," << std::endl
+			    << indent << "\t\"values\": [";
+			for (size_t i = 0; i < times.size(); ++i)
+				out << ((i > 0) ? ", " : "") << jsonNumber(times[i]);
+			out << "]" << std::endl
+			    << indent << "}";
+			return out;
+		}
+
+
+		inline
+		std::ostream&
+		benchmarkReport::writeJson(std::ostream& out) const
+		{
+			out << "{" << std::endl
+			    << "\t\"benchmark\": "     << jsonString(_name)          << "," << std::endl
+			    << "\t\"gitHash\": "       << jsonString(gitHash())      << "," << std::endl
+			    << "\t\"maxNmbThreads\": " << jsonNumber(maxNmbThreads()) << "," << std::endl
+			    << "\t\"parameters\": {";
+			for (std::map<std::string, std::string>::const_iterator it = _parameters.begin(); it != _parameters.end(); ++it)
+				out << ((it != _parameters.begin()) ? "," : "") << std::endl
+				    << "\t\t" << jsonString(it->first) << ": " << it->second;
+			out << std::endl
+			    << "\t}," << std::endl
+			    << "\t\"results\": [";
+			for (size_t i = 0; i < _results.size(); ++i) {
+				const benchmarkResult& result = _results[i];
+				out << ((i > 0) ? "," : "") << std::endl
+				    << "\t\t{" << std::endl
+				    << "\t\t\t\"name\": " << jsonString(result.name) << "," << std::endl
+				    << "\t\t\t\"parameters\": {";
+				for (std::map<std::string, std::string>::const_iterator it = result.parameters.begin(); it != result.parameters.end(); ++it)
+					out << ((it != result.parameters.begin()) ? "," : "") << std::endl
+					    << "\t\t\t\t" << jsonString(it->first) << ": " << it->second;
+				out << std::endl
+				    << "\t\t\t}," << std::endl
+				    << "\t\t\t\"repetitions\": " << result.realTimes.size() << "," << std::endl;
+				writeJson(out, "realTime", result.realTimes, "\t\t\t") << "," << std::endl;
+				writeJson(out, "cpuTime",  result.cpuTimes,  "\t\t\t") << std::endl;
+				out << "\t\t}";
+			}
+			out << std::endl
+			    << "\t]" << std::endl
+			    << "}" << std::endl;
+			return out;
+		}
+
+
+		inline
+		bool
+		benchmarkReport::writeJson(const std::string& fileName) const
+		{
+			if (fileName == "-") {
+				writeJson(std::cout);
+				return true;
+			}
+			std::ofstream outFile(fileName.c_str());
+			if (not outFile) {
+				printErr << "cannot open JSON output file '" << fileName << "'." << std::endl;
+				return false;
+			}
+			writeJson(outFile);
+			printInfo << "wrote benchmark results to '" << fileName << "'." << std::endl;
+			return true;
+		}
+
+
+		/// returns random complex number with independent Gaussian real and imaginary parts
+		inline
+		std::complex<double>
+		randomAmplitude(TRandom3&    random,
+		                const double sigma = 1)
+		{
+			const double re = random.Gaus(0, sigma);
+			const double im = random.Gaus(0, sigma);
+			return std::complex<double>(re, im);
+		}
+
+
+		/// writes amplitude trees with random decay amplitudes for the given waves into the file
+		/// the amplitudes of each wave are scaled by a random factor, so that
+		/// the waves have different intensities like in real data; the file
+		/// should be a TMemFile, if the benchmark should not depend on disk I/O
+		inline
+		bool
+		writeRandomAmplitudes(TFile&                                        outFile,
+		                      const std::vector<std::string>&               waveNames,
+		                      const unsigned long                           nmbEvents,
+		                      TRandom3&                                     random,
+		                      std::vector<const rpwa::amplitudeMetadata*>& ampMetas)
+		{
+			ampMetas.clear();
+			for (size_t iWave = 0; iWave < waveNames.size(); ++iWave) {
+				rpwa::amplitudeFileWriter writer;
+				if (not writer.initialize(outFile, std::vector<const rpwa::eventMetadata*>(), "", waveNames[iWave])) {
+					printErr << "could not initialize amplitude file writer for wave '" << waveNames[iWave] << "'." << std::endl;
+					return false;
+				}
+				const double sigma = random.Uniform(0.5, 2);
+				std::vector<std::complex<double> > amps(nmbEvents);
+				for (unsigned long iEvent = 0; iEvent < nmbEvents; ++iEvent)
+					amps[iEvent] = randomAmplitude(random, sigma);
+				writer.addAmplitudes(amps);
+				if (not writer.finalize()) {
+					printErr << "could not write amplitudes of wave '" << waveNames[iWave] << "'." << std::endl;
+					return false;
+				}
+				const rpwa::amplitudeMetadata* ampMeta = rpwa::amplitudeMetadata::readAmplitudeFile(&outFile, waveNames[iWave], true);
+				if (not ampMeta) {
+					printErr << "could not read back amplitudes of wave '" << waveNames[iWave] << "'." << std::endl;
+					return false;
+				}
+				ampMetas.push_back(ampMeta);
+			}
+			return true;
+		}
+
+
+		/// fills the integral matrix with random decay amplitudes of the given waves
+		inline
+		bool
+		fillRandomIntegralMatrix(rpwa::ampIntegralMatrix&        integral,
+		                         const std::vector<std::string>& waveNames,
+		                         const unsigned long             nmbEvents,
+		                         TRandom3&                       random,
+		                         const unsigned int              nmbThreads = 1)
+		{
+			if (not integral.setWaveNames(waveNames))
+				return false;
+			const unsigned long nmbEventsPerBlock = 10000;
+			std::vector<std::vector<std::complex<double> > > amps(waveNames.size());
+			for (unsigned long blockBegin = 0; blockBegin < nmbEvents; blockBegin += nmbEventsPerBlock) {
+				const unsigned long blockSize = std::min(nmbEventsPerBlock, nmbEvents - blockBegin);
+				for (size_t iWave = 0; iWave < waveNames.size(); ++iWave) {
+					amps[iWave].resize(blockSize);
+					for (unsigned long iEvent = 0; iEvent < blockSize; ++iEvent)
+						amps[iWave][iEvent] = randomAmplitude(random);
+				}
+				if (not integral.addEvents(amps, nmbThreads))
+					return false;
+			}
+			return true;
+		}
+
+
+	}  // namespace benchmark
+
+}  // namespace rpwa
+
+
+#endif  // BENCHMARKUTILS_HPP
@@ -0,0 +1,209 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      round-trip test of amplitude cache files
+//
+//      an amplitude file is written and converted into a cache file;
+//      the memory-mapped cache file has to reproduce the amplitudes
+//      bit by bit, and cache files with a corrupted header or a wrong
+//      content hash have to be rejected
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <stdint.h>
+
+#include <TFile.h>
+#include <TSystem.h>
+
+#include "amplitudeCacheFile.h"
+#include "amplitudeFileWriter.h"
+#include "amplitudeMetadata.h"
+#include "reportingUtils.hpp"
+
+
+using namespace std;
+using namespace rpwa;
+
+
+namespace {
+
+	const string objectBaseName = "testAmplitudeCacheFile";
+
+
+	bool
+	check(const bool    condition,
+	      const string& description)
+	{
+		if (condition)
+			printSucc << description << endl;
+		else
+			printErr << "failed: " << description << endl;
+		return condition;
+	}
+
+
+	vector<char>
+	readFile(const string& fileName)
+	{
+		ifstream file(fileName.c_str(), ios::binary);
+		return vector<char>(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+	}
+
+
+	void
+	writeFile(const string&       fileName,
+	          const vector<char>& content)
+	{
+		ofstream file(fileName.c_str(), ios::binary | ios::trunc);
+		file.write(content.data(), content.size());
+	}
+
+
+	// writes given modification of the cache file and checks that it is rejected
+	bool
+	checkRejected(const string&       fileName,
+	              const vector<char>& content,
+	              const string&       contentHash,
+	              const string&       description)
+	{
+		writeFile(fileName, content);
+		amplitudeCacheFile cacheFile;
+		const bool success = check(not cacheFile.open(fileName, contentHash) and not cacheFile.isOpen(),
+		                           "cache file with " + description + " is rejected");
+		remove(fileName.c_str());
+		return success;
+	}
+
+}
+
+
+int
+main()
+{
+	const string tempDirectory     = gSystem->TempDirectory();
+	const string ampFileName       = tempDirectory + "/testAmplitudeCacheFile.root";
+	const string cacheDirectory    = tempDirectory;
+	const string corruptedFileName = tempDirectory + "/testAmplitudeCacheFile_corrupted.ampcache";
+
+	// write amplitude file
+	const size_t nmbEvents = 100003;
+	vector<complex<double> > amplitudes(nmbEvents);
+	for (size_t i = 0; i < nmbEvents; ++i)
+		amplitudes[i] = complex<double>(sin(0.1 * i) * (i + 1), cos(0.3 * i) / (i + 1));
+	{
+		TFile* outputFile = TFile::Open(ampFileName.c_str(), "RECREATE");
+		if (not outputFile or outputFile->IsZombie()) {
+			printErr << "cannot open output file '" << ampFileName << "'." << endl;
+			return 1;
+		}
+		amplitudeFileWriter writer;
+		if (not writer.initialize(*outputFile, vector<const eventMetadata*>(), "", objectBaseName)) {
+			printErr << "cannot initialize amplitude file writer." << endl;
+			return 1;
+		}
+		writer.addAmplitudes(amplitudes);
+		if (not writer.finalize()) {
+			printErr << "cannot write amplitude file '" << ampFileName << "'." << endl;
+			return 1;
+		}
+		outputFile->Close();
+		delete outputFile;
+	}
+
+	// convert amplitude file into cache file
+	TFile* inputFile = TFile::Open(ampFileName.c_str(), "READ");
+	const amplitudeMetadata* ampMeta = inputFile ? amplitudeMetadata::readAmplitudeFile(inputFile, objectBaseName) : 0;
+	if (not ampMeta) {
+		printErr << "cannot read amplitude file '" << ampFileName << "'." << endl;
+		return 1;
+	}
+	const string contentHash   = ampMeta->contentHash();
+	const string cacheFileName = amplitudeCacheFile::cacheFileName(cacheDirectory, contentHash);
+	bool success = check(amplitudeCacheFile::writeCacheFile(*ampMeta, cacheFileName), "cache file is written");
+	inputFile->Close();
+	delete inputFile;
+	remove(ampFileName.c_str());
+	if (not success)
+		return 1;
+
+	// read cache file
+	{
+		amplitudeCacheFile cacheFile;
+		success &= check(cacheFile.open(cacheFileName, contentHash), "cache file is opened");
+		success &= check(cacheFile.nmbEvents() == nmbEvents, "cache file contains all amplitudes");
+		if (cacheFile.isOpen() and cacheFile.nmbEvents() == nmbEvents) {
+			success &= check(memcmp(cacheFile.amplitudes(), amplitudes.data(), nmbEvents * sizeof(complex<double>)) == 0,
+			                 "amplitudes in cache file are bitwise identical to the written ones");
+			// the mapping starts at a page boundary, the header has 128 bytes
+			success &= check((uintptr_t)cacheFile.amplitudes() % 64 == 0, "amplitudes in cache file are aligned to cache lines");
+		}
+		cacheFile.close();
+		success &= check(not cacheFile.isOpen() and cacheFile.nmbEvents() == 0, "cache file is closed");
+	}
+	{
+		amplitudeCacheFile cacheFile;
+		success &= check(not cacheFile.open(cacheFileName, contentHash + "0"), "cache file with other content hash is rejected");
+		success &= check(not cacheFile.open(cacheDirectory + "/doesNotExist.ampcache", contentHash), "missing cache file is rejected");
+	}
+
+	// corrupted cache files; the header starts with the 8-byte magic
+	// string, followed by the 4-byte version and the 4-byte byte-order mark
+	const vector<char> content = readFile(cacheFileName);
+	remove(cacheFileName.c_str());
+	if (content.size() != 128 + nmbEvents * sizeof(complex<double>)) {
+		printErr << "cache file has unexpected size of " << content.size() << " bytes." << endl;
+		return 1;
+	}
+	vector<char> corrupted = content;
+	corrupted[0] ^= 1;
+	success &= checkRejected(corruptedFileName, corrupted, contentHash, "corrupted magic string");
+	corrupted = content;
+	corrupted[8] ^= 1;
+	success &= checkRejected(corruptedFileName, corrupted, contentHash, "other version");
+	corrupted = content;
+	std::swap(corrupted[12], corrupted[15]);
+	success &= checkRejected(corruptedFileName, corrupted, contentHash, "other byte order");
+	corrupted = content;
+	corrupted[16] ^= 1;
+	success &= checkRejected(corruptedFileName, corrupted, contentHash, "wrong number of events");
+	corrupted = vector<char>(content.begin(), content.end() - 1);
+	success &= checkRejected(corruptedFileName, corrupted, contentHash, "truncated amplitudes");
+	corrupted = vector<char>(content.begin(), content.begin() + 100);
+	success &= checkRejected(corruptedFileName, corrupted, contentHash, "truncated header");
+
+	return success ? 0 : 1;
+}
@@ -0,0 +1,227 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      test of the content hash of event files
+//
+//      two event files are written and merged; the content hash of
+//      the merged file, which is built from the block hashes of the
+//      input files, has to be the same as the hash calculated in a
+//      single pass over the events, and a file without block hashes
+//      has to be hashed with a single MD5 hash over all events
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include <cmath>
+
+#include <TClass.h>
+#include <TFile.h>
+#include <TROOT.h>
+#include <TSystem.h>
+#include <TTree.h>
+#include <TVector3.h>
+
+#include "eventFileWriter.h"
+#include "eventMetadata.h"
+#include "hashCalculator.h"
+#include "reportingUtils.hpp"
+
+
+using namespace std;
+using namespace rpwa;
+
+
+namespace {
+
+	const unsigned int nmbProductionParticles = 1;
+	const unsigned int nmbDecayParticles      = 3;
+
+
+	// deterministic kinematics of event with given index
+	void
+	eventKinematics(const long        eventIndex,
+	                vector<TVector3>& productionMomenta,
+	                vector<TVector3>& decayMomenta,
+	                vector<double>&   additionalVariables)
+	{
+		productionMomenta.assign(nmbProductionParticles, TVector3(0, 0, 190 + 1e-4 * eventIndex));
+		decayMomenta.clear();
+		for (unsigned int i = 0; i < nmbDecayParticles; ++i)
+			decayMomenta.push_back(TVector3(sin(eventIndex + i), cos(eventIndex * (i + 1)), 60 + 1e-3 * eventIndex));
+		additionalVariables.assign(1, 1e-5 * eventIndex);
+	}
+
+
+	template<typename hashorT>
+	void
+	updateHashor(hashorT&   hashor,
+	             const long eventIndex)
+	{
+		vector<TVector3> productionMomenta;
+		vector<TVector3> decayMomenta;
+		vector<double>   additionalVariables;
+		eventKinematics(eventIndex, productionMomenta, decayMomenta, additionalVariables);
+		for (unsigned int i = 0; i < productionMomenta.size(); ++i)
+			hashor.Update(productionMomenta[i]);
+		for (unsigned int i = 0; i < decayMomenta.size(); ++i)
+			hashor.Update(decayMomenta[i]);
+		for (unsigned int i = 0; i < additionalVariables.size(); ++i)
+			hashor.Update(additionalVariables[i]);
+	}
+
+
+	bool
+	writeEventFile(const string& fileName,
+	               const long    firstEvent,
+	               const long    nmbEvents)
+	{
+		TFile* outputFile = TFile::Open(fileName.c_str(), "RECREATE");
+		if (not outputFile or outputFile->IsZombie()) {
+			printErr << "cannot open output file '" << fileName << "'." << endl;
+			return false;
+		}
+		eventFileWriter writer;
+		if (not writer.initialize(*outputFile, "", eventMetadata::GENERATED,
+		                          vector<string>(nmbProductionParticles, "pi-"),
+		                          vector<string>(nmbDecayParticles,      "pi-"),
+		                          multibinBoundariesType(), vector<string>(1, "tPrime"))) {
+			printErr << "cannot initialize event file writer." << endl;
+			return false;
+		}
+		vector<TVector3> productionMomenta;
+		vector<TVector3> decayMomenta;
+		vector<double>   additionalVariables;
+		for (long eventIndex = firstEvent; eventIndex < firstEvent + nmbEvents; ++eventIndex) {
+			eventKinematics(eventIndex, productionMomenta, decayMomenta, additionalVariables);
+			writer.addEvent(productionMomenta, decayMomenta, additionalVariables);
+		}
+		const bool success = writer.finalize();
+		delete outputFile;
+		return success;
+	}
+
+
+	bool
+	check(const bool    condition,
+	      const string& description)
+	{
+		if (condition)
+			printSucc << description << endl;
+		else
+			printErr << "failed: " << description << endl;
+		return condition;
+	}
+
+}
+
+
+int
+main()
+{
+	const long nmbEvents[2] = {25000, 13000};
+	const string fileNames[2] = {string(gSystem->TempDirectory()) + "/testEventMetadataHash_0.root",
+	                             string(gSystem->TempDirectory()) + "/testEventMetadataHash_1.root"};
+	if (not writeEventFile(fileNames[0], 0,            nmbEvents[0])
+	    or not writeEventFile(fileNames[1], nmbEvents[0], nmbEvents[1]))
+		return 1;
+
+	TFile* inputFiles[2];
+	vector<const eventMetadata*> inputMetadata(2);
+	for (unsigned int i = 0; i < 2; ++i) {
+		inputFiles[i]    = TFile::Open(fileNames[i].c_str(), "READ");
+		inputMetadata[i] = inputFiles[i] ? eventMetadata::readEventFile(inputFiles[i]) : 0;
+		if (not inputMetadata[i]) {
+			printErr << "cannot read event file '" << fileNames[i] << "'." << endl;
+			return 1;
+		}
+	}
+
+	bool success = true;
+	for (unsigned int i = 0; i < 2; ++i)
+		success &= check(inputMetadata[i]->recalculateHash() == inputMetadata[i]->contentHash(),
+		                 "recalculated hash of input file " + fileNames[i] + " matches its content hash");
+
+	// the merged file keeps the blocks of the input files; a single pass
+	// over all events with the same blocks has to give the same hash; the
+	// event tree of the merged file is kept in memory
+	gROOT->cd();
+	eventMetadata* merged = eventMetadata::merge(inputMetadata);
+	if (not merged) {
+		printErr << "cannot merge event files." << endl;
+		return 1;
+	}
+	blockHashCalculator singlePassHashor;
+	singlePassHashor.setBlockLayout(merged->contentHashBlockNmbEvents());
+	for (long eventIndex = 0; eventIndex < nmbEvents[0] + nmbEvents[1]; ++eventIndex) {
+		updateHashor(singlePassHashor, eventIndex);
+		singlePassHashor.finishEvent();
+	}
+	const string mergedHash = merged->contentHash();
+	success &= check(merged->contentHashBlockNmbEvents().size() == inputMetadata[0]->contentHashBlockNmbEvents().size()
+	                                                               + inputMetadata[1]->contentHashBlockNmbEvents().size(),
+	                 "merged file keeps the blocks of the input files");
+	success &= check(singlePassHashor.hash() == mergedHash,
+	                 "content hash of merged file matches single-pass hash of the events");
+	success &= check(merged->recalculateHash() == mergedHash,
+	                 "recalculated hash of merged file matches its content hash");
+	delete merged->eventTree();
+	delete merged;
+
+	// emulate an input file written before the content hash was built from
+	// blocks of events, for which ROOT leaves the block members empty when
+	// reading it
+	eventMetadata* legacyMetadata = const_cast<eventMetadata*>(inputMetadata[0]);
+	TClass* metadataClass = TClass::GetClass("rpwa::eventMetadata");
+	reinterpret_cast<vector<Long64_t>*>((char*)legacyMetadata + metadataClass->GetDataMemberOffset("_contentHashBlockNmbEvents"))->clear();
+	reinterpret_cast<vector<string>*>  ((char*)legacyMetadata + metadataClass->GetDataMemberOffset("_contentHashBlockHashes"   ))->clear();
+	hashCalculator md5Hashor;
+	for (long eventIndex = 0; eventIndex < nmbEvents[0]; ++eventIndex)
+		updateHashor(md5Hashor, eventIndex);
+	success &= check(legacyMetadata->recalculateHash() == md5Hashor.hash(),
+	                 "file without block hashes is hashed with a single MD5 hash over all events");
+
+	// the events of an input file without block hashes are hashed again
+	// when merging, which gives the same blocks as the original file
+	gROOT->cd();
+	merged = eventMetadata::merge(inputMetadata);
+	if (not merged) {
+		printErr << "cannot merge event files." << endl;
+		return 1;
+	}
+	success &= check(merged->contentHash() == mergedHash,
+	                 "content hash of merged file does not depend on whether the input file has block hashes");
+	delete merged->eventTree();
+	delete merged;
+
+	for (unsigned int i = 0; i < 2; ++i) {
+		inputFiles[i]->Close();
+		delete inputFiles[i];
+		gSystem->Unlink(fileNames[i].c_str());
+	}
+	return success ? 0 : 1;
+}
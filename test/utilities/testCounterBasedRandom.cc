@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      known-answer test of the Philox4x32-10 counter-based random
+//      number generator; the expected values are the known-answer
+//      vectors of the reference implementation (Random123)
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#include <iomanip>
+
+#include "counterBasedRandom.hpp"
+#include "reportingUtils.hpp"
+
+
+using namespace std;
+using namespace rpwa;
+
+
+namespace {
+
+	struct knownAnswer {
+		uint32_t counter [4];
+		uint32_t key     [2];
+		uint32_t expected[4];
+	};
+
+	const knownAnswer knownAnswers[] = {
+		{{0x00000000, 0x00000000, 0x00000000, 0x00000000}, {0x00000000, 0x00000000},
+		 {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+		{{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff},
+		 {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+		{{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0},
+		 {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}
+	};
+
+}
+
+
+int
+main()
+{
+	bool success = true;
+	for (size_t i = 0; i < sizeof(knownAnswers) / sizeof(knownAnswers[0]); ++i) {
+		const knownAnswer& answer = knownAnswers[i];
+		const counterBasedRandom random(((uint64_t)answer.key[1] << 32) | answer.key[0]);
+		uint32_t r[4];
+		random.random4x32(((uint64_t)answer.counter[1] << 32) | answer.counter[0],
+		                  ((uint64_t)answer.counter[3] << 32) | answer.counter[2], r);
+		bool match = true;
+		for (unsigned int j = 0; j < 4; ++j)
+			if (r[j] != answer.expected[j])
+				match = false;
+		if (not match) {
+			printErr << "known answer " << i << " does not match: got " << hex << setfill('0');
+			for (unsigned int j = 0; j < 4; ++j)
+				cerr << " " << setw(8) << r[j];
+			cerr << ", expected";
+			for (unsigned int j = 0; j < 4; ++j)
+				cerr << " " << setw(8) << answer.expected[j];
+			cerr << dec << setfill(' ') << endl;
+			success = false;
+		}
+	}
+	if (not success)
+		return 1;
+	printSucc << "Philox4x32-10 reproduces all known answers." << endl;
+	return 0;
+}
@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      counter-based random number generator
+//
+//      the random numbers are a pure function of a 64-bit key (the
+//      seed) and a 128-bit counter, so that the generator has no state
+//      that is changed by drawing numbers; any number of threads can
+//      draw from the same instance, and the n-th number of a stream
+//      can be obtained without generating the ones before
+//
+//      the numbers are generated by the Philox4x32-10 bijection, see
+//      J. K. Salmon et al., "Parallel random numbers: as easy as 1, 2, 3",
+//      Proceedings of SC11 (2011), doi:10.1145/2063384.2063405
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#ifndef COUNTERBASEDRANDOM_HPP
+#define COUNTERBASEDRANDOM_HPP
+
+
+#include <stdint.h>
+
+
+namespace rpwa {
+
+
+	class counterBasedRandom {
+
+	public:
+
+		counterBasedRandom(const uint64_t seed = 0)
+			: _seed(seed)
+		{ }
+
+		uint64_t seed   () const              { return _seed; }
+		void     setSeed(const uint64_t seed) { _seed = seed; }
+
+		/// returns four independent 32-bit random numbers for the given counter
+		inline void random4x32(const uint64_t counterLo,
+		                       const uint64_t counterHi,
+		                       uint32_t       r[4]) const;
+
+		/// returns two independent uniform random numbers in ]0, 1] with 53 bits each for the given counter
+		inline void uniform2(const uint64_t counterLo,
+		                     const uint64_t counterHi,
+		                     double&        r0,
+		                     double&        r1) const;
+
+	private:
+
+		static inline void round(uint32_t       ctr[4],
+		                         const uint32_t key[2]);
+
+		static inline double toUniform(const uint32_t hi,
+		                               const uint32_t lo);
+
+		uint64_t _seed;  ///< key of the Philox bijection
+
+	};
+
+
+	inline
+	void
+	counterBasedRandom::round(uint32_t       ctr[4],
+	                          const uint32_t key[2])
+	{
+		const uint64_t prod0 = (uint64_t)0xD2511F53 * ctr[0];
+		const uint64_t prod1 = (uint64_t)0xCD9E8D57 * ctr[2];
+		const uint32_t c1    = ctr[1];
+		const uint32_t c3    = ctr[3];
+		ctr[0] = (uint32_t)(prod1 >> 32) ^ c1 ^ key[0];
+		ctr[1] = (uint32_t)prod1;
+		ctr[2] = (uint32_t)(prod0 >> 32) ^ c3 ^ key[1];
+		ctr[3] = (uint32_t)prod0;
+	}
+
+
+	inline
+	void
+	counterBasedRandom::random4x32(const uint64_t counterLo,
+	                               const uint64_t counterHi,
+	                               uint32_t       r[4]) const
+	{
+		uint32_t key[2] = {(uint32_t)_seed, (uint32_t)(_seed >> 32)};
+		r[0] = (uint32_t)counterLo;
+		r[1] = (uint32_t)(counterLo >> 32);
+		r[2] = (uint32_t)counterHi;
+		r[3] = (uint32_t)(counterHi >> 32);
+		for (unsigned int i = 0; i < 10; ++i) {
+			if (i > 0) {
+				key[0] += 0x9E3779B9;
+				key[1] += 0xBB67AE85;
+			}
+			round(r, key);
+		}
+	}
+
+
+	inline
+	double
+	counterBasedRandom::toUniform(const uint32_t hi,
+	                              const uint32_t lo)
+	{
+		// 53 random bits are mapped to ]0, 1]
+		const uint64_t bits = ((uint64_t)hi << 21) ^ (lo >> 11);
+		return (bits + 1) * (1. / 9007199254740992.);
+	}
+
+
+	inline
+	void
+	counterBasedRandom::uniform2(const uint64_t counterLo,
+	                             const uint64_t counterHi,
+	                             double&        r0,
+	                             double&        r1) const
+	{
+		uint32_t r[4];
+		random4x32(counterLo, counterHi, r);
+		r0 = toUniform(r[0], r[1]);
+		r1 = toUniform(r[2], r[3]);
+	}
+
+
+}  // namespace rpwa
+
+
+#endif  // COUNTERBASEDRANDOM_HPP
@@ -22,6 +22,9 @@
 //
 // Description:
 //      optimized Wigner d-function d^j_{m n}(theta) with caching
+//      the coefficients of all d-functions up to the maximum allowed J
+//      are tabulated on first use; the table is read-only afterwards,
+//      so that d-functions can be evaluated concurrently
 //      used as basis for optimized spherical harmonics Y_l^m(theta, phi)
 //      as well as for optimized D-function D^j_{m n}(alpha, beta,
 //      gamma) and D-function in reflectivity basis
@@ -42,6 +45,7 @@
 #define DFUNCTION_HPP
 
 
+#include <cstddef>
 #include <cmath>
 #include <algorithm>
 #include <vector>
@@ -57,28 +61,50 @@ namespace rpwa {
 
 	public:
 
+		// d^j_{m n}(theta) = cos^kmn1Min(theta / 2) * sin^jmnkMin(theta / 2)
+		//                    * sum_i coeff_i * cos^{2 i}(theta / 2) * sin^{2 (nmbCoeffs - 1 - i)}(theta / 2)
 		struct cacheEntryType {
 
 			cacheEntryType()
-				: constTerm(0)
+				: kmn1Min   (0),
+				  jmnkMin   (0),
+				  firstCoeff(0),
+				  nmbCoeffs (0)
 			{ }
 
-			T                constTerm;
-			std::vector<int> kmn1;
-			std::vector<int> jmnk;
-			std::vector<T>   factor;
+			int          kmn1Min;     ///< exponent of cos(theta / 2) in first term of sum
+			int          jmnkMin;     ///< exponent of sin(theta / 2) in last term of sum
+			unsigned int firstCoeff;  ///< index of first coefficient in coefficient table
+			unsigned int nmbCoeffs;   ///< number of terms in sum
 
 		};
 
-		typedef std::vector<std::vector<std::vector<cacheEntryType> > > cacheType;
 
-
-		static dFunctionCached& instance() { return _instance; }  ///< get singleton instance
+		static const dFunctionCached& instance()  ///< get singleton instance
+		{
+			// the table is built once on first use; initialization of
+			// function-local statics is thread-safe, and the table is never
+			// modified afterwards, so that it can be read concurrently
+			static const dFunctionCached _instance;
+			return _instance;
+		}
 
 		T operator ()(const int j,
 		              const int m,
 		              const int n,
-		              const T&  theta)  ///< returns d^j_{m n}(theta)
+		              const T&  theta) const  ///< returns d^j_{m n}(theta)
+		{
+			T dFuncVal;
+			(*this)(j, m, n, &theta, 1, &dFuncVal);
+			return dFuncVal;
+		}
+
+		void operator ()(const int    j,
+		                 const int    m,
+		                 const int    n,
+		                 const T*     theta,
+		                 const size_t nmbAngles,
+		                 T*           dFuncVals) const  ///< calculates d^j_{m n}(theta) for an array of angles
 		{
 			// check input parameters
 			if (j >= (int)_maxJ) {
@@ -89,126 +115,109 @@ namespace rpwa {
 			if ((j < 0) or (rpwa::abs(m) > j) or (rpwa::abs(n) > j)) {
 				printErr << "illegal argument for Wigner d^{J = " << 0.5 * j << "}"
 				         << "_{M = " << 0.5 * m << ", M' = " << 0.5 * n << "}"
-				         << "(theta = " << maxPrecision(theta) << "). Aborting..." << std::endl;
+				         << "(theta = " << maxPrecision((nmbAngles > 0) ? theta[0] : T()) << "). Aborting..." << std::endl;
 				throw;
 			}
 
-			// trivial case
-			if (j == 0)
-				return 1;
-
-			// swap spin projections for negative angle
-			int _m        = m;
-			int _n        = n;
-			T   thetaHalf = theta / 2;
-			if (theta < 0) {
-				thetaHalf = rpwa::abs(thetaHalf);
-				std::swap(_m, _n);
-			}
-
-			const T cosThetaHalf = cos(thetaHalf);
-			const T sinThetaHalf = sin(thetaHalf);
-
-			T                dFuncVal   = 0;
-			cacheEntryType*& cacheEntry = _cache[j][(j + _m) / 2][(j + _n) / 2];
-			if (_useCache and cacheEntry) {
-				// calculate function value using cache
-				T sumTerm = 0;
-				for (unsigned int i = 0; i < cacheEntry->factor.size(); ++i) {
-					sumTerm +=   rpwa::pow(cosThetaHalf, cacheEntry->kmn1[i])
-						         * rpwa::pow(sinThetaHalf, cacheEntry->jmnk[i]) / cacheEntry->factor[i];
+			const cacheEntryType& cacheEntry = _cache[j][(j + m) / 2][(j + n) / 2];
+			const T*              coeffs     = &_coeffs[cacheEntry.firstCoeff];
+
+			// the angles are processed in blocks with the sum over the terms
+			// as the outer loop, so that the inner loops over the angles
+			// have no dependencies and can be vectorized by the compiler
+			const size_t blockSize = 64;
+			T cos2ThetaHalf[blockSize];
+			T sin2ThetaHalf[blockSize];
+			T cos2Power    [blockSize];
+			for (size_t blockStart = 0; blockStart < nmbAngles; blockStart += blockSize) {
+				const size_t nmbBlock = std::min(blockSize, nmbAngles - blockStart);
+				T* vals = dFuncVals + blockStart;
+				for (size_t i = 0; i < nmbBlock; ++i) {
+					const T cosThetaHalf = cos(theta[blockStart + i] / 2);
+					const T sinThetaHalf = sin(theta[blockStart + i] / 2);
+					cos2ThetaHalf[i] = cosThetaHalf * cosThetaHalf;
+					sin2ThetaHalf[i] = sinThetaHalf * sinThetaHalf;
+					cos2Power    [i] = 1;
+					vals         [i] = intPow(cosThetaHalf, cacheEntry.kmn1Min) * intPow(sinThetaHalf, cacheEntry.jmnkMin);
 				}
-				dFuncVal = cacheEntry->constTerm * sumTerm;
-			} else {
-				// calculate function value and put intermediate values into cache
-				if (_useCache)
-					cacheEntry = new cacheEntryType();
-				const int jpm       = (j + _m) / 2;
-				const int jpn       = (j + _n) / 2;
-				const int jmm       = (j - _m) / 2;
-				const int jmn       = (j - _n) / 2;
-				const T   kk        =   rpwa::factorial<T>(jpm)
-					                    * rpwa::factorial<T>(jmm)
-					                    * rpwa::factorial<T>(jpn)
-					                    * rpwa::factorial<T>(jmn);
-				const T   constTerm = powMinusOne(jpm) * rpwa::sqrt(kk);
-				if (cacheEntry)
-					cacheEntry->constTerm = constTerm;
-
-				T         sumTerm = 0;
-				const int mpn     = (_m + _n) / 2;
-				const int kMin    = std::max(0,   mpn);
-				const int kMax    = std::min(jpm, jpn);
-				for (int k = kMin; k <= kMax; ++k) {
-					const int kmn1   = 2 * k - (_m + _n) / 2;
-					const int jmnk   = j + (_m + _n) / 2 - 2 * k;
-					const int jmk    = (j + _m) / 2 - k;
-					const int jnk    = (j + _n) / 2 - k;
-					const int kmn2   = k - (_m + _n) / 2;
-					const T   factor = (  rpwa::factorial<T>(k   )
-						                  * rpwa::factorial<T>(jmk )
-						                  * rpwa::factorial<T>(jnk )
-					                    * rpwa::factorial<T>(kmn2)) / powMinusOne(k);
-					if (cacheEntry) {
-						cacheEntry->kmn1.push_back  (kmn1);
-						cacheEntry->jmnk.push_back  (jmnk);
-						cacheEntry->factor.push_back(factor);
+				// homogeneous Horner scheme for the sum over the terms:
+				// sumTerm_k = sumTerm_{k - 1} * sin^2 + coeff_k * cos^{2 k}
+				T sumTerm[blockSize];
+				for (size_t i = 0; i < nmbBlock; ++i)
+					sumTerm[i] = coeffs[0];
+				for (unsigned int k = 1; k < cacheEntry.nmbCoeffs; ++k)
+					for (size_t i = 0; i < nmbBlock; ++i) {
+						cos2Power[i] *= cos2ThetaHalf[i];
+						sumTerm  [i]  = sumTerm[i] * sin2ThetaHalf[i] + coeffs[k] * cos2Power[i];
 					}
-					// using the 1 / factor here so that function value is the same as in PWA2000
-					sumTerm += rpwa::pow(cosThetaHalf, kmn1) * rpwa::pow(sinThetaHalf, jmnk) / factor;
-				}
-				dFuncVal = constTerm * sumTerm;
+				for (size_t i = 0; i < nmbBlock; ++i)
+					vals[i] *= sumTerm[i];
 			}
-
-			return dFuncVal;
 		}
 
-		static bool useCache()                              { return _useCache;     }  ///< returns caching flag
-		static void setUseCache(const bool useCache = true) { _useCache = useCache; }  ///< sets caching flag
-		static unsigned int cacheSize()  ///< returns cache size in bytes
+		unsigned int cacheSize() const  ///< returns cache size in bytes
 		{
-			unsigned int size = _maxJ * (_maxJ + 1) * (_maxJ + 1) * sizeof(_cache[0][0][0]);
-			for (int j = 0; j < (int)_maxJ; ++j)
-				for (int m = -j; m <= j; m += 2)
-					for (int n = -j; n <= j; n += 2) {
-						cacheEntryType*& cacheEntry = _cache[j][(j + m) / 2][(j + n) / 2];
-						if (cacheEntry) {
-							size += sizeof(*cacheEntry);
-							size += cacheEntry->kmn1.capacity  () * sizeof(int);
-							size += cacheEntry->jmnk.capacity  () * sizeof(int);
-							size += cacheEntry->factor.capacity() * sizeof(T);
-						}
-					}
-			return size;
+			return sizeof(_cache) + _coeffs.capacity() * sizeof(T);
 		}
 
 
 	private:
 
-		dFunctionCached () { }
-		~dFunctionCached()
+		dFunctionCached()
 		{
+			// factorials are calculated in double precision independent of
+			// T, in order not to depend on the (non-thread-safe)
+			// factorialCached singleton during the construction
+			std::vector<double> factorials(_maxJ + 1, 1);
+			for (unsigned int i = 1; i < factorials.size(); ++i)
+				factorials[i] = i * factorials[i - 1];
+
+			// based on PWA2000 function d_jmn_b()
 			for (int j = 0; j < (int)_maxJ; ++j)
 				for (int m = -j; m <= j; m += 2)
-					for (int n = -j; n <= j; n += 2)
-						delete _cache[j][(j + m) / 2][(j + n) / 2];
+					for (int n = -j; n <= j; n += 2) {
+						cacheEntryType& cacheEntry = _cache[j][(j + m) / 2][(j + n) / 2];
+						const int    jpm       = (j + m) / 2;
+						const int    jpn       = (j + n) / 2;
+						const int    jmm       = (j - m) / 2;
+						const int    jmn       = (j - n) / 2;
+						const double kk        = factorials[jpm] * factorials[jmm] * factorials[jpn] * factorials[jmn];
+						const double constTerm = powMinusOne(jpm) * std::sqrt(kk);
+						const int    mpn       = (m + n) / 2;
+						const int    kMin      = std::max(0,   mpn);
+						const int    kMax      = std::min(jpm, jpn);
+						cacheEntry.kmn1Min    = 2 * kMin - mpn;
+						cacheEntry.jmnkMin    = j + mpn - 2 * kMax;
+						cacheEntry.firstCoeff = _coeffs.size();
+						cacheEntry.nmbCoeffs  = kMax - kMin + 1;
+						for (int k = kMin; k <= kMax; ++k) {
+							const double factor = (  factorials[k]
+							                       * factorials[jpm - k]
+							                       * factorials[jpn - k]
+							                       * factorials[k - mpn]) / powMinusOne(k);
+							// using the 1 / factor here so that function value is the same as in PWA2000
+							_coeffs.push_back((T)(constTerm / factor));
+						}
+					}
 		}
+		~dFunctionCached() { }
 		dFunctionCached (const dFunctionCached&);
 		dFunctionCached& operator =(const dFunctionCached&);
 
-		static dFunctionCached _instance;  ///< singleton instance
-		static bool            _useCache;  ///< if set to true, cache is used
-
-		static const unsigned int _maxJ = 41;                           ///< maximum allowed angular momentum * 2 + 1
-		static cacheEntryType*    _cache[_maxJ][_maxJ + 1][_maxJ + 1];  ///< cache for intermediate terms [j][m][n]
-	};
-
+		static T intPow(const T&  base,
+		                const int exponent)  ///< base^exponent for small non-negative integer exponents
+		{
+			T result = 1;
+			for (int i = 0; i < exponent; ++i)
+				result *= base;
+			return result;
+		}
 
-	template<typename T> dFunctionCached<T> dFunctionCached<T>::_instance;
-	template<typename T> bool               dFunctionCached<T>::_useCache = true;
+		static const unsigned int _maxJ = 41;  ///< maximum allowed angular momentum * 2 + 1
 
-	template<typename T> typename dFunctionCached<T>::cacheEntryType*
-	  dFunctionCached<T>::_cache[_maxJ][_maxJ + 1][_maxJ + 1];
+		cacheEntryType _cache[_maxJ][_maxJ + 1][_maxJ + 1];  ///< position of coefficients in table [j][m][n]
+		std::vector<T> _coeffs;                               ///< table of coefficients of all d-functions
+	};
 
 
 	template<typename T>
@@ -229,6 +238,20 @@ namespace rpwa {
 	}
 
 
+	template<typename T>
+	inline
+	void
+	dFunction(const int    j,
+	          const int    m,
+	          const int    n,
+	          const T*     theta,
+	          const size_t nmbAngles,
+	          T*           dFuncVals)  ///< Wigner d-function d^j_{m n}(theta) for an array of angles
+	{
+		dFunctionCached<T>::instance()(j, m, n, theta, nmbAngles, dFuncVals);
+	}
+
+
 	template<typename complexT>
   inline
   complexT
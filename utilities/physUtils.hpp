@@ -104,6 +104,24 @@ namespace rpwa {
 	}
 
 
+	// computes derivative of breakup momentum of 2-body decay w.r.t. the mass of the mother particle
+	inline
+	double
+	breakupMomentumDerivative(const double M,   // mass of mother particle
+	                          const double m1,  // mass of daughter particle 1
+	                          const double m2)  // mass of daughter particle 2
+	{
+		const double q = breakupMomentum(M, m1, m2);
+		if (q == 0)
+			return 0;
+		// d(q^2)/dM = M / 2 * (1 - (m1 + m2)^2 (m1 - m2)^2 / M^4)
+		const double mSum2  = (m1 + m2) * (m1 + m2);
+		const double mDiff2 = (m1 - m2) * (m1 - m2);
+		const double M2     = M * M;
+		return M * (1 - mSum2 * mDiff2 / (M2 * M2)) / (4 * q);
+	}
+
+
 	// computes breakup momentum of 2-body decay
 	// complex version with analytic continuation below threshold as used in K-matrix formalism
 	inline
@@ -258,6 +276,61 @@ namespace rpwa {
 	}
 
 
+	// computes derivative of square of Blatt-Weisskopf barrier factor for 2-body decay w.r.t. the breakup momentum
+	// !NOTE! L is units of hbar/2
+	inline
+	double
+	barrierFactorSquaredDerivative(const int    L,               // relative orbital angular momentum
+	                               const double breakupMom,      // breakup momentum of 2-body decay [GeV/c]
+	                               const double Pr    = 0.1973)  // momentum scale 0.1973 GeV/c corresponds to 1 fm interaction radius
+	{
+		if ((L == 0) or (breakupMom == 0))
+			return 0;
+		// the squared barrier factors have the form c z^(L/2) / D(z), so that
+		// d(bf2)/dz = bf2 * (L/2 / z - D'(z) / D(z))
+		const double z  = (breakupMom * breakupMom) / (Pr * Pr);
+		double       D  = 0;
+		double       dD = 0;
+		switch (L) {
+		case 2:  // L = 1
+			D  = z + 1;
+			dD = 1;
+			break;
+		case 4:  // L = 2
+			D  = z * (z + 3) + 9;
+			dD = 2 * z + 3;
+			break;
+		case 6:  // L = 3
+			D  = z * (z * (z + 6) + 45) + 225;
+			dD = z * (3 * z + 12) + 45;
+			break;
+		case 8:  // L = 4
+			D  = z * (z * (z * (z + 10) + 135) + 1575) + 11025;
+			dD = z * (z * (4 * z + 30) + 270) + 1575;
+			break;
+		case 10:  // L = 5
+			D  = z * (z * (z * (z * (z + 15) + 315) + 6300) + 99225) + 893025;
+			dD = z * (z * (z * (5 * z + 60) + 945) + 12600) + 99225;
+			break;
+		case 12:  // L = 6
+			D  = z * (z * (z * (z * (z * (z + 21) + 630) + 18900) + 496125) + 9823275) + 108056025;
+			dD = z * (z * (z * (z * (6 * z + 105) + 2520) + 56700) + 992250) + 9823275;
+			break;
+		case 14:  // L = 7
+			D  = z * (z * (z * (z * (z * (z * (z + 28) + 1134) + 47250) + 1819125) + 58939650)
+			          + 1404728325L) + 18261468225LL;
+			dD = z * (z * (z * (z * (z * (7 * z + 168) + 5670) + 189000) + 5457375) + 117879300) + 1404728325L;
+			break;
+		default:
+			printDebug << "calculation of derivative of Blatt-Weisskopf barrier factor is not (yet) implemented for L = "
+			           << spinQn(L) << ". returning 0." << std::endl;
+			return 0;
+		}
+		const double bf2 = barrierFactorSquared(L, breakupMom, false, Pr);
+		return bf2 * ((L / 2) / z - dD / D) * 2 * breakupMom / (Pr * Pr);
+	}
+
+
 	// computes Blatt-Weisskopf barrier factor for 2-body decay
 	// !NOTE! L is units of hbar/2
 	inline
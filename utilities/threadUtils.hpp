@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////
+//
+//    Copyright 2026
+//
+//    This file is part of rootpwa
+//
+//    rootpwa is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    rootpwa is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with rootpwa. If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////
+//-------------------------------------------------------------------------
+//
+// Description:
+//      helper functions for multithreaded calculations
+//
+//      the thread pool is provided by OpenMP; if the code is compiled
+//      without OpenMP support all functions fall back to a single
+//      thread, so that calling code does not need any #ifdefs apart
+//      from the ones around the '#pragma omp' statements
+//
+//      work is always distributed in contiguous chunks whose
+//      boundaries only depend on the number of chunks; partial results
+//      are stored per chunk and are reduced in chunk order by the
+//      calling code, which makes the results bit-reproducible for a
+//      given number of threads
+//
+//
+// Author List:
+//      Boris Grube          TUM            (original author)
+//
+//
+//-------------------------------------------------------------------------
+
+
+#ifndef THREADUTILS_HPP
+#define THREADUTILS_HPP
+
+
+#include <algorithm>
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+namespace rpwa {
+
+
+	inline
+	unsigned int
+	maxNmbThreads()  ///< returns number of threads available to OpenMP; 1 if compiled without OpenMP
+	{
+#ifdef _OPENMP
+		return std::max(omp_get_max_threads(), 1);
+#else
+		return 1;
+#endif
+	}
+
+
+	inline
+	unsigned int
+	threadIndex()  ///< returns index of calling thread within current parallel region
+	{
+#ifdef _OPENMP
+		return omp_get_thread_num();
+#else
+		return 0;
+#endif
+	}
+
+
+	inline
+	unsigned int
+	nmbThreadsToUse(const unsigned int requestedNmbThreads)  ///< translates requested number of threads into number of threads that can be used; 0 means all available threads
+	{
+		const unsigned int maxThreads = maxNmbThreads();
+		if ((requestedNmbThreads == 0) or (requestedNmbThreads > maxThreads))
+			return maxThreads;
+		return requestedNmbThreads;
+	}
+
+
+	inline
+	unsigned int
+	nmbChunks(const std::size_t  nmbItems,
+	          const unsigned int nmbThreads)  ///< returns number of non-empty chunks the items are split into
+	{
+		if (nmbItems == 0)
+			return 1;
+		return (unsigned int)std::min((std::size_t)std::max(nmbThreads, 1u), nmbItems);
+	}
+
+
+	inline
+	void
+	chunkRange(const std::size_t  nmbItems,   // total number of items
+	           const unsigned int nmbChunks,  // number of chunks the items are split into
+	           const unsigned int iChunk,     // index of chunk
+	           std::size_t&       begin,      // index of first item in chunk
+	           std::size_t&       end)        // index after last item in chunk
+	{
+		// the first (nmbItems % nmbChunks) chunks get one item more
+		const std::size_t chunkSize = nmbItems / nmbChunks;
+		const std::size_t remainder = nmbItems % nmbChunks;
+		begin = iChunk * chunkSize + std::min((std::size_t)iChunk, remainder);
+		end   = begin + chunkSize + ((iChunk < remainder) ? 1 : 0);
+	}
+
+
+}  // namespace rpwa
+
+
+#endif  // THREADUTILS_HPP